@@ -318,7 +318,8 @@ function main
 
   local alg_options
 
-  for alg_options in -DSWEEPER_SIMPLE -DSWEEPER_TILEOCTANTS ; do
+  for alg_options in -DSWEEPER_SIMPLE -DSWEEPER_TILEOCTANTS \
+                     -DSWEEPER_HYPERPLANE ; do
 
     #make MPI_OPTION= ALG_OPTIONS="$alg_options" NM_VALUE=16
 
@@ -8,9 +8,22 @@
  */
 /*---------------------------------------------------------------------------*/
 
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include <stdio.h>
 #include <string.h>
 #include "sys/time.h"
 
+#ifdef __linux__
+#include <unistd.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
 #include "arguments.h"
 #include "env.h"
 
@@ -38,6 +51,43 @@ void Env_initialize( Env *env, int argc, char** argv )
   Env_cuda_initialize_( env, argc, argv );
 }
 
+/*===========================================================================*/
+/*---Set thread affinity values from args---*/
+
+static void Env_affinity_set_values_( Env *env, Arguments* args )
+{
+  env->affinity_ = Arguments_consume_int_or_default( args, "--affinity",
+                                                     ENV_AFFINITY_NONE );
+  Insist( env->affinity_ >= ENV_AFFINITY_NONE &&
+          env->affinity_ <= ENV_AFFINITY_SPREAD ?
+          "Invalid affinity supplied." : 0 );
+
+  /*---Record the cpus this process may run on, in increasing order---*/
+
+  env->ncpu_ = 0;
+#if defined( __linux__ ) && defined( USE_OPENMP )
+  {
+    cpu_set_t mask;
+    int cpu = 0;
+
+    CPU_ZERO( &mask );
+    if( sched_getaffinity( 0, sizeof( mask ), &mask ) == 0 )
+    {
+      for( cpu=0; cpu<CPU_SETSIZE && env->ncpu_<ENV_NCPU_MAX; ++cpu )
+      {
+        if( CPU_ISSET( cpu, &mask ) )
+        {
+          env->cpu_[ env->ncpu_++ ] = cpu;
+        }
+      }
+    }
+  }
+#endif
+
+  Insist( env->affinity_ == ENV_AFFINITY_NONE || env->ncpu_ > 0 ?
+          "Thread affinity requires an OpenMP build on Linux." : 0 );
+}
+
 /*===========================================================================*/
 /*---Set values from args---*/
 
@@ -45,6 +95,7 @@ void Env_set_values( Env *env, Arguments* args )
 {
   Env_mpi_set_values_(  env, args );
   Env_cuda_set_values_( env, args );
+  Env_affinity_set_values_( env, args );
 }
 
 /*===========================================================================*/
@@ -84,6 +135,160 @@ Timer Env_get_synced_time( Env* env )
   return Env_get_time( env );
 }
 
+/*===========================================================================*/
+/*---Size in bytes of the data cache at a given level, 0 if unknown---*/
+
+/*---NOTE: read from Linux sysfs for the first cpu; elsewhere 0---*/
+
+size_t Env_cache_size( Env* env, int level )
+{
+  size_t result = 0;
+
+  int index = 0;
+  for( index=0; result==0; ++index )
+  {
+    char path[128];
+    char type[80];
+    int level_this = 0;
+    long size = 0;
+    char unit = 0;
+    FILE* file = NULL;
+
+    sprintf( path, "/sys/devices/system/cpu/cpu0/cache/index%i/level",
+             index );
+    file = fopen( path, "r" );
+    if( ! file )
+    {
+      break;
+    }
+    if( fscanf( file, "%i", &level_this ) != 1 )
+    {
+      level_this = 0;
+    }
+    fclose( file );
+
+    sprintf( path, "/sys/devices/system/cpu/cpu0/cache/index%i/type",
+             index );
+    file = fopen( path, "r" );
+    if( ! file || fscanf( file, "%79s", type ) != 1 )
+    {
+      strcpy( type, "" );
+    }
+    if( file )
+    {
+      fclose( file );
+    }
+
+    if( level_this != level || strcmp( type, "Instruction" ) == 0 )
+    {
+      continue;
+    }
+
+    sprintf( path, "/sys/devices/system/cpu/cpu0/cache/index%i/size",
+             index );
+    file = fopen( path, "r" );
+    if( file && fscanf( file, "%ld%c", &size, &unit ) >= 1 && size > 0 )
+    {
+      result = unit == 'K' ? ( (size_t)size ) << 10 :
+               unit == 'M' ? ( (size_t)size ) << 20 : (size_t)size;
+    }
+    if( file )
+    {
+      fclose( file );
+    }
+  }
+
+  return result;
+}
+
+/*===========================================================================*/
+/*---Count the pages of a host memory range resident on each NUMA node---*/
+
+size_t Env_page_node_counts( Env* env, const void* p, size_t nbytes,
+                             size_t* npage_node )
+{
+  size_t result = 0;
+
+#if defined( __linux__ ) && defined( SYS_move_pages )
+  /*---move_pages with no target nodes reports where each page lives---*/
+
+  enum{ NPAGE_BATCH = 1024 };
+
+  const size_t page_size = (size_t)sysconf( _SC_PAGESIZE );
+  const size_t base = ( (size_t)p ) / page_size * page_size;
+  const size_t npage = nbytes == 0 ? 0 :
+                       ( ( (size_t)p ) + nbytes - base + page_size - 1 )
+                       / page_size;
+
+  size_t page_first = 0;
+
+  for( page_first=0; page_first<npage; page_first+=NPAGE_BATCH )
+  {
+    void* pages[NPAGE_BATCH];
+    int status[NPAGE_BATCH];
+    const size_t npage_batch = npage - page_first < NPAGE_BATCH ?
+                               npage - page_first : NPAGE_BATCH;
+    size_t i = 0;
+
+    for( i=0; i<npage_batch; ++i )
+    {
+      pages[i] = (void*)( base + ( page_first + i ) * page_size );
+    }
+
+    if( syscall( SYS_move_pages, 0, (unsigned long)npage_batch, pages,
+                 NULL, status, 0 ) != 0 )
+    {
+      return 0;
+    }
+
+    /*---Negative status: page not yet touched, or not queryable---*/
+
+    for( i=0; i<npage_batch; ++i )
+    {
+      if( status[i] >= 0 && status[i] < ENV_NNODE_MAX )
+      {
+        npage_node[ status[i] ]++;
+        result++;
+      }
+    }
+  }
+#endif
+
+  return result;
+}
+
+/*===========================================================================*/
+/*---Thread affinity plan---*/
+
+int Env_affinity( const Env* env )
+{
+  return env->affinity_;
+}
+
+/*---------------------------------------------------------------------------*/
+
+int Env_affinity_cpu( const Env* env, int slot, int nslot )
+{
+  const int ncpu = env->ncpu_;
+
+  Assert( env->affinity_ != ENV_AFFINITY_NONE );
+  Assert( ncpu > 0 );
+  Assert( slot >= 0 && slot < nslot );
+
+  /*---With more slots than cpus, wrap around---*/
+
+  return env->affinity_ == ENV_AFFINITY_SPREAD && nslot <= ncpu ?
+         env->cpu_[ ( slot * ncpu ) / nslot ] : env->cpu_[ slot % ncpu ];
+}
+
+/*---------------------------------------------------------------------------*/
+
+const char* Env_affinity_name( const Env* env )
+{
+  return env->affinity_ == ENV_AFFINITY_COMPACT ? "compact" :
+         env->affinity_ == ENV_AFFINITY_SPREAD  ? "spread"  : "none";
+}
+
 /*===========================================================================*/
 
 #ifdef __cplusplus
@@ -79,6 +79,48 @@ Timer Env_get_time( Env* env );
 
 Timer Env_get_synced_time( Env* env );
 
+/*===========================================================================*/
+/*---Size in bytes of the data cache at a given level, 0 if unknown---*/
+
+size_t Env_cache_size( Env* env, int level );
+
+/*===========================================================================*/
+/*---Count the pages of a host memory range resident on each NUMA node---*/
+
+/*---Adds to npage_node[node] for node < ENV_NNODE_MAX; returns the number
+     of pages found resident, 0 if the query is unavailable---*/
+
+enum{ ENV_NNODE_MAX = 64 };
+
+size_t Env_page_node_counts( Env* env, const void* p, size_t nbytes,
+                             size_t* npage_node );
+
+/*===========================================================================*/
+/*---Thread affinity plans---*/
+
+/*---NONE leaves placement to the system.  COMPACT puts consecutive slots
+     on consecutive cpus of this process.  SPREAD spaces the slots evenly
+     over those cpus, so that runs of neighboring slots land on separate
+     cores or sockets---*/
+
+enum{ ENV_AFFINITY_NONE    = 0 };
+enum{ ENV_AFFINITY_COMPACT = 1 };
+enum{ ENV_AFFINITY_SPREAD  = 2 };
+
+/*---------------------------------------------------------------------------*/
+
+int Env_affinity( const Env* env );
+
+/*---------------------------------------------------------------------------*/
+/*---Cpu for slot of nslot threads placed by the affinity plan---*/
+
+int Env_affinity_cpu( const Env* env, int slot, int nslot );
+
+/*---------------------------------------------------------------------------*/
+/*---Name of the affinity plan, for output---*/
+
+const char* Env_affinity_name( const Env* env );
+
 /*===========================================================================*/
 
 #ifdef __cplusplus
@@ -128,6 +128,16 @@ P* malloc_host_P( size_t n )
 
 /*---------------------------------------------------------------------------*/
 
+PAccum* malloc_host_PAccum( size_t n )
+{
+  Assert( n+1 >= 1 );
+  PAccum* result = (PAccum*)malloc( n * sizeof(PAccum) );
+  Assert( result );
+  return result;
+}
+
+/*---------------------------------------------------------------------------*/
+
 P* malloc_host_pinned_P( size_t n )
 {
   Assert( n+1 >= 1 );
@@ -180,6 +190,14 @@ void free_host_P( P* p )
 
 /*---------------------------------------------------------------------------*/
 
+void free_host_PAccum( PAccum* p )
+{
+  Assert( p );
+  free( (void*) p );
+}
+
+/*---------------------------------------------------------------------------*/
+
 void free_host_pinned_P( P* p )
 {
   Assert( p );
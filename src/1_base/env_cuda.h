@@ -64,6 +64,10 @@ P* malloc_host_P( size_t n );
 
 /*---------------------------------------------------------------------------*/
 
+PAccum* malloc_host_PAccum( size_t n );
+
+/*---------------------------------------------------------------------------*/
+
 P* malloc_host_pinned_P( size_t n );
 
 /*---------------------------------------------------------------------------*/
@@ -80,6 +84,10 @@ void free_host_P( P* p );
 
 /*---------------------------------------------------------------------------*/
 
+void free_host_PAccum( PAccum* p );
+
+/*---------------------------------------------------------------------------*/
+
 void free_host_pinned_P( P* p );
 
 /*---------------------------------------------------------------------------*/
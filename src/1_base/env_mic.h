@@ -41,6 +41,16 @@ static P* malloc_host_P( size_t n )
 
 /*---------------------------------------------------------------------------*/
 
+static PAccum* malloc_host_PAccum( size_t n )
+{
+  Assert( n+1 >= 1 );
+  PAccum* result = _mm_malloc( n * sizeof(PAccum), VEC_LEN * sizeof(P) );
+  Assert( result );
+  return result;
+}
+
+/*---------------------------------------------------------------------------*/
+
 static P* malloc_host_pinned_P( size_t n )
 {
   return malloc_host_P( n );
@@ -73,6 +83,14 @@ static void free_host_P( P* p )
 
 /*---------------------------------------------------------------------------*/
 
+static void free_host_PAccum( PAccum* p )
+{
+  Assert( p );
+  _mm_free( p );
+}
+
+/*---------------------------------------------------------------------------*/
+
 static void free_host_pinned_P( P* p )
 {
   free_host_P( p );
@@ -8,10 +8,25 @@
  */
 /*---------------------------------------------------------------------------*/
 
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
 #include <string.h>
 
 #ifdef USE_MPI
+#include <time.h>
+#include <pthread.h>
 #include "mpi.h"
+
+/*---MPI datatype matching P---*/
+#ifdef USE_MIXED_PRECISION
+#define MPI_P MPI_FLOAT
+#else
+#define MPI_P MPI_DOUBLE
+#endif
 #endif
 
 #include "types.h"
@@ -33,9 +48,14 @@ void Env_mpi_nullify_values_( Env *env )
   /*---Initialize MPI-related variables in env struct to null---*/
   env->nproc_x_ = 0;
   env->nproc_y_ = 0;
+  env->nproc_z_ = 0;
   env->tag_ = 0;
   env->active_comm_ = 0;
   env->is_proc_active_ = 0;
+  env->progress_ = ENV_PROGRESS_NONE;
+  env->nrequest_progress_ = 0;
+  env->is_progress_exiting_ = Bool_false;
+  /*---thread_level_ is kept, since MPI is initialized only once---*/
 #endif
 }
 
@@ -44,11 +64,36 @@ void Env_mpi_nullify_values_( Env *env )
 void Env_mpi_initialize_( Env *env, int argc, char** argv )
 {
 #ifdef USE_MPI
-  /*---Initialize for MPI execution---*/
-  const int mpi_code = MPI_Init( &argc, &argv );
+  /*---Initialize for MPI execution; thread support is asked for only if
+       the progress engine needs it: SERIALIZED to poll, MULTIPLE for a
+       progress thread---*/
+  Arguments args = Arguments_null();
+  Arguments_create( &args, argc, argv );
+  const int progress = Arguments_consume_int_or_default( &args,
+                                     "--comm_progress", ENV_PROGRESS_NONE );
+  Arguments_destroy( &args );
+
+  int thread_level = 0;
+  int mpi_code = 0;
+  if( progress == ENV_PROGRESS_THREAD || progress == ENV_PROGRESS_POLL )
+  {
+    mpi_code = MPI_Init_thread( &argc, &argv,
+                                progress == ENV_PROGRESS_THREAD ?
+                                MPI_THREAD_MULTIPLE : MPI_THREAD_SERIALIZED,
+                                &thread_level );
+  }
+  else
+  {
+    mpi_code = MPI_Init( &argc, &argv );
+    Assert( mpi_code == MPI_SUCCESS );
+    mpi_code = MPI_Query_thread( &thread_level );
+  }
   Assert( mpi_code == MPI_SUCCESS );
 #endif
   Env_mpi_nullify_values_( env );
+#ifdef USE_MPI
+  env->thread_level_ = thread_level;
+#endif
 }
 
 /*===========================================================================*/
@@ -64,6 +109,131 @@ Bool_t Env_mpi_are_values_set_( const Env *env )
   return result;
 }
 
+/*===========================================================================*/
+/*---Progress engine---*/
+
+/*---The engine holds copies of the requests handed to it, with the
+     handles they were handed in with as keys, and tests them with
+     MPI_Testsome under a mutex.  A completed nonpersistent request is
+     freed by the test, so the caller learns of it on removal.  The
+     thread sleeps briefly between tests to leave the core mostly to the
+     compute threads---*/
+
+enum{ ENV_PROGRESS_SLEEP_NS = 20000 };
+
+/*---------------------------------------------------------------------------*/
+/*---Test the requests held; mutex held by caller---*/
+/*---pseudo-private member function---*/
+
+#ifdef USE_MPI
+static void Env_progress_test_( Env* env )
+{
+  int indices[ENV_NREQUEST_PROGRESS_MAX];
+  int nindex = 0;
+  int i = 0;
+
+  if( env->nrequest_progress_ == 0 )
+  {
+    return;
+  }
+
+  const int mpi_code = MPI_Testsome( env->nrequest_progress_,
+                                     env->request_progress_, &nindex, indices,
+                                     MPI_STATUSES_IGNORE );
+  Assert( mpi_code == MPI_SUCCESS );
+
+  if( nindex == MPI_UNDEFINED )
+  {
+    return;
+  }
+
+  for( i=0; i<nindex; ++i )
+  {
+    env->is_request_progress_done_[ indices[i] ] = Bool_true;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---Body of the progress thread---*/
+/*---pseudo-private member function---*/
+
+static void* Env_progress_thread_( void* arg )
+{
+  Env* const env = (Env*)arg;
+
+  struct timespec sleep_time;
+  sleep_time.tv_sec  = 0;
+  sleep_time.tv_nsec = ENV_PROGRESS_SLEEP_NS;
+
+  Bool_t is_exiting = Bool_false;
+
+  while( ! is_exiting )
+  {
+    pthread_mutex_lock( &( env->progress_mutex_ ) );
+    is_exiting = env->is_progress_exiting_;
+    if( ! is_exiting )
+    {
+      Env_progress_test_( env );
+    }
+    pthread_mutex_unlock( &( env->progress_mutex_ ) );
+
+    nanosleep( &sleep_time, NULL );
+  }
+
+  return NULL;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+/*---Start and stop the engine---*/
+/*---pseudo-private member functions---*/
+
+static void Env_progress_start_( Env* env )
+{
+#ifdef USE_MPI
+  if( env->progress_ == ENV_PROGRESS_NONE )
+  {
+    return;
+  }
+
+  pthread_mutex_init( &( env->progress_mutex_ ), NULL );
+  env->nrequest_progress_ = 0;
+  env->is_progress_exiting_ = Bool_false;
+
+  if( env->progress_ == ENV_PROGRESS_THREAD )
+  {
+    const int code = pthread_create( &( env->progress_thread_ ), NULL,
+                                     Env_progress_thread_, (void*)env );
+    Insist( code == 0 ? "Unable to start progress thread." : 0 );
+  }
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void Env_progress_stop_( Env* env )
+{
+#ifdef USE_MPI
+  if( env->progress_ == ENV_PROGRESS_NONE )
+  {
+    return;
+  }
+
+  Assert( env->nrequest_progress_ == 0 );
+
+  if( env->progress_ == ENV_PROGRESS_THREAD )
+  {
+    pthread_mutex_lock( &( env->progress_mutex_ ) );
+    env->is_progress_exiting_ = Bool_true;
+    pthread_mutex_unlock( &( env->progress_mutex_ ) );
+    pthread_join( env->progress_thread_, NULL );
+  }
+
+  pthread_mutex_destroy( &( env->progress_mutex_ ) );
+  env->progress_ = ENV_PROGRESS_NONE;
+#endif
+}
+
 /*===========================================================================*/
 /*---Finalize mpi---*/
 
@@ -72,6 +242,7 @@ void Env_mpi_finalize_values_( Env* env )
 #ifdef USE_MPI
   if( Env_mpi_are_values_set_( env ) )
   {
+    Env_progress_stop_( env );
     if( env->active_comm_ != MPI_COMM_WORLD )
     {
       const int mpi_code = MPI_Comm_free( &env->active_comm_ );
@@ -113,10 +284,12 @@ void Env_mpi_set_values_( Env *env, Arguments* args )
 
   env->nproc_x_ = Arguments_consume_int_or_default( args, "--nproc_x", 1 );
   env->nproc_y_ = Arguments_consume_int_or_default( args, "--nproc_y", 1 );
+  env->nproc_z_ = Arguments_consume_int_or_default( args, "--nproc_z", 1 );
   Insist( env->nproc_x_ > 0 ? "Invalid nproc_x supplied." : 0 );
   Insist( env->nproc_y_ > 0 ? "Invalid nproc_y supplied." : 0 );
+  Insist( env->nproc_z_ > 0 ? "Invalid nproc_z supplied." : 0 );
 
-  const int nproc_requested = env->nproc_x_ * env->nproc_y_;
+  const int nproc_requested = env->nproc_x_ * env->nproc_y_ * env->nproc_z_;
   int nproc_world = 0;
   mpi_code = MPI_Comm_size( MPI_COMM_WORLD, &nproc_world );
   Assert( mpi_code == MPI_SUCCESS );
@@ -136,6 +309,20 @@ void Env_mpi_set_values_( Env *env, Arguments* args )
   Assert( mpi_code == MPI_SUCCESS );
 
   env->tag_ = 0;
+
+  env->progress_ = Arguments_consume_int_or_default( args, "--comm_progress",
+                                                     ENV_PROGRESS_NONE );
+  Insist( env->progress_ >= ENV_PROGRESS_NONE &&
+          env->progress_ <= ENV_PROGRESS_THREAD ?
+          "Invalid comm_progress supplied." : 0 );
+  Insist( env->progress_ != ENV_PROGRESS_POLL ||
+          env->thread_level_ >= MPI_THREAD_SERIALIZED ?
+          "Progress polling requires MPI_THREAD_SERIALIZED support." : 0 );
+  Insist( env->progress_ != ENV_PROGRESS_THREAD ||
+          env->thread_level_ >= MPI_THREAD_MULTIPLE ?
+          "A progress thread requires MPI_THREAD_MULTIPLE support." : 0 );
+
+  Env_progress_start_( env );
 #endif
 }
 
@@ -181,10 +368,23 @@ int Env_nproc_y( const Env* env )
 
 /*---------------------------------------------------------------------------*/
 
+int Env_nproc_z( const Env* env )
+{
+  Assert( Env_mpi_are_values_set_( env ) );
+  int result = 1;
+#ifdef USE_MPI
+  result = env->nproc_z_;
+#endif
+  Assert( result > 0 );
+  return result;
+}
+
+/*---------------------------------------------------------------------------*/
+
 int Env_nproc( const Env* env )
 {
   Assert( Env_mpi_are_values_set_( env ) );
-  return Env_nproc_x( env ) * Env_nproc_y( env );
+  return Env_nproc_x( env ) * Env_nproc_y( env ) * Env_nproc_z( env );
 }
 
 /*===========================================================================*/
@@ -229,13 +429,15 @@ void Env_increment_tag( Env* env, int value )
 /*===========================================================================*/
 /*---Proc number info---*/
 
-int Env_proc( const Env* env, int proc_x, int proc_y )
+int Env_proc( const Env* env, int proc_x, int proc_y, int proc_z )
 {
   Assert( Env_mpi_are_values_set_( env ) );
   Assert( proc_x >= 0 && proc_x < Env_nproc_x( env ) );
   Assert( proc_y >= 0 && proc_y < Env_nproc_y( env ) );
-  int result = proc_x + Env_nproc_x( env ) * proc_y;
-  Assert( result >= 0 && result < Env_nproc_x( env ) * Env_nproc_y( env ) );
+  Assert( proc_z >= 0 && proc_z < Env_nproc_z( env ) );
+  int result = proc_x + Env_nproc_x( env ) * (
+               proc_y + Env_nproc_y( env ) * proc_z );
+  Assert( result >= 0 && result < Env_nproc( env ) );
   return result;
 }
 
@@ -256,11 +458,22 @@ int Env_proc_y( const Env* env, int proc )
 {
   Assert( Env_mpi_are_values_set_( env ) );
   Assert( proc >= 0 && proc < Env_nproc( env ) );
-  int result = proc / Env_nproc_x( env );
+  int result = ( proc / Env_nproc_x( env ) ) % Env_nproc_y( env );
   Assert( result >= 0 && result < Env_nproc_y( env ) );
   return result;
 }
 
+/*---------------------------------------------------------------------------*/
+
+int Env_proc_z( const Env* env, int proc )
+{
+  Assert( Env_mpi_are_values_set_( env ) );
+  Assert( proc >= 0 && proc < Env_nproc( env ) );
+  int result = proc / ( Env_nproc_x( env ) * Env_nproc_y( env ) );
+  Assert( result >= 0 && result < Env_nproc_z( env ) );
+  return result;
+}
+
 /*===========================================================================*/
 /*---Proc number info for this proc---*/
 
@@ -292,6 +505,14 @@ int Env_proc_y_this( const Env* env )
   return Env_proc_y( env, Env_proc_this( env ) );
 }
 
+/*---------------------------------------------------------------------------*/
+
+int Env_proc_z_this( const Env* env )
+{
+  Assert( Env_mpi_are_values_set_( env ) );
+  return Env_proc_z( env, Env_proc_this( env ) );
+}
+
 /*===========================================================================*/
 /*---MPI functions: global MPI operations---*/
 
@@ -325,8 +546,7 @@ double Env_sum_d( Env* env, double value )
 P Env_sum_P( Env* env, P value )
 {
   Assert( Env_mpi_are_values_set_( env ) );
-  Static_Assert( P_IS_DOUBLE );
-  return Env_sum_d( env, value );
+  return (P)Env_sum_d( env, (double)value );
 }
 
 /*---------------------------------------------------------------------------*/
@@ -394,14 +614,13 @@ void Env_recv_i( Env* env, int* data, size_t n, int proc, int tag )
 void Env_send_P( Env* env, const P* data, size_t n, int proc, int tag )
 {
   Assert( Env_mpi_are_values_set_( env ) );
-  Static_Assert( P_IS_DOUBLE );
   Assert( data != NULL );
   Assert( n+1 >= 1 );
   Assert( proc>=0 && proc<Env_nproc( env ) );
   Assert( tag>=0 );
 
 #ifdef USE_MPI
-  const int mpi_code = MPI_Send( (void*)data, n, MPI_DOUBLE, proc, tag,
+  const int mpi_code = MPI_Send( (void*)data, n, MPI_P, proc, tag,
                                                 Env_mpi_active_comm_( env ) );
   Assert( mpi_code == MPI_SUCCESS );
 #endif
@@ -412,7 +631,6 @@ void Env_send_P( Env* env, const P* data, size_t n, int proc, int tag )
 void Env_recv_P( Env* env, P* data, size_t n, int proc, int tag )
 {
   Assert( Env_mpi_are_values_set_( env ) );
-  Static_Assert( P_IS_DOUBLE );
   Assert( data != NULL );
   Assert( n+1 >= 1 );
   Assert( proc>=0 && proc<Env_nproc( env ) );
@@ -420,7 +638,7 @@ void Env_recv_P( Env* env, P* data, size_t n, int proc, int tag )
 
 #ifdef USE_MPI
   MPI_Status status;
-  const int mpi_code = MPI_Recv( (void*)data, n, MPI_DOUBLE, proc, tag,
+  const int mpi_code = MPI_Recv( (void*)data, n, MPI_P, proc, tag,
                                        Env_mpi_active_comm_( env ), &status );
   Assert( mpi_code == MPI_SUCCESS );
 #endif
@@ -433,7 +651,6 @@ void Env_asend_P( Env* env, const P* data, size_t n, int proc, int tag,
                                                           Request_t* request )
 {
   Assert( Env_mpi_are_values_set_( env ) );
-  Static_Assert( P_IS_DOUBLE );
   Assert( data != NULL );
   Assert( n+1 >= 1 );
   Assert( proc>=0 && proc<Env_nproc( env ) );
@@ -441,7 +658,7 @@ void Env_asend_P( Env* env, const P* data, size_t n, int proc, int tag,
   Assert( request != NULL );
 
 #ifdef USE_MPI
-  const int mpi_code = MPI_Isend( (void*)data, n, MPI_DOUBLE, proc, tag,
+  const int mpi_code = MPI_Isend( (void*)data, n, MPI_P, proc, tag,
                                        Env_mpi_active_comm_( env ), request );
   Assert( mpi_code == MPI_SUCCESS );
 #endif
@@ -453,7 +670,6 @@ void Env_arecv_P( Env* env, const P* data, size_t n, int proc, int tag,
                                                           Request_t* request )
 {
   Assert( Env_mpi_are_values_set_( env ) );
-  Static_Assert( P_IS_DOUBLE );
   Assert( data != NULL );
   Assert( n+1 >= 1 );
   Assert( proc>=0 && proc<Env_nproc( env ) );
@@ -461,7 +677,7 @@ void Env_arecv_P( Env* env, const P* data, size_t n, int proc, int tag,
   Assert( request != NULL );
 
 #ifdef USE_MPI
-  const int mpi_code = MPI_Irecv( (void*)data, n, MPI_DOUBLE, proc, tag,
+  const int mpi_code = MPI_Irecv( (void*)data, n, MPI_P, proc, tag,
                                        Env_mpi_active_comm_( env ), request );
   Assert( mpi_code == MPI_SUCCESS );
 #endif
@@ -478,6 +694,340 @@ void Env_wait( Env* env, Request_t* request )
 #endif
 }
 
+/*===========================================================================*/
+/*---MPI functions: point-to-point communication: persistent---*/
+
+/*---The request is created inactive and is started by Env_startall.
+     Once complete, it may be started again, until freed---*/
+
+void Env_asend_init_P( Env* env, const P* data, size_t n, int proc, int tag,
+                                                          Request_t* request )
+{
+  Assert( Env_mpi_are_values_set_( env ) );
+  Assert( data != NULL );
+  Assert( n+1 >= 1 );
+  Assert( proc>=0 && proc<Env_nproc( env ) );
+  Assert( tag>=0 );
+  Assert( request != NULL );
+
+#ifdef USE_MPI
+  const int mpi_code = MPI_Send_init( (void*)data, n, MPI_P, proc, tag,
+                                       Env_mpi_active_comm_( env ), request );
+  Assert( mpi_code == MPI_SUCCESS );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_arecv_init_P( Env* env, const P* data, size_t n, int proc, int tag,
+                                                          Request_t* request )
+{
+  Assert( Env_mpi_are_values_set_( env ) );
+  Assert( data != NULL );
+  Assert( n+1 >= 1 );
+  Assert( proc>=0 && proc<Env_nproc( env ) );
+  Assert( tag>=0 );
+  Assert( request != NULL );
+
+#ifdef USE_MPI
+  const int mpi_code = MPI_Recv_init( (void*)data, n, MPI_P, proc, tag,
+                                       Env_mpi_active_comm_( env ), request );
+  Assert( mpi_code == MPI_SUCCESS );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_startall( Env* env, int n, Request_t* requests )
+{
+  Assert( n >= 0 );
+  Assert( requests != NULL || n == 0 );
+#ifdef USE_MPI
+  if( n > 0 )
+  {
+    const int mpi_code = MPI_Startall( n, requests );
+    Assert( mpi_code == MPI_SUCCESS );
+  }
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_waitall( Env* env, int n, Request_t* requests )
+{
+  Assert( n >= 0 );
+  Assert( requests != NULL || n == 0 );
+#ifdef USE_MPI
+  if( n > 0 )
+  {
+    const int mpi_code = MPI_Waitall( n, requests, MPI_STATUSES_IGNORE );
+    Assert( mpi_code == MPI_SUCCESS );
+  }
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_request_free( Env* env, Request_t* request )
+{
+  Assert( request != NULL );
+#ifdef USE_MPI
+  const int mpi_code = MPI_Request_free( request );
+  Assert( mpi_code == MPI_SUCCESS );
+#endif
+}
+
+/*===========================================================================*/
+/*---Progress engine for outstanding requests---*/
+
+int Env_progress( const Env* env )
+{
+  Assert( Env_mpi_are_values_set_( env ) );
+  int result = ENV_PROGRESS_NONE;
+#ifdef USE_MPI
+  result = env->progress_;
+#endif
+  return result;
+}
+
+/*---------------------------------------------------------------------------*/
+
+Bool_t Env_is_progress_supported( const Env* env, int progress )
+{
+  Bool_t result = Bool_true;
+#ifdef USE_MPI
+  result = progress == ENV_PROGRESS_THREAD ?
+             env->thread_level_ >= MPI_THREAD_MULTIPLE :
+           progress == ENV_PROGRESS_POLL ?
+             env->thread_level_ >= MPI_THREAD_SERIALIZED : Bool_true;
+#endif
+  return result;
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_progress_add( Env* env, int n, const Request_t* requests )
+{
+  Assert( n >= 0 );
+  Assert( requests != NULL || n == 0 );
+#ifdef USE_MPI
+  if( env->progress_ == ENV_PROGRESS_NONE )
+  {
+    return;
+  }
+
+  pthread_mutex_lock( &( env->progress_mutex_ ) );
+
+  Insist( env->nrequest_progress_ + n <= ENV_NREQUEST_PROGRESS_MAX ?
+          "Too many requests for the progress engine." : 0 );
+
+  int i = 0;
+
+  for( i=0; i<n; ++i )
+  {
+    const int j = env->nrequest_progress_++;
+    env->request_progress_[j]         = requests[i];
+    env->request_progress_key_[j]     = requests[i];
+    env->is_request_progress_done_[j] = Bool_false;
+  }
+
+  pthread_mutex_unlock( &( env->progress_mutex_ ) );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_progress_remove( Env* env, int n, Request_t* requests )
+{
+  Assert( n >= 0 );
+  Assert( requests != NULL || n == 0 );
+#ifdef USE_MPI
+  if( env->progress_ == ENV_PROGRESS_NONE )
+  {
+    return;
+  }
+
+  pthread_mutex_lock( &( env->progress_mutex_ ) );
+
+  int i = 0;
+
+  for( i=0; i<n; ++i )
+  {
+    int j = 0;
+
+    for( j=0; j<env->nrequest_progress_; ++j )
+    {
+      if( env->request_progress_key_[j] == requests[i] )
+      {
+        break;
+      }
+    }
+    Assert( j < env->nrequest_progress_ );
+
+    if( env->is_request_progress_done_[j] )
+    {
+      requests[i] = MPI_REQUEST_NULL;
+    }
+
+    /*---Fill the hole with the last request held---*/
+
+    const int jlast = --env->nrequest_progress_;
+    env->request_progress_[j]         = env->request_progress_[jlast];
+    env->request_progress_key_[j]     = env->request_progress_key_[jlast];
+    env->is_request_progress_done_[j] = env->is_request_progress_done_[jlast];
+  }
+
+  pthread_mutex_unlock( &( env->progress_mutex_ ) );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_progress_poll( Env* env )
+{
+#ifdef USE_MPI
+  if( env->progress_ != ENV_PROGRESS_POLL )
+  {
+    return;
+  }
+
+  /*---Callers on other threads skip rather than wait.  The count of
+       requests held is changed under the mutex, so it is only read there,
+       by Env_progress_test_---*/
+
+  if( pthread_mutex_trylock( &( env->progress_mutex_ ) ) == 0 )
+  {
+    Env_progress_test_( env );
+    pthread_mutex_unlock( &( env->progress_mutex_ ) );
+  }
+#endif
+}
+
+/*===========================================================================*/
+/*---MPI functions: one-sided communication---*/
+
+/*---A window exposes an array of P on each proc, addressed in units of P.
+     Transfers use general active target synchronization: the target opens
+     an exposure epoch to its origins with Env_win_post and closes it with
+     Env_win_wait; each origin brackets its puts with Env_win_start and
+     Env_win_complete.  Only the procs named take part---*/
+
+/*---------------------------------------------------------------------------*/
+/*---Group of the procs named, within the active communicator---*/
+/*---pseudo-private member function---*/
+
+#ifdef USE_MPI
+static MPI_Group Env_group_( Env* env, int nproc, const int* procs )
+{
+  MPI_Group group_comm;
+  MPI_Group group;
+  int mpi_code = MPI_Comm_group( Env_mpi_active_comm_( env ), &group_comm );
+  Assert( mpi_code == MPI_SUCCESS );
+  mpi_code = MPI_Group_incl( group_comm, nproc, (int*)procs, &group );
+  Assert( mpi_code == MPI_SUCCESS );
+  mpi_code = MPI_Group_free( &group_comm );
+  Assert( mpi_code == MPI_SUCCESS );
+  return group;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_create_P( Env* env, P* data, size_t n, Win_t* win )
+{
+  Assert( Env_mpi_are_values_set_( env ) );
+  Assert( data != NULL );
+  Assert( win != NULL );
+
+#ifdef USE_MPI
+  const int mpi_code = MPI_Win_create( (void*)data,
+                                       (MPI_Aint)( n * sizeof(P) ),
+                                       (int)sizeof(P), MPI_INFO_NULL,
+                                       Env_mpi_active_comm_( env ), win );
+  Assert( mpi_code == MPI_SUCCESS );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_free( Env* env, Win_t* win )
+{
+  Assert( win != NULL );
+#ifdef USE_MPI
+  const int mpi_code = MPI_Win_free( win );
+  Assert( mpi_code == MPI_SUCCESS );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_post( Env* env, int nproc, const int* procs, Win_t win )
+{
+  Assert( Env_mpi_are_values_set_( env ) );
+  Assert( nproc > 0 );
+  Assert( procs != NULL );
+#ifdef USE_MPI
+  MPI_Group group = Env_group_( env, nproc, procs );
+  int mpi_code = MPI_Win_post( group, 0, win );
+  Assert( mpi_code == MPI_SUCCESS );
+  mpi_code = MPI_Group_free( &group );
+  Assert( mpi_code == MPI_SUCCESS );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_wait( Env* env, Win_t win )
+{
+#ifdef USE_MPI
+  const int mpi_code = MPI_Win_wait( win );
+  Assert( mpi_code == MPI_SUCCESS );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_start( Env* env, int nproc, const int* procs, Win_t win )
+{
+  Assert( Env_mpi_are_values_set_( env ) );
+  Assert( nproc > 0 );
+  Assert( procs != NULL );
+#ifdef USE_MPI
+  MPI_Group group = Env_group_( env, nproc, procs );
+  int mpi_code = MPI_Win_start( group, 0, win );
+  Assert( mpi_code == MPI_SUCCESS );
+  mpi_code = MPI_Group_free( &group );
+  Assert( mpi_code == MPI_SUCCESS );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_complete( Env* env, Win_t win )
+{
+#ifdef USE_MPI
+  const int mpi_code = MPI_Win_complete( win );
+  Assert( mpi_code == MPI_SUCCESS );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Env_put_P( Env* env, const P* data, size_t n, int proc, size_t offset,
+                                                                   Win_t win )
+{
+  Assert( Env_mpi_are_values_set_( env ) );
+  Assert( data != NULL );
+  Assert( n+1 >= 1 );
+  Assert( proc>=0 && proc<Env_nproc( env ) );
+
+#ifdef USE_MPI
+  const int mpi_code = MPI_Put( (void*)data, n, MPI_P, proc,
+                                (MPI_Aint)offset, n, MPI_P, win );
+  Assert( mpi_code == MPI_SUCCESS );
+#endif
+}
+
 /*===========================================================================*/
 
 #ifdef __cplusplus
@@ -70,6 +70,10 @@ int Env_nproc_y( const Env* env );
 
 /*---------------------------------------------------------------------------*/
 
+int Env_nproc_z( const Env* env );
+
+/*---------------------------------------------------------------------------*/
+
 int Env_nproc( const Env* env );
 
 /*===========================================================================*/
@@ -89,7 +93,7 @@ void Env_increment_tag( Env* env, int value );
 /*===========================================================================*/
 /*---Proc number info---*/
 
-int Env_proc( const Env* env, int proc_x, int proc_y );
+int Env_proc( const Env* env, int proc_x, int proc_y, int proc_z );
 
 /*---------------------------------------------------------------------------*/
 
@@ -99,6 +103,10 @@ int Env_proc_x( const Env* env, int proc );
 
 int Env_proc_y( const Env* env, int proc );
 
+/*---------------------------------------------------------------------------*/
+
+int Env_proc_z( const Env* env, int proc );
+
 /*===========================================================================*/
 /*---Proc number info for this proc---*/
 
@@ -112,6 +120,10 @@ int Env_proc_x_this( const Env* env );
 
 int Env_proc_y_this( const Env* env );
 
+/*---------------------------------------------------------------------------*/
+
+int Env_proc_z_this( const Env* env );
+
 /*===========================================================================*/
 /*---MPI functions: global MPI operations---*/
 
@@ -165,6 +177,97 @@ void Env_arecv_P( Env* env, const P* data, size_t n, int proc, int tag,
 
 void Env_wait( Env* env, Request_t* request );
 
+/*===========================================================================*/
+/*---MPI functions: point-to-point communication: persistent---*/
+
+void Env_asend_init_P( Env* env, const P* data, size_t n, int proc, int tag,
+                                                          Request_t* request );
+
+/*---------------------------------------------------------------------------*/
+
+void Env_arecv_init_P( Env* env, const P* data, size_t n, int proc, int tag,
+                                                          Request_t* request );
+
+/*---------------------------------------------------------------------------*/
+
+void Env_startall( Env* env, int n, Request_t* requests );
+
+/*---------------------------------------------------------------------------*/
+
+void Env_waitall( Env* env, int n, Request_t* requests );
+
+/*---------------------------------------------------------------------------*/
+
+void Env_request_free( Env* env, Request_t* request );
+
+/*===========================================================================*/
+/*---Progress engine for outstanding requests---*/
+
+/*---NONE leaves requests to progress when they are waited on.  POLL
+     tests them when Env_progress_poll is called, e.g. from inside a
+     compute loop.  THREAD tests them from a helper thread, which needs
+     MPI_THREAD_MULTIPLE---*/
+
+enum{ ENV_PROGRESS_NONE   = 0 };
+enum{ ENV_PROGRESS_POLL   = 1 };
+enum{ ENV_PROGRESS_THREAD = 2 };
+
+/*---------------------------------------------------------------------------*/
+
+int Env_progress( const Env* env );
+
+/*---------------------------------------------------------------------------*/
+/*---Does the thread support MPI provided allow a progress mode---*/
+
+Bool_t Env_is_progress_supported( const Env* env, int progress );
+
+/*---------------------------------------------------------------------------*/
+/*---Hand started requests to the progress engine---*/
+
+void Env_progress_add( Env* env, int n, const Request_t* requests );
+
+/*---------------------------------------------------------------------------*/
+/*---Take requests back from the progress engine before waiting on them;
+     those it has completed are set to null---*/
+
+void Env_progress_remove( Env* env, int n, Request_t* requests );
+
+/*---------------------------------------------------------------------------*/
+/*---Test the requests held, if polling; cheap if there are none or
+     another thread holds the engine---*/
+
+void Env_progress_poll( Env* env );
+
+/*===========================================================================*/
+/*---MPI functions: one-sided communication---*/
+
+void Env_win_create_P( Env* env, P* data, size_t n, Win_t* win );
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_free( Env* env, Win_t* win );
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_post( Env* env, int nproc, const int* procs, Win_t win );
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_wait( Env* env, Win_t win );
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_start( Env* env, int nproc, const int* procs, Win_t win );
+
+/*---------------------------------------------------------------------------*/
+
+void Env_win_complete( Env* env, Win_t win );
+
+/*---------------------------------------------------------------------------*/
+
+void Env_put_P( Env* env, const P* data, size_t n, int proc, size_t offset,
+                                                                  Win_t win );
+
 /*===========================================================================*/
 
 #ifdef __cplusplus
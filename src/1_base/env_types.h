@@ -20,6 +20,7 @@ since these are tightly coupled to the data structure.
 
 #ifdef USE_MPI
 #include "mpi.h"
+#include <pthread.h>
 #endif
 
 #ifdef USE_CUDA
@@ -37,9 +38,11 @@ extern "C"
 #ifdef USE_MPI
 typedef MPI_Comm    Comm_t;
 typedef MPI_Request Request_t;
+typedef MPI_Win     Win_t;
 #else
 typedef int Comm_t;
 typedef int Request_t;
+typedef int Win_t;
 #endif
 
 #ifdef USE_CUDA
@@ -48,17 +51,41 @@ typedef cudaStream_t Stream_t;
 typedef int Stream_t;
 #endif
 
+/*===========================================================================*/
+/*---Most cpus recorded for thread affinity---*/
+
+enum{ ENV_NCPU_MAX = 1024 };
+
+/*===========================================================================*/
+/*---Most requests the progress engine drives at once---*/
+
+enum{ ENV_NREQUEST_PROGRESS_MAX = 256 };
+
 /*===========================================================================*/
 /*---Struct containing environment information---*/
 
 typedef struct
 {
+  int    affinity_;   /*---Thread affinity plan, ENV_AFFINITY_*---*/
+  int    ncpu_;       /*---Number of cpus this process may run on---*/
+  int    cpu_[ENV_NCPU_MAX];
 #ifdef USE_MPI
   int    nproc_x_;    /*---Number of procs along x axis---*/
   int    nproc_y_;    /*---Number of procs along y axis---*/
+  int    nproc_z_;    /*---Number of procs along z axis---*/
   int    tag_;        /*---Next free message tag---*/
   Comm_t active_comm_;
   Bool_t is_proc_active_;
+  int    thread_level_; /*---Thread support provided by MPI---*/
+  /*---Progress engine for outstanding requests, ENV_PROGRESS_*---*/
+  int             progress_;
+  int             nrequest_progress_;
+  Request_t       request_progress_[ENV_NREQUEST_PROGRESS_MAX];
+  Request_t       request_progress_key_[ENV_NREQUEST_PROGRESS_MAX];
+  Bool_t          is_request_progress_done_[ENV_NREQUEST_PROGRESS_MAX];
+  pthread_mutex_t progress_mutex_;
+  pthread_t       progress_thread_;
+  Bool_t          is_progress_exiting_;
 #endif
 #ifdef USE_CUDA
   Bool_t   is_using_device_;
@@ -0,0 +1,291 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   simd_kernels.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Thin wrappers for explicit SIMD, code for comp. kernel.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#ifndef _simd_kernels_h_
+#define _simd_kernels_h_
+
+#include <stddef.h>
+
+#include "types_kernels.h"
+#include "env_assert_kernels.h"
+
+/*---Instruction set is chosen by the compiler target flags, e.g.
+     -mavx2 or -mavx512f (or -march=native); otherwise scalar---*/
+
+#ifndef __CUDA_ARCH__
+#if defined( __AVX512F__ ) || defined( __AVX2__ )
+#include <immintrin.h>
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Vector type of PAccum, lane count, and tail mask for the target ISA---*/
+
+/*---NOTE: the vector types hold PAccum, which is double in every build,
+     and arithmetic is in that precision.  Storage precision P is double
+     too, or float with USE_MIXED_PRECISION; the *_P_* loads and stores
+     take P and convert, the others take PAccum.  Both are checked
+     below---*/
+
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+
+enum{ SIMD_LEN = 8 };
+typedef __m512d SimdAcc;
+typedef __mmask8 SimdMask;
+
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+
+enum{ SIMD_LEN = 4 };
+typedef __m256d SimdAcc;
+typedef __m256i SimdMask;
+
+#else
+
+enum{ SIMD_LEN = 1 };
+typedef PAccum SimdAcc;
+typedef int SimdMask;
+
+#endif
+
+/*===========================================================================*/
+/*---Mask selecting the first n lanes, 0 < n <= SIMD_LEN---*/
+
+TARGET_HD static inline SimdMask SimdAcc_mask( int n )
+{
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+  return (SimdMask)( ( 1 << n ) - 1 );
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm256_cmpgt_epi64( _mm256_set1_epi64x( n ),
+                             _mm256_setr_epi64x( 0, 1, 2, 3 ) );
+#else
+  return n > 0;
+#endif
+}
+
+/*===========================================================================*/
+/*---Loads and stores, masked lanes read as zero and are not written---*/
+
+TARGET_HD static inline SimdAcc SimdAcc_load_mask( const PAccum* p,
+                                                   SimdMask mask )
+{
+  Static_Assert( sizeof( PAccum ) == sizeof( double ) );
+
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm512_maskz_loadu_pd( mask, p );
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm256_maskload_pd( p, mask );
+#else
+  return mask ? *p : PAccum_zero();
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void SimdAcc_store_mask( PAccum* p, SimdAcc v,
+                                                 SimdMask mask )
+{
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+  _mm512_mask_storeu_pd( p, mask, v );
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+  _mm256_maskstore_pd( p, mask, v );
+#else
+  if( mask )
+  {
+    *p = v;
+  }
+#endif
+}
+
+/*===========================================================================*/
+/*---Loads and stores from/to storage precision P---*/
+
+#ifdef USE_MIXED_PRECISION
+
+#if defined( __AVX2__ ) && ! defined( __AVX512F__ ) && \
+    ! defined( __CUDA_ARCH__ )
+/*---Narrow the 64-bit lane mask to 32-bit lanes, for float access---*/
+
+static inline __m128i SimdMask_narrow_( SimdMask mask )
+{
+  const __m256i lo_words = _mm256_setr_epi32( 0, 2, 4, 6, 0, 0, 0, 0 );
+  return _mm256_castsi256_si128(
+           _mm256_permutevar8x32_epi32( mask, lo_words ) );
+}
+#endif
+
+TARGET_HD static inline SimdAcc SimdAcc_load_P_mask( const P* p,
+                                                     SimdMask mask )
+{
+  Static_Assert( sizeof( P ) == sizeof( float ) );
+
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm512_cvtps_pd( _mm512_castps512_ps256(
+                          _mm512_maskz_loadu_ps( (__mmask16)mask, p ) ) );
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm256_cvtps_pd( _mm_maskload_ps( p, SimdMask_narrow_( mask ) ) );
+#else
+  return mask ? (PAccum)*p : PAccum_zero();
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void SimdAcc_store_P_mask( P* p, SimdAcc v,
+                                                   SimdMask mask )
+{
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+  _mm512_mask_storeu_ps( p, (__mmask16)mask,
+                         _mm512_castps256_ps512( _mm512_cvtpd_ps( v ) ) );
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+  _mm_maskstore_ps( p, SimdMask_narrow_( mask ), _mm256_cvtpd_ps( v ) );
+#else
+  if( mask )
+  {
+    *p = (P)v;
+  }
+#endif
+}
+
+#else /*---USE_MIXED_PRECISION---*/
+
+/*---P is PAccum: no conversion needed---*/
+
+TARGET_HD static inline SimdAcc SimdAcc_load_P_mask( const P* p,
+                                                     SimdMask mask )
+{
+  Static_Assert( sizeof( P ) == sizeof( PAccum ) );
+
+  return SimdAcc_load_mask( p, mask );
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void SimdAcc_store_P_mask( P* p, SimdAcc v,
+                                                   SimdMask mask )
+{
+  SimdAcc_store_mask( p, v, mask );
+}
+
+#endif /*---USE_MIXED_PRECISION---*/
+
+/*===========================================================================*/
+/*---Strided loads and stores from/to storage precision P---*/
+
+/*---Lane i is at p[i*stride], for the first nlane lanes; the lanes are
+     packed through a small buffer, which for these short vectors is
+     generally no slower than a hardware gather---*/
+
+TARGET_HD static inline SimdAcc SimdAcc_load_P_stride( const P* p,
+                                                       size_t stride,
+                                                       int nlane )
+{
+  PAccum tmp[SIMD_LEN];
+  int lane = 0;
+  for( lane=0; lane<SIMD_LEN; ++lane )
+  {
+    tmp[lane] = lane < nlane ? (PAccum)p[ lane * stride ] : PAccum_zero();
+  }
+  return SimdAcc_load_mask( tmp, SimdAcc_mask( SIMD_LEN ) );
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void SimdAcc_store_P_stride( P* p, size_t stride,
+                                                     SimdAcc v, int nlane )
+{
+  PAccum tmp[SIMD_LEN];
+  int lane = 0;
+  SimdAcc_store_mask( tmp, v, SimdAcc_mask( SIMD_LEN ) );
+  for( lane=0; lane<nlane; ++lane )
+  {
+    p[ lane * stride ] = (P)tmp[lane];
+  }
+}
+
+/*===========================================================================*/
+/*---Arithmetic---*/
+
+TARGET_HD static inline SimdAcc SimdAcc_set1( PAccum a )
+{
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm512_set1_pd( a );
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm256_set1_pd( a );
+#else
+  return a;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline SimdAcc SimdAcc_add( SimdAcc a, SimdAcc b )
+{
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm512_add_pd( a, b );
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm256_add_pd( a, b );
+#else
+  return a + b;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline SimdAcc SimdAcc_sub( SimdAcc a, SimdAcc b )
+{
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm512_sub_pd( a, b );
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm256_sub_pd( a, b );
+#else
+  return a - b;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline SimdAcc SimdAcc_mul( SimdAcc a, SimdAcc b )
+{
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm512_mul_pd( a, b );
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm256_mul_pd( a, b );
+#else
+  return a * b;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline SimdAcc SimdAcc_div( SimdAcc a, SimdAcc b )
+{
+#if defined( __AVX512F__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm512_div_pd( a, b );
+#elif defined( __AVX2__ ) && ! defined( __CUDA_ARCH__ )
+  return _mm256_div_pd( a, b );
+#else
+  return a / b;
+#endif
+}
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_simd_kernels_h_---*/
+
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,373 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   taskgraph.c
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Task graph run by per-thread work-stealing deques.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "env.h"
+#include "taskgraph.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Ints between the ends of successive deques, to avoid false sharing---*/
+
+enum{ DEQUE_ENDS_STRIDE = 16 };
+
+/*===========================================================================*/
+/*---Null object---*/
+
+TaskGraph TaskGraph_null(void)
+{
+  TaskGraph result;
+  memset( (void*)&result, 0, sizeof(TaskGraph) );
+  return result;
+}
+
+/*===========================================================================*/
+/*---Pseudo-constructor for TaskGraph struct---*/
+
+void TaskGraph_create( TaskGraph* taskgraph )
+{
+  *taskgraph = TaskGraph_null();
+}
+
+/*===========================================================================*/
+/*---Pseudo-destructor for TaskGraph struct---*/
+
+void TaskGraph_destroy( TaskGraph* taskgraph )
+{
+  if( taskgraph->ntask_capacity > 0 )
+  {
+    free_host_int( taskgraph->npred );
+    free_host_int( taskgraph->edge_first );
+    free_host_int( taskgraph->pred_mark );
+  }
+  if( taskgraph->nedge_capacity > 0 )
+  {
+    free_host_int( taskgraph->edge_next );
+    free_host_int( taskgraph->edge_task );
+  }
+  if( taskgraph->nkey_capacity > 0 )
+  {
+    free_host_int( taskgraph->key_last );
+  }
+  if( taskgraph->nthread_capacity > 0 )
+  {
+    free_host_int( taskgraph->deque_task );
+    free_host_int( taskgraph->deque_ends );
+#ifdef USE_OPENMP
+    {
+      int thread = 0;
+      for( thread=0; thread<taskgraph->nthread_capacity; ++thread )
+      {
+        omp_destroy_lock( &( taskgraph->deque_lock[thread] ) );
+      }
+      free( taskgraph->deque_lock );
+    }
+#endif
+  }
+
+  *taskgraph = TaskGraph_null();
+}
+
+/*===========================================================================*/
+/*---Start a new graph of ntask tasks with keys 0..nkey-1---*/
+
+void TaskGraph_begin( TaskGraph* taskgraph, int ntask, int nkey )
+{
+  int i = 0;
+
+  Insist( ntask >= 0 && nkey >= 0 );
+
+  if( ntask > taskgraph->ntask_capacity )
+  {
+    if( taskgraph->ntask_capacity > 0 )
+    {
+      free_host_int( taskgraph->npred );
+      free_host_int( taskgraph->edge_first );
+      free_host_int( taskgraph->pred_mark );
+    }
+    taskgraph->ntask_capacity = ntask;
+    taskgraph->npred      = malloc_host_int( ntask );
+    taskgraph->edge_first = malloc_host_int( ntask );
+    taskgraph->pred_mark  = malloc_host_int( ntask );
+  }
+
+  if( nkey > taskgraph->nkey_capacity )
+  {
+    if( taskgraph->nkey_capacity > 0 )
+    {
+      free_host_int( taskgraph->key_last );
+    }
+    taskgraph->nkey_capacity = nkey;
+    taskgraph->key_last = malloc_host_int( nkey );
+  }
+
+  taskgraph->ntask = ntask;
+  taskgraph->nedge = 0;
+
+  for( i=0; i<ntask; ++i )
+  {
+    taskgraph->npred[i]      = 0;
+    taskgraph->edge_first[i] = -1;
+    taskgraph->pred_mark[i]  = -1;
+  }
+  for( i=0; i<nkey; ++i )
+  {
+    taskgraph->key_last[i] = -1;
+  }
+}
+
+/*===========================================================================*/
+/*---Declare that a task touches a key---*/
+
+void TaskGraph_touch( TaskGraph* taskgraph, int task, int key )
+{
+  const int pred = taskgraph->key_last[key];
+
+  Assert( task >= 0 && task < taskgraph->ntask );
+  Assert( key >= 0 && key < taskgraph->nkey_capacity );
+  Assert( pred <= task ? "Tasks must be declared in order" : 0 );
+
+  /*---Add edge from the last toucher, once per pair of tasks---*/
+
+  if( pred >= 0 && pred != task && taskgraph->pred_mark[pred] != task )
+  {
+    if( taskgraph->nedge == taskgraph->nedge_capacity )
+    {
+      const int nedge_capacity = taskgraph->nedge_capacity > 0 ?
+                                 2 * taskgraph->nedge_capacity :
+                                 4 * taskgraph->ntask_capacity;
+      int* const edge_next = malloc_host_int( nedge_capacity );
+      int* const edge_task = malloc_host_int( nedge_capacity );
+      if( taskgraph->nedge_capacity > 0 )
+      {
+        memcpy( edge_next, taskgraph->edge_next,
+                taskgraph->nedge * sizeof(int) );
+        memcpy( edge_task, taskgraph->edge_task,
+                taskgraph->nedge * sizeof(int) );
+        free_host_int( taskgraph->edge_next );
+        free_host_int( taskgraph->edge_task );
+      }
+      taskgraph->edge_next = edge_next;
+      taskgraph->edge_task = edge_task;
+      taskgraph->nedge_capacity = nedge_capacity;
+    }
+
+    taskgraph->edge_task[taskgraph->nedge] = task;
+    taskgraph->edge_next[taskgraph->nedge] = taskgraph->edge_first[pred];
+    taskgraph->edge_first[pred] = taskgraph->nedge;
+    taskgraph->nedge++;
+
+    taskgraph->npred[task]++;
+    taskgraph->pred_mark[pred] = task;
+  }
+
+  taskgraph->key_last[key] = task;
+}
+
+/*===========================================================================*/
+/*---Deque operations; each task is pushed once per run, so a deque
+     holds at most ntask entries and never wraps---*/
+
+static void TaskGraph_push_( TaskGraph* taskgraph, int thread, int task )
+{
+  int* const ends = &( taskgraph->deque_ends[ thread * DEQUE_ENDS_STRIDE ] );
+  int* const deque = &( taskgraph->deque_task[ thread *
+                                             taskgraph->ndeque_capacity ] );
+#ifdef USE_OPENMP
+  omp_set_lock( &( taskgraph->deque_lock[thread] ) );
+#endif
+  deque[ ends[1]++ ] = task;
+#ifdef USE_OPENMP
+  omp_unset_lock( &( taskgraph->deque_lock[thread] ) );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+static int TaskGraph_pop_( TaskGraph* taskgraph, int thread, Bool_t is_steal )
+{
+  int* const ends = &( taskgraph->deque_ends[ thread * DEQUE_ENDS_STRIDE ] );
+  int* const deque = &( taskgraph->deque_task[ thread *
+                                             taskgraph->ndeque_capacity ] );
+  int task = -1;
+#ifdef USE_OPENMP
+  omp_set_lock( &( taskgraph->deque_lock[thread] ) );
+#endif
+  if( ends[1] > ends[0] )
+  {
+    /*---Owner takes the newest task, thief the oldest---*/
+    task = is_steal ? deque[ ends[0]++ ] : deque[ --ends[1] ];
+  }
+#ifdef USE_OPENMP
+  omp_unset_lock( &( taskgraph->deque_lock[thread] ) );
+#endif
+  return task;
+}
+
+/*===========================================================================*/
+/*---Run all tasks, on the OpenMP threads if any---*/
+
+void TaskGraph_run( TaskGraph* taskgraph, TaskGraph_task_t body,
+                    void* context )
+{
+#ifdef USE_OPENMP
+  const int nthread = omp_get_max_threads();
+#else
+  const int nthread = 1;
+#endif
+  const int ntask = taskgraph->ntask;
+
+  int task = 0;
+  int thread = 0;
+
+  if( ntask == 0 )
+  {
+    return;
+  }
+
+  /*---Allocate deques---*/
+
+  if( nthread > taskgraph->nthread_capacity ||
+      ntask > taskgraph->ndeque_capacity )
+  {
+    const int nthread_old = taskgraph->nthread_capacity;
+    if( nthread_old > 0 )
+    {
+      free_host_int( taskgraph->deque_task );
+      free_host_int( taskgraph->deque_ends );
+    }
+    taskgraph->nthread_capacity = nthread > nthread_old ? nthread
+                                                        : nthread_old;
+    taskgraph->ndeque_capacity = taskgraph->ntask_capacity;
+    taskgraph->deque_task = malloc_host_int( taskgraph->nthread_capacity *
+                                     (size_t)taskgraph->ndeque_capacity );
+    taskgraph->deque_ends = malloc_host_int( taskgraph->nthread_capacity *
+                                     (size_t)DEQUE_ENDS_STRIDE );
+#ifdef USE_OPENMP
+    if( taskgraph->nthread_capacity > nthread_old )
+    {
+      omp_lock_t* const deque_lock = (omp_lock_t*)malloc(
+                     taskgraph->nthread_capacity * sizeof(omp_lock_t) );
+      Insist( deque_lock );
+      for( thread=0; thread<taskgraph->nthread_capacity; ++thread )
+      {
+        if( thread < nthread_old )
+        {
+          omp_destroy_lock( &( taskgraph->deque_lock[thread] ) );
+        }
+        omp_init_lock( &( deque_lock[thread] ) );
+      }
+      if( nthread_old > 0 )
+      {
+        free( taskgraph->deque_lock );
+      }
+      taskgraph->deque_lock = deque_lock;
+    }
+#endif
+  }
+
+  /*---Deal the initially ready tasks round robin---*/
+
+  for( thread=0; thread<nthread; ++thread )
+  {
+    taskgraph->deque_ends[ thread * DEQUE_ENDS_STRIDE + 0 ] = 0;
+    taskgraph->deque_ends[ thread * DEQUE_ENDS_STRIDE + 1 ] = 0;
+  }
+
+  thread = 0;
+  for( task=0; task<ntask; ++task )
+  {
+    if( taskgraph->npred[task] == 0 )
+    {
+      TaskGraph_push_( taskgraph, thread, task );
+      thread = ( thread + 1 ) % nthread;
+    }
+  }
+
+  taskgraph->ntask_done = 0;
+
+  /*---Execute---*/
+
+#ifdef USE_OPENMP
+#pragma omp parallel num_threads( nthread )
+#endif
+  {
+    const int thread_this = Env_omp_thread();
+
+    while( Bool_true )
+    {
+      int task_this = TaskGraph_pop_( taskgraph, thread_this, Bool_false );
+
+      /*---Own deque empty: steal, trying the other threads in turn---*/
+
+      int offset = 0;
+      for( offset=1; offset<nthread && task_this<0; ++offset )
+      {
+        task_this = TaskGraph_pop_( taskgraph, ( thread_this + offset )
+                                               % nthread, Bool_true );
+      }
+
+      if( task_this >= 0 )
+      {
+        int edge = 0;
+
+        body( context, task_this );
+
+        /*---Release successors whose predecessors are now all done---*/
+
+        for( edge=taskgraph->edge_first[task_this]; edge>=0;
+             edge=taskgraph->edge_next[edge] )
+        {
+          const int succ = taskgraph->edge_task[edge];
+          int npred = 0;
+#ifdef USE_OPENMP
+#pragma omp atomic capture
+#endif
+          npred = --taskgraph->npred[succ];
+          if( npred == 0 )
+          {
+            TaskGraph_push_( taskgraph, thread_this, succ );
+          }
+        }
+
+#ifdef USE_OPENMP
+#pragma omp atomic
+#endif
+        taskgraph->ntask_done++;
+      }
+      else
+      {
+        int ntask_done = 0;
+#ifdef USE_OPENMP
+#pragma omp atomic read
+#endif
+        ntask_done = taskgraph->ntask_done;
+        if( ntask_done == ntask )
+        {
+          break;
+        }
+      }
+    } /*---while---*/
+  } /*---omp parallel---*/
+}
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+/*---------------------------------------------------------------------------*/
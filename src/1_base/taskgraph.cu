@@ -0,0 +1 @@
+taskgraph.c
\ No newline at end of file
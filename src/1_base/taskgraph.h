@@ -0,0 +1,113 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   taskgraph.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Task graph run by per-thread work-stealing deques, header.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+/*=============================================================================
+
+A TaskGraph holds a set of tasks numbered 0..ntask-1 in program order.
+Dependencies are inferred, as for OpenMP depend(inout:) clauses, from the
+integer keys each task declares it touches: a task depends on the last
+earlier task that touched any of the same keys.  Tasks must be declared
+in increasing order.
+
+At run time each thread owns a deque.  A thread takes work from the
+bottom of its own deque, and when that is empty steals from the top of
+another thread's.  Each task carries an atomic count of unfinished
+predecessors; the thread that finishes the last predecessor pushes the
+task onto its own deque.  There are no barriers other than at the end.
+
+=============================================================================*/
+
+#ifndef _taskgraph_h_
+#define _taskgraph_h_
+
+#include "env.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Task body: called once per task with the task number---*/
+
+typedef void (*TaskGraph_task_t)( void* context, int task );
+
+/*===========================================================================*/
+/*---Struct for task graph---*/
+
+typedef struct
+{
+  /*---Tasks and dependency edges; edges are singly linked lists---*/
+  int   ntask;
+  int   ntask_capacity;
+  int*  npred;
+  int*  edge_first;
+  int*  pred_mark;
+  int   nedge;
+  int   nedge_capacity;
+  int*  edge_next;
+  int*  edge_task;
+
+  /*---Last task to touch each key---*/
+  int   nkey_capacity;
+  int*  key_last;
+
+  /*---Per-thread deques---*/
+  int   nthread_capacity;
+  int   ndeque_capacity;
+  int*  deque_task;
+  int*  deque_ends;
+#ifdef USE_OPENMP
+  omp_lock_t* deque_lock;
+#endif
+
+  int   ntask_done;
+} TaskGraph;
+
+/*===========================================================================*/
+/*---Null object---*/
+
+TaskGraph TaskGraph_null(void);
+
+/*===========================================================================*/
+/*---Pseudo-constructor for TaskGraph struct---*/
+
+void TaskGraph_create( TaskGraph* taskgraph );
+
+/*===========================================================================*/
+/*---Pseudo-destructor for TaskGraph struct---*/
+
+void TaskGraph_destroy( TaskGraph* taskgraph );
+
+/*===========================================================================*/
+/*---Start a new graph of ntask tasks with keys 0..nkey-1---*/
+
+void TaskGraph_begin( TaskGraph* taskgraph, int ntask, int nkey );
+
+/*===========================================================================*/
+/*---Declare that a task touches a key---*/
+
+void TaskGraph_touch( TaskGraph* taskgraph, int task, int key );
+
+/*===========================================================================*/
+/*---Run all tasks, on the OpenMP threads if any---*/
+
+void TaskGraph_run( TaskGraph* taskgraph, TaskGraph_task_t body,
+                    void* context );
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_taskgraph_h_---*/
+
+/*---------------------------------------------------------------------------*/
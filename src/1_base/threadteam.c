@@ -0,0 +1,503 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   threadteam.c
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Persistent team of host threads.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef USE_OPENMP
+#include <sched.h>
+#endif
+
+#include "env.h"
+#include "threadteam.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Tuning constants---*/
+
+enum{ THREAD_STRIDE = 16 };         /*---Ints between per-thread values---*/
+enum{ TIMER_STRIDE = 8 };           /*---Timers between per-thread values---*/
+enum{ NPOLL_SPIN  = 64 };           /*---Polls before yielding the core---*/
+enum{ NPOLL_SLEEP = 4096 };         /*---Polls before sleeping, idle---*/
+
+/*===========================================================================*/
+/*---Info passed to a worker thread---*/
+
+typedef struct
+{
+  ThreadTeam* team;
+  int         thread;
+} ThreadTeamWorkerInfo;
+
+/*===========================================================================*/
+/*---Null object---*/
+
+ThreadTeam ThreadTeam_null(void)
+{
+  ThreadTeam result;
+  memset( (void*)&result, 0, sizeof(ThreadTeam) );
+  return result;
+}
+
+/*===========================================================================*/
+/*---Wait a little while polling a shared value---*/
+
+static void ThreadTeam_poll_wait_( int npoll )
+{
+#ifdef USE_OPENMP
+  if( npoll > NPOLL_SPIN )
+  {
+    /*---Give up the core, e.g. when threads outnumber cores---*/
+    sched_yield();
+  }
+#endif
+}
+
+/*===========================================================================*/
+/*---Add the time since time_start to the idle time of a thread---*/
+
+static void ThreadTeam_idle_add_( const ThreadTeam* team, int thread,
+                                  Timer time_start )
+{
+  team->idle[ thread * TIMER_STRIDE ] += Env_get_time( NULL ) - time_start;
+}
+
+/*===========================================================================*/
+/*---Barrier among the threads of a run---*/
+
+void ThreadTeam_barrier( ThreadTeam* team, int thread )
+{
+#ifdef USE_OPENMP
+  if( team->nthread > 1 )
+  {
+    int* const thread_sense = &( team->thread_sense[ thread *
+                                                     THREAD_STRIDE ] );
+    const int sense = ! *thread_sense;
+    *thread_sense = sense;
+
+    if( __sync_sub_and_fetch( &( team->barrier_count ), 1 ) == 0 )
+    {
+      /*---Last to arrive: reset the count, then release the others---*/
+      team->barrier_count = team->nthread;
+      __sync_synchronize();
+      team->barrier_sense = sense;
+    }
+    else
+    {
+      const Timer time_start = Env_get_time( NULL );
+      int npoll = 0;
+      while( team->barrier_sense != sense )
+      {
+        ThreadTeam_poll_wait_( ++npoll );
+      }
+      ThreadTeam_idle_add_( team, thread, time_start );
+    }
+    __sync_synchronize();
+  }
+#endif
+}
+
+/*===========================================================================*/
+/*---Flag of a thread; may be read without waiting by its owner---*/
+
+int ThreadTeam_flag( const ThreadTeam* team, int thread )
+{
+  Assert( thread >= 0 && thread < team->nthread );
+  return team->flags[ thread * THREAD_STRIDE ];
+}
+
+/*===========================================================================*/
+/*---Set the flag of the calling thread, releasing its prior writes---*/
+
+void ThreadTeam_flag_post( ThreadTeam* team, int thread, int value )
+{
+  volatile int* const flag = &( team->flags[ thread * THREAD_STRIDE ] );
+
+  Assert( thread >= 0 && thread < team->nthread );
+
+#ifdef USE_OPENMP
+  __atomic_store_n( flag, value, __ATOMIC_RELEASE );
+#else
+  *flag = value;
+#endif
+}
+
+/*===========================================================================*/
+/*---Calling thread thread_this: wait until the flag of a thread is at
+     least value---*/
+
+void ThreadTeam_flag_wait( const ThreadTeam* team, int thread_this,
+                           int thread, int value )
+{
+  volatile int* const flag = &( team->flags[ thread * THREAD_STRIDE ] );
+
+  Assert( thread_this >= 0 && thread_this < team->nthread );
+  Assert( thread >= 0 && thread < team->nthread );
+
+#ifdef USE_OPENMP
+  if( __atomic_load_n( flag, __ATOMIC_ACQUIRE ) < value )
+  {
+    const Timer time_start = Env_get_time( NULL );
+    int npoll = 0;
+    while( __atomic_load_n( flag, __ATOMIC_ACQUIRE ) < value )
+    {
+      ThreadTeam_poll_wait_( ++npoll );
+    }
+    ThreadTeam_idle_add_( team, thread_this, time_start );
+  }
+#else
+  Assert( *flag >= value ? "Flag wait would not return." : 0 );
+#endif
+}
+
+/*===========================================================================*/
+/*---Take the next value of a counter in [begin,end), or -1 if none---*/
+
+int ThreadTeam_counter_take( ThreadTeam* team, int counter, int begin,
+                             int end )
+{
+  volatile int* const count = &( team->counters[ counter * THREAD_STRIDE ] );
+
+  Assert( counter >= 0 && counter < team->nthread );
+
+  while( Bool_true )
+  {
+    /*---Values below begin are skipped, values are never given twice---*/
+
+    const int count_this = *count;
+    const int result = count_this > begin ? count_this : begin;
+
+    if( result >= end )
+    {
+      return -1;
+    }
+#ifdef USE_OPENMP
+    if( __sync_bool_compare_and_swap( count, count_this, result + 1 ) )
+    {
+      return result;
+    }
+#else
+    *count = result + 1;
+    return result;
+#endif
+  }
+}
+
+/*===========================================================================*/
+/*---Time a thread has spent waiting since the last reset---*/
+
+Timer ThreadTeam_idle( const ThreadTeam* team, int thread )
+{
+  Assert( thread >= 0 && thread < team->nthread );
+  return team->idle[ thread * TIMER_STRIDE ];
+}
+
+/*---------------------------------------------------------------------------*/
+
+void ThreadTeam_idle_reset( ThreadTeam* team )
+{
+  int thread = 0;
+  for( thread=0; thread<team->nthread; ++thread )
+  {
+    team->idle[ thread * TIMER_STRIDE ] = 0;
+  }
+}
+
+/*===========================================================================*/
+/*---Pin the calling thread to a cpu---*/
+
+static void ThreadTeam_pin_( int cpu )
+{
+#if defined( USE_OPENMP ) && defined( __linux__ )
+  cpu_set_t mask;
+  CPU_ZERO( &mask );
+  CPU_SET( cpu, &mask );
+  Insist( sched_setaffinity( 0, sizeof( mask ), &mask ) == 0 ?
+          "Failure to set thread affinity." : 0 );
+#endif
+}
+
+/*===========================================================================*/
+/*---Worker thread: wait for the doorbell, run, repeat---*/
+
+#ifdef USE_OPENMP
+static void* ThreadTeam_worker_( void* arg )
+{
+  const ThreadTeamWorkerInfo* const info = (const ThreadTeamWorkerInfo*)arg;
+  ThreadTeam* const team = info->team;
+  const int thread = info->thread;
+
+  int generation_seen = 0;
+
+  if( team->cpu )
+  {
+    ThreadTeam_pin_( team->cpu[ thread ] );
+  }
+
+  while( Bool_true )
+  {
+    /*---Poll for a while, then sleep until rung---*/
+
+    int npoll = 0;
+    while( team->generation == generation_seen && npoll < NPOLL_SLEEP )
+    {
+      ThreadTeam_poll_wait_( ++npoll );
+    }
+    if( team->generation == generation_seen )
+    {
+      pthread_mutex_lock( &( team->mutex ) );
+      while( team->generation == generation_seen )
+      {
+        pthread_cond_wait( &( team->doorbell ), &( team->mutex ) );
+      }
+      pthread_mutex_unlock( &( team->mutex ) );
+    }
+    __sync_synchronize();
+    generation_seen = team->generation;
+
+    if( team->is_exiting )
+    {
+      break;
+    }
+
+    team->body( team->context, thread );
+
+    ThreadTeam_barrier( team, thread );
+  }
+
+  return NULL;
+}
+#endif
+
+/*===========================================================================*/
+/*---Ring the doorbell---*/
+
+#ifdef USE_OPENMP
+static void ThreadTeam_ring_( ThreadTeam* team )
+{
+  __sync_synchronize();
+  pthread_mutex_lock( &( team->mutex ) );
+  team->generation++;
+  pthread_cond_broadcast( &( team->doorbell ) );
+  pthread_mutex_unlock( &( team->mutex ) );
+}
+#endif
+
+/*===========================================================================*/
+/*---Pseudo-constructor for ThreadTeam struct---*/
+
+void ThreadTeam_create( ThreadTeam* team, int nthread,
+                        const int* thread_cpu )
+{
+  Insist( nthread > 0 ? "Invalid thread count supplied." : 0 );
+
+  *team = ThreadTeam_null();
+
+#ifdef USE_OPENMP
+  team->nthread = nthread;
+#else
+  Insist( nthread == 1 ? "Thread team requires an OpenMP build." : 0 );
+  team->nthread = 1;
+#endif
+
+  team->barrier_count = team->nthread;
+  team->thread_sense = malloc_host_int( team->nthread * THREAD_STRIDE );
+  team->flags        = malloc_host_int( team->nthread * THREAD_STRIDE );
+  team->counters     = malloc_host_int( team->nthread * THREAD_STRIDE );
+  team->idle = (Timer*)malloc( team->nthread * TIMER_STRIDE * sizeof(Timer) );
+  Insist( team->idle );
+  {
+    int i = 0;
+    for( i=0; i<team->nthread * THREAD_STRIDE; ++i )
+    {
+      team->thread_sense[i] = 0;
+      team->flags[i]        = 0;
+      team->counters[i]     = 0;
+    }
+  }
+  ThreadTeam_idle_reset( team );
+
+  if( thread_cpu )
+  {
+    int thread = 0;
+    team->cpu = (int*)malloc( team->nthread * sizeof(int) );
+    Insist( team->cpu );
+    for( thread=0; thread<team->nthread; ++thread )
+    {
+      team->cpu[thread] = thread_cpu[thread];
+    }
+  }
+
+#ifdef USE_OPENMP
+  if( team->nthread > 1 )
+  {
+    ThreadTeamWorkerInfo* const info = (ThreadTeamWorkerInfo*)malloc(
+                            team->nthread * sizeof(ThreadTeamWorkerInfo) );
+    int thread = 0;
+
+    team->workers = (pthread_t*)malloc( team->nthread * sizeof(pthread_t) );
+    Insist( info && team->workers );
+    team->worker_info = (void*)info;
+
+    pthread_mutex_init( &( team->mutex ), NULL );
+    pthread_cond_init( &( team->doorbell ), NULL );
+
+    /*---Thread 0 is the caller---*/
+
+    for( thread=1; thread<team->nthread; ++thread )
+    {
+      info[thread].team = team;
+      info[thread].thread = thread;
+      Insist( pthread_create( &( team->workers[thread] ), NULL,
+                              ThreadTeam_worker_, &( info[thread] ) ) == 0
+              ? "Failure to create thread." : 0 );
+    }
+  }
+#endif
+
+  /*---Pin the caller last, so that the workers are not started on its
+       cpu; keep its former cpus to restore---*/
+
+#if defined( USE_OPENMP ) && defined( __linux__ )
+  if( team->cpu )
+  {
+    cpu_set_t* const caller_cpus = (cpu_set_t*)malloc( sizeof(cpu_set_t) );
+    Insist( caller_cpus );
+    CPU_ZERO( caller_cpus );
+    Insist( sched_getaffinity( 0, sizeof(cpu_set_t), caller_cpus ) == 0 ?
+            "Failure to get thread affinity." : 0 );
+    team->caller_cpus = (void*)caller_cpus;
+    ThreadTeam_pin_( team->cpu[0] );
+  }
+#endif
+}
+
+/*===========================================================================*/
+/*---Pseudo-destructor for ThreadTeam struct---*/
+
+void ThreadTeam_destroy( ThreadTeam* team )
+{
+#ifdef USE_OPENMP
+  if( team->nthread > 1 )
+  {
+    int thread = 0;
+
+    team->is_exiting = Bool_true;
+    ThreadTeam_ring_( team );
+
+    for( thread=1; thread<team->nthread; ++thread )
+    {
+      pthread_join( team->workers[thread], NULL );
+    }
+
+    pthread_cond_destroy( &( team->doorbell ) );
+    pthread_mutex_destroy( &( team->mutex ) );
+    free( team->workers );
+    free( team->worker_info );
+  }
+#endif
+
+  if( team->thread_sense )
+  {
+    free_host_int( team->thread_sense );
+  }
+  if( team->flags )
+  {
+    free_host_int( (int*)team->flags );
+  }
+  if( team->counters )
+  {
+    free_host_int( (int*)team->counters );
+  }
+  if( team->idle )
+  {
+    free( team->idle );
+  }
+  if( team->caller_cpus )
+  {
+#if defined( USE_OPENMP ) && defined( __linux__ )
+    sched_setaffinity( 0, sizeof(cpu_set_t), (cpu_set_t*)team->caller_cpus );
+#endif
+    free( team->caller_cpus );
+  }
+  if( team->cpu )
+  {
+    free( team->cpu );
+  }
+
+  *team = ThreadTeam_null();
+}
+
+/*===========================================================================*/
+/*---Accessor: number of threads---*/
+
+int ThreadTeam_nthread( const ThreadTeam* team )
+{
+  return team->nthread;
+}
+
+/*===========================================================================*/
+/*---Accessor: cpu a thread is pinned to, -1 if not pinned---*/
+
+int ThreadTeam_cpu( const ThreadTeam* team, int thread )
+{
+  Assert( thread >= 0 && thread < team->nthread );
+  return team->cpu ? team->cpu[ thread ] : -1;
+}
+
+/*===========================================================================*/
+/*---Run body on every thread of the team and wait for all to finish---*/
+
+void ThreadTeam_run( ThreadTeam* team, ThreadTeam_body_t body,
+                     void* context )
+{
+  Assert( team->nthread > 0 );
+
+  team->body    = body;
+  team->context = context;
+
+  {
+    int thread = 0;
+    for( thread=0; thread<team->nthread; ++thread )
+    {
+      team->flags[ thread * THREAD_STRIDE ]    = 0;
+      team->counters[ thread * THREAD_STRIDE ] = 0;
+    }
+  }
+
+#ifdef USE_OPENMP
+  if( team->nthread > 1 )
+  {
+    ThreadTeam_ring_( team );
+  }
+#endif
+
+  body( context, 0 );
+
+  ThreadTeam_barrier( team, 0 );
+}
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1 @@
+threadteam.c
\ No newline at end of file
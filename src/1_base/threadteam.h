@@ -0,0 +1,183 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   threadteam.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Persistent team of host threads, header.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+/*=============================================================================
+
+A ThreadTeam starts its worker threads once, when created, and keeps them
+until destroyed, so that repeated parallel work avoids a fork/join per
+call.  The calling thread is thread 0 of the team.
+
+ThreadTeam_run rings a doorbell, a generation count behind a mutex and
+condition variable (futex based on Linux).  Idle workers poll the count
+for a while before sleeping on the condition variable, so a quick
+succession of runs costs no system calls.  Within a run, and at its end,
+threads meet at a sense-reversing barrier.
+
+Each thread also owns a flag, an int that it alone sets and that others
+may wait on, for point-to-point synchronization within a run.  Flags are
+zeroed at the start of each run; a wait returns once the flag reaches a
+given value.
+
+For dynamic scheduling the team also has nthread counters, likewise
+zeroed at the start of each run, from which any thread may take the
+next value in a given range.
+
+The time each thread spends waiting at barriers and on flags is summed,
+as a measure of load imbalance.
+
+Threads may be pinned, each to one cpu, with sched_setaffinity.  The
+calling thread is then pinned for the life of the team and released to
+its former cpus when the team is destroyed.
+
+Worker threads are only started in OpenMP builds, whose runtime already
+links the thread library; otherwise the team has one thread.
+
+=============================================================================*/
+
+#ifndef _threadteam_h_
+#define _threadteam_h_
+
+#ifdef USE_OPENMP
+#include <pthread.h>
+#endif
+
+#include "env.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Work done by each thread of a run: called with the thread number---*/
+
+typedef void (*ThreadTeam_body_t)( void* context, int thread );
+
+/*===========================================================================*/
+/*---Struct for thread team---*/
+
+typedef struct
+{
+  int                nthread;
+
+  /*---Current run---*/
+  ThreadTeam_body_t  body;
+  void*              context;
+
+  /*---Doorbell---*/
+  volatile int       generation;
+  volatile int       is_exiting;
+
+  /*---Barrier; per-thread senses are padded to separate cache lines---*/
+  volatile int       barrier_count;
+  volatile int       barrier_sense;
+  int*               thread_sense;
+
+  /*---Per-thread flags, padded likewise---*/
+  volatile int*      flags;
+
+  /*---Counters for dynamic scheduling, padded likewise---*/
+  volatile int*      counters;
+
+  /*---Per-thread time spent waiting, padded likewise---*/
+  Timer*             idle;
+
+  /*---Cpu each thread is pinned to, or NULL if not pinned---*/
+  int*               cpu;
+  void*              caller_cpus;
+
+#ifdef USE_OPENMP
+  pthread_t*         workers;
+  void*              worker_info;
+  pthread_mutex_t    mutex;
+  pthread_cond_t     doorbell;
+#endif
+} ThreadTeam;
+
+/*===========================================================================*/
+/*---Null object---*/
+
+ThreadTeam ThreadTeam_null(void);
+
+/*===========================================================================*/
+/*---Pseudo-constructor for ThreadTeam struct; the struct must not be
+     moved until destroyed.  thread_cpu gives the cpu for each thread to
+     be pinned to, or is NULL to leave placement to the system---*/
+
+void ThreadTeam_create( ThreadTeam* team, int nthread,
+                        const int* thread_cpu );
+
+/*===========================================================================*/
+/*---Pseudo-destructor for ThreadTeam struct---*/
+
+void ThreadTeam_destroy( ThreadTeam* team );
+
+/*===========================================================================*/
+/*---Accessor: number of threads---*/
+
+int ThreadTeam_nthread( const ThreadTeam* team );
+
+/*===========================================================================*/
+/*---Accessor: cpu a thread is pinned to, -1 if not pinned---*/
+
+int ThreadTeam_cpu( const ThreadTeam* team, int thread );
+
+/*===========================================================================*/
+/*---Run body on every thread of the team and wait for all to finish---*/
+
+void ThreadTeam_run( ThreadTeam* team, ThreadTeam_body_t body,
+                     void* context );
+
+/*===========================================================================*/
+/*---Barrier among the threads of a run---*/
+
+void ThreadTeam_barrier( ThreadTeam* team, int thread );
+
+/*===========================================================================*/
+/*---Flag of a thread; may be read without waiting by its owner---*/
+
+int ThreadTeam_flag( const ThreadTeam* team, int thread );
+
+/*===========================================================================*/
+/*---Set the flag of the calling thread, releasing its prior writes---*/
+
+void ThreadTeam_flag_post( ThreadTeam* team, int thread, int value );
+
+/*===========================================================================*/
+/*---Calling thread thread_this: wait until the flag of a thread is at
+     least value---*/
+
+void ThreadTeam_flag_wait( const ThreadTeam* team, int thread_this,
+                           int thread, int value );
+
+/*===========================================================================*/
+/*---Take the next value of a counter in [begin,end), or -1 if none---*/
+
+int ThreadTeam_counter_take( ThreadTeam* team, int counter, int begin,
+                             int end );
+
+/*===========================================================================*/
+/*---Time a thread has spent waiting since the last reset---*/
+
+Timer ThreadTeam_idle( const ThreadTeam* team, int thread );
+
+/*---------------------------------------------------------------------------*/
+
+void ThreadTeam_idle_reset( ThreadTeam* team );
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_threadteam_h_---*/
+
+/*---------------------------------------------------------------------------*/
@@ -40,14 +40,34 @@ typedef int Bool_t;
 
 enum{ Bool_true = (1==1), Bool_false = (0==1) };
 
-/*---Default floating point type---*/
+/*---Default floating point type, used for storage of state and faces---*/
 
+#ifdef USE_MIXED_PRECISION
+typedef float P;
+enum{ P_IS_DOUBLE = Bool_false };
+#else
 typedef double P;
 enum{ P_IS_DOUBLE = Bool_true };
+#endif
 
 TARGET_HD static inline P P_zero() { return (P)0; }
 TARGET_HD static inline P P_one()  { return (P)1; }
 
+/*---Floating point type for accumulations and the cell solve---*/
+
+/*---NOTE: with USE_MIXED_PRECISION, values are stored as float to halve
+     memory and message traffic, but all arithmetic is done in double---*/
+
+typedef double PAccum;
+
+TARGET_HD static inline PAccum PAccum_zero() { return (PAccum)0; }
+
+#ifdef USE_MIXED_PRECISION
+  enum{ IS_USING_MIXED_PRECISION = 1 };
+#else
+  enum{ IS_USING_MIXED_PRECISION = 0 };
+#endif
+
 /*===========================================================================*/
 
 #ifdef __cplusplus
@@ -24,6 +24,97 @@ extern "C"
 {
 #endif
 
+/*===========================================================================*/
+/*---State vector layout policy---*/
+
+/*=============================================================================
+
+The order of the state vector axes is selected at build time:
+
+  (default)                       im, iu, ix, iy, ie, iz
+  -DUSE_STATE_LAYOUT_ENERGY_INNER im, iu, ie, ix, iy, iz
+  -DUSE_STATE_LAYOUT_TILED_XY     im, iu, (ix, iy in tile), (tile), ie, iz
+
+For the tiled layout each z-plane of each energy group is cut into
+STATE_TILE_X x STATE_TILE_Y tiles of cells, stored tile after tile;
+edge tiles are narrower, so there is no padding.
+
+All layouts keep two invariants the sweepers rely on:
+- the NM x NU values of one cell and energy group are contiguous,
+  im fastest;
+- iz is the slowest-varying axis, so a block of z-planes is a contiguous
+  range and can be transferred or offset by a fixed stride.
+
+=============================================================================*/
+
+enum{ STATE_LAYOUT_CELL_INNER   = 0 };
+enum{ STATE_LAYOUT_ENERGY_INNER = 1 };
+enum{ STATE_LAYOUT_TILED_XY     = 2 };
+
+#if defined( USE_STATE_LAYOUT_ENERGY_INNER )
+enum{ STATE_LAYOUT = STATE_LAYOUT_ENERGY_INNER };
+#elif defined( USE_STATE_LAYOUT_TILED_XY )
+enum{ STATE_LAYOUT = STATE_LAYOUT_TILED_XY };
+#else
+enum{ STATE_LAYOUT = STATE_LAYOUT_CELL_INNER };
+#endif
+
+#ifndef STATE_TILE_X
+#define STATE_TILE_X 4
+#endif
+#ifndef STATE_TILE_Y
+#define STATE_TILE_Y 4
+#endif
+
+/*===========================================================================*/
+/*---Index of (ix, iy, ie) within a z-plane of the state, per layout---*/
+
+/*---Result is in [ 0, ncell_x * ncell_y * ne ), one-to-one---*/
+
+TARGET_HD static inline size_t ind_state_xye_(
+    const int dims_ncell_x,
+    const int dims_ncell_y,
+    const int dims_ne,
+    const int ix,
+    const int iy,
+    const int ie )
+{
+#if defined( USE_STATE_LAYOUT_ENERGY_INNER )
+
+  return  ie + dims_ne      * (
+          ix + dims_ncell_x * (
+          iy + dims_ncell_y * (
+          0 )));
+
+#elif defined( USE_STATE_LAYOUT_TILED_XY )
+
+  /*---Tile coordinates and extents; edge tiles may be narrower---*/
+
+  const int tile_x   = ix / STATE_TILE_X;
+  const int tile_y   = iy / STATE_TILE_Y;
+  const int ix_base  = tile_x * STATE_TILE_X;
+  const int iy_base  = tile_y * STATE_TILE_Y;
+  const int nx_tile  = imin( STATE_TILE_X, dims_ncell_x - ix_base );
+  const int ny_tile  = imin( STATE_TILE_Y, dims_ncell_y - iy_base );
+
+  /*---Cells before this tile: full rows of tiles, then tiles in this row---*/
+
+  const size_t ixy_tile = ( (size_t)iy_base ) * dims_ncell_x
+                        + ( (size_t)ix_base ) * ny_tile;
+
+  return  ixy_tile + ( ix - ix_base ) + nx_tile * ( iy - iy_base )
+          + ( (size_t)dims_ncell_x ) * dims_ncell_y * ie;
+
+#else
+
+  return  ix + dims_ncell_x * (
+          iy + dims_ncell_y * (
+          ie + dims_ne      * (
+          0 )));
+
+#endif
+}
+
 /*===========================================================================*/
 /*---Multidimensional indexing function---*/
 
@@ -51,11 +142,10 @@ TARGET_HD static inline size_t ind_state_flat(
 
   return  im + dims_nm      * (
           iu + nu           * (
-          ix + dims_ncell_x * (
-          iy + dims_ncell_y * (
-          ie + dims_ne      * (
+          ind_state_xye_( dims_ncell_x, dims_ncell_y, dims_ne, ix, iy, ie ) +
+            ( (size_t)dims_ncell_x ) * dims_ncell_y * dims_ne * (
           iz + dims_ncell_z * ( /*---NOTE: This axis MUST be slowest-varying---*/
-          0 ))))));
+          0 ))));
 }
 
 /*===========================================================================*/
@@ -79,13 +169,9 @@ TARGET_HD static inline size_t ind_state(
   Assert( im >= 0 && im < dims.nm );
   Assert( iu >= 0 && iu < nu );
 
-  return  im + dims.nm      * (
-          iu + nu           * (
-          ix + dims.ncell_x * (
-          iy + dims.ncell_y * (
-          ie + dims.ne      * (
-          iz + dims.ncell_z * ( /*---NOTE: This axis MUST be slowest-varying---*/
-          0 ))))));
+  return ind_state_flat( dims.ncell_x, dims.ncell_y, dims.ncell_z,
+                         dims.ne, dims.nm, nu,
+                         ix, iy, iz, ie, im, iu );
 }
 
 /*===========================================================================*/
@@ -207,13 +293,13 @@ TARGET_HD static inline const P* const_ref_state(
 /*===========================================================================*/
 /*---Multidimensional array accessor function---*/
 
-TARGET_HD static inline P* ref_vilocal(
-    P* const __restrict__  v,
-    const Dimensions       dims,
-    const int              nu,
-    const int              immax,
-    const int              im,
-    const int              iu )
+TARGET_HD static inline PAccum* ref_vilocal(
+    PAccum* const __restrict__  v,
+    const Dimensions            dims,
+    const int                   nu,
+    const int                   immax,
+    const int                   im,
+    const int                   iu )
 {
   Assert( v );
   Assert( nu > 0 );
@@ -228,13 +314,13 @@ TARGET_HD static inline P* ref_vilocal(
 /*===========================================================================*/
 /*---Multidimensional array accessor function---*/
 
-TARGET_HD static inline const P* const_ref_vilocal(
-    const P* const __restrict__  v,
-    const Dimensions             dims,
-    const int                    nu,
-    const int                    immax,
-    const int                    im,
-    const int                    iu )
+TARGET_HD static inline const PAccum* const_ref_vilocal(
+    const PAccum* const __restrict__  v,
+    const Dimensions                  dims,
+    const int                         nu,
+    const int                         immax,
+    const int                         im,
+    const int                         iu )
 {
   Assert( v );
   Assert( nu > 0 );
@@ -268,13 +354,13 @@ TARGET_HD static inline int ind_vslocal(
 /*===========================================================================*/
 /*---Multidimensional array accessor function---*/
 
-TARGET_HD static inline P* ref_vslocal(
-    P* const __restrict__  v,
-    const Dimensions       dims,
-    const int              nu,
-    const int              iamax,
-    const int              ia,
-    const int              iu )
+TARGET_HD static inline PAccum* ref_vslocal(
+    PAccum* const __restrict__  v,
+    const Dimensions            dims,
+    const int                   nu,
+    const int                   iamax,
+    const int                   ia,
+    const int                   iu )
 {
   Assert( v );
   Assert( nu > 0 );
@@ -289,13 +375,13 @@ TARGET_HD static inline P* ref_vslocal(
 /*===========================================================================*/
 /*---Multidimensional array accessor function---*/
 
-TARGET_HD static inline const P* const_ref_vslocal(
-    const P* const __restrict__  v,
-    const Dimensions             dims,
-    const int                    nu,
-    const int                    iamax,
-    const int                    ia,
-    const int                    iu )
+TARGET_HD static inline const PAccum* const_ref_vslocal(
+    const PAccum* const __restrict__  v,
+    const Dimensions                  dims,
+    const int                         nu,
+    const int                         iamax,
+    const int                         ia,
+    const int                         iu )
 {
   Assert( v );
   Assert( nu > 0 );
@@ -310,13 +396,13 @@ TARGET_HD static inline const P* const_ref_vslocal(
 /*===========================================================================*/
 /*---Multidimensional array accessor function---*/
 
-TARGET_HD static inline P* ref_volocal(
-    P* const __restrict__  v,
-    const Dimensions       dims,
-    const int              nu,
-    const int              immax,
-    const int              im,
-    const int              iu )
+TARGET_HD static inline PAccum* ref_volocal(
+    PAccum* const __restrict__  v,
+    const Dimensions            dims,
+    const int                   nu,
+    const int                   immax,
+    const int                   im,
+    const int                   iu )
 {
   Assert( v );
   Assert( nu > 0 );
@@ -344,7 +430,7 @@ TARGET_HD static inline P* ref_a_from_m(
   Assert( octant >= 0 && octant < NOCTANT );
 
   return & v[ ia     + dims.na * (
-              im     +      NM * (
+              im     + dims.nm * (
               octant + NOCTANT * (
               0 ))) ];
 }
@@ -365,7 +451,7 @@ TARGET_HD static inline const P* const_ref_a_from_m(
   Assert( octant >= 0 && octant < NOCTANT );
 
   return & v[ ia     + dims.na * (
-              im     +      NM * (
+              im     + dims.nm * (
               octant + NOCTANT * (
               0 ))) ];
 }
@@ -387,7 +473,7 @@ TARGET_HD static inline const P* __restrict__ const_ref_a_from_m_flat(
   Assert( octant >= 0 && octant < NOCTANT );
 
   return & v[ ia     + dims_na * (
-              im     +      NM * (
+              im     + dims_nm * (
               octant + NOCTANT * (
               0 ))) ];
 }
@@ -407,7 +493,7 @@ TARGET_HD static inline P* ref_m_from_a(
   Assert( ia >= 0 && ia < dims.na );
   Assert( octant >= 0 && octant < NOCTANT );
 
-  return & v[ im     +      NM * (
+  return & v[ im     + dims.nm * (
               ia     + dims.na * (
               octant + NOCTANT * (
               0 ))) ];
@@ -428,7 +514,7 @@ TARGET_HD static inline const P* const_ref_m_from_a(
   Assert( ia >= 0 && ia < dims.na );
   Assert( octant >= 0 && octant < NOCTANT );
 
-  return & v[ im     +      NM * (
+  return & v[ im     + dims.nm * (
               ia     + dims.na * (
               octant + NOCTANT * (
               0 ))) ];
@@ -448,7 +534,7 @@ TARGET_HD static inline int ind_m_from_a_flat(
   Assert( ia >= 0 && ia < dims_na );
   Assert( octant >= 0 && octant < NOCTANT );
 
-  return im     +      NM * (
+  return im     + dims_nm * (
          ia     + dims_na * (
          octant + NOCTANT * (
          0 )));
@@ -8,7 +8,10 @@
  */
 /*---------------------------------------------------------------------------*/
 
+#include <stdlib.h>
+
 #include "env.h"
+#include "simd_kernels.h"
 #include "definitions.h"
 #include "dimensions.h"
 #include "array_accessors.h"
@@ -27,6 +30,21 @@ void initialize_state( P* const __restrict__   v,
                        const Dimensions        dims,
                        const int               nu,
                        const Quantities* const quan )
+{
+  initialize_state_range( v, dims, nu, quan, 0, dims.ne, 0, dims.ncell_z );
+}
+
+/*===========================================================================*/
+/*---Initialize part of a state vector to required input value---*/
+
+void initialize_state_range( P* const __restrict__   v,
+                             const Dimensions        dims,
+                             const int               nu,
+                             const Quantities* const quan,
+                             const int               ie_min,
+                             const int               ie_max,
+                             const int               iz_min,
+                             const int               iz_max )
 {
   int ix = 0;
   int iy = 0;
@@ -35,15 +53,28 @@ void initialize_state( P* const __restrict__   v,
   int im = 0;
   int iu = 0;
 
-  for( iz=0; iz<dims.ncell_z; ++iz )
+  Assert( ie_min >= 0 && ie_min <= ie_max && ie_max <= dims.ne );
+  Assert( iz_min >= 0 && iz_min <= iz_max && iz_max <= dims.ncell_z );
+
+  for( iz=iz_min; iz<iz_max; ++iz )
   for( iy=0; iy<dims.ncell_y; ++iy )
   for( ix=0; ix<dims.ncell_x; ++ix )
-  for( ie=0; ie<dims.ne; ++ie )
-  for( im=0; im<dims.nm; ++im )
-  for( iu=0; iu<nu; ++iu )
+  for( ie=ie_min; ie<ie_max; ++ie )
   {
-    *ref_state( v, dims, nu, ix, iy, iz, ie, im, iu )
+    /*---The moments and unknowns of a cell and group are contiguous---*/
+
+    P* const __restrict__ v_this = ref_state( v, dims, nu, ix, iy, iz, ie,
+                                              0, 0 );
+    for( iu=0; iu<nu; ++iu )
+    {
+#pragma ivdep
+#pragma simd
+      for( im=0; im<dims.nm; ++im )
+      {
+        v_this[ im + dims.nm * iu ]
                 = Quantities_init_state( quan, ix, iy, iz, ie, im, iu, dims );
+      }
+    }
   }
 }
 
@@ -63,6 +94,38 @@ void initialize_state_zero( P* const __restrict__ v,
   }
 }
 
+/*===========================================================================*/
+/*---Initialize to zero part of a state vector---*/
+
+void initialize_state_zero_range( P* const __restrict__ v,
+                                  const Dimensions      dims,
+                                  const int             nu,
+                                  const int             ie_min,
+                                  const int             ie_max,
+                                  const int             iz_min,
+                                  const int             iz_max )
+{
+  int ix = 0;
+  int iy = 0;
+  int iz = 0;
+  int ie = 0;
+  int im = 0;
+  int iu = 0;
+
+  Assert( ie_min >= 0 && ie_min <= ie_max && ie_max <= dims.ne );
+  Assert( iz_min >= 0 && iz_min <= iz_max && iz_max <= dims.ncell_z );
+
+  for( iz=iz_min; iz<iz_max; ++iz )
+  for( ie=ie_min; ie<ie_max; ++ie )
+  for( iy=0; iy<dims.ncell_y; ++iy )
+  for( ix=0; ix<dims.ncell_x; ++ix )
+  for( im=0; im<dims.nm; ++im )
+  for( iu=0; iu<nu; ++iu )
+  {
+    *ref_state( v, dims, nu, ix, iy, iz, ie, im, iu ) = P_zero();
+  }
+}
+
 /*===========================================================================*/
 /*---Compute vector norm info for state vector---*/
 
@@ -70,40 +133,150 @@ void get_state_norms( const P* const __restrict__ vi,
                       const P* const __restrict__ vo,
                       const Dimensions            dims,
                       const int                   nu,
-                      P* const __restrict__       normsqp,
-                      P* const __restrict__       normsqdiffp,
+                      double* const __restrict__  normsqp,
+                      double* const __restrict__  normsqdiffp,
                       Env* const                  env )
 {
-  Assert( normsqp     != NULL ? "Null pointer encountered" : 0 );
-  Assert( normsqdiffp != NULL ? "Null pointer encountered" : 0 );
+  const size_t npart = ( (size_t)dims.ncell_z ) * dims.ne;
+
+  double* const normsq_part     = (double*)malloc( npart * sizeof(double) );
+  double* const normsqdiff_part = (double*)malloc( npart * sizeof(double) );
+
+  Insist( normsq_part && normsqdiff_part );
+
+  get_state_norms_range( vi, vo, dims, nu, 0, dims.ne, 0, dims.ncell_z,
+                         normsq_part, normsqdiff_part );
+
+  get_state_norms_combine( normsq_part, normsqdiff_part, dims,
+                           normsqp, normsqdiffp, env );
+
+  free( (void*)normsq_part );
+  free( (void*)normsqdiff_part );
+}
+
+/*===========================================================================*/
+/*---Compute vector norm info for part of a state vector---*/
+
+void get_state_norms_range( const P* const __restrict__ vi,
+                            const P* const __restrict__ vo,
+                            const Dimensions            dims,
+                            const int                   nu,
+                            const int                   ie_min,
+                            const int                   ie_max,
+                            const int                   iz_min,
+                            const int                   iz_max,
+                            double* const __restrict__  normsq_part,
+                            double* const __restrict__  normsqdiff_part )
+{
+  const int n = dims.nm * nu;
 
   int ix = 0;
   int iy = 0;
   int iz = 0;
   int ie = 0;
-  int im = 0;
-  int iu = 0;
+  int i = 0;
 
-  P normsq     = P_zero();
-  P normsqdiff = P_zero();
+  Assert( ie_min >= 0 && ie_min <= ie_max && ie_max <= dims.ne );
+  Assert( iz_min >= 0 && iz_min <= iz_max && iz_max <= dims.ncell_z );
+  Assert( normsq_part     != NULL ? "Null pointer encountered" : 0 );
+  Assert( normsqdiff_part != NULL ? "Null pointer encountered" : 0 );
 
-  for( iz=0; iz<dims.ncell_z; ++iz )
-  for( iy=0; iy<dims.ncell_y; ++iy )
-  for( ix=0; ix<dims.ncell_x; ++ix )
-  for( ie=0; ie<dims.ne; ++ie )
-  for( im=0; im<dims.nm; ++im )
-  for( iu=0; iu<nu; ++iu )
+  for( iz=iz_min; iz<iz_max; ++iz )
+  for( ie=ie_min; ie<ie_max; ++ie )
+  {
+    /*---NOTE: accumulate in double regardless of storage precision---*/
+
+    SimdAcc normsq_lanes     = SimdAcc_set1( PAccum_zero() );
+    SimdAcc normsqdiff_lanes = SimdAcc_set1( PAccum_zero() );
+
+    PAccum normsq_lane[SIMD_LEN];
+    PAccum normsqdiff_lane[SIMD_LEN];
+
+    double normsq     = 0;
+    double normsqdiff = 0;
+
+    for( iy=0; iy<dims.ncell_y; ++iy )
+    for( ix=0; ix<dims.ncell_x; ++ix )
+    {
+      /*---The moments and unknowns of a cell and group are contiguous---*/
+
+      const P* const __restrict__ vi_this = const_ref_state( vi, dims, nu,
+                                                    ix, iy, iz, ie, 0, 0 );
+      const P* const __restrict__ vo_this = const_ref_state( vo, dims, nu,
+                                                    ix, iy, iz, ie, 0, 0 );
+
+      for( i=0; i<n; i+=SIMD_LEN )
+      {
+        const SimdMask mask = SimdAcc_mask( n-i < SIMD_LEN ? n-i : SIMD_LEN );
+        const SimdAcc val_vi = SimdAcc_load_P_mask( vi_this + i, mask );
+        const SimdAcc val_vo = SimdAcc_load_P_mask( vo_this + i, mask );
+        const SimdAcc diff   = SimdAcc_sub( val_vi, val_vo );
+        normsq_lanes     = SimdAcc_add( normsq_lanes,
+                                        SimdAcc_mul( val_vo, val_vo ) );
+        normsqdiff_lanes = SimdAcc_add( normsqdiff_lanes,
+                                        SimdAcc_mul( diff, diff ) );
+      }
+    }
+
+    /*---Add the lanes in a fixed order---*/
+
+    SimdAcc_store_mask( normsq_lane,     normsq_lanes,
+                        SimdAcc_mask( SIMD_LEN ) );
+    SimdAcc_store_mask( normsqdiff_lane, normsqdiff_lanes,
+                        SimdAcc_mask( SIMD_LEN ) );
+
+    for( i=0; i<SIMD_LEN; ++i )
+    {
+      normsq     += normsq_lane[i];
+      normsqdiff += normsqdiff_lane[i];
+    }
+
+    normsq_part[     ie + dims.ne * iz ] = normsq;
+    normsqdiff_part[ ie + dims.ne * iz ] = normsqdiff;
+  }
+}
+
+/*===========================================================================*/
+/*---Sum values by pairs, in place, in an order fixed by their number---*/
+
+static double sum_tree_( double* const __restrict__ v,
+                         const size_t               n )
+{
+  size_t stride = 1;
+  size_t i = 0;
+
+  for( stride=1; stride<n; stride*=2 )
   {
-    const P val_vi = *const_ref_state( vi, dims, nu, ix, iy, iz, ie, im, iu );
-    const P val_vo = *const_ref_state( vo, dims, nu, ix, iy, iz, ie, im, iu );
-    const P diff   = val_vi - val_vo;
-    normsq        += val_vo * val_vo;
-    normsqdiff    += diff   * diff;
+    for( i=0; i+stride<n; i+=2*stride )
+    {
+      v[i] += v[i+stride];
+    }
   }
-  Assert( normsq     >= P_zero() );
-  Assert( normsqdiff >= P_zero() );
-  normsq     = Env_sum_P( env, normsq );
-  normsqdiff = Env_sum_P( env, normsqdiff );
+
+  return n > 0 ? v[0] : 0;
+}
+
+/*---------------------------------------------------------------------------*/
+
+void get_state_norms_combine( double* const __restrict__  normsq_part,
+                              double* const __restrict__  normsqdiff_part,
+                              const Dimensions            dims,
+                              double* const __restrict__  normsqp,
+                              double* const __restrict__  normsqdiffp,
+                              Env* const                  env )
+{
+  const size_t npart = ( (size_t)dims.ncell_z ) * dims.ne;
+
+  Assert( normsqp     != NULL ? "Null pointer encountered" : 0 );
+  Assert( normsqdiffp != NULL ? "Null pointer encountered" : 0 );
+
+  double normsq     = sum_tree_( normsq_part,     npart );
+  double normsqdiff = sum_tree_( normsqdiff_part, npart );
+
+  Assert( normsq     >= 0 );
+  Assert( normsqdiff >= 0 );
+  normsq     = Env_sum_d( env, normsq );
+  normsqdiff = Env_sum_d( env, normsqdiff );
 
   *normsqp     = normsq;
   *normsqdiffp = normsqdiff;
@@ -125,6 +298,20 @@ void copy_vector(       P* const __restrict__ vo,
   }
 }
 
+/*===========================================================================*/
+/*---Zero vector---*/
+
+void zero_vector( P* const __restrict__ v,
+                  const size_t          n )
+{
+  size_t i = 0;
+
+  for( i=0; i<n; ++i )
+  {
+    v[i] = P_zero();
+  }
+}
+
 /*===========================================================================*/
 
 #ifdef __cplusplus
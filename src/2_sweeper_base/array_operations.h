@@ -29,6 +29,19 @@ void initialize_state( P* const __restrict__   v,
                        const int               nu,
                        const Quantities* const quan );
 
+/*===========================================================================*/
+/*---Initialize to required input value the part of a state vector for
+     energy groups [ie_min, ie_max) and z-cells [iz_min, iz_max)---*/
+
+void initialize_state_range( P* const __restrict__   v,
+                             const Dimensions        dims,
+                             const int               nu,
+                             const Quantities* const quan,
+                             const int               ie_min,
+                             const int               ie_max,
+                             const int               iz_min,
+                             const int               iz_max );
+
 /*===========================================================================*/
 /*---Initialize state vector to zero---*/
 
@@ -36,6 +49,19 @@ void initialize_state_zero( P* const __restrict__ v,
                             const Dimensions      dims,
                             const int             nu );
 
+/*===========================================================================*/
+/*---Initialize to zero the part of a state vector for energy groups
+     [ie_min, ie_max) and z-cells [iz_min, iz_max).  Called on fresh
+     memory, this places its pages on the NUMA node of the caller---*/
+
+void initialize_state_zero_range( P* const __restrict__ v,
+                                  const Dimensions      dims,
+                                  const int             nu,
+                                  const int             ie_min,
+                                  const int             ie_max,
+                                  const int             iz_min,
+                                  const int             iz_max );
+
 /*===========================================================================*/
 /*---Compute vector norm info for state vector---*/
 
@@ -43,10 +69,38 @@ void get_state_norms( const P* const __restrict__ vi,
                       const P* const __restrict__ vo,
                       const Dimensions            dims,
                       const int                   nu,
-                      P* const __restrict__       normsqp,
-                      P* const __restrict__       normsqdiffp,
+                      double* const __restrict__  normsqp,
+                      double* const __restrict__  normsqdiffp,
                       Env* const                  env );
 
+/*===========================================================================*/
+/*---Compute the norm info of the part of a state vector for energy groups
+     [ie_min, ie_max) and z-cells [iz_min, iz_max), one partial sum per
+     z-cell and group, stored at index ie + ne * iz---*/
+
+void get_state_norms_range( const P* const __restrict__ vi,
+                            const P* const __restrict__ vo,
+                            const Dimensions            dims,
+                            const int                   nu,
+                            const int                   ie_min,
+                            const int                   ie_max,
+                            const int                   iz_min,
+                            const int                   iz_max,
+                            double* const __restrict__  normsq_part,
+                            double* const __restrict__  normsqdiff_part );
+
+/*===========================================================================*/
+/*---Combine all partial sums of get_state_norms_range, by a tree whose
+     shape depends only on dims, so results do not depend on how the
+     parts were computed; overwrites the partial sums---*/
+
+void get_state_norms_combine( double* const __restrict__  normsq_part,
+                              double* const __restrict__  normsqdiff_part,
+                              const Dimensions            dims,
+                              double* const __restrict__  normsqp,
+                              double* const __restrict__  normsqdiffp,
+                              Env* const                  env );
+
 /*===========================================================================*/
 /*---Copy vector---*/
 
@@ -54,6 +108,12 @@ void copy_vector(       P* const __restrict__ vo,
                   const P* const __restrict__ vi,
                   const size_t                n );
 
+/*===========================================================================*/
+/*---Zero vector---*/
+
+void zero_vector( P* const __restrict__ v,
+                  const size_t          n );
+
 /*===========================================================================*/
 
 #ifdef __cplusplus
@@ -0,0 +1,153 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   array_operations_kernels.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Functions to operate on multi-dim arrays, code for comp. kernel.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#ifndef _array_operations_kernels_h_
+#define _array_operations_kernels_h_
+
+#include "env_assert_kernels.h"
+
+#include "types_kernels.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Register tile sizes for small dense matrix product---*/
+
+/*---NOTE: a GEMM_MR column of PAccum fills one AVX-512 register or two AVX2
+     registers; the GEMM_MR x GEMM_NR tile of accumulators then occupies
+     4 or 8 vector registers, leaving room for the A column and B scalars---*/
+
+enum{ GEMM_MR = 8 };
+enum{ GEMM_NR = 4 };
+
+/*===========================================================================*/
+/*---Small dense matrix product, one register tile: C = A * B---*/
+
+/*---All matrices column-major; mr <= GEMM_MR, nr <= GEMM_NR.
+     A is in storage precision, B and C in accumulation precision---*/
+
+TARGET_HD static inline void gemm_tile_P_(
+  const int                        mr,
+  const int                        nr,
+  const int                        k,
+  const P* const __restrict__      a,
+  const int                        lda,
+  const PAccum* const __restrict__ b,
+  const int                        ldb,
+  PAccum* const __restrict__       c,
+  const int                        ldc )
+{
+  PAccum ctile[GEMM_NR][GEMM_MR];
+
+  int i = 0;
+  int j = 0;
+  int p = 0;
+
+  for( j=0; j<GEMM_NR; ++j )
+  {
+    for( i=0; i<GEMM_MR; ++i )
+    {
+      ctile[j][i] = PAccum_zero();
+    }
+  }
+
+  if( mr == GEMM_MR && nr == GEMM_NR )
+  {
+    /*---Full tile: fixed trip counts so inner loops map onto registers---*/
+    for( p=0; p<k; ++p )
+    {
+      const P* const __restrict__ a_p = a + lda * p;
+#pragma unroll
+      for( j=0; j<GEMM_NR; ++j )
+      {
+        const PAccum b_pj = b[ p + ldb * j ];
+#pragma ivdep
+#pragma simd
+        for( i=0; i<GEMM_MR; ++i )
+        {
+          ctile[j][i] += a_p[i] * b_pj;
+        }
+      }
+    }
+  }
+  else
+  {
+    /*---Edge tile---*/
+    for( p=0; p<k; ++p )
+    {
+      const P* const __restrict__ a_p = a + lda * p;
+      for( j=0; j<nr; ++j )
+      {
+        const PAccum b_pj = b[ p + ldb * j ];
+        for( i=0; i<mr; ++i )
+        {
+          ctile[j][i] += a_p[i] * b_pj;
+        }
+      }
+    }
+  }
+
+  for( j=0; j<nr; ++j )
+  {
+    for( i=0; i<mr; ++i )
+    {
+      c[ i + ldc * j ] = ctile[j][i];
+    }
+  }
+}
+
+/*===========================================================================*/
+/*---Small dense matrix product: C = A * B---*/
+
+/*---A is m x k, B is k x n, C is m x n, all column-major---*/
+
+TARGET_HD static inline void gemm_P(
+  const int                        m,
+  const int                        n,
+  const int                        k,
+  const P* const __restrict__      a,
+  const int                        lda,
+  const PAccum* const __restrict__ b,
+  const int                        ldb,
+  PAccum* const __restrict__       c,
+  const int                        ldc )
+{
+  Assert( m >= 0 && n >= 0 && k >= 0 );
+  Assert( lda >= m && ldb >= k && ldc >= m );
+
+  int i = 0;
+  int j = 0;
+
+  /*---Loop over register tiles; j outer so the B panel stays in L1---*/
+
+  for( j=0; j<n; j+=GEMM_NR )
+  {
+    const int nr = n-j < GEMM_NR ? n-j : GEMM_NR;
+    for( i=0; i<m; i+=GEMM_MR )
+    {
+      const int mr = m-i < GEMM_MR ? m-i : GEMM_MR;
+      gemm_tile_P_( mr, nr, k, a + i, lda, b + ldb * j, ldb,
+                    c + i + ldc * j, ldc );
+    }
+  }
+}
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_array_operations_kernels_h_---*/
+
+/*---------------------------------------------------------------------------*/
@@ -21,6 +21,10 @@ extern "C"
 /*===========================================================================*/
 /*---Enums for compile-time sizes---*/
 
+/*---NOTE: these are the default sizes for the build.  Sweep kernels are
+     compiled against these values, possibly several times over for
+     different values, see sweeper_kba_kernel_instances.h---*/
+
 /*---Number of unknowns per gridcell, moment, energy group---*/
 #ifdef NU_VALUE
 enum{ NU = NU_VALUE };
@@ -51,6 +55,9 @@ typedef struct
   /*----Number of moments---*/
   int nm;
 
+  /*---Number of unknowns per gridcell, moment, energy group---*/
+  int nu;
+
   /*---Number of angles---*/
   int na;
 } Dimensions;
@@ -0,0 +1,286 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   facecodec.c
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Compression of face messages, code.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "env.h"
+#include "facecodec.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Header of an encoded face: payload bytes, and whether run coded---*/
+
+enum{ FACECODEC_NHEADER = 2 };
+
+/*===========================================================================*/
+/*---Null object---*/
+
+FaceCodec FaceCodec_null()
+{
+  FaceCodec result;
+  memset( (void*)&result, 0, sizeof(FaceCodec) );
+  return result;
+}
+
+/*===========================================================================*/
+/*---Pseudo-constructor for FaceCodec struct---*/
+
+void FaceCodec_create( FaceCodec* codec,
+                       int        mode,
+                       int        nbit,
+                       int        na,
+                       size_t     nmax )
+{
+  Assert( codec != NULL );
+  Insist( mode >= FACECODEC_NONE && mode <= FACECODEC_LOSSY ?
+          "Invalid face compression mode supplied." : 0 );
+  Insist( nbit > 0 ? "Invalid face compression bit count supplied." : 0 );
+  Assert( na > 0 );
+
+  *codec = FaceCodec_null();
+
+  codec->mode = mode;
+  codec->nbit = nbit;
+  codec->na   = na;
+  codec->nmax = nmax;
+
+  if( FaceCodec_is_active( codec ) )
+  {
+    codec->scratch = (unsigned char*)malloc( nmax * sizeof(P) + 1 );
+    Insist( codec->scratch );
+  }
+}
+
+/*===========================================================================*/
+/*---Pseudo-destructor for FaceCodec struct---*/
+
+void FaceCodec_destroy( FaceCodec* codec )
+{
+  Assert( codec != NULL );
+
+  if( codec->scratch )
+  {
+    free( codec->scratch );
+  }
+  *codec = FaceCodec_null();
+}
+
+/*===========================================================================*/
+/*---Most P values in the encoding of a face of n values---*/
+
+size_t FaceCodec_size_coded_max( const FaceCodec* codec,
+                                 size_t           n )
+{
+  const size_t nbyte = FACECODEC_NHEADER * sizeof(size_t) + n * sizeof(P);
+  return ( nbyte + sizeof(P) - 1 ) / sizeof(P);
+}
+
+/*===========================================================================*/
+/*---Round to nbit significant bits---*/
+/*---pseudo-private member function---*/
+
+static P FaceCodec_round_( P value, int nbit )
+{
+  int exponent = 0;
+  const double mantissa = frexp( (double)value, &exponent );
+  const double scale = ldexp( 1., nbit );
+  return (P)ldexp( floor( mantissa * scale + .5 ) / scale, exponent );
+}
+
+/*===========================================================================*/
+/*---Encode n values of in into coded; returns the number of P used---*/
+
+size_t FaceCodec_encode( FaceCodec*  codec,
+                         P*          coded,
+                         const P*    in,
+                         size_t      n,
+                         Env*        env )
+{
+  Assert( codec != NULL );
+  Assert( FaceCodec_is_active( codec ) );
+  Assert( coded != NULL );
+  Assert( in != NULL );
+  Assert( n <= codec->nmax );
+  Assert( n % codec->na == 0 );
+
+  const Timer time_start = Env_get_time( env );
+
+  const size_t nbyte_raw = n * sizeof(P);
+  const int    is_lossy  = codec->mode == FACECODEC_LOSSY;
+
+  unsigned char* const __restrict__ planes = codec->scratch;
+  unsigned char* const __restrict__ payload = (unsigned char*)coded +
+                                        FACECODEC_NHEADER * sizeof(size_t);
+
+  /*---XOR each value with the one before it in its run of na, and
+       shuffle byte j of value k to planes[ j*n + k ]---*/
+
+  unsigned char prev[sizeof(P)];
+  unsigned char word[sizeof(P)];
+
+  size_t k = 0;
+
+  for( k=0; k<n; ++k )
+  {
+    const P value = is_lossy ? FaceCodec_round_( in[k], codec->nbit ) : in[k];
+    const int is_run_start = k % codec->na == 0;
+    size_t j = 0;
+
+    memcpy( word, &value, sizeof(P) );
+    for( j=0; j<sizeof(P); ++j )
+    {
+      planes[ j*n + k ] = is_run_start ? word[j] : word[j] ^ prev[j];
+      prev[j] = word[j];
+    }
+  }
+
+  /*---Code each run of zero bytes as a zero and a count, giving up if
+       the result would be no smaller than the planes---*/
+
+  size_t nbyte = 0;
+  size_t is_coded = 1;
+
+  size_t ibyte = 0;
+
+  while( ibyte < nbyte_raw && is_coded )
+  {
+    if( nbyte + 2 > nbyte_raw )
+    {
+      is_coded = 0;
+    }
+    else if( planes[ibyte] != 0 )
+    {
+      payload[nbyte++] = planes[ibyte++];
+    }
+    else
+    {
+      size_t nzero = 0;
+      while( ibyte < nbyte_raw && planes[ibyte] == 0 && nzero < 255 )
+      {
+        ++ibyte;
+        ++nzero;
+      }
+      payload[nbyte++] = 0;
+      payload[nbyte++] = (unsigned char)nzero;
+    }
+  }
+
+  if( ! is_coded )
+  {
+    memcpy( payload, planes, nbyte_raw );
+    nbyte = nbyte_raw;
+  }
+
+  const size_t header[FACECODEC_NHEADER] = { nbyte, is_coded };
+  memcpy( coded, header, sizeof(header) );
+
+  const size_t ncoded = ( sizeof(header) + nbyte + sizeof(P) - 1 ) / sizeof(P);
+
+  codec->nbyte_raw   += nbyte_raw;
+  codec->nbyte_coded += ncoded * sizeof(P);
+  codec->time        += Env_get_time( env ) - time_start;
+
+  return ncoded;
+}
+
+/*===========================================================================*/
+/*---Decode coded into the n values of out---*/
+
+void FaceCodec_decode( FaceCodec*  codec,
+                       P*          out,
+                       const P*    coded,
+                       size_t      n,
+                       Env*        env )
+{
+  Assert( codec != NULL );
+  Assert( FaceCodec_is_active( codec ) );
+  Assert( out != NULL );
+  Assert( coded != NULL );
+  Assert( n <= codec->nmax );
+  Assert( n % codec->na == 0 );
+
+  const Timer time_start = Env_get_time( env );
+
+  const size_t nbyte_raw = n * sizeof(P);
+
+  unsigned char* const __restrict__ planes = codec->scratch;
+  const unsigned char* const __restrict__ payload =
+              (const unsigned char*)coded + FACECODEC_NHEADER * sizeof(size_t);
+
+  size_t header[FACECODEC_NHEADER];
+  memcpy( header, coded, sizeof(header) );
+  const size_t nbyte    = header[0];
+  const size_t is_coded = header[1];
+
+  /*---Expand the zero runs into the planes---*/
+
+  if( is_coded )
+  {
+    size_t ibyte = 0;
+    size_t i = 0;
+
+    for( i=0; i<nbyte; ++i )
+    {
+      if( payload[i] != 0 )
+      {
+        planes[ibyte++] = payload[i];
+      }
+      else
+      {
+        const size_t nzero = payload[++i];
+        Assert( ibyte + nzero <= nbyte_raw );
+        memset( planes + ibyte, 0, nzero );
+        ibyte += nzero;
+      }
+    }
+    Insist( ibyte == nbyte_raw ? "Corrupt compressed face received." : 0 );
+  }
+  else
+  {
+    Insist( nbyte == nbyte_raw ? "Corrupt compressed face received." : 0 );
+    memcpy( planes, payload, nbyte_raw );
+  }
+
+  /*---Unshuffle and undo the XOR with the value before---*/
+
+  unsigned char prev[sizeof(P)];
+  unsigned char word[sizeof(P)];
+
+  size_t k = 0;
+
+  for( k=0; k<n; ++k )
+  {
+    const int is_run_start = k % codec->na == 0;
+    size_t j = 0;
+
+    for( j=0; j<sizeof(P); ++j )
+    {
+      word[j] = is_run_start ? planes[ j*n + k ] : planes[ j*n + k ] ^ prev[j];
+      prev[j] = word[j];
+    }
+    memcpy( &out[k], word, sizeof(P) );
+  }
+
+  codec->time += Env_get_time( env ) - time_start;
+}
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+/*---------------------------------------------------------------------------*/
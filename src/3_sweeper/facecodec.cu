@@ -0,0 +1 @@
+./facecodec.c
\ No newline at end of file
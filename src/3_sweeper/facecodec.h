@@ -0,0 +1,126 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   facecodec.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Compression of face messages, header.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+/*=============================================================================
+
+A face is a sequence of runs of na values, one value per angle, and the
+values of neighboring angles are close.  The encoder replaces each value
+after the first of its run by its bitwise XOR with the one before, which
+zeros the leading bytes the two share, then shuffles the bytes so that
+byte j of every value is contiguous, and finally codes each run of zero
+bytes as a zero byte and a count.  If that would not shrink the data the
+shuffled bytes are sent as they are.
+
+In the lossless mode the decoded face is bitwise identical.  In the lossy
+mode each value is first rounded to nbit significant bits, so its
+relative error is at most 2^-nbit, and the low bytes of the mantissas
+become zero and code to almost nothing.
+
+The encoded message is a whole number of P values, so it can be sent as
+P; its length in bytes is in its header.
+
+=============================================================================*/
+
+#ifndef _facecodec_h_
+#define _facecodec_h_
+
+#include <stddef.h>
+
+#include "env.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Compression modes---*/
+
+enum{ FACECODEC_NONE     = 0 };
+enum{ FACECODEC_LOSSLESS = 1 };
+enum{ FACECODEC_LOSSY    = 2 };
+
+/*===========================================================================*/
+/*---Struct for face codec---*/
+
+typedef struct
+{
+  int            mode;
+  int            nbit;      /*---Significant bits kept, lossy mode---*/
+  int            na;        /*---Length of the runs of neighboring values---*/
+  size_t         nmax;      /*---Most values in a face---*/
+  unsigned char* scratch;
+
+  /*---Totals over all faces coded so far---*/
+  double         nbyte_raw;
+  double         nbyte_coded;
+  Timer          time;
+} FaceCodec;
+
+/*===========================================================================*/
+/*---Null object---*/
+
+FaceCodec FaceCodec_null(void);
+
+/*===========================================================================*/
+/*---Pseudo-constructor for FaceCodec struct---*/
+
+void FaceCodec_create( FaceCodec* codec,
+                       int        mode,
+                       int        nbit,
+                       int        na,
+                       size_t     nmax );
+
+/*===========================================================================*/
+/*---Pseudo-destructor for FaceCodec struct---*/
+
+void FaceCodec_destroy( FaceCodec* codec );
+
+/*===========================================================================*/
+/*---Is compression on---*/
+
+static int FaceCodec_is_active( const FaceCodec* codec )
+{
+  return codec->mode != FACECODEC_NONE;
+}
+
+/*===========================================================================*/
+/*---Most P values in the encoding of a face of n values---*/
+
+size_t FaceCodec_size_coded_max( const FaceCodec* codec,
+                                 size_t           n );
+
+/*===========================================================================*/
+/*---Encode n values of in into coded; returns the number of P used---*/
+
+size_t FaceCodec_encode( FaceCodec*  codec,
+                         P*          coded,
+                         const P*    in,
+                         size_t      n,
+                         Env*        env );
+
+/*===========================================================================*/
+/*---Decode coded into the n values of out---*/
+
+void FaceCodec_decode( FaceCodec*  codec,
+                       P*          out,
+                       const P*    coded,
+                       size_t      n,
+                       Env*        env );
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_facecodec_h_---*/
+
+/*---------------------------------------------------------------------------*/
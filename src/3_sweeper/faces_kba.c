@@ -17,6 +17,339 @@ extern "C"
 {
 #endif
 
+/*===========================================================================*/
+/*---Index of the xz, yz face buffer used at step, async case---*/
+/*---pseudo-private member function---*/
+
+static int Faces_buffer_step_( int step )
+{
+  Assert( step >= -1 );
+  return ( step + NDIM ) % NDIM;
+}
+
+/*===========================================================================*/
+/*---Proc that faces are sent to or received from, or -1 if none---*/
+/*---pseudo-private member function---*/
+
+static int Faces_proc_other_( int axis, int dir_ind, Bool_t is_send,
+                              Env* env )
+{
+  const int dir = dir_ind==0 ? DIR_UP*1 : DIR_DN*1;
+  const int inc = is_send ? Dir_inc( dir ) : - Dir_inc( dir );
+  const int proc_x = Env_proc_x_this( env ) + ( axis==0 ? inc : 0 );
+  const int proc_y = Env_proc_y_this( env ) + ( axis==1 ? inc : 0 );
+  const int proc_z = Env_proc_z_this( env ) + ( axis==2 ? inc : 0 );
+
+  return proc_x >= 0 && proc_x < Env_nproc_x( env ) &&
+         proc_y >= 0 && proc_y < Env_nproc_y( env ) &&
+         proc_z >= 0 && proc_z < Env_nproc_z( env ) ?
+         Env_proc( env, proc_x, proc_y, proc_z ) : -1;
+}
+
+/*===========================================================================*/
+/*---Face crossing the proc boundary normal to an axis: size per octant,
+     and start of the part for an octant in block, for the step---*/
+/*---pseudo-private member functions---*/
+
+static size_t Faces_size_face_per_octant_( Faces*      faces,
+                                           Dimensions  dims_b,
+                                           int         axis )
+{
+  const size_t size_face = axis==0 ?
+    Dimensions_size_faceyz( dims_b, dims_b.nu, faces->noctant_per_block ) :
+                           axis==1 ?
+    Dimensions_size_facexz( dims_b, dims_b.nu, faces->noctant_per_block ) :
+    Dimensions_size_facexy( dims_b, dims_b.nu, faces->noctant_per_block );
+
+  return size_face / faces->noctant_per_block;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static P* Faces_face_per_octant_( Faces*      faces,
+                                  Dimensions  dims_b,
+                                  int         axis,
+                                  int         step,
+                                  int         octant_in_block )
+{
+  return axis==0 ?
+    ref_faceyz( Pointer_h( Faces_faceyz_step( faces, step ) ),
+                dims_b, dims_b.nu, faces->noctant_per_block,
+                0, 0, 0, 0, 0, octant_in_block ) :
+         axis==1 ?
+    ref_facexz( Pointer_h( Faces_facexz_step( faces, step ) ),
+                dims_b, dims_b.nu, faces->noctant_per_block,
+                0, 0, 0, 0, 0, octant_in_block ) :
+    ref_facexy( Pointer_h( Faces_facexy_step( faces, step ) ),
+                dims_b, dims_b.nu, faces->noctant_per_block,
+                0, 0, 0, 0, 0, octant_in_block );
+}
+
+/*===========================================================================*/
+/*---Create the persistent requests of the async face exchange---*/
+/*---pseudo-private member function---*/
+
+/*---One send and one receive per face buffer, axis, direction and octant
+     in block, for each neighbor that exists.  The buffers, peers and
+     sizes repeat with the period of the face buffer rotation, so the
+     requests are built once and each step only starts and completes
+     them.  The single xy face gets a set per buffer index like the
+     others.  Tags are fixed when the faces are created; messages between
+     two procs with the same tag match in the order posted, which the
+     step order keeps.  Encoded faces vary in length, so when compressing
+     the sends are started afresh each step, and every receive of a face
+     lands in the one buffer for its axis, direction and octant---*/
+
+static void Faces_create_requests_( Faces*      faces,
+                                    Dimensions  dims_b,
+                                    Env*        env )
+{
+  Assert( Faces_is_face_comm_async( faces ) );
+
+  int i = 0;
+
+  for( i=0; i<NDIM; ++i )
+  {
+    int octant_in_block = 0;
+
+    for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
+                                                            ++octant_in_block )
+    {
+      int axis = 0;
+
+      for( axis=0; axis<NDIM; ++axis )
+      {
+        const size_t    size_face_per_octant = Faces_size_face_per_octant_(
+                                                       faces, dims_b, axis );
+        P* __restrict__ face_per_octant = Faces_face_per_octant_(
+                                 faces, dims_b, axis, i, octant_in_block );
+
+        int dir_ind = 0;
+
+        for( dir_ind=0; dir_ind<2; ++dir_ind )
+        {
+          const int proc_send = Faces_proc_other_( axis, dir_ind, Bool_true,
+                                                   env );
+          const int proc_recv = Faces_proc_other_( axis, dir_ind, Bool_false,
+                                                   env );
+          if( proc_send >= 0 && ! Faces_is_face_compressed( faces ) )
+          {
+            Env_asend_init_P( env, face_per_octant, size_face_per_octant,
+              proc_send, faces->tag+octant_in_block,
+              & faces->request_send[i][axis][dir_ind][octant_in_block] );
+          }
+          if( proc_recv >= 0 && ! Faces_is_face_compressed( faces ) )
+          {
+            Env_arecv_init_P( env, face_per_octant, size_face_per_octant,
+              proc_recv, faces->tag+octant_in_block,
+              & faces->request_recv[i][axis][dir_ind][octant_in_block] );
+          }
+          if( proc_recv >= 0 && Faces_is_face_compressed( faces ) )
+          {
+            Env_arecv_init_P( env,
+              faces->face_coded_recv[axis][dir_ind][octant_in_block],
+              FaceCodec_size_coded_max( & faces->codec, size_face_per_octant ),
+              proc_recv, faces->tag+octant_in_block,
+              & faces->request_recv[i][axis][dir_ind][octant_in_block] );
+          }
+        } /*---dir_ind---*/
+      } /*---axis---*/
+    } /*---octant_in_block---*/
+  } /*---i---*/
+}
+
+/*===========================================================================*/
+/*---Free the persistent requests of the async face exchange---*/
+/*---pseudo-private member function---*/
+
+static void Faces_destroy_requests_( Faces* faces,
+                                     Env*   env )
+{
+  Assert( Faces_is_face_comm_async( faces ) );
+
+  int i = 0;
+
+  for( i=0; i<NDIM; ++i )
+  {
+    int octant_in_block = 0;
+
+    for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
+                                                            ++octant_in_block )
+    {
+      int axis = 0;
+
+      for( axis=0; axis<NDIM; ++axis )
+      {
+        int dir_ind = 0;
+
+        for( dir_ind=0; dir_ind<2; ++dir_ind )
+        {
+          if( Faces_proc_other_( axis, dir_ind, Bool_true, env ) >= 0 &&
+              ! Faces_is_face_compressed( faces ) )
+          {
+            Env_request_free( env,
+              & faces->request_send[i][axis][dir_ind][octant_in_block] );
+          }
+          if( Faces_proc_other_( axis, dir_ind, Bool_false, env ) >= 0 )
+          {
+            Env_request_free( env,
+              & faces->request_recv[i][axis][dir_ind][octant_in_block] );
+          }
+        } /*---dir_ind---*/
+      } /*---axis---*/
+    } /*---octant_in_block---*/
+  } /*---i---*/
+}
+
+/*===========================================================================*/
+/*---Allocate the encoded faces and the codec, compressed case---*/
+/*---pseudo-private member function---*/
+
+static void Faces_create_coded_( Faces*      faces,
+                                 Dimensions  dims_b,
+                                 int         face_compression,
+                                 int         face_compression_nbit,
+                                 Env*        env )
+{
+  size_t size_face_per_octant_max = 0;
+
+  int axis = 0;
+
+  for( axis=0; axis<NDIM; ++axis )
+  {
+    const size_t size_face_per_octant = Faces_size_face_per_octant_(
+                                                       faces, dims_b, axis );
+    size_face_per_octant_max = size_face_per_octant > size_face_per_octant_max
+                             ? size_face_per_octant : size_face_per_octant_max;
+  }
+
+  FaceCodec_create( & faces->codec, face_compression, face_compression_nbit,
+                    dims_b.na, size_face_per_octant_max );
+
+  if( ! Faces_is_face_compressed( faces ) )
+  {
+    return;
+  }
+
+  for( axis=0; axis<NDIM; ++axis )
+  {
+    const size_t size_coded_max = FaceCodec_size_coded_max( & faces->codec,
+                       Faces_size_face_per_octant_( faces, dims_b, axis ) );
+
+    int dir_ind = 0;
+
+    for( dir_ind=0; dir_ind<2; ++dir_ind )
+    {
+      int octant_in_block = 0;
+
+      for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
+                                                            ++octant_in_block )
+      {
+        faces->face_coded_send[axis][dir_ind][octant_in_block] =
+          Faces_proc_other_( axis, dir_ind, Bool_true, env ) < 0 ? NULL :
+          malloc_host_P( size_coded_max );
+        faces->face_coded_recv[axis][dir_ind][octant_in_block] =
+          Faces_proc_other_( axis, dir_ind, Bool_false, env ) < 0 ? NULL :
+          malloc_host_P( size_coded_max );
+      }
+    }
+  }
+}
+
+/*===========================================================================*/
+/*---Free the encoded faces and the codec---*/
+/*---pseudo-private member function---*/
+
+static void Faces_destroy_coded_( Faces* faces,
+                                  Env*   env )
+{
+  if( Faces_is_face_compressed( faces ) )
+  {
+    int axis = 0;
+
+    for( axis=0; axis<NDIM; ++axis )
+    {
+      int dir_ind = 0;
+
+      for( dir_ind=0; dir_ind<2; ++dir_ind )
+      {
+        int octant_in_block = 0;
+
+        for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
+                                                            ++octant_in_block )
+        {
+          if( faces->face_coded_send[axis][dir_ind][octant_in_block] )
+          {
+            free_host_P(
+                     faces->face_coded_send[axis][dir_ind][octant_in_block] );
+          }
+          if( faces->face_coded_recv[axis][dir_ind][octant_in_block] )
+          {
+            free_host_P(
+                     faces->face_coded_recv[axis][dir_ind][octant_in_block] );
+          }
+        }
+      }
+    }
+  }
+
+  FaceCodec_destroy( & faces->codec );
+}
+
+/*===========================================================================*/
+/*---Create the windows of the one-sided face exchange---*/
+/*---pseudo-private member function---*/
+
+/*---Each window exposes one whole face buffer of this proc; an upstream
+     proc puts its face for an octant in block at that octant's offset.
+     The single xy face is exposed by one window per buffer index, like
+     the requests of the two-sided case---*/
+
+static void Faces_create_windows_( Faces*      faces,
+                                   Dimensions  dims_b,
+                                   Env*        env )
+{
+  Assert( Faces_is_face_comm_rma( faces ) );
+
+  int i = 0;
+
+  for( i=0; i<NDIM; ++i )
+  {
+    int axis = 0;
+
+    for( axis=0; axis<NDIM; ++axis )
+    {
+      Env_win_create_P( env,
+        Faces_face_per_octant_( faces, dims_b, axis, i, 0 ),
+        Faces_size_face_per_octant_( faces, dims_b, axis ) *
+                                               faces->noctant_per_block,
+        & faces->win[i][axis] );
+    }
+  }
+}
+
+/*===========================================================================*/
+/*---Free the windows of the one-sided face exchange---*/
+/*---pseudo-private member function---*/
+
+static void Faces_destroy_windows_( Faces* faces,
+                                    Env*   env )
+{
+  Assert( Faces_is_face_comm_rma( faces ) );
+
+  int i = 0;
+
+  for( i=0; i<NDIM; ++i )
+  {
+    int axis = 0;
+
+    for( axis=0; axis<NDIM; ++axis )
+    {
+      Env_win_free( env, & faces->win[i][axis] );
+    }
+  }
+}
+
 /*===========================================================================*/
 /*---Pseudo-constructor for Faces struct---*/
 
@@ -24,19 +357,32 @@ void Faces_create( Faces*      faces,
                    Dimensions  dims_b,
                    int         noctant_per_block,
                    Bool_t      is_face_comm_async,
+                   Bool_t      is_face_comm_rma,
+                   int         face_compression,
+                   int         face_compression_nbit,
                    Env*        env )
 {
   int i = 0;
 
+  Insist( ( is_face_comm_async || ! is_face_comm_rma ) ?
+          "One-sided face communication requires async face communication."
+          : 0 );
+  Insist( ( face_compression == FACECODEC_NONE ||
+            ( is_face_comm_async && ! is_face_comm_rma ) ) ?
+          "Face compression requires async two-sided face communication."
+          : 0 );
+
   faces->noctant_per_block  = noctant_per_block;
   faces->is_face_comm_async = is_face_comm_async;
+  faces->is_face_comm_rma   = is_face_comm_rma;
+  faces->tag                = Env_tag( env );
 
   /*====================*/
   /*---Allocate faces---*/
   /*====================*/
 
   Pointer_create(       Faces_facexy( faces, 0 ),
-    Dimensions_size_facexy( dims_b, NU, noctant_per_block ),
+    Dimensions_size_facexy( dims_b, dims_b.nu, noctant_per_block ),
     Env_cuda_is_using_device( env ) );
   Pointer_set_pinned( Faces_facexy( faces, 0 ), Bool_true );
   Pointer_allocate(     Faces_facexy( faces, 0 ) );
@@ -44,12 +390,12 @@ void Faces_create( Faces*      faces,
   for( i = 0; i < ( Faces_is_face_comm_async( faces ) ? NDIM : 1 ); ++i )
   {
     Pointer_create(       Faces_facexz( faces, i ),
-      Dimensions_size_facexz( dims_b, NU, noctant_per_block ),
+      Dimensions_size_facexz( dims_b, dims_b.nu, noctant_per_block ),
       Env_cuda_is_using_device( env ) );
     Pointer_set_pinned( Faces_facexz( faces, i ), Bool_true );
 
     Pointer_create(       Faces_faceyz( faces, i ),
-      Dimensions_size_faceyz( dims_b, NU, noctant_per_block ),
+      Dimensions_size_faceyz( dims_b, dims_b.nu, noctant_per_block ),
       Env_cuda_is_using_device( env ) );
     Pointer_set_pinned( Faces_faceyz( faces, i ), Bool_true );
   }
@@ -59,15 +405,47 @@ void Faces_create( Faces*      faces,
     Pointer_allocate( Faces_facexz( faces, i ) );
     Pointer_allocate( Faces_faceyz( faces, i ) );
   }
+
+  Faces_create_coded_( faces, dims_b, face_compression,
+                       face_compression_nbit, env );
+
+  /*====================*/
+  /*---Create requests or windows---*/
+  /*====================*/
+
+  if( Faces_is_face_comm_rma( faces ) )
+  {
+    Faces_create_windows_( faces, dims_b, env );
+  }
+  else if( Faces_is_face_comm_async( faces ) )
+  {
+    Faces_create_requests_( faces, dims_b, env );
+  }
 }
 
 /*===========================================================================*/
 /*---Pseudo-destructor for Faces struct---*/
 
-void Faces_destroy( Faces* faces )
+void Faces_destroy( Faces* faces,
+                    Env*   env )
 {
   int i = 0;
 
+  /*====================*/
+  /*---Free requests or windows---*/
+  /*====================*/
+
+  if( Faces_is_face_comm_rma( faces ) )
+  {
+    Faces_destroy_windows_( faces, env );
+  }
+  else if( Faces_is_face_comm_async( faces ) )
+  {
+    Faces_destroy_requests_( faces, env );
+  }
+
+  Faces_destroy_coded_( faces, env );
+
   /*====================*/
   /*---Deallocate faces---*/
   /*====================*/
@@ -80,6 +458,7 @@ void Faces_destroy( Faces* faces )
     Pointer_destroy( Faces_faceyz( faces, i ) );
   }
 }
+
 /*===========================================================================*/
 /*---Communicate faces computed at step, used at step+1---*/
 
@@ -92,18 +471,21 @@ void Faces_communicate_faces(
 {
   Assert( ! Faces_is_face_comm_async( faces ) );
 
-  const int proc_x = Env_proc_x_this( env );
-  const int proc_y = Env_proc_y_this( env );
-
-  const size_t size_facexz_per_octant = Dimensions_size_facexz( dims_b,
-                 NU, faces->noctant_per_block ) / faces->noctant_per_block;
-  const size_t size_faceyz_per_octant = Dimensions_size_faceyz( dims_b,
-                 NU, faces->noctant_per_block ) / faces->noctant_per_block;
+  const int proc_this[NDIM] = { Env_proc_x_this( env ),
+                                Env_proc_y_this( env ),
+                                Env_proc_z_this( env ) };
 
   /*---Allocate temporary face buffers---*/
 
-  P* __restrict__ buf_xz  = malloc_host_P( size_facexz_per_octant );
-  P* __restrict__ buf_yz  = malloc_host_P( size_faceyz_per_octant );
+  P* __restrict__ bufs[NDIM];
+
+  int axis = 0;
+
+  for( axis=0; axis<NDIM; ++axis )
+  {
+    bufs[axis] = malloc_host_P( Faces_size_face_per_octant_( faces, dims_b,
+                                                             axis ) );
+  }
 
   /*---Loop over octants---*/
 
@@ -112,37 +494,22 @@ void Faces_communicate_faces(
   for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
                                                             ++octant_in_block )
   {
-    /*---Communicate +/-X, +/-Y---*/
-
-    int axis = 0;
+    /*---Communicate +/-X, +/-Y, +/-Z---*/
 
-    for( axis=0; axis<2; ++axis )  /*---Loop: X, Y---*/
+    for( axis=0; axis<NDIM; ++axis )  /*---Loop: X, Y, Z---*/
     {
-      const Bool_t axis_x = axis==0;
-      const Bool_t axis_y = axis==1;
-
-      const int proc_axis = axis_x ? proc_x : proc_y;
-
-      const size_t    size_face_per_octant    = axis_x ? size_faceyz_per_octant
-                                                       : size_facexz_per_octant;
-      P* __restrict__ buf                     = axis_x ? buf_yz
-                                                       : buf_xz;
-      P* __restrict__ face_per_octant = axis_x ?
-        ref_faceyz( Pointer_h( Faces_faceyz_step( faces, step ) ),
-                    dims_b, NU, faces->noctant_per_block,
-                    0, 0, 0, 0, 0, octant_in_block ) :
-        ref_facexz( Pointer_h( Faces_facexz_step( faces, step ) ),
-                    dims_b, NU, faces->noctant_per_block,
-                     0, 0, 0, 0, 0, octant_in_block );
+      const int proc_axis = proc_this[axis];
+
+      const size_t    size_face_per_octant = Faces_size_face_per_octant_(
+                                                       faces, dims_b, axis );
+      P* __restrict__ buf                  = bufs[axis];
+      P* __restrict__ face_per_octant      = Faces_face_per_octant_(
+                              faces, dims_b, axis, step, octant_in_block );
 
       int dir_ind = 0;
 
       for( dir_ind=0; dir_ind<2; ++dir_ind ) /*---Loop: up, down---*/
       {
-        const int dir = dir_ind==0 ? DIR_UP*1 : DIR_DN*1;
-        const int inc_x = axis_x ? Dir_inc( dir ) : 0;
-        const int inc_y = axis_y ? Dir_inc( dir ) : 0;
-
         /*---Determine whether to communicate---*/
 
         Bool_t const do_send = StepScheduler_must_do_send(
@@ -166,7 +533,7 @@ void Faces_communicate_faces(
               if( do_send )
               {
                 const int proc_other
-                                 = Env_proc( env, proc_x+inc_x, proc_y+inc_y );
+                         = Faces_proc_other_( axis, dir_ind, Bool_true, env );
                 Env_send_P( env, face_per_octant, size_face_per_octant,
                             proc_other, Env_tag( env )+octant_in_block );
               }
@@ -176,7 +543,7 @@ void Faces_communicate_faces(
               if( do_recv )
               {
                 const int proc_other
-                                 = Env_proc( env, proc_x-inc_x, proc_y-inc_y );
+                        = Faces_proc_other_( axis, dir_ind, Bool_false, env );
                 /*---save copy else color 0 recv will destroy color 1 send---*/
                 copy_vector( buf, face_per_octant, size_face_per_octant );
                 use_buf = Bool_true;
@@ -192,7 +559,7 @@ void Faces_communicate_faces(
               if( do_recv )
               {
                 const int proc_other
-                                 = Env_proc( env, proc_x-inc_x, proc_y-inc_y );
+                        = Faces_proc_other_( axis, dir_ind, Bool_false, env );
                 Env_recv_P( env, face_per_octant, size_face_per_octant,
                             proc_other, Env_tag( env )+octant_in_block );
               }
@@ -202,7 +569,7 @@ void Faces_communicate_faces(
               if( do_send )
               {
                 const int proc_other
-                                 = Env_proc( env, proc_x+inc_x, proc_y+inc_y );
+                         = Faces_proc_other_( axis, dir_ind, Bool_true, env );
                 Env_send_P( env, use_buf ? buf : face_per_octant,
                   size_face_per_octant, proc_other,
                   Env_tag( env )+octant_in_block );
@@ -216,29 +583,33 @@ void Faces_communicate_faces(
 
   /*---Deallocations---*/
 
-  free_host_P( buf_xz );
-  free_host_P( buf_yz );
+  for( axis=0; axis<NDIM; ++axis )
+  {
+    free_host_P( bufs[axis] );
+  }
 }
 
 /*===========================================================================*/
-/*---Asynchronously send faces computed at step, used at step+1: start---*/
+/*---Persistent requests used on a step---*/
+/*---pseudo-private member function---*/
 
-void Faces_send_faces_start(
+/*---Copies into requests the handles of the sends of faces computed at
+     step, or of the receives of faces used at step+1, and returns how
+     many there are---*/
+
+static int Faces_requests_step_(
   Faces*          faces,
   StepScheduler*  stepscheduler,
-  Dimensions      dims_b,
   int             step,
+  Bool_t          is_send,
+  Request_t*      requests,
   Env*            env )
 {
   Assert( Faces_is_face_comm_async( faces ) );
 
-  const int proc_x = Env_proc_x_this( env );
-  const int proc_y = Env_proc_y_this( env );
+  const int i = Faces_buffer_step_( is_send ? step : step+1 );
 
-  const size_t size_facexz_per_octant = Dimensions_size_facexz( dims_b,
-                 NU, faces->noctant_per_block ) / faces->noctant_per_block;
-  const size_t size_faceyz_per_octant = Dimensions_size_faceyz( dims_b,
-                 NU, faces->noctant_per_block ) / faces->noctant_per_block;
+  int nrequest = 0;
 
   /*---Loop over octants---*/
 
@@ -247,237 +618,386 @@ void Faces_send_faces_start(
   for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
                                                             ++octant_in_block )
   {
-    /*---Communicate +/-X, +/-Y---*/
+    /*---Communicate +/-X, +/-Y, +/-Z---*/
 
     int axis = 0;
 
-    for( axis=0; axis<2; ++axis )
+    for( axis=0; axis<NDIM; ++axis )
     {
-      const Bool_t axis_x = axis==0;
-      const Bool_t axis_y = axis==1;
-
-      /*---Send values computed on this step---*/
-
-      const size_t    size_face_per_octant    = axis_x ? size_faceyz_per_octant
-                                                       : size_facexz_per_octant;
-      P* __restrict__ face_per_octant = axis_x ?
-        ref_faceyz( Pointer_h( Faces_faceyz_step( faces, step ) ),
-                    dims_b, NU, faces->noctant_per_block,
-                    0, 0, 0, 0, 0, octant_in_block ) :
-        ref_facexz( Pointer_h( Faces_facexz_step( faces, step ) ),
-                    dims_b, NU, faces->noctant_per_block,
-                    0, 0, 0, 0, 0, octant_in_block );
-
       int dir_ind = 0;
 
       for( dir_ind=0; dir_ind<2; ++dir_ind )
       {
-        const int dir = dir_ind==0 ? DIR_UP*1 : DIR_DN*1;
-        const int inc_x = axis_x ? Dir_inc( dir ) : 0;
-        const int inc_y = axis_y ? Dir_inc( dir ) : 0;
-
         /*---Determine whether to communicate---*/
 
-        Bool_t const do_send = StepScheduler_must_do_send(
+        Bool_t const do_comm = is_send ?
+          StepScheduler_must_do_send(
+                   stepscheduler, step, axis, dir_ind, octant_in_block, env ) :
+          StepScheduler_must_do_recv(
                    stepscheduler, step, axis, dir_ind, octant_in_block, env );
 
-        if( do_send )
+        if( do_comm )
         {
-          const int proc_other = Env_proc( env, proc_x+inc_x, proc_y+inc_y );
-          Request_t* request = axis_x ?
-                                   & faces->request_send_xz[octant_in_block]
-                                 : & faces->request_send_yz[octant_in_block];
-          Env_asend_P( env, face_per_octant, size_face_per_octant,
-                    proc_other, Env_tag( env )+octant_in_block, request );
+          Assert( Faces_proc_other_( axis, dir_ind, is_send, env ) >= 0 );
+          requests[nrequest++] = is_send ?
+            faces->request_send[i][axis][dir_ind][octant_in_block] :
+            faces->request_recv[i][axis][dir_ind][octant_in_block];
         }
       } /*---dir_ind---*/
     } /*---axis---*/
   } /*---octant_in_block---*/
+
+  return nrequest;
 }
 
 /*===========================================================================*/
-/*---Asynchronously send faces computed at step, used at step+1: end---*/
+/*---Procs that faces are put to or got from along an axis on a step---*/
+/*---pseudo-private member function---*/
 
-void Faces_send_faces_end(
+/*---Fills procs with the targets of the puts of faces computed at step,
+     or the origins of the puts of faces used at step+1, and returns how
+     many there are---*/
+
+static int Faces_rma_procs_step_(
   Faces*          faces,
   StepScheduler*  stepscheduler,
-  Dimensions      dims_b,
   int             step,
+  int             axis,
+  Bool_t          is_send,
+  int*            procs,
   Env*            env )
 {
-  Assert( Faces_is_face_comm_async( faces ) );
+  Assert( Faces_is_face_comm_rma( faces ) );
 
-  const int proc_x = Env_proc_x_this( env );
-  const int proc_y = Env_proc_y_this( env );
+  int nproc = 0;
 
-  /*---Loop over octants---*/
+  int dir_ind = 0;
 
-  int octant_in_block = 0;
+  for( dir_ind=0; dir_ind<2; ++dir_ind )
+  {
+    Bool_t do_comm = Bool_false;
 
-  for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
+    int octant_in_block = 0;
+
+    for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
                                                             ++octant_in_block )
-  {
-    /*---Communicate +/-X, +/-Y---*/
+    {
+      do_comm = do_comm || ( is_send ?
+        StepScheduler_must_do_send(
+                   stepscheduler, step, axis, dir_ind, octant_in_block, env ) :
+        StepScheduler_must_do_recv(
+                   stepscheduler, step, axis, dir_ind, octant_in_block, env ) );
+    }
+
+    if( do_comm )
+    {
+      procs[nproc++] = Faces_proc_other_( axis, dir_ind, is_send, env );
+    }
+  }
 
-    int axis = 0;
+  return nproc;
+}
+
+/*===========================================================================*/
+/*---Put faces computed at step into the procs that use them at step+1---*/
+/*---pseudo-private member function---*/
+
+/*---The access epoch is opened and closed here, so that a target's wait
+     for step depends only on this proc reaching the end of step.  The
+     start returns at once when the target has already posted, which it
+     does before computing the step---*/
+
+static void Faces_rma_put_faces_(
+  Faces*          faces,
+  StepScheduler*  stepscheduler,
+  Dimensions      dims_b,
+  int             step,
+  Env*            env )
+{
+  const int i = Faces_buffer_step_( step+1 );
 
-    for( axis=0; axis<2; ++axis )
+  int axis = 0;
+
+  for( axis=0; axis<NDIM; ++axis )
+  {
+    int procs[2];
+
+    const int nproc = Faces_rma_procs_step_( faces, stepscheduler, step,
+                                             axis, Bool_true, procs, env );
+    if( nproc == 0 )
     {
-      const Bool_t axis_x = axis==0;
+      continue;
+    }
 
-      int dir_ind = 0;
+    const size_t size_face_per_octant = Faces_size_face_per_octant_(
+                                                       faces, dims_b, axis );
 
-      for( dir_ind=0; dir_ind<2; ++dir_ind )
-      {
+    Env_win_start( env, nproc, procs, faces->win[i][axis] );
 
-        /*---Determine whether to communicate---*/
+    int octant_in_block = 0;
 
-        Bool_t const do_send = StepScheduler_must_do_send(
-                   stepscheduler, step, axis, dir_ind, octant_in_block, env );
+    for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
+                                                            ++octant_in_block )
+    {
+      int dir_ind = 0;
 
-        if( do_send )
+      for( dir_ind=0; dir_ind<2; ++dir_ind )
+      {
+        if( StepScheduler_must_do_send(
+                   stepscheduler, step, axis, dir_ind, octant_in_block, env ) )
         {
-          Request_t* request = axis_x ?
-                                   & faces->request_send_xz[octant_in_block]
-                                 : & faces->request_send_yz[octant_in_block];
-          Env_wait( env, request );
+          Env_put_P( env, Faces_face_per_octant_( faces, dims_b, axis, step,
+                                                  octant_in_block ),
+                     size_face_per_octant,
+                     Faces_proc_other_( axis, dir_ind, Bool_true, env ),
+                     size_face_per_octant * octant_in_block,
+                     faces->win[i][axis] );
         }
       } /*---dir_ind---*/
-    } /*---axis---*/
-  } /*---octant_in_block---*/
+    } /*---octant_in_block---*/
+
+    Env_win_complete( env, faces->win[i][axis] );
+  } /*---axis---*/
 }
 
 /*===========================================================================*/
-/*---Asynchronously recv faces computed at step, used at step+1: start---*/
+/*---Expose, or finish exposing, the faces used at step+1---*/
+/*---pseudo-private member function---*/
 
-void Faces_recv_faces_start(
+static void Faces_rma_expose_faces_(
   Faces*          faces,
   StepScheduler*  stepscheduler,
-  Dimensions      dims_b,
   int             step,
+  Bool_t          is_start,
   Env*            env )
 {
-  Assert( Faces_is_face_comm_async( faces ) );
+  const int i = Faces_buffer_step_( step+1 );
 
-  const int proc_x = Env_proc_x_this( env );
-  const int proc_y = Env_proc_y_this( env );
+  int axis = 0;
 
-  const size_t size_facexz_per_octant = Dimensions_size_facexz( dims_b,
-                 NU, faces->noctant_per_block ) / faces->noctant_per_block;
-  const size_t size_faceyz_per_octant = Dimensions_size_faceyz( dims_b,
-                 NU, faces->noctant_per_block ) / faces->noctant_per_block;
+  for( axis=0; axis<NDIM; ++axis )
+  {
+    int procs[2];
 
-  /*---Loop over octants---*/
+    const int nproc = Faces_rma_procs_step_( faces, stepscheduler, step,
+                                             axis, Bool_false, procs, env );
+    if( nproc == 0 )
+    {
+      continue;
+    }
+
+    if( is_start )
+    {
+      Env_win_post( env, nproc, procs, faces->win[i][axis] );
+    }
+    else
+    {
+      Env_win_wait( env, faces->win[i][axis] );
+    }
+  } /*---axis---*/
+}
+
+/*===========================================================================*/
+/*---Encode and send the faces computed at step---*/
+/*---pseudo-private member function---*/
+
+static void Faces_send_coded_faces_(
+  Faces*          faces,
+  StepScheduler*  stepscheduler,
+  Dimensions      dims_b,
+  int             step,
+  Env*            env )
+{
+  Assert( Faces_is_face_compressed( faces ) );
+
+  const int i = Faces_buffer_step_( step );
 
   int octant_in_block = 0;
 
   for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
                                                             ++octant_in_block )
   {
-    /*---Communicate +/-X, +/-Y---*/
-
     int axis = 0;
 
-    for( axis=0; axis<2; ++axis )
+    for( axis=0; axis<NDIM; ++axis )
     {
-      const Bool_t axis_x = axis==0;
-      const Bool_t axis_y = axis==1;
-
-      /*---Receive values computed on the next step---*/
-
-      const size_t    size_face_per_octant    = axis_x ? size_faceyz_per_octant
-                                                       : size_facexz_per_octant;
-      P* __restrict__ face_per_octant = axis_x ?
-        ref_faceyz( Pointer_h( Faces_faceyz_step( faces, step+1 ) ),
-                    dims_b, NU, faces->noctant_per_block,
-                    0, 0, 0, 0, 0, octant_in_block ) :
-        ref_facexz( Pointer_h( Faces_facexz_step( faces, step+1 ) ),
-                    dims_b, NU, faces->noctant_per_block,
-                    0, 0, 0, 0, 0, octant_in_block );
-
       int dir_ind = 0;
 
       for( dir_ind=0; dir_ind<2; ++dir_ind )
       {
-        const int dir = dir_ind==0 ? DIR_UP*1 : DIR_DN*1;
-        const int inc_x = axis_x ? Dir_inc( dir ) : 0;
-        const int inc_y = axis_y ? Dir_inc( dir ) : 0;
+        if( ! StepScheduler_must_do_send(
+                   stepscheduler, step, axis, dir_ind, octant_in_block, env ) )
+        {
+          continue;
+        }
 
-        /*---Determine whether to communicate---*/
+        P* const face_coded =
+                    faces->face_coded_send[axis][dir_ind][octant_in_block];
 
-        Bool_t const do_recv = StepScheduler_must_do_recv(
-                   stepscheduler, step, axis, dir_ind, octant_in_block, env );
+        const size_t size_coded = FaceCodec_encode( & faces->codec,
+          face_coded,
+          Faces_face_per_octant_( faces, dims_b, axis, step, octant_in_block ),
+          Faces_size_face_per_octant_( faces, dims_b, axis ), env );
 
-        if( do_recv )
-        {
-          const int proc_other = Env_proc( env, proc_x-inc_x, proc_y-inc_y );
-          Request_t* request = axis_x ?
-                                   & faces->request_recv_xz[octant_in_block]
-                                 : & faces->request_recv_yz[octant_in_block];
-          Env_arecv_P( env, face_per_octant, size_face_per_octant,
-                    proc_other, Env_tag( env )+octant_in_block, request );
-        }
+        Env_asend_P( env, face_coded, size_coded,
+          Faces_proc_other_( axis, dir_ind, Bool_true, env ),
+          faces->tag+octant_in_block,
+          & faces->request_send[i][axis][dir_ind][octant_in_block] );
       } /*---dir_ind---*/
     } /*---axis---*/
   } /*---octant_in_block---*/
 }
 
 /*===========================================================================*/
-/*---Asynchronously recv faces computed at step, used at step+1: end---*/
+/*---Decode the received faces used at step+1---*/
+/*---pseudo-private member function---*/
 
-void Faces_recv_faces_end(
+static void Faces_decode_faces_(
   Faces*          faces,
   StepScheduler*  stepscheduler,
   Dimensions      dims_b,
   int             step,
   Env*            env )
 {
-  Assert( Faces_is_face_comm_async( faces ) );
-
-  const int proc_x = Env_proc_x_this( env );
-  const int proc_y = Env_proc_y_this( env );
-
-  const size_t size_facexz_per_octant = Dimensions_size_facexz( dims_b,
-                 NU, faces->noctant_per_block ) / faces->noctant_per_block;
-  const size_t size_faceyz_per_octant = Dimensions_size_faceyz( dims_b,
-                 NU, faces->noctant_per_block ) / faces->noctant_per_block;
-
-  /*---Loop over octants---*/
+  Assert( Faces_is_face_compressed( faces ) );
 
   int octant_in_block = 0;
 
   for( octant_in_block=0; octant_in_block<faces->noctant_per_block;
                                                             ++octant_in_block )
   {
-    /*---Communicate +/-X, +/-Y---*/
-
     int axis = 0;
 
-    for( axis=0; axis<2; ++axis )
+    for( axis=0; axis<NDIM; ++axis )
     {
-      const Bool_t axis_x = axis==0;
-
       int dir_ind = 0;
 
       for( dir_ind=0; dir_ind<2; ++dir_ind )
       {
-        /*---Determine whether to communicate---*/
-
-        Bool_t const do_recv = StepScheduler_must_do_recv(
-                   stepscheduler, step, axis, dir_ind, octant_in_block, env );
-
-        if( do_recv )
+        if( StepScheduler_must_do_recv(
+                   stepscheduler, step, axis, dir_ind, octant_in_block, env ) )
         {
-          Request_t* request = axis_x ?
-                                   & faces->request_recv_xz[octant_in_block]
-                                 : & faces->request_recv_yz[octant_in_block];
-          Env_wait( env, request );
+          FaceCodec_decode( & faces->codec,
+            Faces_face_per_octant_( faces, dims_b, axis, step+1,
+                                    octant_in_block ),
+            faces->face_coded_recv[axis][dir_ind][octant_in_block],
+            Faces_size_face_per_octant_( faces, dims_b, axis ), env );
         }
       } /*---dir_ind---*/
     } /*---axis---*/
   } /*---octant_in_block---*/
 }
 
+/*===========================================================================*/
+/*---Asynchronously send faces computed at step, used at step+1: start---*/
+
+void Faces_send_faces_start(
+  Faces*          faces,
+  StepScheduler*  stepscheduler,
+  Dimensions      dims_b,
+  int             step,
+  Env*            env )
+{
+  if( Faces_is_face_comm_rma( faces ) )
+  {
+    Faces_rma_put_faces_( faces, stepscheduler, dims_b, step, env );
+    return;
+  }
+
+  if( Faces_is_face_compressed( faces ) )
+  {
+    Faces_send_coded_faces_( faces, stepscheduler, dims_b, step, env );
+  }
+
+  Request_t requests[NDIM*2*NOCTANT];
+
+  const int nrequest = Faces_requests_step_( faces, stepscheduler, step,
+                                             Bool_true, requests, env );
+  if( ! Faces_is_face_compressed( faces ) )
+  {
+    Env_startall( env, nrequest, requests );
+  }
+  Env_progress_add( env, nrequest, requests );
+}
+
+/*===========================================================================*/
+/*---Asynchronously send faces computed at step, used at step+1: end---*/
+
+void Faces_send_faces_end(
+  Faces*          faces,
+  StepScheduler*  stepscheduler,
+  Dimensions      dims_b,
+  int             step,
+  Env*            env )
+{
+  /*---One-sided puts are complete when put---*/
+
+  if( Faces_is_face_comm_rma( faces ) )
+  {
+    return;
+  }
+
+  Request_t requests[NDIM*2*NOCTANT];
+
+  const int nrequest = Faces_requests_step_( faces, stepscheduler, step,
+                                             Bool_true, requests, env );
+  Env_progress_remove( env, nrequest, requests );
+  Env_waitall( env, nrequest, requests );
+}
+
+/*===========================================================================*/
+/*---Asynchronously recv faces computed at step, used at step+1: start---*/
+
+void Faces_recv_faces_start(
+  Faces*          faces,
+  StepScheduler*  stepscheduler,
+  Dimensions      dims_b,
+  int             step,
+  Env*            env )
+{
+  if( Faces_is_face_comm_rma( faces ) )
+  {
+    Faces_rma_expose_faces_( faces, stepscheduler, step, Bool_true, env );
+    return;
+  }
+
+  Request_t requests[NDIM*2*NOCTANT];
+
+  const int nrequest = Faces_requests_step_( faces, stepscheduler, step,
+                                             Bool_false, requests, env );
+  Env_startall( env, nrequest, requests );
+  Env_progress_add( env, nrequest, requests );
+}
+
+/*===========================================================================*/
+/*---Asynchronously recv faces computed at step, used at step+1: end---*/
+
+void Faces_recv_faces_end(
+  Faces*          faces,
+  StepScheduler*  stepscheduler,
+  Dimensions      dims_b,
+  int             step,
+  Env*            env )
+{
+  if( Faces_is_face_comm_rma( faces ) )
+  {
+    Faces_rma_expose_faces_( faces, stepscheduler, step, Bool_false, env );
+    return;
+  }
+
+  Request_t requests[NDIM*2*NOCTANT];
+
+  const int nrequest = Faces_requests_step_( faces, stepscheduler, step,
+                                             Bool_false, requests, env );
+  Env_progress_remove( env, nrequest, requests );
+  Env_waitall( env, nrequest, requests );
+
+  if( Faces_is_face_compressed( faces ) )
+  {
+    Faces_decode_faces_( faces, stepscheduler, dims_b, step, env );
+  }
+}
+
 /*===========================================================================*/
 
 #ifdef __cplusplus
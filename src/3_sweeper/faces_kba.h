@@ -17,6 +17,7 @@
 #include "dimensions.h"
 #include "quantities.h"
 #include "stepscheduler_kba.h"
+#include "facecodec.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -38,14 +39,26 @@ typedef struct
   Pointer          faceyz1;
   Pointer          faceyz2;
 
-  Request_t        request_send_xz[NOCTANT];
-  Request_t        request_send_yz[NOCTANT];
-  Request_t        request_recv_xz[NOCTANT];
-  Request_t        request_recv_yz[NOCTANT];
+  /*---Persistent requests, by xz/yz face buffer, axis, direction and
+       octant in block, async case---*/
+  Request_t        request_send[NDIM][NDIM][2][NOCTANT];
+  Request_t        request_recv[NDIM][NDIM][2][NOCTANT];
+
+  /*---Windows exposing the face to be received, by xz/yz face buffer
+       and axis, one-sided case---*/
+  Win_t            win[NDIM][NDIM];
+
+  /*---Encoded faces, by axis, direction and octant in block, and the
+       codec, compressed case---*/
+  P*               face_coded_send[NDIM][2][NOCTANT];
+  P*               face_coded_recv[NDIM][2][NOCTANT];
+  FaceCodec        codec;
 
   int              noctant_per_block;
+  int              tag;
 
   Bool_t           is_face_comm_async;
+  Bool_t           is_face_comm_rma;
 } Faces;
 
 /*===========================================================================*/
@@ -55,12 +68,16 @@ void Faces_create( Faces*      faces,
                    Dimensions  dims_b,
                    int         noctant_per_block,
                    Bool_t      is_face_comm_async,
+                   Bool_t      is_face_comm_rma,
+                   int         face_compression,
+                   int         face_compression_nbit,
                    Env*        env );
 
 /*===========================================================================*/
 /*---Pseudo-destructor for Faces struct---*/
 
-void Faces_destroy( Faces* faces );
+void Faces_destroy( Faces* faces,
+                    Env*   env );
 
 /*===========================================================================*/
 /*---Is face communication done asynchronously---*/
@@ -70,6 +87,29 @@ static int Faces_is_face_comm_async( Faces* faces )
   return faces->is_face_comm_async;
 }
 
+/*===========================================================================*/
+/*---Are async faces delivered by one-sided puts---*/
+
+static int Faces_is_face_comm_rma( Faces* faces )
+{
+  return faces->is_face_comm_rma;
+}
+
+/*===========================================================================*/
+/*---Are async faces compressed before sending---*/
+
+static int Faces_is_face_compressed( Faces* faces )
+{
+  return FaceCodec_is_active( & faces->codec );
+}
+
+/*---------------------------------------------------------------------------*/
+
+static const FaceCodec* Faces_codec( const Faces* faces )
+{
+  return & faces->codec;
+}
+
 /*===========================================================================*/
 /*---Selectors for faces---*/
 
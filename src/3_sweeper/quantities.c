@@ -8,7 +8,11 @@
  */
 /*---------------------------------------------------------------------------*/
 
+#ifdef USE_QUANTITIES_DD
+#include "quantities_dd_c.h"
+#else
 #include "quantities_testing_c.h"
+#endif
 
 /*---------------------------------------------------------------------------*/
 
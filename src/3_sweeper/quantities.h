@@ -11,7 +11,13 @@
 #ifndef _quantities_h_
 #define _quantities_h_
 
+#include "quantities_kernels.h"
+
+#ifdef USE_QUANTITIES_DD
+#include "quantities_dd.h"
+#else
 #include "quantities_testing.h"
+#endif
 
 #endif /*---_quantities_h_---*/
 
@@ -0,0 +1,106 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   quantities_dd.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Declarations for physical quantities, diamond difference case.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#ifndef _quantities_dd_h_
+#define _quantities_dd_h_
+
+#include "types.h"
+#include "dimensions.h"
+
+#include "quantities_dd_kernels.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Pseudo-constructor for Quantities struct---*/
+
+void Quantities_create( Quantities*       quan,
+                        const Dimensions  dims,
+                        Env*              env );
+
+/*===========================================================================*/
+/*---Pseudo-destructor for Quantities struct---*/
+
+void Quantities_destroy( Quantities* quan );
+
+/*===========================================================================*/
+/*---Initialize Quantities a_from_m, m_from_a matrices---*/
+/*---pseudo-private member function---*/
+
+void Quantities_init_am_matrices_( Quantities*       quan,
+                                   const Dimensions  dims,
+                                   Env*              env );
+
+/*===========================================================================*/
+/*---Initialize Quantities subgrid decomp info---*/
+/*---pseudo-private member function---*/
+
+void Quantities_init_decomp_( Quantities*       quan,
+                              const Dimensions  dims,
+                              Env*              env );
+
+/*===========================================================================*/
+/*---Initialize Quantities material and coefficient tables---*/
+/*---pseudo-private member function---*/
+
+void Quantities_init_tables_( Quantities*       quan,
+                              const Dimensions  dims,
+                              Env*              env );
+
+/*===========================================================================*/
+/*---Flops cost of solve per element---*/
+
+double Quantities_flops_per_solve( const Dimensions dims );
+
+/*===========================================================================*/
+/*---Initial values for state vector---*/
+
+/*---The input state vector is the source, in moments: a fixed source in
+     the fuel plus a weaker, scattering-like source everywhere, falling
+     off with moment number---*/
+
+static inline P Quantities_init_state(
+  const Quantities*  quan,
+  int                ix,
+  int                iy,
+  int                iz,
+  int                ie,
+  int                im,
+  int                iu,
+  const Dimensions   dims )
+{
+  Assert( ix >= 0 && ix < dims.ncell_x);
+  Assert( iy >= 0 && iy < dims.ncell_y );
+  Assert( iz >= 0 && iz < dims.ncell_z );
+  Assert( ie >= 0 && ie < dims.ne );
+  Assert( im >= 0 && im < dims.nm );
+  Assert( iu >= 0 && iu < dims.nu );
+
+  const int material = quan->material_vals[ Quantities_ind_material_( quan,
+                               ix+quan->ix_base, iy+quan->iy_base,
+                               iz+quan->iz_base ) ];
+
+  const PAccum source = material == QUANTITIES_MATERIAL_FUEL ? 1 : .1;
+
+  return (P)( source / ( ( 1 + ie ) * ( 1 + im ) * ( 1 + iu ) ) );
+}
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_quantities_dd_h_---*/
+
+/*---------------------------------------------------------------------------*/
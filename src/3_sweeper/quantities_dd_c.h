@@ -0,0 +1,272 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   quantities_dd_c.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Definitions for physical quantities, diamond difference case.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#ifndef _quantities_dd_c_h_
+#define _quantities_dd_c_h_
+
+#include <math.h>
+
+#include "env.h"
+#include "dimensions.h"
+#include "array_accessors.h"
+#include "pointer.h"
+#include "quantities_dd.h"
+#include "quantities_decomp_c.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Pseudo-constructor for Quantities struct---*/
+
+void Quantities_create( Quantities*       quan,
+                        const Dimensions  dims,
+                        Env*              env )
+{
+  Quantities_init_am_matrices_( quan, dims, env );
+  Quantities_init_decomp_( quan, dims, env );
+  Quantities_init_tables_( quan, dims, env );
+
+} /*---Quantities_create---*/
+
+/*===========================================================================*/
+/*---Real spherical harmonic for moment im at a direction---*/
+
+/*---Moment im is degree l, order k = im - l*l - l in -l .. l.  Schmidt
+     seminormalized, so the average over the sphere of the square is
+     1 / ( 2 l + 1 )---*/
+
+static double Quantities_harmonic_( int im, double mu, double eta, double xi )
+{
+  int l = 0;
+  int i = 0;
+
+  while( ( l + 1 ) * ( l + 1 ) <= im )
+  {
+    ++l;
+  }
+
+  const int k = im - l * l - l;
+  const int kk = k >= 0 ? k : -k;
+  const double s = sqrt( 1 - xi * xi );
+
+  /*---Associated Legendre function P_l^kk( xi ), by upward recurrence---*/
+
+  double p_lm1 = 1;
+  for( i=1; i<=kk; ++i )
+  {
+    p_lm1 *= ( 2 * i - 1 ) * s;
+  }
+
+  double p_l = xi * ( 2 * kk + 1 ) * p_lm1;
+  double p = l == kk ? p_lm1 : p_l;
+
+  for( i=kk+2; i<=l; ++i )
+  {
+    p = ( ( 2 * i - 1 ) * xi * p_l - ( i + kk - 1 ) * p_lm1 ) / ( i - kk );
+    p_lm1 = p_l;
+    p_l = p;
+  }
+
+  /*---Normalization sqrt( 2 ( l - kk )! / ( l + kk )! ) for kk > 0---*/
+
+  double ratio = 1;
+  for( i=l-kk+1; i<=l+kk; ++i )
+  {
+    ratio /= i;
+  }
+
+  const double phi = atan2( eta, mu );
+
+  return k == 0 ? p :
+         k >  0 ? sqrt( 2 * ratio ) * p * cos( kk * phi ) :
+                  sqrt( 2 * ratio ) * p * sin( kk * phi );
+}
+
+/*===========================================================================*/
+/*---Initialize Quantities a_from_m, m_from_a matrices---*/
+
+void Quantities_init_am_matrices_( Quantities*       quan,
+                                   const Dimensions  dims,
+                                   Env*              env )
+{
+  /*---Declarations---*/
+
+  int im     = 0;
+  int ia     = 0;
+  int octant = 0;
+
+  /*---Allocate arrays---*/
+
+  Pointer_create( & quan->a_from_m, dims.nm * dims.na * NOCTANT,
+                                             Env_cuda_is_using_device( env ) );
+  Pointer_create( & quan->m_from_a, dims.nm * dims.na * NOCTANT,
+                                             Env_cuda_is_using_device( env ) );
+
+  Pointer_allocate( & quan->a_from_m );
+  Pointer_allocate( & quan->m_from_a );
+
+  /*---a_from_m evaluates the expansion in harmonics at each direction;
+       m_from_a takes the moments by quadrature---*/
+
+  for( octant=0; octant<NOCTANT; ++octant )
+  for( ia=0;     ia<dims.na;     ++ia )
+  {
+    const double mu  = Dir_x( octant ) * Quantities_direction_( dims, ia, 0 );
+    const double eta = Dir_y( octant ) * Quantities_direction_( dims, ia, 1 );
+    const double xi  = Dir_z( octant ) * Quantities_direction_( dims, ia, 2 );
+    const double weight = 1. / ( NOCTANT * dims.na );
+
+    for( im=0; im<dims.nm; ++im )
+    {
+      const double harmonic = Quantities_harmonic_( im, mu, eta, xi );
+      const int l = (int)floor( sqrt( im + .5 ) );
+
+      *ref_a_from_m( Pointer_h( & quan->a_from_m ), dims, im, ia, octant )
+                                             = (P)( ( 2 * l + 1 ) * harmonic );
+      *ref_m_from_a( Pointer_h( & quan->m_from_a ), dims, im, ia, octant )
+                                             = (P)( weight * harmonic );
+    }
+  }
+
+  Pointer_update_d( & quan->a_from_m );
+  Pointer_update_d( & quan->m_from_a );
+
+} /*---Quantities_init_am_matrices_---*/
+
+/*===========================================================================*/
+/*---Initialize Quantities material and coefficient tables---*/
+
+/*---The kernel then needs only loads, no transcendentals, to get the
+     coefficients of the solve.  Requires ix_base, iy_base, iz_base to
+     have been set---*/
+
+void Quantities_init_tables_( Quantities*       quan,
+                              const Dimensions  dims,
+                              Env*              env )
+{
+  /*---Declarations---*/
+
+  enum{ NCOEFS_PER_LINE = 64 / sizeof(PAccum) };
+
+  int material = 0;
+  int ie       = 0;
+  int ia       = 0;
+  int ix       = 0;
+  int iy       = 0;
+  int iz       = 0;
+
+  /*---Table sizes, rounded up to whole cache lines---*/
+
+  const size_t ndircoef_vals = iceil( NDIM * dims.na, NCOEFS_PER_LINE )
+                                                         * NCOEFS_PER_LINE;
+  const size_t nsigma_t_vals = QUANTITIES_NMATERIAL * (size_t)dims.ne;
+
+  /*---Allocate arrays; one extra line to allow alignment---*/
+
+  quan->coefs_host_ = malloc_host_PAccum( ndircoef_vals + nsigma_t_vals +
+                                          NCOEFS_PER_LINE );
+
+  quan->dircoef_vals = quan->coefs_host_ +
+    ( NCOEFS_PER_LINE - ( (size_t)quan->coefs_host_ / sizeof(PAccum) )
+                                       % NCOEFS_PER_LINE ) % NCOEFS_PER_LINE;
+  quan->sigma_t_vals = quan->dircoef_vals + ndircoef_vals;
+
+  quan->material_vals = malloc_host_int( dims.ncell_x * (size_t)dims.ncell_y
+                                                      * dims.ncell_z );
+  quan->ncell_x_material = dims.ncell_x;
+  quan->ncell_y_material = dims.ncell_y;
+  quan->ncell_z_material = dims.ncell_z;
+
+  /*---Streaming coefficients, x then y then z, each indexed by angle---*/
+
+  for( ia=0; ia<dims.na; ++ia )
+  {
+    quan->dircoef_vals[ ia + 0 * dims.na ] = Quantities_dircoef_( dims, ia, 0 );
+    quan->dircoef_vals[ ia + 1 * dims.na ] = Quantities_dircoef_( dims, ia, 1 );
+    quan->dircoef_vals[ ia + 2 * dims.na ] = Quantities_dircoef_( dims, ia, 2 );
+  }
+
+  /*---Cross sections, indexed by group then material---*/
+
+  for( material=0; material<QUANTITIES_NMATERIAL; ++material )
+  for( ie=0; ie<dims.ne; ++ie )
+  {
+    quan->sigma_t_vals[ ie + dims.ne * material ]
+                                   = Quantities_sigma_t_( material, ie, dims );
+  }
+
+  /*---Material of each cell of this proc---*/
+
+  for( iz=0; iz<dims.ncell_z; ++iz )
+  for( iy=0; iy<dims.ncell_y; ++iy )
+  for( ix=0; ix<dims.ncell_x; ++ix )
+  {
+    const int ix_g = ix + quan->ix_base;
+    const int iy_g = iy + quan->iy_base;
+    const int iz_g = iz + quan->iz_base;
+    quan->material_vals[ Quantities_ind_material_( quan, ix_g, iy_g, iz_g ) ]
+                = Quantities_material_( ix_g, iy_g, iz_g, quan->ncell_z_g );
+  }
+
+} /*---Quantities_init_tables_---*/
+
+/*===========================================================================*/
+/*---Pseudo-destructor for Quantities struct---*/
+
+void Quantities_destroy( Quantities* quan )
+{
+  /*---Deallocate arrays---*/
+
+  Pointer_destroy( & quan->a_from_m );
+  Pointer_destroy( & quan->m_from_a );
+
+  free_host_int( quan->ix_base_vals );
+  free_host_int( quan->iy_base_vals );
+  free_host_int( quan->iz_base_vals );
+
+  quan->ix_base_vals = NULL;
+  quan->iy_base_vals = NULL;
+  quan->iz_base_vals = NULL;
+
+  free_host_PAccum( quan->coefs_host_ );
+  free_host_int( quan->material_vals );
+
+  quan->coefs_host_   = NULL;
+  quan->dircoef_vals  = NULL;
+  quan->sigma_t_vals  = NULL;
+  quan->material_vals = NULL;
+
+} /*---Quantities_destroy---*/
+
+/*===========================================================================*/
+/*---Flops cost of solve per element---*/
+
+/*---Per angle and unknown: 3 multiplies and 3 adds for the numerator,
+     1 multiply by the reciprocal denominator, 1 add for 2 psi and 3
+     subtracts for the closure.  The denominator, 3 adds and a divide,
+     is shared by the unknowns---*/
+
+double Quantities_flops_per_solve( const Dimensions dims )
+{
+  return 11. + 4. / dims.nu;
+}
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_quantities_dd_c_h_---*/
+
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,789 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   quantities_dd_kernels.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  quantities_dd, code for comp. kernel.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#ifndef _quantities_dd_kernels_h_
+#define _quantities_dd_kernels_h_
+
+#include <math.h>
+
+#include "types_kernels.h"
+#include "simd_kernels.h"
+#include "dimensions_kernels.h"
+#include "array_accessors_kernels.h"
+#include "pointer_kernels.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*=============================================================================
+
+Diamond-difference physics, for benchmarking.
+
+Each cell has a material and each (material, energy group) a total cross
+section sigma_t.  Cell widths are one unit, so sigma_t is also the optical
+thickness of the cell.  Angle ia of an octant has direction cosines
+(mu, eta, xi), the same for every octant up to sign, from an equal-area
+quadrature on the sphere with equal weights 1 / ( NOCTANT * na ).
+
+With cx = 2 |mu|, cy = 2 |eta|, cz = 2 |xi| the cell solve is
+
+  psi = ( q + cx psi_yz + cy psi_xz + cz psi_xy ) / ( sigma_t + cx + cy + cz )
+
+where q is the angular source from the moments-to-angles transform and
+psi_* the incoming face fluxes, followed by the diamond-difference closure
+psi_out = 2 psi - psi_in on each face.  The transforms are built from real
+spherical harmonics.  Boundaries are vacuum.
+
+=============================================================================*/
+
+/*===========================================================================*/
+/*---Type of boundary conditions---*/
+
+TARGET_HD static inline Bool_t Quantities_bc_vacuum()
+{
+  return Bool_true;
+}
+
+/*===========================================================================*/
+/*---Materials---*/
+
+enum{ QUANTITIES_MATERIAL_FUEL      = 0 };
+enum{ QUANTITIES_MATERIAL_ABSORBER  = 1 };
+enum{ QUANTITIES_MATERIAL_MODERATOR = 2 };
+enum{ QUANTITIES_MATERIAL_REFLECTOR = 3 };
+enum{ QUANTITIES_NMATERIAL          = 4 };
+
+/*===========================================================================*/
+/*---Struct to hold pointers to arrays associated with physical quantities---*/
+
+typedef struct
+{
+  Pointer  a_from_m;
+  Pointer  m_from_a;
+  int*     ix_base_vals;
+  int*     iy_base_vals;
+  int*     iz_base_vals;
+  int      ix_base;
+  int      iy_base;
+  int      iz_base;
+  int      ncell_x_g;
+  int      ncell_y_g;
+  int      ncell_z_g;
+
+  /*---Coefficient tables of the solve, host; see Quantities_init_tables_---*/
+  PAccum*  coefs_host_;
+  PAccum*  dircoef_vals;
+  PAccum*  sigma_t_vals;
+  int*     material_vals;
+  int      ncell_x_material;
+  int      ncell_y_material;
+  int      ncell_z_material;
+} Quantities;
+
+/*===========================================================================*/
+/*---Material of a cell: a lattice of 2x2-cell pins on a 4-cell pitch,
+     in moderator, with a reflector layer at top and bottom---*/
+/*---pseudo-private member function---*/
+
+TARGET_HD static inline int Quantities_material_( int ix_g,
+                                                  int iy_g,
+                                                  int iz_g,
+                                                  int ncell_z_g )
+{
+  Assert( ix_g >= 0 && iy_g >= 0 );
+  Assert( iz_g >= 0 && iz_g < ncell_z_g );
+
+  const int px = ix_g % 4;
+  const int py = iy_g % 4;
+  const Bool_t is_pin = ( px == 1 || px == 2 ) && ( py == 1 || py == 2 );
+
+  return is_pin ? ( ( ix_g / 4 + 2 * ( iy_g / 4 ) ) % 3 == 2
+                    ? QUANTITIES_MATERIAL_ABSORBER
+                    : QUANTITIES_MATERIAL_FUEL ) :
+         iz_g == 0 || iz_g == ncell_z_g - 1
+                    ? QUANTITIES_MATERIAL_REFLECTOR
+                    : QUANTITIES_MATERIAL_MODERATOR;
+}
+
+/*===========================================================================*/
+/*---Total cross section of a material for an energy group---*/
+/*---pseudo-private member function---*/
+
+TARGET_HD static inline PAccum Quantities_sigma_t_( int material,
+                                                    int ie,
+                                                    Dimensions dims )
+{
+  Assert( material >= 0 && material < QUANTITIES_NMATERIAL );
+  Assert( ie >= 0 && ie < dims.ne );
+
+  /*---Rises from fast to thermal groups---*/
+
+  const PAccum sigma_t_base =
+      material == QUANTITIES_MATERIAL_FUEL      ? (PAccum) 0.6 :
+      material == QUANTITIES_MATERIAL_ABSORBER  ? (PAccum) 2.5 :
+      material == QUANTITIES_MATERIAL_MODERATOR ? (PAccum) 1.2 :
+                                                  (PAccum) 0.9;
+
+  return sigma_t_base * ( 1 + ( 2 * ie ) / (PAccum) dims.ne );
+}
+
+/*===========================================================================*/
+/*---Absolute value of direction cosine of an angle along an axis---*/
+/*---pseudo-private member function---*/
+
+TARGET_HD static inline PAccum Quantities_direction_( Dimensions dims,
+                                                      int ia,
+                                                      int axis )
+{
+  Assert( ia >= 0 && ia < dims.na );
+  Assert( axis >= 0 && axis < NDIM );
+
+  /*---Equally spaced in xi, which gives equal-area cells on the sphere,
+       with azimuth from the golden-ratio sequence---*/
+
+  const double pi_2 = 1.57079632679489661923;
+  const double golden_r = 0.61803398874989484820;
+
+  const double xi = ( ia + .5 ) / dims.na;
+  const double t = ( ia + .5 ) * golden_r;
+  const double phi = pi_2 * ( t - floor( t ) );
+  const double r = sqrt( 1 - xi * xi );
+
+  return (PAccum)( axis == 0 ? r * cos( phi ) :
+                   axis == 1 ? r * sin( phi ) : xi );
+}
+
+/*===========================================================================*/
+/*---Streaming coefficient 2 |cosine| / width of an angle along an axis---*/
+/*---pseudo-private member function---*/
+
+TARGET_HD static inline PAccum Quantities_dircoef_( Dimensions dims,
+                                                    int ia,
+                                                    int axis )
+{
+  return 2 * Quantities_direction_( dims, ia, axis );
+}
+
+/*===========================================================================*/
+/*---Index into material_vals of a cell---*/
+/*---pseudo-private member function---*/
+
+TARGET_HD static inline int Quantities_ind_material_( const Quantities* quan,
+                                                      int ix_g,
+                                                      int iy_g,
+                                                      int iz_g )
+{
+  Assert( ix_g - quan->ix_base >= 0 &&
+          ix_g - quan->ix_base < quan->ncell_x_material );
+  Assert( iy_g - quan->iy_base >= 0 &&
+          iy_g - quan->iy_base < quan->ncell_y_material );
+  Assert( iz_g - quan->iz_base >= 0 &&
+          iz_g - quan->iz_base < quan->ncell_z_material );
+
+  return ( ix_g - quan->ix_base ) + quan->ncell_x_material * (
+         ( iy_g - quan->iy_base ) + quan->ncell_y_material * (
+         ( iz_g - quan->iz_base ) ) );
+}
+
+/*===========================================================================*/
+/*---Coefficients of the solve at a cell, angle---*/
+/*---pseudo-private member functions---*/
+
+/*---Loaded from the tables on the host; computed directly on the device,
+     to which the tables are not copied---*/
+
+TARGET_HD static inline PAccum Quantities_sigma_t_cell_(
+                                                  const Quantities* quan,
+                                                  int ix_g,
+                                                  int iy_g,
+                                                  int iz_g,
+                                                  int ie,
+                                                  Dimensions dims_g )
+{
+#ifdef __CUDA_ARCH__
+  return Quantities_sigma_t_( Quantities_material_( ix_g, iy_g, iz_g,
+                                                    quan->ncell_z_g ),
+                              ie, dims_g );
+#else
+  const int material = quan->material_vals[
+                          Quantities_ind_material_( quan, ix_g, iy_g, iz_g ) ];
+  return quan->sigma_t_vals[ ie + dims_g.ne * material ];
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline PAccum Quantities_dircoef_angle_(
+                                                  const Quantities* quan,
+                                                  int ia,
+                                                  int axis,
+                                                  Dimensions dims_g )
+{
+#ifdef __CUDA_ARCH__
+  return Quantities_dircoef_( dims_g, ia, axis );
+#else
+  return quan->dircoef_vals[ ia + dims_g.na * axis ];
+#endif
+}
+
+/*===========================================================================*/
+/*---Initial values for boundary array---*/
+
+TARGET_HD static inline P Quantities_init_facexy(
+  const Quantities*  quan,
+  int                ix_g,
+  int                iy_g,
+  int                iz_g,
+  int                ie,
+  int                ia,
+  int                iu,
+  int                octant,
+  const Dimensions   dims_g )
+{
+  Assert( ix_g >=  0 && ix_g <  dims_g.ncell_x );
+  Assert( iy_g >=  0 && iy_g <  dims_g.ncell_y );
+  Assert( ( iz_g == -1             && Dir_z(octant)==DIR_UP ) ||
+          ( iz_g == dims_g.ncell_z && Dir_z(octant)==DIR_DN ) );
+  Assert( ie >=  0 && ie < dims_g.ne );
+  Assert( ia >=  0 && ia < dims_g.na );
+  Assert( iu >=  0 && iu < NU );
+  Assert( octant >= 0 && octant < NOCTANT );
+
+  /*---Vacuum: no incoming flux---*/
+
+  return ((P)0);
+}
+
+/*===========================================================================*/
+/*---Initial values for boundary array---*/
+
+TARGET_HD static inline P Quantities_init_facexz(
+  const Quantities*  quan,
+  int                ix_g,
+  int                iy_g,
+  int                iz_g,
+  int                ie,
+  int                ia,
+  int                iu,
+  int                octant,
+  const Dimensions   dims_g )
+{
+  Assert( ix_g >=  0 && ix_g < dims_g.ncell_x );
+  Assert( ( iy_g == -1             && Dir_y(octant)==DIR_UP ) ||
+          ( iy_g == dims_g.ncell_y && Dir_y(octant)==DIR_DN ) );
+  Assert( iz_g >=  0 && iz_g < dims_g.ncell_z );
+  Assert( ie >=  0 && ie < dims_g.ne );
+  Assert( ia >=  0 && ia < dims_g.na );
+  Assert( iu >=  0 && iu < NU );
+  Assert( octant >= 0 && octant < NOCTANT );
+
+  return ((P)0);
+}
+
+/*===========================================================================*/
+/*---Initial values for boundary array---*/
+
+TARGET_HD static inline P Quantities_init_faceyz(
+  const Quantities*  quan,
+  int                ix_g,
+  int                iy_g,
+  int                iz_g,
+  int                ie,
+  int                ia,
+  int                iu,
+  int                octant,
+  const Dimensions   dims_g )
+{
+  Assert( ( ix_g == -1             && Dir_x(octant)==DIR_UP ) ||
+          ( ix_g == dims_g.ncell_x && Dir_x(octant)==DIR_DN ) );
+  Assert( iy_g >=  0 && iy_g < dims_g.ncell_y );
+  Assert( iz_g >=  0 && iz_g < dims_g.ncell_z );
+  Assert( ie >=  0 && ie < dims_g.ne );
+  Assert( ia >=  0 && ia < dims_g.na );
+  Assert( iu >=  0 && iu < NU );
+  Assert( octant >= 0 && octant < NOCTANT );
+
+  return ((P)0);
+}
+
+/*===========================================================================*/
+/*---Perform equation solve at a cell---*/
+
+TARGET_HD static inline void Quantities_solve(
+  const Quantities* const  quan,
+  PAccum* const __restrict__ vslocal,
+  const int             ia,
+  const int             iaind,
+  const int             iamax,
+  P* const __restrict__ facexy,
+  P* const __restrict__ facexz,
+  P* const __restrict__ faceyz,
+  const int             ix_b,
+  const int             iy_b,
+  const int             iz_b,
+  const int             ie,
+  const int             ix_g,
+  const int             iy_g,
+  const int             iz_g,
+  const int             octant,
+  const int             octant_in_block,
+  const int             noctant_per_block,
+  const Dimensions      dims_b,
+  const Dimensions      dims_g,
+  const Bool_t          is_cell_active )
+{
+  Assert( vslocal );
+  Assert( ia >= 0 );
+  Assert( iaind >= 0 && iaind < iamax );
+  Assert( iamax >= 0 );
+  Assert( facexy );
+  Assert( facexz );
+  Assert( faceyz );
+  Assert( ( ix_b >= 0 && ix_b < dims_b.ncell_x ) || ! is_cell_active );
+  Assert( ( iy_b >= 0 && iy_b < dims_b.ncell_y ) || ! is_cell_active );
+  Assert( ( iz_b >= 0 && iz_b < dims_b.ncell_z ) || ! is_cell_active );
+  Assert( ( ix_g >= 0 && ix_g < dims_g.ncell_x ) || ! is_cell_active );
+  Assert( ( iy_g >= 0 && iy_g < dims_g.ncell_y ) || ! is_cell_active );
+  Assert( ( iz_g >= 0 && iz_g < dims_g.ncell_z ) || ! is_cell_active );
+  Assert( ie   >= 0 && ie   < dims_b.ne );
+  Assert( octant >= 0 && octant < NOCTANT );
+  Assert( octant_in_block >= 0 && octant_in_block < noctant_per_block );
+
+  if( ia < dims_b.na && is_cell_active )
+  {
+    int iu = 0;
+
+    const PAccum sigma_t = Quantities_sigma_t_cell_( quan, ix_g, iy_g, iz_g,
+                                                     ie, dims_g );
+    const PAccum cx = Quantities_dircoef_angle_( quan, ia, 0, dims_g );
+    const PAccum cy = Quantities_dircoef_angle_( quan, ia, 1, dims_g );
+    const PAccum cz = Quantities_dircoef_angle_( quan, ia, 2, dims_g );
+
+    const PAccum denom_r = ((PAccum)1) / ( ( ( sigma_t + cx ) + cy ) + cz );
+
+#pragma unroll
+    for( iu=0; iu<NU; ++iu )
+    {
+      PAccum* const __restrict__ vslocal_this
+                        = ref_vslocal( vslocal, dims_b, NU, iamax, iaind, iu );
+      P* const __restrict__ facexy_this
+                        = ref_facexy( facexy, dims_b, NU, noctant_per_block,
+                                      ix_b, iy_b, ie, ia, iu, octant_in_block );
+      P* const __restrict__ facexz_this
+                        = ref_facexz( facexz, dims_b, NU, noctant_per_block,
+                                      ix_b, iz_b, ie, ia, iu, octant_in_block );
+      P* const __restrict__ faceyz_this
+                        = ref_faceyz( faceyz, dims_b, NU, noctant_per_block,
+                                      iy_b, iz_b, ie, ia, iu, octant_in_block );
+
+      const PAccum face_xy = (PAccum)*facexy_this;
+      const PAccum face_xz = (PAccum)*facexz_this;
+      const PAccum face_yz = (PAccum)*faceyz_this;
+
+      const PAccum psi = ( ( ( *vslocal_this + cx * face_yz )
+                                             + cy * face_xz )
+                                             + cz * face_xy ) * denom_r;
+      const PAccum psi2 = psi + psi;
+
+      /*---Diamond-difference closure for the outgoing face values---*/
+
+      *vslocal_this = psi;
+      *facexy_this = (P)( psi2 - face_xy );
+      *facexz_this = (P)( psi2 - face_xz );
+      *faceyz_this = (P)( psi2 - face_yz );
+    } /*---for---*/
+  }
+} /*---Quantities_solve---*/
+
+/*===========================================================================*/
+/*---Perform equation solve at a cell, for a range of angles, SIMD---*/
+
+/*---Same as Quantities_solve applied to ia = ia_base + iaind for
+     iaind = 0 .. nia-1, vectorized across angles, one angle per lane.
+     The operation order matches Quantities_solve, so results agree
+     bitwise---*/
+
+TARGET_HD static inline void Quantities_solve_angles(
+  const Quantities* const  quan,
+  PAccum* const __restrict__ vslocal,
+  const int             ia_base,
+  const int             nia,
+  const int             iamax,
+  P* const __restrict__ facexy,
+  P* const __restrict__ facexz,
+  P* const __restrict__ faceyz,
+  const int             ix_b,
+  const int             iy_b,
+  const int             iz_b,
+  const int             ie,
+  const int             ix_g,
+  const int             iy_g,
+  const int             iz_g,
+  const int             octant,
+  const int             octant_in_block,
+  const int             noctant_per_block,
+  const Dimensions      dims_b,
+  const Dimensions      dims_g,
+  const Bool_t          is_cell_active )
+{
+  Assert( vslocal );
+  Assert( ia_base >= 0 );
+  Assert( nia >= 0 && nia <= iamax );
+  Assert( ia_base + nia <= dims_b.na );
+  Assert( facexy );
+  Assert( facexz );
+  Assert( faceyz );
+  Assert( ( ix_b >= 0 && ix_b < dims_b.ncell_x ) || ! is_cell_active );
+  Assert( ( iy_b >= 0 && iy_b < dims_b.ncell_y ) || ! is_cell_active );
+  Assert( ( iz_b >= 0 && iz_b < dims_b.ncell_z ) || ! is_cell_active );
+  Assert( ( ix_g >= 0 && ix_g < dims_g.ncell_x ) || ! is_cell_active );
+  Assert( ( iy_g >= 0 && iy_g < dims_g.ncell_y ) || ! is_cell_active );
+  Assert( ( iz_g >= 0 && iz_g < dims_g.ncell_z ) || ! is_cell_active );
+  Assert( ie   >= 0 && ie   < dims_b.ne );
+  Assert( octant >= 0 && octant < NOCTANT );
+  Assert( octant_in_block >= 0 && octant_in_block < noctant_per_block );
+
+  if( nia > 0 && is_cell_active )
+  {
+    const SimdAcc v_sigma_t = SimdAcc_set1( Quantities_sigma_t_cell_(
+                                   quan, ix_g, iy_g, iz_g, ie, dims_g ) );
+    const SimdAcc v_one = SimdAcc_set1( (PAccum)1 );
+
+    int iaind = 0;
+
+    for( iaind=0; iaind<nia; iaind+=SIMD_LEN )
+    {
+      const int ia = ia_base + iaind;
+      const int nlane = nia - iaind < SIMD_LEN ? nia - iaind : SIMD_LEN;
+      const SimdMask mask = SimdAcc_mask( nlane );
+
+      /*---Streaming coefficients for these angles, invariant across
+           unknowns---*/
+
+      const PAccum* const __restrict__ dircoef = quan->dircoef_vals + ia;
+      const SimdAcc v_cx = SimdAcc_load_mask( dircoef + 0 * dims_g.na, mask );
+      const SimdAcc v_cy = SimdAcc_load_mask( dircoef + 1 * dims_g.na, mask );
+      const SimdAcc v_cz = SimdAcc_load_mask( dircoef + 2 * dims_g.na, mask );
+
+      const SimdAcc v_denom_r = SimdAcc_div( v_one, SimdAcc_add( SimdAcc_add(
+                     SimdAcc_add( v_sigma_t, v_cx ), v_cy ), v_cz ) );
+
+      int iu = 0;
+
+#pragma unroll
+      for( iu=0; iu<NU; ++iu )
+      {
+        PAccum* const __restrict__ vslocal_this
+                     = ref_vslocal( vslocal, dims_b, NU, iamax, iaind, iu );
+        P* const __restrict__ facexy_this
+                     = ref_facexy( facexy, dims_b, NU, noctant_per_block,
+                                   ix_b, iy_b, ie, ia, iu, octant_in_block );
+        P* const __restrict__ facexz_this
+                     = ref_facexz( facexz, dims_b, NU, noctant_per_block,
+                                   ix_b, iz_b, ie, ia, iu, octant_in_block );
+        P* const __restrict__ faceyz_this
+                     = ref_faceyz( faceyz, dims_b, NU, noctant_per_block,
+                                   iy_b, iz_b, ie, ia, iu, octant_in_block );
+
+        const SimdAcc face_xy = SimdAcc_load_P_mask( facexy_this, mask );
+        const SimdAcc face_xz = SimdAcc_load_P_mask( facexz_this, mask );
+        const SimdAcc face_yz = SimdAcc_load_P_mask( faceyz_this, mask );
+
+        const SimdAcc psi = SimdAcc_mul( SimdAcc_add( SimdAcc_add( SimdAcc_add(
+                              SimdAcc_load_mask( vslocal_this, mask ),
+                              SimdAcc_mul( v_cx, face_yz ) ),
+                              SimdAcc_mul( v_cy, face_xz ) ),
+                              SimdAcc_mul( v_cz, face_xy ) ), v_denom_r );
+        const SimdAcc psi2 = SimdAcc_add( psi, psi );
+
+        SimdAcc_store_mask(   vslocal_this, psi, mask );
+        SimdAcc_store_P_mask( facexy_this,  SimdAcc_sub( psi2, face_xy ),
+                                                                   mask );
+        SimdAcc_store_P_mask( facexz_this,  SimdAcc_sub( psi2, face_xz ),
+                                                                   mask );
+        SimdAcc_store_P_mask( faceyz_this,  SimdAcc_sub( psi2, face_yz ),
+                                                                   mask );
+      } /*---for iu---*/
+    } /*---for iaind---*/
+  }
+} /*---Quantities_solve_angles---*/
+
+/*===========================================================================*/
+/*---Perform equation solve at a cell, for a range of energy groups, SIMD---*/
+
+/*---Same as Quantities_solve applied to ie = ie_base + lane for
+     lane = 0 .. nlane-1 and all angles, vectorized across energy groups.
+     vslocal holds lane + SIMD_LEN * ( ia + na * iu ).  Face values for
+     successive groups are a fixed stride apart.  The operation order
+     matches Quantities_solve, so results agree bitwise---*/
+
+TARGET_HD static inline void Quantities_solve_elanes(
+  const Quantities* const  quan,
+  PAccum* const __restrict__ vslocal,
+  P* const __restrict__ facexy,
+  P* const __restrict__ facexz,
+  P* const __restrict__ faceyz,
+  const int             ix_b,
+  const int             iy_b,
+  const int             iz_b,
+  const int             ie_base,
+  const int             nlane,
+  const int             ix_g,
+  const int             iy_g,
+  const int             iz_g,
+  const int             octant,
+  const int             octant_in_block,
+  const int             noctant_per_block,
+  const Dimensions      dims_b,
+  const Dimensions      dims_g )
+{
+  Assert( vslocal );
+  Assert( facexy );
+  Assert( facexz );
+  Assert( faceyz );
+  Assert( ix_b >= 0 && ix_b < dims_b.ncell_x );
+  Assert( iy_b >= 0 && iy_b < dims_b.ncell_y );
+  Assert( iz_b >= 0 && iz_b < dims_b.ncell_z );
+  Assert( ix_g >= 0 && ix_g < dims_g.ncell_x );
+  Assert( iy_g >= 0 && iy_g < dims_g.ncell_y );
+  Assert( iz_g >= 0 && iz_g < dims_g.ncell_z );
+  Assert( nlane > 0 && nlane <= SIMD_LEN );
+  Assert( ie_base >= 0 && ie_base + nlane <= dims_b.ne );
+  Assert( octant >= 0 && octant < NOCTANT );
+  Assert( octant_in_block >= 0 && octant_in_block < noctant_per_block );
+
+  /*---Cross sections of the groups; unused lanes get zero---*/
+
+  const int material = quan->material_vals[
+                          Quantities_ind_material_( quan, ix_g, iy_g, iz_g ) ];
+  const SimdAcc v_sigma_t = SimdAcc_load_mask(
+                       quan->sigma_t_vals + ie_base + dims_g.ne * material,
+                       SimdAcc_mask( nlane ) );
+  const SimdAcc v_one = SimdAcc_set1( (PAccum)1 );
+
+  const SimdMask mask_all = SimdAcc_mask( SIMD_LEN );
+
+  /*---Distance between face values of successive energy groups---*/
+
+  const size_t stride_xy = nlane == 1 ? 0 :
+      ref_facexy( facexy, dims_b, NU, noctant_per_block,
+                  ix_b, iy_b, ie_base+1, 0, 0, octant_in_block ) -
+      ref_facexy( facexy, dims_b, NU, noctant_per_block,
+                  ix_b, iy_b, ie_base,   0, 0, octant_in_block );
+  const size_t stride_xz = nlane == 1 ? 0 :
+      ref_facexz( facexz, dims_b, NU, noctant_per_block,
+                  ix_b, iz_b, ie_base+1, 0, 0, octant_in_block ) -
+      ref_facexz( facexz, dims_b, NU, noctant_per_block,
+                  ix_b, iz_b, ie_base,   0, 0, octant_in_block );
+  const size_t stride_yz = nlane == 1 ? 0 :
+      ref_faceyz( faceyz, dims_b, NU, noctant_per_block,
+                  iy_b, iz_b, ie_base+1, 0, 0, octant_in_block ) -
+      ref_faceyz( faceyz, dims_b, NU, noctant_per_block,
+                  iy_b, iz_b, ie_base,   0, 0, octant_in_block );
+
+  int ia = 0;
+
+  for( ia=0; ia<dims_b.na; ++ia )
+  {
+    const SimdAcc v_cx
+                 = SimdAcc_set1( quan->dircoef_vals[ ia + 0 * dims_g.na ] );
+    const SimdAcc v_cy
+                 = SimdAcc_set1( quan->dircoef_vals[ ia + 1 * dims_g.na ] );
+    const SimdAcc v_cz
+                 = SimdAcc_set1( quan->dircoef_vals[ ia + 2 * dims_g.na ] );
+
+    const SimdAcc v_denom_r = SimdAcc_div( v_one, SimdAcc_add( SimdAcc_add(
+                   SimdAcc_add( v_sigma_t, v_cx ), v_cy ), v_cz ) );
+
+    int iu = 0;
+
+#pragma unroll
+    for( iu=0; iu<NU; ++iu )
+    {
+      PAccum* const __restrict__ vslocal_this
+                             = vslocal + SIMD_LEN * ( ia + dims_b.na * iu );
+      P* const __restrict__ facexy_this
+                     = ref_facexy( facexy, dims_b, NU, noctant_per_block,
+                                   ix_b, iy_b, ie_base, ia, iu,
+                                   octant_in_block );
+      P* const __restrict__ facexz_this
+                     = ref_facexz( facexz, dims_b, NU, noctant_per_block,
+                                   ix_b, iz_b, ie_base, ia, iu,
+                                   octant_in_block );
+      P* const __restrict__ faceyz_this
+                     = ref_faceyz( faceyz, dims_b, NU, noctant_per_block,
+                                   iy_b, iz_b, ie_base, ia, iu,
+                                   octant_in_block );
+
+      const SimdAcc face_xy
+                     = SimdAcc_load_P_stride( facexy_this, stride_xy, nlane );
+      const SimdAcc face_xz
+                     = SimdAcc_load_P_stride( facexz_this, stride_xz, nlane );
+      const SimdAcc face_yz
+                     = SimdAcc_load_P_stride( faceyz_this, stride_yz, nlane );
+
+      const SimdAcc psi = SimdAcc_mul( SimdAcc_add( SimdAcc_add( SimdAcc_add(
+                            SimdAcc_load_mask( vslocal_this, mask_all ),
+                            SimdAcc_mul( v_cx, face_yz ) ),
+                            SimdAcc_mul( v_cy, face_xz ) ),
+                            SimdAcc_mul( v_cz, face_xy ) ), v_denom_r );
+      const SimdAcc psi2 = SimdAcc_add( psi, psi );
+
+      SimdAcc_store_mask(     vslocal_this, psi, mask_all );
+      SimdAcc_store_P_stride( facexy_this, stride_xy,
+                              SimdAcc_sub( psi2, face_xy ), nlane );
+      SimdAcc_store_P_stride( facexz_this, stride_xz,
+                              SimdAcc_sub( psi2, face_xz ), nlane );
+      SimdAcc_store_P_stride( faceyz_this, stride_yz,
+                              SimdAcc_sub( psi2, face_yz ), nlane );
+    } /*---for iu---*/
+  } /*---for ia---*/
+} /*---Quantities_solve_elanes---*/
+
+/*===========================================================================*/
+/*---Perform equation solve at a run of cells, SIMD---*/
+
+/*---Same as Quantities_solve applied to cells icell = 0 .. ncell-1 at
+     ( ix_g + ix_inc * icell, iy_g + iy_inc * icell, iz_g ) and all angles,
+     vectorized across the cells of one hyperplane.  The value for cell
+     icell, angle ia, unknown iu is at icell + stride * ( ia + na * iu ) in
+     vslocal and in each face.  The operation order matches
+     Quantities_solve, so results agree bitwise---*/
+
+TARGET_HD static inline void Quantities_solve_cells(
+  const Quantities* const  quan,
+  PAccum* const __restrict__ vslocal,
+  const int             stride_vslocal,
+  P* const __restrict__ facexy,
+  const int             stride_facexy,
+  P* const __restrict__ facexz,
+  const int             stride_facexz,
+  P* const __restrict__ faceyz,
+  const int             stride_faceyz,
+  const int             ncell,
+  const int             ix_g,
+  const int             iy_g,
+  const int             iz_g,
+  const int             ix_inc,
+  const int             iy_inc,
+  const int             ie,
+  const int             octant,
+  const Dimensions      dims_g )
+{
+  Assert( vslocal );
+  Assert( facexy );
+  Assert( facexz );
+  Assert( faceyz );
+  Assert( ncell > 0 );
+  Assert( stride_vslocal >= ncell );
+  Assert( stride_facexy >= ncell );
+  Assert( stride_facexz >= ncell );
+  Assert( stride_faceyz >= ncell );
+  Assert( ix_g >= 0 && ix_g < dims_g.ncell_x );
+  Assert( iy_g >= 0 && iy_g < dims_g.ncell_y );
+  Assert( iz_g >= 0 && iz_g < dims_g.ncell_z );
+  Assert( ix_g + ix_inc * ( ncell - 1 ) >= 0 &&
+          ix_g + ix_inc * ( ncell - 1 ) < dims_g.ncell_x );
+  Assert( iy_g + iy_inc * ( ncell - 1 ) >= 0 &&
+          iy_g + iy_inc * ( ncell - 1 ) < dims_g.ncell_y );
+  Assert( ie >= 0 && ie < dims_g.ne );
+  Assert( octant >= 0 && octant < NOCTANT );
+
+  int icell_base = 0;
+
+  for( icell_base=0; icell_base<ncell; icell_base+=SIMD_LEN )
+  {
+    const int nlane = ncell - icell_base < SIMD_LEN ? ncell - icell_base
+                                                    : SIMD_LEN;
+    const SimdMask mask = SimdAcc_mask( nlane );
+
+    /*---Cross sections of the cells, one cell per lane;
+         unused lanes get zero---*/
+
+    PAccum sigma_t[SIMD_LEN];
+
+    int lane = 0;
+
+    for( lane=0; lane<nlane; ++lane )
+    {
+      const int icell = icell_base + lane;
+      sigma_t[lane] = Quantities_sigma_t_cell_( quan,
+                          ix_g + ix_inc * icell, iy_g + iy_inc * icell, iz_g,
+                          ie, dims_g );
+    }
+
+    const SimdAcc v_sigma_t = SimdAcc_load_mask( sigma_t, mask );
+    const SimdAcc v_one = SimdAcc_set1( (PAccum)1 );
+
+    int ia = 0;
+
+    for( ia=0; ia<dims_g.na; ++ia )
+    {
+      const SimdAcc v_cx
+                 = SimdAcc_set1( quan->dircoef_vals[ ia + 0 * dims_g.na ] );
+      const SimdAcc v_cy
+                 = SimdAcc_set1( quan->dircoef_vals[ ia + 1 * dims_g.na ] );
+      const SimdAcc v_cz
+                 = SimdAcc_set1( quan->dircoef_vals[ ia + 2 * dims_g.na ] );
+
+      const SimdAcc v_denom_r = SimdAcc_div( v_one, SimdAcc_add( SimdAcc_add(
+                   SimdAcc_add( v_sigma_t, v_cx ), v_cy ), v_cz ) );
+
+      int iu = 0;
+
+#pragma unroll
+      for( iu=0; iu<NU; ++iu )
+      {
+        const int iaiu = ia + dims_g.na * iu;
+
+        PAccum* const __restrict__ vslocal_this
+                            = vslocal + icell_base + stride_vslocal * iaiu;
+        P* const __restrict__ facexy_this
+                            = facexy + icell_base + stride_facexy * iaiu;
+        P* const __restrict__ facexz_this
+                            = facexz + icell_base + stride_facexz * iaiu;
+        P* const __restrict__ faceyz_this
+                            = faceyz + icell_base + stride_faceyz * iaiu;
+
+        const SimdAcc face_xy = SimdAcc_load_P_mask( facexy_this, mask );
+        const SimdAcc face_xz = SimdAcc_load_P_mask( facexz_this, mask );
+        const SimdAcc face_yz = SimdAcc_load_P_mask( faceyz_this, mask );
+
+        const SimdAcc psi = SimdAcc_mul( SimdAcc_add( SimdAcc_add(
+                              SimdAcc_add(
+                              SimdAcc_load_mask( vslocal_this, mask ),
+                              SimdAcc_mul( v_cx, face_yz ) ),
+                              SimdAcc_mul( v_cy, face_xz ) ),
+                              SimdAcc_mul( v_cz, face_xy ) ), v_denom_r );
+        const SimdAcc psi2 = SimdAcc_add( psi, psi );
+
+        SimdAcc_store_mask(   vslocal_this, psi, mask );
+        SimdAcc_store_P_mask( facexy_this, SimdAcc_sub( psi2, face_xy ),
+                              mask );
+        SimdAcc_store_P_mask( facexz_this, SimdAcc_sub( psi2, face_xz ),
+                              mask );
+        SimdAcc_store_P_mask( faceyz_this, SimdAcc_sub( psi2, face_yz ),
+                              mask );
+      } /*---for iu---*/
+    } /*---for ia---*/
+  } /*---for icell_base---*/
+} /*---Quantities_solve_cells---*/
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_quantities_dd_kernels_h_---*/
+
+/*---------------------------------------------------------------------------*/
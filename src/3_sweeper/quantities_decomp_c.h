@@ -0,0 +1,143 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   quantities_decomp_c.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Definitions for physical quantities, subgrid decomp info.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+/*---NOTE: shared by the Quantities implementations, each of which has the
+     ix_base_vals, iy_base_vals, iz_base_vals and related
+     members---*/
+
+#ifndef _quantities_decomp_c_h_
+#define _quantities_decomp_c_h_
+
+#include "env.h"
+#include "dimensions.h"
+#include "quantities.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Proc number of the proc at position proc_axis along an axis, sharing
+     this proc's position along the other axes---*/
+/*---pseudo-private member function---*/
+
+static int Quantities_decomp_proc_( int axis, int proc_axis, const Env* env )
+{
+  return Env_proc( env, axis==0 ? proc_axis : Env_proc_x_this( env ),
+                        axis==1 ? proc_axis : Env_proc_y_this( env ),
+                        axis==2 ? proc_axis : Env_proc_z_this( env ) );
+}
+
+/*===========================================================================*/
+/*---Set the cell offsets of the procs along an axis---*/
+/*---pseudo-private member function---*/
+
+/*---base_vals[proc_axis] is the first global cell of the proc at
+     proc_axis, and base_vals[nproc_axis] the global cell count---*/
+
+static void Quantities_init_decomp_axis_( int*  base_vals,
+                                          int   ncell,
+                                          int   nproc_axis,
+                                          int   proc_axis_this,
+                                          int   axis,
+                                          Env*  env )
+{
+  int i  = 0;
+
+  /*---Collect values to base proc along axis---*/
+
+  if( proc_axis_this == 0 )
+  {
+    int proc_axis = 0;
+    base_vals[ 1+0 ] = ncell;
+    for( proc_axis=1; proc_axis<nproc_axis; ++proc_axis )
+    {
+      Env_recv_i( env, & base_vals[ 1+proc_axis ], 1,
+        Quantities_decomp_proc_( axis, proc_axis, env ), Env_tag( env ) );
+    }
+  }
+  else
+  {
+    Env_send_i( env, & ncell, 1,
+             Quantities_decomp_proc_( axis, 0, env ), Env_tag( env ) );
+  }
+  Env_increment_tag( env, 1 );
+
+  /*---Broadcast collected array to all other procs along axis---*/
+
+  if( proc_axis_this == 0 )
+  {
+    int proc_axis = 0;
+    for( proc_axis=1; proc_axis<nproc_axis; ++proc_axis )
+    {
+      Env_send_i( env, & base_vals[ 1 ], nproc_axis,
+        Quantities_decomp_proc_( axis, proc_axis, env ), Env_tag( env ) );
+    }
+  }
+  else
+  {
+    Env_recv_i( env, & base_vals[ 1 ], nproc_axis,
+             Quantities_decomp_proc_( axis, 0, env ), Env_tag( env ) );
+  }
+  Env_increment_tag( env, 1 );
+
+  /*---Scan sum---*/
+
+  base_vals[0] = 0;
+  for( i=0; i<nproc_axis; ++i )
+  {
+    base_vals[1+i] += base_vals[i];
+  }
+
+  Assert( base_vals[ proc_axis_this+1 ] -
+          base_vals[ proc_axis_this   ] == ncell );
+}
+
+/*===========================================================================*/
+/*---Initialize Quantities subgrid decomp info---*/
+
+void Quantities_init_decomp_( Quantities*       quan,
+                              const Dimensions  dims,
+                              Env*              env )
+{
+  /*---Allocate arrays---*/
+
+  quan->ix_base_vals = malloc_host_int( Env_nproc_x( env ) + 1 );
+  quan->iy_base_vals = malloc_host_int( Env_nproc_y( env ) + 1 );
+  quan->iz_base_vals = malloc_host_int( Env_nproc_z( env ) + 1 );
+
+  /*---Set entries of base_vals arrays---*/
+
+  Quantities_init_decomp_axis_( quan->ix_base_vals, dims.ncell_x,
+                       Env_nproc_x( env ), Env_proc_x_this( env ), 0, env );
+  Quantities_init_decomp_axis_( quan->iy_base_vals, dims.ncell_y,
+                       Env_nproc_y( env ), Env_proc_y_this( env ), 1, env );
+  Quantities_init_decomp_axis_( quan->iz_base_vals, dims.ncell_z,
+                       Env_nproc_z( env ), Env_proc_z_this( env ), 2, env );
+
+  quan->ix_base   = quan->ix_base_vals[ Env_proc_x_this( env ) ];
+  quan->iy_base   = quan->iy_base_vals[ Env_proc_y_this( env ) ];
+  quan->iz_base   = quan->iz_base_vals[ Env_proc_z_this( env ) ];
+  quan->ncell_x_g = quan->ix_base_vals[ Env_nproc_x(     env ) ];
+  quan->ncell_y_g = quan->iy_base_vals[ Env_nproc_y(     env ) ];
+  quan->ncell_z_g = quan->iz_base_vals[ Env_nproc_z(     env ) ];
+
+} /*---Quantities_init_decomp_---*/
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_quantities_decomp_c_h_---*/
+
+/*---------------------------------------------------------------------------*/
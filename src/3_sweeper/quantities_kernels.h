@@ -11,7 +11,29 @@
 #ifndef _quantities_kernels_h_
 #define _quantities_kernels_h_
 
+/*---Build-time choice of physics: the default testing case, whose result
+     is known analytically, or diamond difference, for benchmarking---*/
+
+#ifdef USE_QUANTITIES_DD
+#include "quantities_dd_kernels.h"
+#else
 #include "quantities_testing_kernels.h"
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifdef USE_QUANTITIES_DD
+  enum{ IS_USING_QUANTITIES_DD = 1 };
+#else
+  enum{ IS_USING_QUANTITIES_DD = 0 };
+#endif
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
 
 #endif /*---_quantities_kernels_h_---*/
 
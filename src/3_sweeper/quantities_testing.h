@@ -49,6 +49,14 @@ void Quantities_init_decomp_( Quantities*       quan,
                               const Dimensions  dims,
                               Env*              env );
 
+/*===========================================================================*/
+/*---Initialize Quantities coefficient tables---*/
+/*---pseudo-private member function---*/
+
+void Quantities_init_coefs_( Quantities*       quan,
+                             const Dimensions  dims,
+                             Env*              env );
+
 /*===========================================================================*/
 /*---Flops cost of solve per element---*/
 
@@ -72,7 +80,7 @@ static inline P Quantities_init_state(
   Assert( iz >= 0 && iz < dims.ncell_z );
   Assert( ie >= 0 && ie < dims.ne );
   Assert( im >= 0 && im < dims.nm );
-  Assert( iu >= 0 && iu < NU );
+  Assert( iu >= 0 && iu < dims.nu );
 
   if( Quantities_bc_vacuum() )
   {
@@ -83,7 +91,8 @@ static inline P Quantities_init_state(
     return   ( (P) Quantities_affinefunction_( im ) )
            * ( (P) Quantities_scalefactor_space_( quan,
                                                    ix+quan->ix_base,
-                                                   iy+quan->iy_base, iz ) )
+                                                   iy+quan->iy_base,
+                                                   iz+quan->iz_base ) )
            * ( (P) Quantities_scalefactor_energy_( ie, dims ) )
            * ( (P) Quantities_scalefactor_unknown_( iu ) );
   }
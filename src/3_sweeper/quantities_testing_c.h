@@ -16,6 +16,7 @@
 #include "array_accessors.h"
 #include "pointer.h"
 #include "quantities_testing.h"
+#include "quantities_decomp_c.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -31,6 +32,7 @@ void Quantities_create( Quantities*       quan,
 {
   Quantities_init_am_matrices_( quan, dims, env );
   Quantities_init_decomp_( quan, dims, env );
+  Quantities_init_coefs_( quan, dims, env );
 
 } /*---Quantities_create---*/
 
@@ -201,136 +203,94 @@ void Quantities_init_am_matrices_( Quantities*       quan,
 } /*---Quantities_init_am_matrices_---*/
 
 /*===========================================================================*/
-/*---Initialize Quantities subgrid decomp info---*/
+/*---Initialize Quantities coefficient tables---*/
 
-void Quantities_init_decomp_( Quantities*       quan,
-                              const Dimensions  dims,
-                              Env*              env )
+/*---Precompute the scale factors and flux weights of the solve, so that
+     the kernel needs no hashing or divides, only loads.  Each table starts
+     on a cache line.  Requires ix_base, iy_base, iz_base to have been
+     set---*/
+
+void Quantities_init_coefs_( Quantities*       quan,
+                             const Dimensions  dims,
+                             Env*              env )
 {
   /*---Declarations---*/
 
-  int i  = 0;
+  enum{ NCOEFS_PER_LINE = 64 / sizeof(PAccum) };
 
-  /*---Record z dimension---*/
+  int octant = 0;
+  int ia     = 0;
+  int ix     = 0;
+  int iy     = 0;
+  int iz     = 0;
 
-  quan->ncell_z_g = dims.ncell_z;
+  /*---Table sizes, rounded up to whole cache lines---*/
 
-  /*---Allocate arrays---*/
+  const int ncell_x_coefs = dims.ncell_x + 2;
+  const int ncell_y_coefs = dims.ncell_y + 2;
+  const int ncell_z_coefs = dims.ncell_z + 2;
 
-  quan->ix_base_vals = malloc_host_int( Env_nproc_x( env ) + 1 );
-  quan->iy_base_vals = malloc_host_int( Env_nproc_y( env ) + 1 );
+  const size_t noctant_vals = iceil( 2 * NOCTANT, NCOEFS_PER_LINE )
+                                                         * NCOEFS_PER_LINE;
+  const size_t nfluxweight_vals = iceil( 3 * dims.na, NCOEFS_PER_LINE )
+                                                         * NCOEFS_PER_LINE;
+  const size_t nspace_vals = 2 * (size_t)ncell_x_coefs * ncell_y_coefs *
+                                                         ncell_z_coefs;
 
-  /*---------------------------------*/
-  /*---Set entries of ix_base_vals---*/
-  /*---------------------------------*/
+  /*---Allocate arrays; one extra line to allow alignment---*/
 
-  /*---Collect values to base proc along axis---*/
+  quan->coefs_host_ = malloc_host_PAccum( noctant_vals + nfluxweight_vals +
+                                          nspace_vals + NCOEFS_PER_LINE );
 
-  if( Env_proc_x_this( env ) == 0 )
-  {
-    int proc_x = 0;
-    quan->ix_base_vals[ 1+0 ] = dims.ncell_x;
-    for( proc_x=1; proc_x<Env_nproc_x( env ); ++proc_x )
-    {
-      Env_recv_i( env, & quan->ix_base_vals[ 1+proc_x ], 1,
-        Env_proc( env, proc_x, Env_proc_y_this( env ) ), Env_tag( env ) );
-    }
-  }
-  else
-  {
-    Env_send_i( env, & dims.ncell_x, 1,
-             Env_proc( env, 0, Env_proc_y_this( env ) ), Env_tag( env ) );
-  }
-  Env_increment_tag( env, 1 );
+  quan->scalefactor_octant_vals = quan->coefs_host_ +
+    ( NCOEFS_PER_LINE - ( (size_t)quan->coefs_host_ / sizeof(PAccum) )
+                                       % NCOEFS_PER_LINE ) % NCOEFS_PER_LINE;
+  quan->fluxweight_vals = quan->scalefactor_octant_vals + noctant_vals;
+  quan->scalefactor_space_vals = quan->fluxweight_vals + nfluxweight_vals;
 
-  /*---Broadcast collected array to all other procs along axis---*/
+  quan->ncell_x_coefs = ncell_x_coefs;
+  quan->ncell_y_coefs = ncell_y_coefs;
+  quan->ncell_z_coefs = ncell_z_coefs;
 
-  if( Env_proc_x_this( env ) == 0 )
-  {
-    int proc_x = 0;
-    for( proc_x=1; proc_x<Env_nproc_x( env ); ++proc_x )
-    {
-      Env_send_i( env, & quan->ix_base_vals[ 1 ], Env_nproc_x( env ),
-        Env_proc( env, proc_x, Env_proc_y_this( env ) ), Env_tag( env ) );
-    }
-  }
-  else
-  {
-    Env_recv_i( env, & quan->ix_base_vals[ 1 ], Env_nproc_x( env ),
-             Env_proc( env, 0, Env_proc_y_this( env ) ), Env_tag( env ) );
-  }
-  Env_increment_tag( env, 1 );
-
-  /*---Scan sum---*/
+  /*---Octant factor and reciprocal---*/
 
-  quan->ix_base_vals[0] = 0;
-  for( i=0; i<Env_nproc_x( env ); ++i )
-  {
-    quan->ix_base_vals[1+i] += quan->ix_base_vals[i];
-  }
-
-  quan->ix_base   = quan->ix_base_vals[ Env_proc_x_this( env ) ];
-  quan->ncell_x_g = quan->ix_base_vals[ Env_nproc_x(     env ) ];
-
-  Assert( quan->ix_base_vals[ Env_proc_x_this( env )+1 ] -
-          quan->ix_base_vals[ Env_proc_x_this( env )   ] == dims.ncell_x );
-
-  /*---------------------------------*/
-  /*---Set entries of iy_base_vals---*/
-  /*---------------------------------*/
-
-  /*---Collect values to base proc along axis---*/
-
-  if( Env_proc_y_this( env ) == 0 )
-  {
-    int proc_y = 0;
-    quan->iy_base_vals[ 1+0 ] = dims.ncell_y;
-    for( proc_y=1; proc_y<Env_nproc_y( env ); ++proc_y )
-    {
-      Env_recv_i( env, & quan->iy_base_vals[ 1+proc_y ], 1,
-        Env_proc( env, Env_proc_x_this( env ), proc_y ), Env_tag( env ) );
-    }
-  }
-  else
+  for( octant=0; octant<NOCTANT; ++octant )
   {
-    Env_send_i( env, & dims.ncell_y, 1,
-             Env_proc( env, Env_proc_x_this( env ), 0 ), Env_tag( env ) );
+    const PAccum scalefactor_octant = Quantities_scalefactor_octant_( octant );
+    quan->scalefactor_octant_vals[ 2 * octant     ] = scalefactor_octant;
+    quan->scalefactor_octant_vals[ 2 * octant + 1 ] =
+                                            ((PAccum)1) / scalefactor_octant;
   }
-  Env_increment_tag( env, 1 );
 
-  /*---Broadcast collected array to all other procs along axis---*/
+  /*---Flux weights, x then y then z, each indexed by angle---*/
 
-  if( Env_proc_y_this( env ) == 0 )
-  {
-    int proc_y = 0;
-    for( proc_y=1; proc_y<Env_nproc_y( env ); ++proc_y )
-    {
-      Env_send_i( env, & quan->iy_base_vals[ 1 ], Env_nproc_y( env ),
-        Env_proc( env, Env_proc_x_this( env ), proc_y ), Env_tag( env ) );
-    }
-  }
-  else
+  for( ia=0; ia<dims.na; ++ia )
   {
-    Env_recv_i( env, & quan->iy_base_vals[ 1 ], Env_nproc_y( env ),
-             Env_proc( env, Env_proc_x_this( env ), 0 ), Env_tag( env ) );
+    quan->fluxweight_vals[ ia + 0 * dims.na ] =
+                                         Quantities_xfluxweight_( dims, ia );
+    quan->fluxweight_vals[ ia + 1 * dims.na ] =
+                                         Quantities_yfluxweight_( dims, ia );
+    quan->fluxweight_vals[ ia + 2 * dims.na ] =
+                                         Quantities_zfluxweight_( dims, ia );
   }
-  Env_increment_tag( env, 1 );
 
-  /*---Scan sum---*/
+  /*---Space factor and reciprocal for each cell, including halo---*/
 
-  quan->iy_base_vals[0] = 0;
-  for( i=0; i<Env_nproc_y( env ); ++i )
+  for( iz=-1; iz<=dims.ncell_z; ++iz )
+  for( iy=-1; iy<=dims.ncell_y; ++iy )
+  for( ix=-1; ix<=dims.ncell_x; ++ix )
   {
-    quan->iy_base_vals[1+i] += quan->iy_base_vals[i];
+    const int ix_g = ix + quan->ix_base;
+    const int iy_g = iy + quan->iy_base;
+    const int iz_g = iz + quan->iz_base;
+    const int ind = Quantities_ind_space_( quan, ix_g, iy_g, iz_g );
+    const PAccum scalefactor_space
+                    = Quantities_scalefactor_space_( quan, ix_g, iy_g, iz_g );
+    quan->scalefactor_space_vals[ ind     ] = scalefactor_space;
+    quan->scalefactor_space_vals[ ind + 1 ] = ((PAccum)1) / scalefactor_space;
   }
 
-  quan->iy_base   = quan->iy_base_vals[ Env_proc_y_this( env ) ];
-  quan->ncell_y_g = quan->iy_base_vals[ Env_nproc_y(     env ) ];
-
-  Assert( quan->iy_base_vals[ Env_proc_y_this( env )+1 ] -
-          quan->iy_base_vals[ Env_proc_y_this( env )   ] == dims.ncell_y );
-
-} /*---Quantities_init_decomp_---*/
+} /*---Quantities_init_coefs_---*/
 
 /*===========================================================================*/
 /*---Pseudo-destructor for Quantities struct---*/
@@ -344,9 +304,18 @@ void Quantities_destroy( Quantities* quan )
 
   free_host_int( quan->ix_base_vals );
   free_host_int( quan->iy_base_vals );
+  free_host_int( quan->iz_base_vals );
 
   quan->ix_base_vals = NULL;
   quan->iy_base_vals = NULL;
+  quan->iz_base_vals = NULL;
+
+  free_host_PAccum( quan->coefs_host_ );
+
+  quan->coefs_host_             = NULL;
+  quan->scalefactor_octant_vals = NULL;
+  quan->fluxweight_vals         = NULL;
+  quan->scalefactor_space_vals  = NULL;
 
 } /*---Quantities_destroy---*/
 
@@ -12,6 +12,7 @@
 #define _quantities_testing_kernels_h_
 
 #include "types_kernels.h"
+#include "simd_kernels.h"
 #include "dimensions_kernels.h"
 #include "array_accessors_kernels.h"
 #include "pointer_kernels.h"
@@ -38,13 +39,38 @@ typedef struct
   Pointer  m_from_a;
   int*     ix_base_vals;
   int*     iy_base_vals;
+  int*     iz_base_vals;
   int      ix_base;
   int      iy_base;
+  int      iz_base;
   int      ncell_x_g;
   int      ncell_y_g;
   int      ncell_z_g;
+
+  /*---Coefficient tables of the solve, host; see Quantities_init_coefs_---*/
+  PAccum*  coefs_host_;
+  PAccum*  scalefactor_octant_vals;
+  PAccum*  fluxweight_vals;
+  PAccum*  scalefactor_space_vals;
+  int      ncell_x_coefs;
+  int      ncell_y_coefs;
+  int      ncell_z_coefs;
 } Quantities;
 
+/*===========================================================================*/
+/*---Coefficients of the solve at one cell, for one octant---*/
+
+typedef struct
+{
+  PAccum  octant;
+  PAccum  octant_r;
+  PAccum  space;
+  PAccum  space_r;
+  PAccum  space_x_r;
+  PAccum  space_y_r;
+  PAccum  space_z_r;
+} QuantitiesCoefs;
+
 /*===========================================================================*/
 /*---Scale factor for energy---*/
 /*---pseudo-private member function---*/
@@ -77,7 +103,9 @@ TARGET_HD static inline int Quantities_scalefactor_unknown_( int iu )
   /*---Random power-of-two multiplier for each cell unknown,
        to help catch errors regarding indexing of cell unknowns.
   ---*/
-  Assert( iu >= 0 && iu < NU );
+  /*---NOTE: upper bound of iu is checked by the caller, since the
+       value of nu may differ from the compile-time default NU---*/
+  Assert( iu >= 0 );
 
   const int im = 312500;
   const int ia = 741;
@@ -213,6 +241,83 @@ TARGET_HD static inline int Quantities_scalefactor_octant_( int octant )
   return result;
 }
 
+/*===========================================================================*/
+/*---Index into scalefactor_space_vals of (factor, reciprocal) for a cell---*/
+/*---pseudo-private member function---*/
+
+/*---The table covers the cells of this proc plus one halo cell each side,
+     the range of the upwind neighbors used by the solve---*/
+
+TARGET_HD static inline int Quantities_ind_space_( const Quantities* quan,
+                                                   int ix_g,
+                                                   int iy_g,
+                                                   int iz_g )
+{
+  Assert( ix_g - quan->ix_base >= -1 &&
+          ix_g - quan->ix_base <= quan->ncell_x_coefs - 2 );
+  Assert( iy_g - quan->iy_base >= -1 &&
+          iy_g - quan->iy_base <= quan->ncell_y_coefs - 2 );
+  Assert( iz_g - quan->iz_base >= -1 &&
+          iz_g - quan->iz_base <= quan->ncell_z_coefs - 2 );
+
+  return 2 * ( ( ix_g - quan->ix_base + 1 ) + quan->ncell_x_coefs * (
+               ( iy_g - quan->iy_base + 1 ) + quan->ncell_y_coefs * (
+               ( iz_g - quan->iz_base + 1 ) ) ) );
+}
+
+/*===========================================================================*/
+/*---Scale factors for the solve at a cell---*/
+/*---pseudo-private member function---*/
+
+/*---Loaded from the tables on the host; computed directly on the device,
+     to which the tables are not copied.  Either way the values agree
+     exactly---*/
+
+TARGET_HD static inline QuantitiesCoefs Quantities_coefs_(
+                                                  const Quantities* quan,
+                                                  int ix_g,
+                                                  int iy_g,
+                                                  int iz_g,
+                                                  int octant )
+{
+  Assert( octant >= 0 && octant < NOCTANT );
+
+  const int dir_inc_x = Dir_inc( Dir_x( octant ) );
+  const int dir_inc_y = Dir_inc( Dir_y( octant ) );
+  const int dir_inc_z = Dir_inc( Dir_z( octant ) );
+
+  QuantitiesCoefs coefs;
+
+#ifdef __CUDA_ARCH__
+  coefs.octant    = Quantities_scalefactor_octant_( octant );
+  coefs.octant_r  = ((PAccum)1) / coefs.octant;
+  coefs.space     = Quantities_scalefactor_space_( quan, ix_g, iy_g, iz_g );
+  coefs.space_r   = ((PAccum)1) / coefs.space;
+  coefs.space_x_r = ((PAccum)1) /
+          Quantities_scalefactor_space_( quan, ix_g-dir_inc_x, iy_g, iz_g );
+  coefs.space_y_r = ((PAccum)1) /
+          Quantities_scalefactor_space_( quan, ix_g, iy_g-dir_inc_y, iz_g );
+  coefs.space_z_r = ((PAccum)1) /
+          Quantities_scalefactor_space_( quan, ix_g, iy_g, iz_g-dir_inc_z );
+#else
+  const PAccum* const __restrict__ space = quan->scalefactor_space_vals;
+
+  coefs.octant    = quan->scalefactor_octant_vals[ 2 * octant     ];
+  coefs.octant_r  = quan->scalefactor_octant_vals[ 2 * octant + 1 ];
+  coefs.space     = space[ Quantities_ind_space_( quan, ix_g, iy_g, iz_g ) ];
+  coefs.space_r   = space[ Quantities_ind_space_( quan, ix_g, iy_g, iz_g )
+                           + 1 ];
+  coefs.space_x_r = space[ Quantities_ind_space_( quan, ix_g-dir_inc_x,
+                                                  iy_g, iz_g ) + 1 ];
+  coefs.space_y_r = space[ Quantities_ind_space_( quan, ix_g,
+                                                  iy_g-dir_inc_y, iz_g ) + 1 ];
+  coefs.space_z_r = space[ Quantities_ind_space_( quan, ix_g, iy_g,
+                                                  iz_g-dir_inc_z ) + 1 ];
+#endif
+
+  return coefs;
+}
+
 /*===========================================================================*/
 /*---Initial values for boundary array---*/
 
@@ -336,7 +441,7 @@ TARGET_HD static inline P Quantities_init_faceyz(
 
 TARGET_HD static inline void Quantities_solve(
   const Quantities* const  quan,
-  P* const __restrict__ vslocal,
+  PAccum* const __restrict__ vslocal,
   const int             ia,
   const int             iaind,
   const int             iamax,
@@ -379,10 +484,6 @@ TARGET_HD static inline void Quantities_solve(
 
   if( ia < dims_b.na && is_cell_active )
   {
-    const int dir_x = Dir_x( octant );
-    const int dir_y = Dir_y( octant );
-    const int dir_z = Dir_z( octant );
-
     int iu = 0;
 
     /*---Average the face values and accumulate---*/
@@ -395,22 +496,21 @@ TARGET_HD static inline void Quantities_solve(
          stored.
     ---*/
 
-    const P scalefactor_octant = Quantities_scalefactor_octant_( octant );
-    const P scalefactor_octant_r = ((P)1) / scalefactor_octant;
-    const P scalefactor_space
-                    = Quantities_scalefactor_space_( quan, ix_g, iy_g, iz_g );
-    const P scalefactor_space_r = ((P)1) / scalefactor_space;
-    const P scalefactor_space_x_r = ((P)1) /
-       Quantities_scalefactor_space_( quan, ix_g-Dir_inc(dir_x), iy_g, iz_g );
-    const P scalefactor_space_y_r = ((P)1) /
-       Quantities_scalefactor_space_( quan, ix_g, iy_g-Dir_inc(dir_y), iz_g );
-    const P scalefactor_space_z_r = ((P)1) /
-       Quantities_scalefactor_space_( quan, ix_g, iy_g, iz_g-Dir_inc(dir_z) );
+    const QuantitiesCoefs coefs = Quantities_coefs_( quan, ix_g, iy_g, iz_g,
+                                                     octant );
+
+    const PAccum scalefactor_octant    = coefs.octant;
+    const PAccum scalefactor_octant_r  = coefs.octant_r;
+    const PAccum scalefactor_space     = coefs.space;
+    const PAccum scalefactor_space_r   = coefs.space_r;
+    const PAccum scalefactor_space_x_r = coefs.space_x_r;
+    const PAccum scalefactor_space_y_r = coefs.space_y_r;
+    const PAccum scalefactor_space_z_r = coefs.space_z_r;
 
 #pragma unroll
     for( iu=0; iu<NU; ++iu )
     {
-      P* const __restrict__ vslocal_this
+      PAccum* const __restrict__ vslocal_this
                         = ref_vslocal( vslocal, dims_b, NU, iamax, iaind, iu );
 /*
       P* const __restrict__ facexy_this
@@ -418,7 +518,7 @@ TARGET_HD static inline void Quantities_solve(
                                       ix_b, iy_b, ie, ia, iu, octant_in_block );
 */
 
-      const P result = ( *vslocal_this * scalefactor_space_r + (
+      const PAccum result = ( *vslocal_this * scalefactor_space_r + (
           *const_ref_facexy( facexy, dims_b, NU, noctant_per_block,
                                      ix_b, iy_b, ie, ia, iu, octant_in_block )
            * Quantities_xfluxweight_( dims_g, ia )
@@ -434,7 +534,7 @@ TARGET_HD static inline void Quantities_solve(
       ) * scalefactor_octant_r ) * scalefactor_space;
 
       *vslocal_this = result;
-      const P result_scaled = result * scalefactor_octant;
+      const P result_scaled = (P)( result * scalefactor_octant );
       *ref_facexy( facexy, dims_b, NU, noctant_per_block,
                    ix_b, iy_b, ie, ia, iu, octant_in_block ) = result_scaled;
       *ref_facexz( facexz, dims_b, NU, noctant_per_block,
@@ -446,6 +546,424 @@ TARGET_HD static inline void Quantities_solve(
   }
 } /*---Quantities_solve---*/
 
+/*===========================================================================*/
+/*---Perform equation solve at a cell, for a range of angles, SIMD---*/
+
+/*---Same as Quantities_solve applied to ia = ia_base + iaind for
+     iaind = 0 .. nia-1, but vectorized across angles: the angle axis is
+     unit-stride in both vslocal and the faces, so each SIMD lane is one
+     angle.  The last partial vector is handled with masked loads/stores.
+     The operation order matches Quantities_solve, so results agree
+     bitwise---*/
+
+TARGET_HD static inline void Quantities_solve_angles(
+  const Quantities* const  quan,
+  PAccum* const __restrict__ vslocal,
+  const int             ia_base,
+  const int             nia,
+  const int             iamax,
+  P* const __restrict__ facexy,
+  P* const __restrict__ facexz,
+  P* const __restrict__ faceyz,
+  const int             ix_b,
+  const int             iy_b,
+  const int             iz_b,
+  const int             ie,
+  const int             ix_g,
+  const int             iy_g,
+  const int             iz_g,
+  const int             octant,
+  const int             octant_in_block,
+  const int             noctant_per_block,
+  const Dimensions      dims_b,
+  const Dimensions      dims_g,
+  const Bool_t          is_cell_active )
+{
+  Assert( vslocal );
+  Assert( ia_base >= 0 );
+  Assert( nia >= 0 && nia <= iamax );
+  Assert( ia_base + nia <= dims_b.na );
+  Assert( facexy );
+  Assert( facexz );
+  Assert( faceyz );
+  Assert( ( ix_b >= 0 && ix_b < dims_b.ncell_x ) || ! is_cell_active );
+  Assert( ( iy_b >= 0 && iy_b < dims_b.ncell_y ) || ! is_cell_active );
+  Assert( ( iz_b >= 0 && iz_b < dims_b.ncell_z ) || ! is_cell_active );
+  Assert( ( ix_g >= 0 && ix_g < dims_g.ncell_x ) || ! is_cell_active );
+  Assert( ( iy_g >= 0 && iy_g < dims_g.ncell_y ) || ! is_cell_active );
+  Assert( ( iz_g >= 0 && iz_g < dims_g.ncell_z ) || ! is_cell_active );
+  Assert( ie   >= 0 && ie   < dims_b.ne );
+  Assert( octant >= 0 && octant < NOCTANT );
+  Assert( octant_in_block >= 0 && octant_in_block < noctant_per_block );
+
+  if( nia > 0 && is_cell_active )
+  {
+    const QuantitiesCoefs coefs = Quantities_coefs_( quan, ix_g, iy_g, iz_g,
+                                                     octant );
+
+    const SimdAcc v_scalefactor_octant    = SimdAcc_set1( coefs.octant );
+    const SimdAcc v_scalefactor_octant_r  = SimdAcc_set1( coefs.octant_r );
+    const SimdAcc v_scalefactor_space     = SimdAcc_set1( coefs.space );
+    const SimdAcc v_scalefactor_space_r   = SimdAcc_set1( coefs.space_r );
+    const SimdAcc v_scalefactor_space_x_r = SimdAcc_set1( coefs.space_x_r );
+    const SimdAcc v_scalefactor_space_y_r = SimdAcc_set1( coefs.space_y_r );
+    const SimdAcc v_scalefactor_space_z_r = SimdAcc_set1( coefs.space_z_r );
+
+    int iaind = 0;
+
+    for( iaind=0; iaind<nia; iaind+=SIMD_LEN )
+    {
+      const int ia = ia_base + iaind;
+      const int nlane = nia - iaind < SIMD_LEN ? nia - iaind : SIMD_LEN;
+      const SimdMask mask = SimdAcc_mask( nlane );
+
+      /*---Flux weights for these angles, invariant across unknowns---*/
+
+      const PAccum* const __restrict__ fluxweight
+                                          = quan->fluxweight_vals + ia;
+      const SimdAcc v_xfluxweight = SimdAcc_load_mask(
+                                     fluxweight + 0 * dims_g.na, mask );
+      const SimdAcc v_yfluxweight = SimdAcc_load_mask(
+                                     fluxweight + 1 * dims_g.na, mask );
+      const SimdAcc v_zfluxweight = SimdAcc_load_mask(
+                                     fluxweight + 2 * dims_g.na, mask );
+
+      int iu = 0;
+
+#pragma unroll
+      for( iu=0; iu<NU; ++iu )
+      {
+        PAccum* const __restrict__ vslocal_this
+                     = ref_vslocal( vslocal, dims_b, NU, iamax, iaind, iu );
+        P* const __restrict__ facexy_this
+                     = ref_facexy( facexy, dims_b, NU, noctant_per_block,
+                                   ix_b, iy_b, ie, ia, iu, octant_in_block );
+        P* const __restrict__ facexz_this
+                     = ref_facexz( facexz, dims_b, NU, noctant_per_block,
+                                   ix_b, iz_b, ie, ia, iu, octant_in_block );
+        P* const __restrict__ faceyz_this
+                     = ref_faceyz( faceyz, dims_b, NU, noctant_per_block,
+                                   iy_b, iz_b, ie, ia, iu, octant_in_block );
+
+        const SimdAcc face_xy = SimdAcc_load_P_mask( facexy_this, mask );
+        const SimdAcc face_xz = SimdAcc_load_P_mask( facexz_this, mask );
+        const SimdAcc face_yz = SimdAcc_load_P_mask( faceyz_this, mask );
+
+        const SimdAcc result = SimdAcc_mul( SimdAcc_add(
+          SimdAcc_mul( SimdAcc_load_mask( vslocal_this, mask ),
+                       v_scalefactor_space_r ),
+          SimdAcc_mul( SimdAcc_add( SimdAcc_add(
+            SimdAcc_mul( SimdAcc_mul( face_xy, v_xfluxweight ),
+                         v_scalefactor_space_z_r ),
+            SimdAcc_mul( SimdAcc_mul( face_xz, v_yfluxweight ),
+                         v_scalefactor_space_y_r ) ),
+            SimdAcc_mul( SimdAcc_mul( face_yz, v_zfluxweight ),
+                         v_scalefactor_space_x_r ) ),
+          v_scalefactor_octant_r ) ), v_scalefactor_space );
+
+        const SimdAcc result_scaled
+                               = SimdAcc_mul( result, v_scalefactor_octant );
+
+        SimdAcc_store_mask(   vslocal_this, result,        mask );
+        SimdAcc_store_P_mask( facexy_this,  result_scaled, mask );
+        SimdAcc_store_P_mask( facexz_this,  result_scaled, mask );
+        SimdAcc_store_P_mask( faceyz_this,  result_scaled, mask );
+      } /*---for iu---*/
+    } /*---for iaind---*/
+  }
+} /*---Quantities_solve_angles---*/
+
+/*===========================================================================*/
+/*---Perform equation solve at a cell, for a range of energy groups, SIMD---*/
+
+/*---Same as Quantities_solve applied to ie = ie_base + lane for
+     lane = 0 .. nlane-1 and all angles, but vectorized across energy
+     groups, for problems with too few angles to fill the SIMD lanes.
+     vslocal holds lane + SIMD_LEN * ( ia + na * iu ).  Face values for
+     successive groups are a fixed stride apart.  The operation order
+     matches Quantities_solve, so results agree bitwise---*/
+
+TARGET_HD static inline void Quantities_solve_elanes(
+  const Quantities* const  quan,
+  PAccum* const __restrict__ vslocal,
+  P* const __restrict__ facexy,
+  P* const __restrict__ facexz,
+  P* const __restrict__ faceyz,
+  const int             ix_b,
+  const int             iy_b,
+  const int             iz_b,
+  const int             ie_base,
+  const int             nlane,
+  const int             ix_g,
+  const int             iy_g,
+  const int             iz_g,
+  const int             octant,
+  const int             octant_in_block,
+  const int             noctant_per_block,
+  const Dimensions      dims_b,
+  const Dimensions      dims_g )
+{
+  Assert( vslocal );
+  Assert( facexy );
+  Assert( facexz );
+  Assert( faceyz );
+  Assert( ix_b >= 0 && ix_b < dims_b.ncell_x );
+  Assert( iy_b >= 0 && iy_b < dims_b.ncell_y );
+  Assert( iz_b >= 0 && iz_b < dims_b.ncell_z );
+  Assert( ix_g >= 0 && ix_g < dims_g.ncell_x );
+  Assert( iy_g >= 0 && iy_g < dims_g.ncell_y );
+  Assert( iz_g >= 0 && iz_g < dims_g.ncell_z );
+  Assert( nlane > 0 && nlane <= SIMD_LEN );
+  Assert( ie_base >= 0 && ie_base + nlane <= dims_b.ne );
+  Assert( octant >= 0 && octant < NOCTANT );
+  Assert( octant_in_block >= 0 && octant_in_block < noctant_per_block );
+
+  const QuantitiesCoefs coefs = Quantities_coefs_( quan, ix_g, iy_g, iz_g,
+                                                   octant );
+
+  const SimdAcc v_scalefactor_octant    = SimdAcc_set1( coefs.octant );
+  const SimdAcc v_scalefactor_octant_r  = SimdAcc_set1( coefs.octant_r );
+  const SimdAcc v_scalefactor_space     = SimdAcc_set1( coefs.space );
+  const SimdAcc v_scalefactor_space_r   = SimdAcc_set1( coefs.space_r );
+  const SimdAcc v_scalefactor_space_x_r = SimdAcc_set1( coefs.space_x_r );
+  const SimdAcc v_scalefactor_space_y_r = SimdAcc_set1( coefs.space_y_r );
+  const SimdAcc v_scalefactor_space_z_r = SimdAcc_set1( coefs.space_z_r );
+
+  const SimdMask mask_all = SimdAcc_mask( SIMD_LEN );
+
+  /*---Distance between face values of successive energy groups---*/
+
+  const size_t stride_xy = nlane == 1 ? 0 :
+      ref_facexy( facexy, dims_b, NU, noctant_per_block,
+                  ix_b, iy_b, ie_base+1, 0, 0, octant_in_block ) -
+      ref_facexy( facexy, dims_b, NU, noctant_per_block,
+                  ix_b, iy_b, ie_base,   0, 0, octant_in_block );
+  const size_t stride_xz = nlane == 1 ? 0 :
+      ref_facexz( facexz, dims_b, NU, noctant_per_block,
+                  ix_b, iz_b, ie_base+1, 0, 0, octant_in_block ) -
+      ref_facexz( facexz, dims_b, NU, noctant_per_block,
+                  ix_b, iz_b, ie_base,   0, 0, octant_in_block );
+  const size_t stride_yz = nlane == 1 ? 0 :
+      ref_faceyz( faceyz, dims_b, NU, noctant_per_block,
+                  iy_b, iz_b, ie_base+1, 0, 0, octant_in_block ) -
+      ref_faceyz( faceyz, dims_b, NU, noctant_per_block,
+                  iy_b, iz_b, ie_base,   0, 0, octant_in_block );
+
+  int ia = 0;
+
+  for( ia=0; ia<dims_b.na; ++ia )
+  {
+    const SimdAcc v_xfluxweight
+                 = SimdAcc_set1( quan->fluxweight_vals[ ia + 0 * dims_g.na ] );
+    const SimdAcc v_yfluxweight
+                 = SimdAcc_set1( quan->fluxweight_vals[ ia + 1 * dims_g.na ] );
+    const SimdAcc v_zfluxweight
+                 = SimdAcc_set1( quan->fluxweight_vals[ ia + 2 * dims_g.na ] );
+
+    int iu = 0;
+
+#pragma unroll
+    for( iu=0; iu<NU; ++iu )
+    {
+      PAccum* const __restrict__ vslocal_this
+                             = vslocal + SIMD_LEN * ( ia + dims_b.na * iu );
+      P* const __restrict__ facexy_this
+                     = ref_facexy( facexy, dims_b, NU, noctant_per_block,
+                                   ix_b, iy_b, ie_base, ia, iu,
+                                   octant_in_block );
+      P* const __restrict__ facexz_this
+                     = ref_facexz( facexz, dims_b, NU, noctant_per_block,
+                                   ix_b, iz_b, ie_base, ia, iu,
+                                   octant_in_block );
+      P* const __restrict__ faceyz_this
+                     = ref_faceyz( faceyz, dims_b, NU, noctant_per_block,
+                                   iy_b, iz_b, ie_base, ia, iu,
+                                   octant_in_block );
+
+      const SimdAcc face_xy
+                     = SimdAcc_load_P_stride( facexy_this, stride_xy, nlane );
+      const SimdAcc face_xz
+                     = SimdAcc_load_P_stride( facexz_this, stride_xz, nlane );
+      const SimdAcc face_yz
+                     = SimdAcc_load_P_stride( faceyz_this, stride_yz, nlane );
+
+      const SimdAcc result = SimdAcc_mul( SimdAcc_add(
+        SimdAcc_mul( SimdAcc_load_mask( vslocal_this, mask_all ),
+                     v_scalefactor_space_r ),
+        SimdAcc_mul( SimdAcc_add( SimdAcc_add(
+          SimdAcc_mul( SimdAcc_mul( face_xy, v_xfluxweight ),
+                       v_scalefactor_space_z_r ),
+          SimdAcc_mul( SimdAcc_mul( face_xz, v_yfluxweight ),
+                       v_scalefactor_space_y_r ) ),
+          SimdAcc_mul( SimdAcc_mul( face_yz, v_zfluxweight ),
+                       v_scalefactor_space_x_r ) ),
+        v_scalefactor_octant_r ) ), v_scalefactor_space );
+
+      const SimdAcc result_scaled
+                               = SimdAcc_mul( result, v_scalefactor_octant );
+
+      SimdAcc_store_mask(     vslocal_this, result, mask_all );
+      SimdAcc_store_P_stride( facexy_this, stride_xy, result_scaled, nlane );
+      SimdAcc_store_P_stride( facexz_this, stride_xz, result_scaled, nlane );
+      SimdAcc_store_P_stride( faceyz_this, stride_yz, result_scaled, nlane );
+    } /*---for iu---*/
+  } /*---for ia---*/
+} /*---Quantities_solve_elanes---*/
+
+/*===========================================================================*/
+/*---Perform equation solve at a run of cells, SIMD---*/
+
+/*---Same as Quantities_solve applied to cells icell = 0 .. ncell-1 at
+     ( ix_g + ix_inc * icell, iy_g + iy_inc * icell, iz_g ) and all angles,
+     but vectorized across the cells, which lie on one hyperplane and so
+     are independent.  The value for cell icell, angle ia, unknown iu is at
+     icell + stride * ( ia + na * iu ) in vslocal and in each face, with
+     the stride given for each.  The operation order matches
+     Quantities_solve, so results agree bitwise---*/
+
+TARGET_HD static inline void Quantities_solve_cells(
+  const Quantities* const  quan,
+  PAccum* const __restrict__ vslocal,
+  const int             stride_vslocal,
+  P* const __restrict__ facexy,
+  const int             stride_facexy,
+  P* const __restrict__ facexz,
+  const int             stride_facexz,
+  P* const __restrict__ faceyz,
+  const int             stride_faceyz,
+  const int             ncell,
+  const int             ix_g,
+  const int             iy_g,
+  const int             iz_g,
+  const int             ix_inc,
+  const int             iy_inc,
+  const int             ie,
+  const int             octant,
+  const Dimensions      dims_g )
+{
+  Assert( vslocal );
+  Assert( facexy );
+  Assert( facexz );
+  Assert( faceyz );
+  Assert( ncell > 0 );
+  Assert( stride_vslocal >= ncell );
+  Assert( stride_facexy >= ncell );
+  Assert( stride_facexz >= ncell );
+  Assert( stride_faceyz >= ncell );
+  Assert( ix_g >= 0 && ix_g < dims_g.ncell_x );
+  Assert( iy_g >= 0 && iy_g < dims_g.ncell_y );
+  Assert( iz_g >= 0 && iz_g < dims_g.ncell_z );
+  Assert( ix_g + ix_inc * ( ncell - 1 ) >= 0 &&
+          ix_g + ix_inc * ( ncell - 1 ) < dims_g.ncell_x );
+  Assert( iy_g + iy_inc * ( ncell - 1 ) >= 0 &&
+          iy_g + iy_inc * ( ncell - 1 ) < dims_g.ncell_y );
+  Assert( ie >= 0 && ie < dims_g.ne );
+  Assert( octant >= 0 && octant < NOCTANT );
+
+  int icell_base = 0;
+
+  for( icell_base=0; icell_base<ncell; icell_base+=SIMD_LEN )
+  {
+    const int nlane = ncell - icell_base < SIMD_LEN ? ncell - icell_base
+                                                    : SIMD_LEN;
+    const SimdMask mask = SimdAcc_mask( nlane );
+
+    /*---Coefficients of the cells, one cell per lane---*/
+
+    PAccum octant_sf[SIMD_LEN];
+    PAccum octant_r[SIMD_LEN];
+    PAccum space[SIMD_LEN];
+    PAccum space_r[SIMD_LEN];
+    PAccum space_x_r[SIMD_LEN];
+    PAccum space_y_r[SIMD_LEN];
+    PAccum space_z_r[SIMD_LEN];
+
+    int lane = 0;
+
+    for( lane=0; lane<nlane; ++lane )
+    {
+      const int icell = icell_base + lane;
+      const QuantitiesCoefs coefs = Quantities_coefs_( quan,
+                          ix_g + ix_inc * icell, iy_g + iy_inc * icell, iz_g,
+                          octant );
+      octant_sf[lane] = coefs.octant;
+      octant_r[lane]  = coefs.octant_r;
+      space[lane]     = coefs.space;
+      space_r[lane]   = coefs.space_r;
+      space_x_r[lane] = coefs.space_x_r;
+      space_y_r[lane] = coefs.space_y_r;
+      space_z_r[lane] = coefs.space_z_r;
+    }
+
+    const SimdAcc v_scalefactor_octant    = SimdAcc_load_mask( octant_sf,
+                                                               mask );
+    const SimdAcc v_scalefactor_octant_r  = SimdAcc_load_mask( octant_r,
+                                                               mask );
+    const SimdAcc v_scalefactor_space     = SimdAcc_load_mask( space, mask );
+    const SimdAcc v_scalefactor_space_r   = SimdAcc_load_mask( space_r,
+                                                               mask );
+    const SimdAcc v_scalefactor_space_x_r = SimdAcc_load_mask( space_x_r,
+                                                               mask );
+    const SimdAcc v_scalefactor_space_y_r = SimdAcc_load_mask( space_y_r,
+                                                               mask );
+    const SimdAcc v_scalefactor_space_z_r = SimdAcc_load_mask( space_z_r,
+                                                               mask );
+
+    int ia = 0;
+
+    for( ia=0; ia<dims_g.na; ++ia )
+    {
+      const SimdAcc v_xfluxweight
+                 = SimdAcc_set1( quan->fluxweight_vals[ ia + 0 * dims_g.na ] );
+      const SimdAcc v_yfluxweight
+                 = SimdAcc_set1( quan->fluxweight_vals[ ia + 1 * dims_g.na ] );
+      const SimdAcc v_zfluxweight
+                 = SimdAcc_set1( quan->fluxweight_vals[ ia + 2 * dims_g.na ] );
+
+      int iu = 0;
+
+#pragma unroll
+      for( iu=0; iu<NU; ++iu )
+      {
+        const int iaiu = ia + dims_g.na * iu;
+
+        PAccum* const __restrict__ vslocal_this
+                            = vslocal + icell_base + stride_vslocal * iaiu;
+        P* const __restrict__ facexy_this
+                            = facexy + icell_base + stride_facexy * iaiu;
+        P* const __restrict__ facexz_this
+                            = facexz + icell_base + stride_facexz * iaiu;
+        P* const __restrict__ faceyz_this
+                            = faceyz + icell_base + stride_faceyz * iaiu;
+
+        const SimdAcc face_xy = SimdAcc_load_P_mask( facexy_this, mask );
+        const SimdAcc face_xz = SimdAcc_load_P_mask( facexz_this, mask );
+        const SimdAcc face_yz = SimdAcc_load_P_mask( faceyz_this, mask );
+
+        const SimdAcc result = SimdAcc_mul( SimdAcc_add(
+          SimdAcc_mul( SimdAcc_load_mask( vslocal_this, mask ),
+                       v_scalefactor_space_r ),
+          SimdAcc_mul( SimdAcc_add( SimdAcc_add(
+            SimdAcc_mul( SimdAcc_mul( face_xy, v_xfluxweight ),
+                         v_scalefactor_space_z_r ),
+            SimdAcc_mul( SimdAcc_mul( face_xz, v_yfluxweight ),
+                         v_scalefactor_space_y_r ) ),
+            SimdAcc_mul( SimdAcc_mul( face_yz, v_zfluxweight ),
+                         v_scalefactor_space_x_r ) ),
+          v_scalefactor_octant_r ) ), v_scalefactor_space );
+
+        const SimdAcc result_scaled
+                               = SimdAcc_mul( result, v_scalefactor_octant );
+
+        SimdAcc_store_mask(   vslocal_this, result,        mask );
+        SimdAcc_store_P_mask( facexy_this,  result_scaled, mask );
+        SimdAcc_store_P_mask( facexz_this,  result_scaled, mask );
+        SimdAcc_store_P_mask( faceyz_this,  result_scaled, mask );
+      } /*---for iu---*/
+    } /*---for ia---*/
+  } /*---for icell_base---*/
+} /*---Quantities_solve_cells---*/
+
 /*===========================================================================*/
 
 #ifdef __cplusplus
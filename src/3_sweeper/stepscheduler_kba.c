@@ -39,6 +39,7 @@ void StepScheduler_create( StepScheduler* stepscheduler,
   stepscheduler->nblock_z_          = nblock_z;
   stepscheduler->nproc_x_           = Env_nproc_x( env );
   stepscheduler->nproc_y_           = Env_nproc_y( env );
+  stepscheduler->nproc_z_           = Env_nproc_z( env );
   stepscheduler->nblock_octant_     = nblock_octant;
   stepscheduler->noctant_per_block_ = NOCTANT / nblock_octant;
 }
@@ -51,7 +52,7 @@ void StepScheduler_destroy( StepScheduler* stepscheduler )
 }
 
 /*===========================================================================*/
-/*---Accessor: blocks along z axis---*/
+/*---Accessor: blocks along z axis, this proc---*/
 
 int StepScheduler_nblock_z( const StepScheduler* stepscheduler )
 {
@@ -63,7 +64,7 @@ int StepScheduler_nblock_z( const StepScheduler* stepscheduler )
 
 int StepScheduler_nblock( const StepScheduler* stepscheduler )
 {
-  return stepscheduler->nblock_z_;
+  return stepscheduler->nblock_z_ * stepscheduler->nproc_z_;
 }
 
 /*===========================================================================*/
@@ -122,7 +123,8 @@ StepInfo StepScheduler_stepinfo( const StepScheduler* stepscheduler,
                                  const int            step,
                                  const int            octant_in_block,
                                  const int            proc_x,
-                                 const int            proc_y )
+                                 const int            proc_y,
+                                 const int            proc_z )
 {
   Assert( octant_in_block>=0 &&
           octant_in_block * stepscheduler->nblock_octant_ < NOCTANT );
@@ -132,6 +134,8 @@ StepInfo StepScheduler_stepinfo( const StepScheduler* stepscheduler,
   */
   const int nproc_x           = stepscheduler->nproc_x_;
   const int nproc_y           = stepscheduler->nproc_y_;
+  const int nproc_z           = stepscheduler->nproc_z_;
+  const int nblock_z          = stepscheduler->nblock_z_;
   const int nblock            = StepScheduler_nblock( stepscheduler );
   const int nstep             = StepScheduler_nstep( stepscheduler );
   const int noctant_per_block = stepscheduler->noctant_per_block_;
@@ -140,6 +144,7 @@ StepInfo StepScheduler_stepinfo( const StepScheduler* stepscheduler,
   int wave          = 0;
   int step_base     = 0;
   int block         = 0;
+  int block_z       = 0;
   int octant        = 0;
   int dir_x         = 0;
   int dir_y         = 0;
@@ -266,18 +271,26 @@ StepInfo StepScheduler_stepinfo( const StepScheduler* stepscheduler,
                           ? ( nblock - 1 - folded_block )
                           : folded_block;
 
+  /*---The block is numbered along the whole column of procs along z;
+       get its number on proc_z, which owns blocks
+       proc_z*nblock_z .. proc_z*nblock_z+nblock_z-1 of the column---*/
+
+  block_z = block - proc_z * nblock_z;
+
   /*---Now determine whether the block calculation is active based on whether
        the block in question falls within the physical domain.
   ---*/
 
-  stepinfo.is_active = block  >= 0 && block  < nblock &&
-                       step   >= 0 && step   < nstep &&
-                       proc_x >= 0 && proc_x < nproc_x &&
-                       proc_y >= 0 && proc_y < nproc_y;
+  stepinfo.is_active = block   >= 0 && block   < nblock &&
+                       block_z >= 0 && block_z < nblock_z &&
+                       step    >= 0 && step    < nstep &&
+                       proc_x  >= 0 && proc_x  < nproc_x &&
+                       proc_y  >= 0 && proc_y  < nproc_y &&
+                       proc_z  >= 0 && proc_z  < nproc_z;
 
   /*---Set remaining values---*/
 
-  stepinfo.block_z = stepinfo.is_active ? block : 0;
+  stepinfo.block_z = stepinfo.is_active ? block_z : 0;
   stepinfo.octant  = octant;
 
   return stepinfo;
@@ -296,21 +309,37 @@ Bool_t StepScheduler_must_do_send(
 {
   const int proc_x = Env_proc_x_this( env );
   const int proc_y = Env_proc_y_this( env );
+  const int proc_z = Env_proc_z_this( env );
 
   const Bool_t axis_x = axis==0;
   const Bool_t axis_y = axis==1;
+  const Bool_t axis_z = axis==2;
 
   const int dir = dir_ind==0 ? (int)DIR_UP : (int)DIR_DN;
   const int inc_x = axis_x ? Dir_inc( dir ) : 0;
   const int inc_y = axis_y ? Dir_inc( dir ) : 0;
+  const int inc_z = axis_z ? Dir_inc( dir ) : 0;
 
   /*---Get step info for processors involved in communication---*/
 
   const StepInfo stepinfo_send_source_step = StepScheduler_stepinfo(
-    stepscheduler, step,   octant_in_block, proc_x,       proc_y       );
+    stepscheduler, step,   octant_in_block,
+    proc_x,       proc_y,       proc_z       );
 
   const StepInfo stepinfo_send_target_step = StepScheduler_stepinfo(
-    stepscheduler, step+1, octant_in_block, proc_x+inc_x, proc_y+inc_y );
+    stepscheduler, step+1, octant_in_block,
+    proc_x+inc_x, proc_y+inc_y, proc_z+inc_z );
+
+  /*---Along z the face passes from the last block of one proc to the
+       first block of the next, in the direction of the sweep---*/
+
+  const int nblock_z = stepscheduler->nblock_z_;
+  const int block_z_last = dir==DIR_UP ? nblock_z-1 : 0;
+
+  const Bool_t is_block_z_match = axis_z ?
+      stepinfo_send_source_step.block_z == block_z_last &&
+      stepinfo_send_target_step.block_z == nblock_z-1 - block_z_last :
+      stepinfo_send_source_step.block_z == stepinfo_send_target_step.block_z;
 
   /*---Determine whether to communicate---*/
 
@@ -318,11 +347,11 @@ Bool_t StepScheduler_must_do_send(
                       && stepinfo_send_target_step.is_active
                       && stepinfo_send_source_step.octant ==
                          stepinfo_send_target_step.octant
-                      && stepinfo_send_source_step.block_z ==
-                         stepinfo_send_target_step.block_z
-                      && ( axis_x ?
-                           Dir_x( stepinfo_send_target_step.octant ) :
-                           Dir_y( stepinfo_send_target_step.octant ) ) == dir;
+                      && is_block_z_match
+                      && ( axis_x ? Dir_x( stepinfo_send_target_step.octant ) :
+                           axis_y ? Dir_y( stepinfo_send_target_step.octant ) :
+                                    Dir_z( stepinfo_send_target_step.octant ) )
+                         == dir;
 
   return do_send;
 }
@@ -340,21 +369,37 @@ Bool_t StepScheduler_must_do_recv(
 {
   const int proc_x = Env_proc_x_this( env );
   const int proc_y = Env_proc_y_this( env );
+  const int proc_z = Env_proc_z_this( env );
 
   const Bool_t axis_x = axis==0;
   const Bool_t axis_y = axis==1;
+  const Bool_t axis_z = axis==2;
 
   const int dir = dir_ind==0 ? (int)DIR_UP : (int)DIR_DN;
   const int inc_x = axis_x ? Dir_inc( dir ) : 0;
   const int inc_y = axis_y ? Dir_inc( dir ) : 0;
+  const int inc_z = axis_z ? Dir_inc( dir ) : 0;
 
   /*---Get step info for processors involved in communication---*/
 
   const StepInfo stepinfo_recv_source_step = StepScheduler_stepinfo(
-    stepscheduler, step,   octant_in_block, proc_x-inc_x, proc_y-inc_y );
+    stepscheduler, step,   octant_in_block,
+    proc_x-inc_x, proc_y-inc_y, proc_z-inc_z );
 
   const StepInfo stepinfo_recv_target_step = StepScheduler_stepinfo(
-    stepscheduler, step+1, octant_in_block, proc_x,       proc_y       );
+    stepscheduler, step+1, octant_in_block,
+    proc_x,       proc_y,       proc_z       );
+
+  /*---Along z the face passes from the last block of one proc to the
+       first block of the next, in the direction of the sweep---*/
+
+  const int nblock_z = stepscheduler->nblock_z_;
+  const int block_z_last = dir==DIR_UP ? nblock_z-1 : 0;
+
+  const Bool_t is_block_z_match = axis_z ?
+      stepinfo_recv_source_step.block_z == block_z_last &&
+      stepinfo_recv_target_step.block_z == nblock_z-1 - block_z_last :
+      stepinfo_recv_source_step.block_z == stepinfo_recv_target_step.block_z;
 
   /*---Determine whether to communicate---*/
 
@@ -362,11 +407,11 @@ Bool_t StepScheduler_must_do_recv(
                       && stepinfo_recv_target_step.is_active
                       && stepinfo_recv_source_step.octant ==
                          stepinfo_recv_target_step.octant
-                      && stepinfo_recv_source_step.block_z ==
-                         stepinfo_recv_target_step.block_z
-                      && ( axis_x ?
-                           Dir_x( stepinfo_recv_target_step.octant ) :
-                           Dir_y( stepinfo_recv_target_step.octant ) ) == dir;
+                      && is_block_z_match
+                      && ( axis_x ? Dir_x( stepinfo_recv_target_step.octant ) :
+                           axis_y ? Dir_y( stepinfo_recv_target_step.octant ) :
+                                    Dir_z( stepinfo_recv_target_step.octant ) )
+                         == dir;
 
   return do_recv;
 }
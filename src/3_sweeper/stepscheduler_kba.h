@@ -28,6 +28,7 @@ typedef struct
   int nblock_z_;
   int nproc_x_;
   int nproc_y_;
+  int nproc_z_;
   int nblock_octant_;
   int noctant_per_block_;
 } StepScheduler;
@@ -51,13 +52,16 @@ void StepScheduler_create( StepScheduler* stepscheduler,
 void StepScheduler_destroy( StepScheduler* stepscheduler );
 
 /*===========================================================================*/
-/*---Accessor: blocks along z axis---*/
+/*---Accessor: blocks along z axis, this proc---*/
 
 int StepScheduler_nblock_z( const StepScheduler* stepscheduler );
 
 /*===========================================================================*/
 /*---Number of block steps executed for a single octant in isolation---*/
 
+/*---This is the number of blocks of a column of procs along z, which
+     the octant crosses one block per step---*/
+
 int StepScheduler_nblock( const StepScheduler* stepscheduler );
 
 /*===========================================================================*/
@@ -77,7 +81,8 @@ StepInfo StepScheduler_stepinfo( const StepScheduler* stepscheduler,
                                  const int            step,
                                  const int            octant_in_block,
                                  const int            proc_x,
-                                 const int            proc_y );
+                                 const int            proc_y,
+                                 const int            proc_z );
 
 /*===========================================================================*/
 /*---Determine whether to send a face computed at step, used at step+1---*/
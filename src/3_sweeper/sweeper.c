@@ -18,6 +18,10 @@
 #include "sweeper_tileoctants_c.h"
 #endif
 
+#ifdef SWEEPER_HYPERPLANE
+#include "sweeper_hyperplane_c.h"
+#endif
+
 #ifdef SWEEPER_KBA
 #include "sweeper_kba_c.h"
 #endif
@@ -25,9 +25,15 @@
 #ifdef USE_OPENMP4
 #define SWEEPER_OPENMP4
 #else
+#ifndef SWEEPER_SIMPLE
+#ifndef SWEEPER_TILEOCTANTS
+#ifndef SWEEPER_HYPERPLANE
 #define SWEEPER_KBA
 #endif
 #endif
+#endif
+#endif
+#endif
 
 #ifdef SWEEPER_SIMPLE
 #include "sweeper_simple.h"
@@ -37,6 +43,10 @@
 #include "sweeper_tileoctants.h"
 #endif
 
+#ifdef SWEEPER_HYPERPLANE
+#include "sweeper_hyperplane.h"
+#endif
+
 #ifdef SWEEPER_KBA
 #include "sweeper_kba.h"
 #endif
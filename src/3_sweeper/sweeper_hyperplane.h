@@ -0,0 +1,97 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   sweeper_hyperplane.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Declarations for performing a sweep, hyperplane version.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#ifndef _sweeper_hyperplane_h_
+#define _sweeper_hyperplane_h_
+
+#include "env.h"
+#include "definitions.h"
+#include "dimensions.h"
+#include "arguments.h"
+#include "quantities.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Struct with pointers etc. used to perform sweep---*/
+
+/*---Cells with equal ix + iy + iz, counted in the sweep direction, are
+     independent.  This version sweeps such hyperplanes in turn and
+     vectorizes the solve across their cells.  The cells of a hyperplane
+     with the same iz form a run, and the faces are laid out so that a run
+     is unit stride in each: facexy by ix + iy diagonals, facexz with ix
+     running backward, faceyz as usual---*/
+
+typedef struct
+{
+  P* __restrict__       facexy;
+  P* __restrict__       facexz;
+  P* __restrict__       faceyz;
+  PAccum* __restrict__  vslocal;
+
+  /*---Start of each ix + iy diagonal in facexy---*/
+  int*                  facexy_diag_offset;
+
+  /*---Most cells with the same iz on a hyperplane---*/
+  int                   ncell_run_max;
+
+  Dimensions            dims;
+} Sweeper;
+
+/*===========================================================================*/
+/*---Null object---*/
+
+Sweeper Sweeper_null(void);
+
+/*===========================================================================*/
+/*---Pseudo-constructor for Sweeper struct---*/
+
+void Sweeper_create( Sweeper*          sweeper,
+                     Dimensions        dims,
+                     const Quantities* quan,
+                     Env*              env,
+                     Arguments*        args );
+
+/*===========================================================================*/
+/*---Pseudo-destructor for Sweeper struct---*/
+
+void Sweeper_destroy( Sweeper* sweeper,
+                      Env*     env );
+
+/*===========================================================================*/
+/*---Number of octants in an octant block---*/
+
+static int Sweeper_noctant_per_block( const Sweeper* sweeper )
+{
+  return 1;
+}
+
+/*===========================================================================*/
+/*---Perform a sweep---*/
+
+void Sweeper_sweep(
+  Sweeper*               sweeper,
+  Pointer*               vo,
+  Pointer*               vi,
+  const Quantities*      quan,
+  Env*                   env );
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_sweeper_hyperplane_h_---*/
+
+/*---------------------------------------------------------------------------*/
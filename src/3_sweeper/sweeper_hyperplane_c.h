@@ -0,0 +1,431 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   sweeper_hyperplane_c.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Definitions for performing a sweep, hyperplane version.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#ifndef _sweeper_hyperplane_c_h_
+#define _sweeper_hyperplane_c_h_
+
+#include <stdlib.h>
+
+#include "env.h"
+#include "definitions.h"
+#include "quantities.h"
+#include "array_accessors.h"
+#include "array_operations.h"
+#include "sweeper_hyperplane.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*===========================================================================*/
+/*---Null object---*/
+
+Sweeper Sweeper_null()
+{
+  Sweeper result;
+  memset( (void*)&result, 0, sizeof(Sweeper) );
+  return result;
+}
+
+/*===========================================================================*/
+/*---Pseudo-constructor for Sweeper struct---*/
+
+void Sweeper_create( Sweeper*          sweeper,
+                     Dimensions        dims,
+                     const Quantities* quan,
+                     Env*              env,
+                     Arguments*        args )
+{
+  Insist( Env_nproc( env ) == 1 &&
+                             "This sweeper version runs only with one proc." );
+
+  Insist( dims.nm == NM && dims.nu == NU ?
+          "This sweeper version supports only the compile-time NM, NU." : 0 );
+
+  const int ndiag_xy = dims.ncell_x + dims.ncell_y - 1;
+  int idiag = 0;
+
+  /*---Offsets of the ix + iy diagonals of facexy---*/
+
+  sweeper->facexy_diag_offset = (int*)malloc( ( ndiag_xy + 1 ) * sizeof(int) );
+  Insist( sweeper->facexy_diag_offset ? "Allocation failure." : 0 );
+
+  sweeper->facexy_diag_offset[0] = 0;
+  for( idiag=0; idiag<ndiag_xy; ++idiag )
+  {
+    const int iy_min = idiag < dims.ncell_x ? 0 : idiag - dims.ncell_x + 1;
+    const int iy_max = idiag < dims.ncell_y ? idiag : dims.ncell_y - 1;
+    sweeper->facexy_diag_offset[idiag+1] = sweeper->facexy_diag_offset[idiag]
+                                           + iy_max - iy_min + 1;
+  }
+  Assert( sweeper->facexy_diag_offset[ndiag_xy] ==
+          dims.ncell_x * dims.ncell_y );
+
+  sweeper->ncell_run_max = dims.ncell_x < dims.ncell_y ? dims.ncell_x
+                                                       : dims.ncell_y;
+
+  /*---Allocate arrays---*/
+
+  sweeper->vslocal = malloc_host_PAccum( sweeper->ncell_run_max *
+                                         dims.na * NU );
+  sweeper->facexy  = malloc_host_P( dims.ncell_x * dims.ncell_y * dims.ne *
+                         dims.na * NU * Sweeper_noctant_per_block( sweeper ) );
+  sweeper->facexz  = malloc_host_P( dims.ncell_x * dims.ncell_z * dims.ne *
+                         dims.na * NU * Sweeper_noctant_per_block( sweeper ) );
+  sweeper->faceyz  = malloc_host_P( dims.ncell_y * dims.ncell_z * dims.ne *
+                         dims.na * NU * Sweeper_noctant_per_block( sweeper ) );
+
+  sweeper->dims = dims;
+}
+
+/*===========================================================================*/
+/*---Pseudo-destructor for Sweeper struct---*/
+
+void Sweeper_destroy( Sweeper* sweeper,
+                      Env*     env )
+{
+  /*---Deallocate arrays---*/
+
+  free_host_PAccum( sweeper->vslocal );
+  free_host_P( sweeper->facexy );
+  free_host_P( sweeper->facexz );
+  free_host_P( sweeper->faceyz );
+  free( sweeper->facexy_diag_offset );
+
+  sweeper->vslocal            = NULL;
+  sweeper->facexy             = NULL;
+  sweeper->facexz             = NULL;
+  sweeper->faceyz             = NULL;
+  sweeper->facexy_diag_offset = NULL;
+}
+
+/*===========================================================================*/
+/*---Cell index from index counted in the sweep direction, and back---*/
+/*---pseudo-private member function---*/
+
+static int Sweeper_index_dir_( int i, int dir, int ncell )
+{
+  return dir == DIR_UP ? i : ncell - 1 - i;
+}
+
+/*===========================================================================*/
+/*---Face array accessors---*/
+/*---pseudo-private member functions---*/
+
+/*---jx, jy, jz are counted in the sweep direction.  Along a run, jy
+     increases and jx decreases by one from cell to cell, and the position
+     in each face increases by one.  Positions are fastest, then angle,
+     unknown and energy group---*/
+
+static P* Sweeper_ref_facexy_( const Sweeper* sweeper,
+                               int jx, int jy, int ie, int ia, int iu )
+{
+  const Dimensions dims = sweeper->dims;
+  const int idiag = jx + jy;
+  const int jy_min = idiag < dims.ncell_x ? 0 : idiag - dims.ncell_x + 1;
+
+  Assert( jx >= 0 && jx < dims.ncell_x );
+  Assert( jy >= 0 && jy < dims.ncell_y );
+
+  return & sweeper->facexy[ sweeper->facexy_diag_offset[ idiag ] +
+                            jy - jy_min +
+                            dims.ncell_x * dims.ncell_y * (
+                            ia + dims.na * (
+                            iu + NU      * (
+                            ie ))) ];
+}
+
+/*---------------------------------------------------------------------------*/
+
+static P* Sweeper_ref_facexz_( const Sweeper* sweeper,
+                               int jx, int jz, int ie, int ia, int iu )
+{
+  const Dimensions dims = sweeper->dims;
+
+  Assert( jx >= 0 && jx < dims.ncell_x );
+  Assert( jz >= 0 && jz < dims.ncell_z );
+
+  return & sweeper->facexz[ dims.ncell_x - 1 - jx +
+                            dims.ncell_x * (
+                            jz + dims.ncell_z * (
+                            ia + dims.na * (
+                            iu + NU      * (
+                            ie )))) ];
+}
+
+/*---------------------------------------------------------------------------*/
+
+static P* Sweeper_ref_faceyz_( const Sweeper* sweeper,
+                               int jy, int jz, int ie, int ia, int iu )
+{
+  const Dimensions dims = sweeper->dims;
+
+  Assert( jy >= 0 && jy < dims.ncell_y );
+  Assert( jz >= 0 && jz < dims.ncell_z );
+
+  return & sweeper->faceyz[ jy +
+                            dims.ncell_y * (
+                            jz + dims.ncell_z * (
+                            ia + dims.na * (
+                            iu + NU      * (
+                            ie )))) ];
+}
+
+/*===========================================================================*/
+/*---Initialize faces---*/
+/*---pseudo-private member function---*/
+
+/*---See sweeper_simple_c.h for the semantics of the face arrays---*/
+
+static void Sweeper_init_faces_( Sweeper*          sweeper,
+                                 const Quantities* quan,
+                                 int               octant )
+{
+  const Dimensions dims = sweeper->dims;
+
+  const int dir_x = Dir_x( octant );
+  const int dir_y = Dir_y( octant );
+  const int dir_z = Dir_z( octant );
+
+  int ix = 0;
+  int iy = 0;
+  int iz = 0;
+  int ie = 0;
+  int ia = 0;
+  int iu = 0;
+
+  {
+    iz = dir_z == DIR_UP ? -1 : dims.ncell_z;
+    for( ie=0; ie<dims.ne; ++ie )
+    for( iu=0; iu<NU; ++iu )
+    for( ia=0; ia<dims.na; ++ia )
+    for( iy=0; iy<dims.ncell_y; ++iy )
+    for( ix=0; ix<dims.ncell_x; ++ix )
+    {
+      *Sweeper_ref_facexy_( sweeper,
+                            Sweeper_index_dir_( ix, dir_x, dims.ncell_x ),
+                            Sweeper_index_dir_( iy, dir_y, dims.ncell_y ),
+                            ie, ia, iu )
+           = Quantities_init_facexy( quan, ix, iy, iz, ie, ia, iu, octant,
+                                     dims );
+    }
+  }
+
+  {
+    iy = dir_y == DIR_UP ? -1 : dims.ncell_y;
+    for( ie=0; ie<dims.ne; ++ie )
+    for( iu=0; iu<NU; ++iu )
+    for( ia=0; ia<dims.na; ++ia )
+    for( iz=0; iz<dims.ncell_z; ++iz )
+    for( ix=0; ix<dims.ncell_x; ++ix )
+    {
+      *Sweeper_ref_facexz_( sweeper,
+                            Sweeper_index_dir_( ix, dir_x, dims.ncell_x ),
+                            Sweeper_index_dir_( iz, dir_z, dims.ncell_z ),
+                            ie, ia, iu )
+           = Quantities_init_facexz( quan, ix, iy, iz, ie, ia, iu, octant,
+                                     dims );
+    }
+  }
+
+  {
+    ix = dir_x == DIR_UP ? -1 : dims.ncell_x;
+    for( ie=0; ie<dims.ne; ++ie )
+    for( iu=0; iu<NU; ++iu )
+    for( ia=0; ia<dims.na; ++ia )
+    for( iz=0; iz<dims.ncell_z; ++iz )
+    for( iy=0; iy<dims.ncell_y; ++iy )
+    {
+      *Sweeper_ref_faceyz_( sweeper,
+                            Sweeper_index_dir_( iy, dir_y, dims.ncell_y ),
+                            Sweeper_index_dir_( iz, dir_z, dims.ncell_z ),
+                            ie, ia, iu )
+           = Quantities_init_faceyz( quan, ix, iy, iz, ie, ia, iu, octant,
+                                     dims );
+    }
+  }
+}
+
+/*===========================================================================*/
+/*---Sweep one run of a hyperplane---*/
+/*---pseudo-private member function---*/
+
+/*---The run is the ncell cells with jz given, starting at jx0, jy0---*/
+
+static void Sweeper_sweep_run_( Sweeper*          sweeper,
+                                Pointer*          vo,
+                                Pointer*          vi,
+                                const Quantities* quan,
+                                int               octant,
+                                int               ie,
+                                int               jx0,
+                                int               jy0,
+                                int               jz,
+                                int               ncell )
+{
+  const Dimensions dims = sweeper->dims;
+  const int nvslocal = sweeper->ncell_run_max;
+
+  const int dir_x = Dir_x( octant );
+  const int dir_y = Dir_y( octant );
+  const int dir_z = Dir_z( octant );
+
+  /*---Cell icell of the run is at ix0 + ix_inc * icell, etc.---*/
+
+  const int ix0 = Sweeper_index_dir_( jx0, dir_x, dims.ncell_x );
+  const int iy0 = Sweeper_index_dir_( jy0, dir_y, dims.ncell_y );
+  const int iz  = Sweeper_index_dir_( jz,  dir_z, dims.ncell_z );
+  const int ix_inc = - Dir_inc( dir_x );
+  const int iy_inc =   Dir_inc( dir_y );
+
+  int icell = 0;
+  int im = 0;
+  int ia = 0;
+  int iu = 0;
+
+  Assert( ncell > 0 && ncell <= nvslocal );
+  Assert( jx0 - ( ncell - 1 ) >= 0 );
+  Assert( jy0 + ( ncell - 1 ) < dims.ncell_y );
+
+  /*--------------------*/
+  /*---Transform state vector from moments to angles---*/
+  /*--------------------*/
+
+  for( iu=0; iu<NU; ++iu )
+  for( ia=0; ia<dims.na; ++ia )
+  for( icell=0; icell<ncell; ++icell )
+  {
+    PAccum result = PAccum_zero();
+    for( im=0; im<dims.nm; ++im )
+    {
+      result += *const_ref_a_from_m( Pointer_const_h( & quan->a_from_m ),
+                                     dims, im, ia, octant )*
+                *const_ref_state(    Pointer_h( vi ), dims, NU,
+                                     ix0 + ix_inc * icell,
+                                     iy0 + iy_inc * icell, iz, ie, im, iu );
+    }
+    sweeper->vslocal[ icell + nvslocal * ( ia + dims.na * iu ) ] = result;
+  }
+
+  /*--------------------*/
+  /*---Perform solve---*/
+  /*--------------------*/
+
+  Quantities_solve_cells( quan,
+    sweeper->vslocal, nvslocal,
+    Sweeper_ref_facexy_( sweeper, jx0, jy0, ie, 0, 0 ),
+    dims.ncell_x * dims.ncell_y,
+    Sweeper_ref_facexz_( sweeper, jx0, jz, ie, 0, 0 ),
+    dims.ncell_x * dims.ncell_z,
+    Sweeper_ref_faceyz_( sweeper, jy0, jz, ie, 0, 0 ),
+    dims.ncell_y * dims.ncell_z,
+    ncell, ix0, iy0, iz, ix_inc, iy_inc, ie, octant, dims );
+
+  /*--------------------*/
+  /*---Transform state vector from angles to moments---*/
+  /*--------------------*/
+
+  for( iu=0; iu<NU; ++iu )
+  for( im=0; im<dims.nm; ++im )
+  for( icell=0; icell<ncell; ++icell )
+  {
+    PAccum result = PAccum_zero();
+    for( ia=0; ia<dims.na; ++ia )
+    {
+      result += *const_ref_m_from_a( Pointer_const_h( & quan->m_from_a ),
+                                     dims, im, ia, octant )*
+                sweeper->vslocal[ icell + nvslocal * ( ia + dims.na * iu ) ];
+    }
+    *ref_state( Pointer_h( vo ), dims, NU,
+                ix0 + ix_inc * icell, iy0 + iy_inc * icell, iz,
+                ie, im, iu ) += result;
+  }
+}
+
+/*===========================================================================*/
+/*---Perform a sweep---*/
+
+void Sweeper_sweep(
+  Sweeper*               sweeper,
+  Pointer*               vo,
+  Pointer*               vi,
+  const Quantities*      quan,
+  Env*                   env )
+{
+  Assert( sweeper );
+  Assert( vi );
+  Assert( vo );
+
+  const Dimensions dims = sweeper->dims;
+  const int nplane = dims.ncell_x + dims.ncell_y + dims.ncell_z - 2;
+
+  int octant = 0;
+  int ie = 0;
+  int iplane = 0;
+  int jz = 0;
+
+  /*---Initialize result array to zero---*/
+
+  initialize_state_zero( Pointer_h( vo ), dims, NU );
+
+  /*---Loop over octants---*/
+
+  for( octant=0; octant<NOCTANT; ++octant )
+  {
+    Sweeper_init_faces_( sweeper, quan, octant );
+
+    /*---Loop over energy groups---*/
+
+    for( ie=0; ie<dims.ne; ++ie )
+    {
+      /*---Loop over hyperplanes jx + jy + jz = iplane, in order---*/
+
+      for( iplane=0; iplane<nplane; ++iplane )
+      {
+        const int jz_min = iplane - ( dims.ncell_x - 1 )
+                                  - ( dims.ncell_y - 1 ) > 0 ?
+                           iplane - ( dims.ncell_x - 1 )
+                                  - ( dims.ncell_y - 1 ) : 0;
+        const int jz_max = iplane < dims.ncell_z - 1 ? iplane
+                                                     : dims.ncell_z - 1;
+
+        /*---Runs of the hyperplane are independent of each other---*/
+
+        for( jz=jz_min; jz<=jz_max; ++jz )
+        {
+          const int idiag = iplane - jz;
+          const int jy_min = idiag < dims.ncell_x ? 0
+                                                  : idiag - dims.ncell_x + 1;
+          const int jy_max = idiag < dims.ncell_y ? idiag
+                                                  : dims.ncell_y - 1;
+
+          Sweeper_sweep_run_( sweeper, vo, vi, quan, octant, ie,
+                              idiag - jy_min, jy_min, jz,
+                              jy_max - jy_min + 1 );
+        }
+
+      } /*---iplane---*/
+
+    } /*---ie---*/
+
+  } /*---octant---*/
+
+} /*---sweep---*/
+
+/*===========================================================================*/
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---_sweeper_hyperplane_c_h_---*/
+
+/*---------------------------------------------------------------------------*/
@@ -13,6 +13,8 @@
 
 #include "types.h"
 #include "env.h"
+#include "taskgraph.h"
+#include "threadteam.h"
 #include "definitions.h"
 #include "dimensions.h"
 #include "arguments.h"
@@ -28,14 +30,75 @@ extern "C"
 {
 #endif
 
+/*===========================================================================*/
+/*---Sweep block kernel specialized for one (NM, NU) pair---*/
+
+typedef void (*Sweeper_sweep_block_impl_t)(
+  SweeperLite            sweeper,
+        P* __restrict__  vo,
+  const P* __restrict__  vi,
+        P* __restrict__  facexy,
+        P* __restrict__  facexz,
+        P* __restrict__  faceyz,
+  const P* __restrict__  a_from_m,
+  const P* __restrict__  m_from_a,
+  int                    step,
+  const Quantities       quan,
+  Bool_t                 proc_x_min,
+  Bool_t                 proc_x_max,
+  Bool_t                 proc_y_min,
+  Bool_t                 proc_y_max,
+  StepInfoAll            stepinfoall,
+  unsigned long int      do_block_init );
+
+/*---Apply a moment/angle transform variant nrep times, for calibration---*/
+
+typedef void (*Sweeper_xform_bench_t)(
+  int                     variant,
+  int                     na,
+  const P* __restrict__   a_from_m,
+  const P* __restrict__   m_from_a,
+  PAccum* __restrict__    vxform,
+  int                     nrep );
+
+typedef struct
+{
+  /*---Sizes the kernel was compiled for---*/
+  int                         nm;
+  int                         nu;
+
+  /*---Compile-time thread counts of the kernel, host and device---*/
+  int                         nthread_a;
+  int                         nthread_m;
+  int                         nthread_u;
+  int                         nthread_device_a;
+  int                         nthread_device_m;
+  int                         nthread_device_u;
+
+  /*---Entry points---*/
+  Sweeper_sweep_block_impl_t  impl;
+  Sweeper_sweep_block_impl_t  impl_global;
+  Sweeper_xform_bench_t       xform_bench;
+} SweeperKernel;
+
+/*===========================================================================*/
+/*---Look up the kernel instantiated for given nm, nu; NULL if none---*/
+
+const SweeperKernel* Sweeper_kernel_find( int nm, int nu );
+
 /*===========================================================================*/
 /*---Struct with pointers etc. used to perform sweep---*/
 
 typedef struct
 {
-  P* __restrict__  vilocal_host_;
-  P* __restrict__  vslocal_host_;
-  P* __restrict__  volocal_host_;
+  PAccum* __restrict__  vilocal_host_;
+  PAccum* __restrict__  vslocal_host_;
+  PAccum* __restrict__  volocal_host_;
+  PAccum* __restrict__  vmbatch_host_;
+  PAccum* __restrict__  vabatch_host_;
+  PAccum* __restrict__  velanes_host_;
+  PAccum* __restrict__  vxform_host_;
+  P* __restrict__       vo_private_host_;
 
   Dimensions       dims;
   Dimensions       dims_b;
@@ -54,10 +117,25 @@ typedef struct
   int              ncell_x_per_subblock;
   int              ncell_y_per_subblock;
   int              ncell_z_per_subblock;
+  int              ne_per_tile;
+  int              ne_per_chunk;
+  int              ncell_x_per_tile;
+  int              ncell_y_per_tile;
+  int              gemm_batch_size;
+  Bool_t           is_using_energy_lanes;
+  int              xform_variant;
+  Bool_t           is_using_vo_private;
+  Bool_t           is_using_dataflow;
 
   StepScheduler    stepscheduler;
 
   Faces            faces;
+
+  TaskGraph        taskgraph;
+
+  ThreadTeam       threadteam;
+
+  const SweeperKernel* kernel;
 } Sweeper;
 
 /*===========================================================================*/
@@ -94,7 +172,8 @@ static int Sweeper_noctant_per_block( const Sweeper* sweeper )
 static inline int Sweeper_nthread_a( const Sweeper* sweeper,
                                      const Env*     env )
 {
-  return Env_cuda_is_using_device( env ) ? NTHREAD_DEVICE_A*1 : NTHREAD_A*1;
+  return Env_cuda_is_using_device( env ) ? sweeper->kernel->nthread_device_a
+                                          : sweeper->kernel->nthread_a;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -102,7 +181,8 @@ static inline int Sweeper_nthread_a( const Sweeper* sweeper,
 static inline int Sweeper_nthread_m( const Sweeper* sweeper,
                                      const Env*     env )
 {
-  return Env_cuda_is_using_device( env ) ? NTHREAD_DEVICE_M*1 : NTHREAD_M*1;
+  return Env_cuda_is_using_device( env ) ? sweeper->kernel->nthread_device_m
+                                          : sweeper->kernel->nthread_m;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -110,7 +190,8 @@ static inline int Sweeper_nthread_m( const Sweeper* sweeper,
 static inline int Sweeper_nthread_u( const Sweeper* sweeper,
                                      const Env*     env )
 {
-  return Env_cuda_is_using_device( env ) ? NTHREAD_DEVICE_U*1 : NTHREAD_U*1;
+  return Env_cuda_is_using_device( env ) ? sweeper->kernel->nthread_device_u
+                                          : sweeper->kernel->nthread_u;
 }
 
 /*===========================================================================*/
@@ -122,14 +203,14 @@ static inline int Sweeper_nvilocal_( Sweeper* sweeper,
   return Env_cuda_is_using_device( env )
       ?
          Sweeper_nthread_m( sweeper, env ) *
-         NU *
+         sweeper->dims.nu *
          sweeper->nthread_octant *
          sweeper->nthread_x *
          sweeper->nthread_y *
          sweeper->nthread_z
        :
          Sweeper_nthread_m( sweeper, env ) *
-         NU *
+         sweeper->dims.nu *
          sweeper->nthread_octant *
          sweeper->nthread_e *
          sweeper->nthread_x *
@@ -146,14 +227,14 @@ static inline int Sweeper_nvslocal_( Sweeper* sweeper,
   return Env_cuda_is_using_device( env )
       ?
          Sweeper_nthread_a( sweeper, env ) *
-         NU *
+         sweeper->dims.nu *
          sweeper->nthread_octant *
          sweeper->nthread_x *
          sweeper->nthread_y *
          sweeper->nthread_z
        :
          Sweeper_nthread_a( sweeper, env ) *
-         NU *
+         sweeper->dims.nu *
          sweeper->nthread_octant *
          sweeper->nthread_e *
          sweeper->nthread_x *
@@ -170,14 +251,14 @@ static inline int Sweeper_nvolocal_( Sweeper* sweeper,
   return Env_cuda_is_using_device( env )
       ?
          Sweeper_nthread_m( sweeper, env ) *
-         NU *
+         sweeper->dims.nu *
          sweeper->nthread_octant *
          sweeper->nthread_x *
          sweeper->nthread_y *
          sweeper->nthread_z
        :
          Sweeper_nthread_m( sweeper, env ) *
-         NU *
+         sweeper->dims.nu *
          sweeper->nthread_octant *
          sweeper->nthread_e *
          sweeper->nthread_x *
@@ -186,6 +267,72 @@ static inline int Sweeper_nvolocal_( Sweeper* sweeper,
        ;
 }
 
+/*---------------------------------------------------------------------------*/
+
+static inline int Sweeper_nvmbatch_( Sweeper* sweeper )
+{
+  return sweeper->dims.nm *
+         sweeper->dims.nu *
+         sweeper->gemm_batch_size *
+         sweeper->nthread_octant *
+         sweeper->nthread_e *
+         sweeper->nthread_x *
+         sweeper->nthread_y *
+         sweeper->nthread_z;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static inline int Sweeper_nvabatch_( Sweeper* sweeper )
+{
+  return sweeper->dims.na *
+         sweeper->dims.nu *
+         sweeper->gemm_batch_size *
+         sweeper->nthread_octant *
+         sweeper->nthread_e *
+         sweeper->nthread_x *
+         sweeper->nthread_y *
+         sweeper->nthread_z;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static inline int Sweeper_nvelanes_( Sweeper* sweeper )
+{
+  /*---Per thread: NM x NU and NA x NU values for each of SIMD_LEN groups---*/
+  return ( sweeper->dims.nm + sweeper->dims.na ) *
+         sweeper->dims.nu *
+         SIMD_LEN *
+         sweeper->nthread_octant *
+         sweeper->nthread_e *
+         sweeper->nthread_x *
+         sweeper->nthread_y *
+         sweeper->nthread_z;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static inline int Sweeper_nvxform_( Sweeper* sweeper )
+{
+  /*---Per thread: NM x NU moments and NA x NU angles---*/
+  return ( sweeper->dims.nm + sweeper->dims.na ) *
+         sweeper->dims.nu *
+         sweeper->nthread_octant *
+         sweeper->nthread_e *
+         sweeper->nthread_x *
+         sweeper->nthread_y *
+         sweeper->nthread_z;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static inline size_t Sweeper_nvo_private_( Sweeper* sweeper )
+{
+  /*---One z block of state per octant in block---*/
+  return Dimensions_size_state( sweeper->dims_b, sweeper->dims_b.nu ) *
+         sweeper->noctant_per_block;
+}
+
 /*===========================================================================*/
 /*---For kernel launch: CUDA thread/block counts---*/
 
@@ -221,7 +368,7 @@ static int Sweeper_shared_size_( Sweeper* sweeper,
 {
   return ( Sweeper_nvilocal_( sweeper, env ) +
            Sweeper_nvslocal_( sweeper, env ) +
-           Sweeper_nvolocal_( sweeper, env ) ) * sizeof( P );
+           Sweeper_nvolocal_( sweeper, env ) ) * sizeof( PAccum );
 }
 
 /*===========================================================================*/
@@ -246,6 +393,87 @@ void Sweeper_sweep_block(
   const Quantities*      quan,
   Env*                   env );
 
+/*===========================================================================*/
+/*---Place a state vector near the threads that sweep it: zeroes it, so
+     call before it is filled---*/
+
+void Sweeper_place_state( Sweeper* sweeper,
+                          Pointer* v,
+                          Env*     env );
+
+/*===========================================================================*/
+/*---Place a state vector near the threads that sweep it and set it to
+     the required input value---*/
+
+void Sweeper_initialize_state( Sweeper*          sweeper,
+                               Pointer*          v,
+                               const Quantities* quan,
+                               Env*              env );
+
+/*===========================================================================*/
+/*---Compute vector norm info for state vector, each thread of the team
+     reading the part it placed; results do not depend on thread counts---*/
+
+void Sweeper_get_state_norms( Sweeper* sweeper,
+                              Pointer* vi,
+                              Pointer* vo,
+                              double*  normsqp,
+                              double*  normsqdiffp,
+                              Env*     env );
+
+/*===========================================================================*/
+/*---Time each thread of the team has spent waiting on the others---*/
+
+static inline int Sweeper_nthread_team( const Sweeper* sweeper )
+{
+  return ThreadTeam_nthread( &( sweeper->threadteam ) );
+}
+
+/*---------------------------------------------------------------------------*/
+
+static inline Timer Sweeper_idle_time( const Sweeper* sweeper, int thread )
+{
+  return ThreadTeam_idle( &( sweeper->threadteam ), thread );
+}
+
+/*---------------------------------------------------------------------------*/
+
+static inline void Sweeper_idle_time_reset( Sweeper* sweeper )
+{
+  ThreadTeam_idle_reset( &( sweeper->threadteam ) );
+}
+
+/*===========================================================================*/
+/*---Face bytes before and after compression, and codec time, if the
+     faces are compressed---*/
+
+static inline double Sweeper_face_nbyte_raw( const Sweeper* sweeper )
+{
+  return Faces_codec( &( sweeper->faces ) )->nbyte_raw;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static inline double Sweeper_face_nbyte_coded( const Sweeper* sweeper )
+{
+  return Faces_codec( &( sweeper->faces ) )->nbyte_coded;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static inline Timer Sweeper_face_codec_time( const Sweeper* sweeper )
+{
+  return Faces_codec( &( sweeper->faces ) )->time;
+}
+
+/*===========================================================================*/
+/*---Cpu each thread of the team is pinned to, -1 if not pinned---*/
+
+static inline int Sweeper_thread_cpu( const Sweeper* sweeper, int thread )
+{
+  return ThreadTeam_cpu( &( sweeper->threadteam ), thread );
+}
+
 /*===========================================================================*/
 /*---Perform a sweep---*/
 
@@ -11,6 +11,12 @@
 #ifndef _sweeper_kba_c_h_
 #define _sweeper_kba_c_h_
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <sys/file.h>
+
 #include "types.h"
 #include "env.h"
 #include "pointer.h"
@@ -20,6 +26,7 @@
 #include "array_operations.h"
 #include "stepscheduler_kba.h"
 #include "sweeper_kba.h"
+#include "sweeper_kba_kernel_instances.h"
 
 #include "sweeper_kba_kernels.h"
 
@@ -38,6 +45,475 @@ Sweeper Sweeper_null()
   return result;
 }
 
+/*===========================================================================*/
+/*---Kernel instances, defined in the sweeper_kernels*.c files---*/
+
+extern const SweeperKernel Sweeper_kernel_default;
+
+#define SWEEPER_KBA_KERNEL_DECLARE_( nm, nu ) \
+  extern const SweeperKernel SWEEPER_KBA_KERNEL_NAME( Sweeper_kernel, nm, nu );
+SWEEPER_KBA_KERNEL_INSTANCES( SWEEPER_KBA_KERNEL_DECLARE_ )
+#undef SWEEPER_KBA_KERNEL_DECLARE_
+
+/*===========================================================================*/
+/*---Look up the kernel instantiated for given nm, nu; NULL if none---*/
+
+const SweeperKernel* Sweeper_kernel_find( int nm, int nu )
+{
+#define SWEEPER_KBA_KERNEL_ADDRESS_( nm, nu ) \
+  & SWEEPER_KBA_KERNEL_NAME( Sweeper_kernel, nm, nu ),
+
+  /*---Default first, so that it is preferred if listed twice---*/
+  static const SweeperKernel* const kernels[] = {
+    & Sweeper_kernel_default,
+    SWEEPER_KBA_KERNEL_INSTANCES( SWEEPER_KBA_KERNEL_ADDRESS_ )
+  };
+
+#undef SWEEPER_KBA_KERNEL_ADDRESS_
+
+  const int nkernel = sizeof( kernels ) / sizeof( kernels[0] );
+  int i = 0;
+
+  for( i=0; i<nkernel; ++i )
+  {
+    if( kernels[i]->nm == nm && kernels[i]->nu == nu )
+    {
+      return kernels[i];
+    }
+  }
+
+  return NULL;
+}
+
+/*===========================================================================*/
+/*---Moment/angle transform variant: calibration and disk cache---*/
+
+/*---The cache is a text file, $MINISWEEP_XFORM_CACHE if set, else
+     $HOME/.minisweep_xform_cache.  Each line holds
+     "host nm nu na simd_len sizeof(P) variant", written at most once per
+     key; should there be more, the last match wins---*/
+
+enum{ XFORM_CACHE_STRING_LEN = 256 };
+
+/*---------------------------------------------------------------------------*/
+
+static Bool_t Sweeper_xform_cache_path_( char* path )
+{
+  const char* const path_env = getenv( "MINISWEEP_XFORM_CACHE" );
+  const char* const home     = getenv( "HOME" );
+  const char* const name     = "/.minisweep_xform_cache";
+
+  if( path_env && path_env[0] && strlen( path_env ) < XFORM_CACHE_STRING_LEN )
+  {
+    strcpy( path, path_env );
+    return Bool_true;
+  }
+  if( home && home[0] &&
+      strlen( home ) + strlen( name ) < XFORM_CACHE_STRING_LEN )
+  {
+    strcpy( path, home );
+    strcat( path, name );
+    return Bool_true;
+  }
+  return Bool_false;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void Sweeper_xform_cache_host_( char* host )
+{
+  struct utsname name;
+  const Bool_t is_named = uname( &name ) >= 0 &&
+                          name.nodename[0] != 0 &&
+                          strlen( name.nodename ) < XFORM_CACHE_STRING_LEN;
+
+  strcpy( host, is_named ? name.nodename : "unknown" );
+}
+
+/*---------------------------------------------------------------------------*/
+
+static int Sweeper_xform_cache_scan_( FILE*       file,
+                                      const char* host,
+                                      int         nm,
+                                      int         nu,
+                                      int         na )
+{
+  int variant = -1;
+
+  /*---NOTE: field width is XFORM_CACHE_STRING_LEN - 1---*/
+  char host_f[XFORM_CACHE_STRING_LEN];
+  int nm_f = 0, nu_f = 0, na_f = 0, simd_len_f = 0, p_size_f = 0;
+  int variant_f = 0;
+
+  while( fscanf( file, "%255s %d %d %d %d %d %d", host_f, &nm_f, &nu_f,
+                 &na_f, &simd_len_f, &p_size_f, &variant_f ) == 7 )
+  {
+    if( strcmp( host_f, host ) == 0 && nm_f == nm && nu_f == nu &&
+        na_f == na && simd_len_f == SIMD_LEN &&
+        p_size_f == (int)sizeof(P) )
+    {
+      variant = variant_f;
+    }
+  }
+
+  return variant;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static int Sweeper_xform_cache_read_( const char* path,
+                                      const char* host,
+                                      int         nm,
+                                      int         nu,
+                                      int         na )
+{
+  int variant = -1;
+  FILE* const file = fopen( path, "r" );
+
+  if( file )
+  {
+    flock( fileno( file ), LOCK_SH );
+    variant = Sweeper_xform_cache_scan_( file, host, nm, nu, na );
+    flock( fileno( file ), LOCK_UN );
+    fclose( file );
+  }
+
+  return variant;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void Sweeper_xform_cache_write_( const char* path,
+                                        const char* host,
+                                        int         nm,
+                                        int         nu,
+                                        int         na,
+                                        int         variant )
+{
+  /*---Failure to write, e.g. read-only file system, is not an error---*/
+  FILE* const file = fopen( path, "a+" );
+
+  if( file )
+  {
+    /*---Under the lock, add the entry only if no other run has since---*/
+    flock( fileno( file ), LOCK_EX );
+    rewind( file );
+    if( Sweeper_xform_cache_scan_( file, host, nm, nu, na ) < 0 )
+    {
+      fprintf( file, "%s %i %i %i %i %i %i\n", host, nm, nu, na,
+               (int)SIMD_LEN, (int)sizeof(P), variant );
+      fflush( file );
+    }
+    flock( fileno( file ), LOCK_UN );
+    fclose( file );
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+
+static int Sweeper_xform_calibrate_( const Sweeper*    sweeper,
+                                     const Quantities* quan,
+                                     Env*              env )
+{
+  enum{ NTRIAL = 3 };
+
+  const int nm = sweeper->dims.nm;
+  const int nu = sweeper->dims.nu;
+  const int na = sweeper->dims.na;
+
+  /*---Enough repetitions of the transform pair for about 10^6 flops, a
+       millisecond or so, the best of NTRIAL kept: this is paid by every
+       run that does not use the cache---*/
+  const int nrep = 1 + 1000000 / ( 4 * nm * nu * na );
+
+  const int nvxform = ( 2 * nm + na ) * nu;
+  PAccum* const vxform = malloc_host_PAccum( nvxform );
+
+  int variant_best = XFORM_VARIANT_CELL;
+  Timer time_best = 0;
+  int variant = 0;
+  int i = 0;
+
+  for( i=0; i<nvxform; ++i )
+  {
+    vxform[i] = (PAccum)( 1 + i % 7 );
+  }
+
+  for( variant=XFORM_VARIANT_CELL; variant<NXFORM_VARIANT; ++variant )
+  {
+    int trial = 0;
+    for( trial=0; trial<NTRIAL; ++trial )
+    {
+      const Timer time_start = Env_get_time( env );
+      sweeper->kernel->xform_bench( variant, na,
+                                    Pointer_const_h( & quan->a_from_m ),
+                                    Pointer_const_h( & quan->m_from_a ),
+                                    vxform, nrep );
+      const Timer time = Env_get_time( env ) - time_start;
+
+      if( time < time_best || ( variant == XFORM_VARIANT_CELL && trial == 0 ) )
+      {
+        variant_best = variant;
+        time_best = time;
+      }
+    }
+  }
+
+  free_host_PAccum( vxform );
+
+  return variant_best;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static int Sweeper_xform_select_( const Sweeper*    sweeper,
+                                  const Quantities* quan,
+                                  Env*              env,
+                                  Bool_t            is_using_cache )
+{
+  int variant = -1;
+
+  if( Env_proc_this( env ) == 0 )
+  {
+    char path[XFORM_CACHE_STRING_LEN];
+    char host[XFORM_CACHE_STRING_LEN];
+    const Bool_t is_cached = is_using_cache &&
+                             Sweeper_xform_cache_path_( path );
+
+    Sweeper_xform_cache_host_( host );
+
+    if( is_cached )
+    {
+      variant = Sweeper_xform_cache_read_( path, host, sweeper->dims.nm,
+                                      sweeper->dims.nu, sweeper->dims.na );
+    }
+
+    if( variant < XFORM_VARIANT_CELL || variant >= NXFORM_VARIANT )
+    {
+      variant = Sweeper_xform_calibrate_( sweeper, quan, env );
+      if( is_cached )
+      {
+        Sweeper_xform_cache_write_( path, host, sweeper->dims.nm,
+                           sweeper->dims.nu, sweeper->dims.na, variant );
+      }
+    }
+  }
+
+  /*---All procs use the choice of proc 0---*/
+  Env_bcast_int( env, &variant, 0 );
+
+  return variant;
+}
+
+/*===========================================================================*/
+/*---First touch of arrays by the threads that sweep them---*/
+
+/*=============================================================================
+
+Pages are placed on the NUMA node of the thread that first touches them,
+so each array is zeroed, before first use, by the team thread that will
+use it:
+
+- state vectors: each energy thread's groups, since the energy split is
+  fixed; the z-planes of these are dealt out among the threads of that
+  energy thread, which all sweep every plane;
+- faces: the slice of each octant in block, for the energy groups of an
+  energy thread, by the first yz thread of the energy, octant thread
+  that sweeps it;
+- private vo copies: likewise, with the z-planes dealt out among the
+  yz threads;
+- per-thread scratch: each thread's own slice.
+
+=============================================================================*/
+
+typedef struct
+{
+  Sweeper*           sweeper;
+  P*                 v;
+  const Quantities*  quan;
+  Env*               env;
+} SweeperPlaceArgs_;
+
+/*---------------------------------------------------------------------------*/
+/*---The part of a state vector first touched by a thread of the team---*/
+
+static void Sweeper_state_part_( const Sweeper* sweeper, int thread,
+                                 int* iemin, int* iemax,
+                                 int* izmin, int* izmax )
+{
+  const int nthread = ThreadTeam_nthread( &( sweeper->threadteam ) );
+
+  const int thread_e  = thread % sweeper->nthread_e;
+  const int nthread_e = nthread == 1 ? 1 : sweeper->nthread_e;
+
+  /*---Groups of the energy thread; z-planes dealt out among the threads
+       of that energy thread---*/
+
+  const int rank    = thread / nthread_e;
+  const int nrank   = nthread / nthread_e;
+  const int ncell_z = sweeper->dims.ncell_z;
+
+  *iemin = ( sweeper->dims.ne * ( thread_e     ) ) / nthread_e;
+  *iemax = ( sweeper->dims.ne * ( thread_e + 1 ) ) / nthread_e;
+  *izmin = ( ncell_z * ( rank     ) ) / nrank;
+  *izmax = ( ncell_z * ( rank + 1 ) ) / nrank;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void Sweeper_place_scratch_( PAccum* v, size_t n, int slice,
+                                    int nslice )
+{
+  if( v )
+  {
+    size_t i = 0;
+    for( i=( n * slice ) / nslice; i<( n * ( slice + 1 ) ) / nslice; ++i )
+    {
+      v[i] = 0;
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void Sweeper_place_thread_( void* context, int thread )
+{
+  const SweeperPlaceArgs_* const args = (const SweeperPlaceArgs_*)context;
+  Sweeper* const sweeper = args->sweeper;
+
+  const int nthread = ThreadTeam_nthread( &( sweeper->threadteam ) );
+
+  /*---Same thread numbering as the sweep: energy fastest, then octant,
+       then y and z.  A team of one thread places everything---*/
+
+  const int thread_e      = thread % sweeper->nthread_e;
+  const int thread_octant = ( thread / sweeper->nthread_e )
+                                     % sweeper->nthread_octant;
+  const int thread_yz     = thread / ( sweeper->nthread_e *
+                                       sweeper->nthread_octant );
+  const int nthread_e     = nthread == 1 ? 1 : sweeper->nthread_e;
+  const int nthread_octant = nthread == 1 ? 1 : sweeper->nthread_octant;
+  const int nthread_yz    = nthread / ( nthread_e * nthread_octant );
+
+  const int iemin = ( sweeper->dims.ne * ( thread_e     ) ) / nthread_e;
+  const int iemax = ( sweeper->dims.ne * ( thread_e + 1 ) ) / nthread_e;
+
+  if( args->v )
+  {
+    /*---State vector, set to its input value or zero---*/
+
+    int iemin_state = 0;
+    int iemax_state = 0;
+    int izmin_state = 0;
+    int izmax_state = 0;
+
+    Sweeper_state_part_( sweeper, thread, &iemin_state, &iemax_state,
+                                          &izmin_state, &izmax_state );
+
+    if( args->quan )
+    {
+      initialize_state_range( args->v, sweeper->dims, sweeper->dims.nu,
+                              args->quan, iemin_state, iemax_state,
+                              izmin_state, izmax_state );
+    }
+    else
+    {
+      initialize_state_zero_range( args->v, sweeper->dims, sweeper->dims.nu,
+                                   iemin_state, iemax_state,
+                                   izmin_state, izmax_state );
+    }
+  }
+  else
+  {
+    /*---Faces---*/
+
+    const int noctant_per_block = sweeper->noctant_per_block;
+    const int nfaces = Faces_is_face_comm_async( &( sweeper->faces ) ) ?
+                       NDIM : 1;
+    const Dimensions dims_b = sweeper->dims_b;
+    const int nu = dims_b.nu;
+
+    /*---Face values per octant in block and energy group---*/
+
+    const size_t nxy = Dimensions_size_facexy( dims_b, nu, 1 ) / dims_b.ne;
+    const size_t nxz = Dimensions_size_facexz( dims_b, nu, 1 ) / dims_b.ne;
+    const size_t nyz = Dimensions_size_faceyz( dims_b, nu, 1 ) / dims_b.ne;
+
+    const int octant_in_block_min = ( noctant_per_block *
+                                    ( thread_octant     ) ) / nthread_octant;
+    const int octant_in_block_max = ( noctant_per_block *
+                                    ( thread_octant + 1 ) ) / nthread_octant;
+
+    /*---Thread number in scratch array order---*/
+
+    const int slice = thread_octant + sweeper->nthread_octant * (
+                      thread_yz     + sweeper->nthread_y *
+                                      sweeper->nthread_z * (
+                      thread_e ) );
+
+    int octant_in_block = 0;
+    int i = 0;
+
+    for( octant_in_block=octant_in_block_min;
+         octant_in_block<octant_in_block_max && thread_yz == 0 &&
+         iemin < iemax; ++octant_in_block )
+    {
+      zero_vector( ref_facexy( Pointer_h( Faces_facexy( &( sweeper->faces ),
+                   0 ) ), dims_b, nu, noctant_per_block, 0, 0, iemin, 0, 0,
+                   octant_in_block ), nxy * ( iemax - iemin ) );
+
+      for( i=0; i<nfaces; ++i )
+      {
+        zero_vector( ref_facexz( Pointer_h( Faces_facexz( &( sweeper->faces ),
+                     i ) ), dims_b, nu, noctant_per_block, 0, 0, iemin, 0, 0,
+                     octant_in_block ), nxz * ( iemax - iemin ) );
+        zero_vector( ref_faceyz( Pointer_h( Faces_faceyz( &( sweeper->faces ),
+                     i ) ), dims_b, nu, noctant_per_block, 0, 0, iemin, 0, 0,
+                     octant_in_block ), nyz * ( iemax - iemin ) );
+      }
+    }
+
+    /*---Private vo---*/
+
+    for( octant_in_block=octant_in_block_min;
+         octant_in_block<octant_in_block_max && sweeper->vo_private_host_;
+         ++octant_in_block )
+    {
+      initialize_state_zero_range( sweeper->vo_private_host_ +
+                                   Dimensions_size_state( dims_b, nu ) *
+                                   octant_in_block, dims_b, nu, iemin, iemax,
+                                   ( dims_b.ncell_z * ( thread_yz     ) )
+                                                    / nthread_yz,
+                                   ( dims_b.ncell_z * ( thread_yz + 1 ) )
+                                                    / nthread_yz );
+    }
+
+    /*---Scratch---*/
+
+    Sweeper_place_scratch_( sweeper->vilocal_host_,
+                            (size_t)Sweeper_nvilocal_( sweeper, args->env ),
+                            slice, nthread );
+    Sweeper_place_scratch_( sweeper->vslocal_host_,
+                            (size_t)Sweeper_nvslocal_( sweeper, args->env ),
+                            slice, nthread );
+    Sweeper_place_scratch_( sweeper->volocal_host_,
+                            (size_t)Sweeper_nvolocal_( sweeper, args->env ),
+                            slice, nthread );
+    Sweeper_place_scratch_( sweeper->vmbatch_host_,
+                            (size_t)Sweeper_nvmbatch_( sweeper ),
+                            slice, nthread );
+    Sweeper_place_scratch_( sweeper->vabatch_host_,
+                            (size_t)Sweeper_nvabatch_( sweeper ),
+                            slice, nthread );
+    Sweeper_place_scratch_( sweeper->velanes_host_,
+                            (size_t)Sweeper_nvelanes_( sweeper ),
+                            slice, nthread );
+    Sweeper_place_scratch_( sweeper->vxform_host_,
+                            (size_t)Sweeper_nvxform_( sweeper ),
+                            slice, nthread );
+  }
+}
+
 /*===========================================================================*/
 /*---Pseudo-constructor for Sweeper struct---*/
 
@@ -53,6 +529,12 @@ void Sweeper_create( Sweeper*          sweeper,
 
   Bool_t is_face_comm_async = Arguments_consume_int_or_default( args,
                                            "--is_face_comm_async", Bool_true );
+  Bool_t is_face_comm_rma = Arguments_consume_int_or_default( args,
+                                           "--is_face_comm_rma", Bool_false );
+  const int face_compression = Arguments_consume_int_or_default( args,
+                                     "--face_compression", FACECODEC_NONE );
+  const int face_compression_nbit = Arguments_consume_int_or_default( args,
+                                     "--face_compression_nbit", 20 );
 
   Insist( dims.ncell_x > 0 ?
                 "Currently required that all spatial blocks be nonempty" : 0 );
@@ -109,11 +591,43 @@ void Sweeper_create( Sweeper*          sweeper,
   Insist( sweeper->nsemiblock>0 && sweeper->nsemiblock<=NOCTANT
           && ((sweeper->nsemiblock&(sweeper->nsemiblock-1))==0)
                                 ? "Invalid semiblock count supplied" : 0 );
-  Insist( ( sweeper->nsemiblock >= sweeper->nthread_octant ||
+  /*====================*/
+  /*---Set up private accumulation of vo---*/
+  /*====================*/
+
+  /*---With fewer semiblocks than octant threads, octants of a block may
+       update the same cells at once.  Either the updates are atomic, or
+       each octant in block sweeps into a private copy of the block, and
+       the copies are added into vo in octant order when the block step
+       is done, which gives the same result for any thread timing---*/
+
+  {
+    const Bool_t is_semiblock_set_complete =
+            sweeper->nsemiblock >= sweeper->nthread_octant ||
             (sweeper->nthread_octant==8 && sweeper->nblock_z % 2 == 0
-                                        && sweeper->nsemiblock==4) ||
-            IS_USING_OPENMP_VO_ATOMIC )
-         ? "Incomplete set of semiblock steps requires atomic vo update" : 0 );
+                                        && sweeper->nsemiblock==4);
+
+    const Bool_t is_vo_private_possible =
+            ! Env_cuda_is_using_device( env ) && ! IS_USING_OPENMP_VO_ATOMIC;
+
+    const int is_using_vo_private = Arguments_consume_int_or_default(
+                                       args, "--is_using_vo_private", -1 );
+
+    Insist( is_using_vo_private >= -1 && is_using_vo_private <= 1 ?
+            "Invalid is_using_vo_private setting supplied." : 0 );
+    Insist( is_using_vo_private != 1 || is_vo_private_possible ?
+            "Private vo not available with the device or atomic vo update."
+            : 0 );
+
+    sweeper->is_using_vo_private = is_using_vo_private == -1 ?
+                   is_vo_private_possible && ! is_semiblock_set_complete :
+                   is_using_vo_private == 1;
+
+    Insist( ( is_semiblock_set_complete || sweeper->is_using_vo_private ||
+              IS_USING_OPENMP_VO_ATOMIC )
+         ? "Incomplete set of semiblock steps requires atomic or private "
+           "vo update" : 0 );
+  }
 
   /*====================*/
   /*---Set up size of subblocks---*/
@@ -158,6 +672,7 @@ void Sweeper_create( Sweeper*          sweeper,
   sweeper->dims_g = sweeper->dims;
   sweeper->dims_g.ncell_x = quan->ncell_x_g;
   sweeper->dims_g.ncell_y = quan->ncell_y_g;
+  sweeper->dims_g.ncell_z = quan->ncell_z_g;
 
   /*====================*/
   /*---Set up number of energy threads---*/
@@ -173,6 +688,20 @@ void Sweeper_create( Sweeper*          sweeper,
                                 || Env_cuda_is_using_device( env ) ?
           "Threading not allowed for this case" : 0 );
 
+  /*---By default each energy thread sweeps a fixed share of the groups.
+       Otherwise the energy threads take chunks of ne_per_chunk groups in
+       turn at each subblock, so that they finish together even when the
+       groups do not divide evenly or differ in cost---*/
+
+  sweeper->ne_per_chunk
+                = Arguments_consume_int_or_default( args, "--ne_per_chunk", 0);
+
+  Insist( sweeper->ne_per_chunk >= 0 ? "Invalid chunk size supplied." : 0 );
+  Insist( sweeper->ne_per_chunk == 0 || ( IS_USING_OPENMP_THREADS &&
+                                          ! Env_cuda_is_using_device( env ) )
+          ? "Dynamic energy scheduling requires OpenMP threads on the CPU."
+          : 0 );
+
   /*====================*/
   /*---Set up number of spatial threads---*/
   /*====================*/
@@ -239,13 +768,84 @@ void Sweeper_create( Sweeper*          sweeper,
   StepScheduler_create( &(sweeper->stepscheduler),
                               sweeper->nblock_z, sweeper->nblock_octant, env );
 
+  /*====================*/
+  /*---Set up task graph, used for OpenMP tasks---*/
+  /*====================*/
+
+  TaskGraph_create( &(sweeper->taskgraph) );
+
+  /*====================*/
+  /*---Set up persistent thread team, used for OpenMP threads---*/
+  /*====================*/
+
+  {
+    const Bool_t is_team = IS_USING_OPENMP_THREADS &&
+                           ! Env_cuda_is_using_device( env );
+    const int nthread = is_team ? sweeper->nthread_e * sweeper->nthread_octant *
+                                  sweeper->nthread_y * sweeper->nthread_z : 1;
+    const int nthread_e = is_team ? sweeper->nthread_e : 1;
+
+    int* thread_cpu = NULL;
+    int thread = 0;
+
+    Insist( Env_affinity( env ) == ENV_AFFINITY_NONE || is_team ?
+            "Thread affinity requires OpenMP threads on the CPU." : 0 );
+
+    /*---Slots for the affinity plan.  Compact keeps the team order, so
+         the energy threads of a yz thread are neighbors.  Spread orders
+         by energy thread last, so each energy thread's octant and yz
+         threads, which exchange faces, are neighbors, and the energy
+         threads, with the state vector groups they placed, are far
+         apart---*/
+
+    if( Env_affinity( env ) != ENV_AFFINITY_NONE )
+    {
+      thread_cpu = (int*)malloc( nthread * sizeof(int) );
+      Insist( thread_cpu );
+      for( thread=0; thread<nthread; ++thread )
+      {
+        const int slot = Env_affinity( env ) == ENV_AFFINITY_SPREAD ?
+                         thread / nthread_e + ( nthread / nthread_e ) *
+                         ( thread % nthread_e ) : thread;
+        thread_cpu[thread] = Env_affinity_cpu( env, slot, nthread );
+      }
+    }
+
+    ThreadTeam_create( &(sweeper->threadteam), nthread, thread_cpu );
+
+    if( thread_cpu )
+    {
+      free( thread_cpu );
+    }
+  }
+
+  /*---Optionally run all KBA steps in one team run, each step waiting
+       only for the data it uses rather than for the whole previous step---*/
+
+  sweeper->is_using_dataflow = Arguments_consume_int_or_default( args,
+                                              "--is_using_dataflow", 0 );
+
+  Insist( ! sweeper->is_using_dataflow || ( IS_USING_OPENMP_THREADS &&
+                                     ! Env_cuda_is_using_device( env ) )
+          ? "Dataflow execution requires OpenMP threads on the CPU." : 0 );
+
+  /*====================*/
+  /*---Select kernel specialized for nm, nu---*/
+  /*====================*/
+
+  sweeper->kernel = Sweeper_kernel_find( dims.nm, dims.nu );
+
+  Insist( sweeper->kernel ?
+          "No sweep kernel instantiated for this nm, nu; see "
+          "sweeper_kba_kernel_instances.h" : 0 );
+
   /*====================*/
   /*---Set up amu threads---*/
   /*====================*/
 
-  Insist( NU * 1 > 0 );
-  Insist(      Sweeper_nthread_u( sweeper, env ) > 0 );
-  Insist( NU % Sweeper_nthread_u( sweeper, env ) == 0 );
+  Insist( dims.nu > 0 );
+  Insist(           Sweeper_nthread_u( sweeper, env ) > 0 );
+  Insist( dims.nu % Sweeper_nthread_u( sweeper, env ) == 0 );
   Insist( Sweeper_nthread_a( sweeper, env ) > 0 );
   if( ! IS_USING_MIC )
   {
@@ -262,28 +862,218 @@ void Sweeper_create( Sweeper*          sweeper,
     Insist( dims.na % VEC_LEN == 0 );
   }
 
+  /*====================*/
+  /*---Set up batching of moment/angle transforms---*/
+  /*====================*/
+
+  /*---Number of (cell, energy group) pairs whose transforms are done
+       as one GEMM; 0 for the cell-at-a-time matvecs---*/
+
+  sweeper->gemm_batch_size = Arguments_consume_int_or_default(
+                                             args, "--gemm_batch_size", 0 );
+
+  Insist( sweeper->gemm_batch_size >= 0 &&
+          sweeper->gemm_batch_size <= GEMM_BATCH_SIZE_MAX ?
+          "Invalid GEMM batch size supplied." : 0 );
+  Insist( sweeper->gemm_batch_size == 0 || ! Env_cuda_is_using_device( env ) ?
+          "GEMM batching not available on the device." : 0 );
+
+  /*====================*/
+  /*---Choose between angle-lane and energy-lane cell kernels---*/
+  /*====================*/
+
+  /*---The cell solve is vectorized across angles.  If there are too few
+       angles to fill the SIMD lanes, energy groups can be put in the
+       lanes instead; by default choose whichever fills more lanes---*/
+
+  {
+    const int is_using_energy_lanes = Arguments_consume_int_or_default(
+                                       args, "--is_using_energy_lanes", -1 );
+
+    Insist( is_using_energy_lanes >= -1 && is_using_energy_lanes <= 1 ?
+            "Invalid is_using_energy_lanes setting supplied." : 0 );
+
+    /*---Energy groups per energy thread, at least---*/
+    const int ne_thread = dims.ne / sweeper->nthread_e;
+    const int na = dims.na;
+
+    /*---Lane fill of the two choices, compared without division---*/
+    const int na_padded = ( ( na + SIMD_LEN - 1 ) / SIMD_LEN ) * SIMD_LEN;
+    const int ne_padded = ( ( ne_thread + SIMD_LEN - 1 ) / SIMD_LEN )
+                                                               * SIMD_LEN;
+    const Bool_t is_energy_lanes_better = ne_thread > 0 &&
+                                          ne_thread * na_padded >
+                                          na * ne_padded;
+
+    const Bool_t is_energy_lanes_possible =
+                                      ! Env_cuda_is_using_device( env ) &&
+                                      sweeper->gemm_batch_size == 0;
+
+    Insist( is_using_energy_lanes != 1 || is_energy_lanes_possible ?
+            "Energy lanes not available with the device or GEMM batching."
+            : 0 );
+
+    sweeper->is_using_energy_lanes = is_using_energy_lanes == -1 ?
+                       is_energy_lanes_possible && is_energy_lanes_better :
+                       is_using_energy_lanes == 1;
+  }
+
+  /*====================*/
+  /*---Choose moment/angle transform variant---*/
+  /*====================*/
+
+  /*---By default time the variants for this nm, nu, na, or take the
+       result of an earlier timing on this host from the disk cache---*/
+
+  {
+    const int xform_variant = Arguments_consume_int_or_default(
+                                       args, "--xform_variant", -1 );
+    const Bool_t is_using_xform_cache = Arguments_consume_int_or_default(
+                                       args, "--is_using_xform_cache", 1 );
+
+    const Bool_t is_xform_possible = ! Env_cuda_is_using_device( env ) &&
+                                     sweeper->gemm_batch_size == 0 &&
+                                     ! sweeper->is_using_energy_lanes;
+
+    Insist( xform_variant >= -1 && xform_variant < NXFORM_VARIANT ?
+            "Invalid xform_variant setting supplied." : 0 );
+    Insist( xform_variant <= XFORM_VARIANT_CELL || is_xform_possible ?
+            "Transform variants not available with the device, "
+            "GEMM batching or energy lanes." : 0 );
+
+    sweeper->xform_variant = xform_variant != -1 ? xform_variant :
+                             ! is_xform_possible ? XFORM_VARIANT_CELL :
+                             Sweeper_xform_select_( sweeper, quan, env,
+                                                    is_using_xform_cache );
+  }
+
+  /*====================*/
+  /*---Set up tiling of energy groups and cells in a subblock---*/
+  /*====================*/
+
+  /*---At each cell a tile of energy groups is swept back to back, so one
+       octant's a_from_m/m_from_a slice is fetched into cache once per tile
+       of groups rather than once per group.  Cells are tiled in x and y so
+       the faces passed between z planes of a tile stay in cache.  By
+       default the group tile fills the cache level holding the matrices
+       and the cell tile fills half of L2---*/
+
+  {
+    const int ne_thread = imax( 1, dims.ne / sweeper->nthread_e );
+
+    const size_t cache_l1_detected = Env_cache_size( env, 1 );
+    const size_t cache_l2_detected = Env_cache_size( env, 2 );
+    const size_t cache_l1 = cache_l1_detected ? cache_l1_detected : 32768;
+    const size_t cache_l2 = cache_l2_detected ? cache_l2_detected : 1048576;
+
+    /*---One octant's matrices; the vi, vo and face values of one
+         (cell, group) pair---*/
+    const size_t matrix_bytes = 2 * (size_t)dims.nm * dims.na * sizeof(P);
+    const size_t cell_bytes = ( 2 * (size_t)dims.nm + 3 * (size_t)dims.na )
+                            * dims.nu * sizeof(P);
+
+    const size_t cache_matrix = matrix_bytes < cache_l1 ? cache_l1 : cache_l2;
+    const size_t ne_fit = cache_matrix > matrix_bytes ?
+                          ( cache_matrix - matrix_bytes ) / cell_bytes : 1;
+
+    int ne_per_tile_default = (int)( ne_fit < (size_t)ne_thread ?
+                                     ne_fit : (size_t)ne_thread );
+    ne_per_tile_default = imax( 1, ne_per_tile_default );
+    if( sweeper->is_using_energy_lanes )
+    {
+      /*---Whole chunks of lanes---*/
+      ne_per_tile_default = iceil( ne_per_tile_default, SIMD_LEN ) * SIMD_LEN;
+    }
+
+    const size_t ncell_fit = ( cache_l2 / 2 ) /
+                             ( ne_per_tile_default * cell_bytes );
+    int ncell_side_fit = 1;
+    while( (size_t)( ( ncell_side_fit + 1 ) * ( ncell_side_fit + 1 ) )
+                                                               <= ncell_fit )
+    {
+      ++ncell_side_fit;
+    }
+
+    const Bool_t is_tiling_default = ! Env_cuda_is_using_device( env );
+
+    sweeper->ne_per_tile = Arguments_consume_int_or_default(
+                                     args, "--ne_per_tile",
+                                     is_tiling_default ? ne_per_tile_default
+                                                       : 1 );
+    Insist( sweeper->ne_per_tile>0 ? "Invalid tile size supplied" : 0 );
+
+    sweeper->ncell_x_per_tile = Arguments_consume_int_or_default(
+                 args, "--ncell_x_per_tile", is_tiling_default ?
+                 imin( ncell_side_fit, sweeper->ncell_x_per_subblock ) :
+                 sweeper->ncell_x_per_subblock );
+    Insist( sweeper->ncell_x_per_tile>0 ? "Invalid tile size supplied" : 0 );
+
+    sweeper->ncell_y_per_tile = Arguments_consume_int_or_default(
+                 args, "--ncell_y_per_tile", is_tiling_default ?
+                 imin( ncell_side_fit, sweeper->ncell_y_per_subblock ) :
+                 sweeper->ncell_y_per_subblock );
+    Insist( sweeper->ncell_y_per_tile>0 ? "Invalid tile size supplied" : 0 );
+  }
+
   /*====================*/
   /*---Allocate arrays---*/
   /*====================*/
 
   sweeper->vilocal_host_ = Env_cuda_is_using_device( env ) ?
-                           ( (P*) NULL ) :
-                           malloc_host_P( Sweeper_nvilocal_( sweeper, env ) );
+      ( (PAccum*) NULL ) :
+      malloc_host_PAccum( Sweeper_nvilocal_( sweeper, env ) );
 
   sweeper->vslocal_host_ = Env_cuda_is_using_device( env ) ?
-                           ( (P*) NULL ) :
-                           malloc_host_P( Sweeper_nvslocal_( sweeper, env ) );
+      ( (PAccum*) NULL ) :
+      malloc_host_PAccum( Sweeper_nvslocal_( sweeper, env ) );
 
   sweeper->volocal_host_ = Env_cuda_is_using_device( env ) ?
-                           ( (P*) NULL ) :
-                           malloc_host_P( Sweeper_nvolocal_( sweeper, env ) );
+      ( (PAccum*) NULL ) :
+      malloc_host_PAccum( Sweeper_nvolocal_( sweeper, env ) );
+
+  sweeper->vmbatch_host_ = sweeper->gemm_batch_size == 0 ?
+      ( (PAccum*) NULL ) :
+      malloc_host_PAccum( Sweeper_nvmbatch_( sweeper ) );
+
+  sweeper->vabatch_host_ = sweeper->gemm_batch_size == 0 ?
+      ( (PAccum*) NULL ) :
+      malloc_host_PAccum( Sweeper_nvabatch_( sweeper ) );
+
+  sweeper->velanes_host_ = ! sweeper->is_using_energy_lanes ?
+      ( (PAccum*) NULL ) :
+      malloc_host_PAccum( Sweeper_nvelanes_( sweeper ) );
+
+  sweeper->vxform_host_ = sweeper->xform_variant == XFORM_VARIANT_CELL ?
+      ( (PAccum*) NULL ) :
+      malloc_host_PAccum( Sweeper_nvxform_( sweeper ) );
+
+  sweeper->vo_private_host_ = ! sweeper->is_using_vo_private ?
+      ( (P*) NULL ) :
+      malloc_host_P( Sweeper_nvo_private_( sweeper ) );
 
   /*====================*/
   /*---Allocate faces---*/
   /*====================*/
 
   Faces_create( &(sweeper->faces), sweeper->dims_b,
-                sweeper->noctant_per_block, is_face_comm_async, env );
+                sweeper->noctant_per_block, is_face_comm_async,
+                is_face_comm_rma, face_compression, face_compression_nbit,
+                env );
+
+  /*====================*/
+  /*---Place faces and scratch near the threads that use them---*/
+  /*====================*/
+
+  if( ! Env_cuda_is_using_device( env ) )
+  {
+    SweeperPlaceArgs_ args_place;
+    args_place.sweeper = sweeper;
+    args_place.v       = NULL;
+    args_place.quan    = NULL;
+    args_place.env     = env;
+    ThreadTeam_run( &( sweeper->threadteam ), Sweeper_place_thread_,
+                    &args_place );
+  }
 }
 
 /*===========================================================================*/
@@ -300,32 +1090,171 @@ void Sweeper_destroy( Sweeper* sweeper,
   {
     if( sweeper->vilocal_host_ )
     {
-      free_host_P( sweeper->vilocal_host_ );
+      free_host_PAccum( sweeper->vilocal_host_ );
     }
     if( sweeper->vslocal_host_ )
     {
-      free_host_P( sweeper->vslocal_host_ );
+      free_host_PAccum( sweeper->vslocal_host_ );
     }
     if( sweeper->volocal_host_ )
     {
-      free_host_P( sweeper->volocal_host_ );
+      free_host_PAccum( sweeper->volocal_host_ );
     }
     sweeper->vilocal_host_ = NULL;
     sweeper->vslocal_host_ = NULL;
     sweeper->volocal_host_ = NULL;
   }
 
+  if( sweeper->vmbatch_host_ )
+  {
+    free_host_PAccum( sweeper->vmbatch_host_ );
+  }
+  if( sweeper->vabatch_host_ )
+  {
+    free_host_PAccum( sweeper->vabatch_host_ );
+  }
+  if( sweeper->velanes_host_ )
+  {
+    free_host_PAccum( sweeper->velanes_host_ );
+  }
+  if( sweeper->vxform_host_ )
+  {
+    free_host_PAccum( sweeper->vxform_host_ );
+  }
+  if( sweeper->vo_private_host_ )
+  {
+    free_host_P( sweeper->vo_private_host_ );
+  }
+  sweeper->vmbatch_host_ = NULL;
+  sweeper->vabatch_host_ = NULL;
+  sweeper->velanes_host_ = NULL;
+  sweeper->vxform_host_  = NULL;
+  sweeper->vo_private_host_ = NULL;
+
   /*====================*/
   /*---Deallocate faces---*/
   /*====================*/
 
-  Faces_destroy( &(sweeper->faces) );
+  Faces_destroy( &(sweeper->faces), env );
 
   /*====================*/
   /*---Terminate scheduler---*/
   /*====================*/
 
   StepScheduler_destroy( &( sweeper->stepscheduler ) );
+
+  /*====================*/
+  /*---Deallocate task graph---*/
+  /*====================*/
+
+  TaskGraph_destroy( &( sweeper->taskgraph ) );
+
+  /*====================*/
+  /*---Stop thread team---*/
+  /*====================*/
+
+  ThreadTeam_destroy( &( sweeper->threadteam ) );
+}
+
+/*===========================================================================*/
+/*---Place a state vector near the threads that sweep it---*/
+
+void Sweeper_place_state( Sweeper* sweeper,
+                          Pointer* v,
+                          Env*     env )
+{
+  SweeperPlaceArgs_ args_place;
+  args_place.sweeper = sweeper;
+  args_place.v       = Pointer_h( v );
+  args_place.quan    = NULL;
+  args_place.env     = env;
+
+  ThreadTeam_run( &( sweeper->threadteam ), Sweeper_place_thread_,
+                  &args_place );
+}
+
+/*===========================================================================*/
+/*---Place a state vector near the threads that sweep it and set it to
+     the required input value---*/
+
+void Sweeper_initialize_state( Sweeper*          sweeper,
+                               Pointer*          v,
+                               const Quantities* quan,
+                               Env*              env )
+{
+  SweeperPlaceArgs_ args_place;
+  args_place.sweeper = sweeper;
+  args_place.v       = Pointer_h( v );
+  args_place.quan    = quan;
+  args_place.env     = env;
+
+  ThreadTeam_run( &( sweeper->threadteam ), Sweeper_place_thread_,
+                  &args_place );
+}
+
+/*===========================================================================*/
+/*---Compute vector norm info for state vector on the thread team---*/
+
+typedef struct
+{
+  const Sweeper*     sweeper;
+  const P*           vi;
+  const P*           vo;
+  double*            normsq_part;
+  double*            normsqdiff_part;
+} SweeperNormsArgs_;
+
+/*---------------------------------------------------------------------------*/
+
+static void Sweeper_get_state_norms_thread_( void* context, int thread )
+{
+  const SweeperNormsArgs_* const args = (const SweeperNormsArgs_*)context;
+  const Sweeper* const sweeper = args->sweeper;
+
+  /*---Each thread reads the part it placed---*/
+
+  int iemin = 0;
+  int iemax = 0;
+  int izmin = 0;
+  int izmax = 0;
+
+  Sweeper_state_part_( sweeper, thread, &iemin, &iemax, &izmin, &izmax );
+
+  get_state_norms_range( args->vi, args->vo, sweeper->dims, sweeper->dims.nu,
+                         iemin, iemax, izmin, izmax,
+                         args->normsq_part, args->normsqdiff_part );
+}
+
+/*---------------------------------------------------------------------------*/
+
+void Sweeper_get_state_norms( Sweeper* sweeper,
+                              Pointer* vi,
+                              Pointer* vo,
+                              double*  normsqp,
+                              double*  normsqdiffp,
+                              Env*     env )
+{
+  /*---Partial sums per z-cell and group are combined in a fixed order,
+       so the result does not depend on the thread count---*/
+
+  const size_t npart = ( (size_t)sweeper->dims.ncell_z ) * sweeper->dims.ne;
+
+  SweeperNormsArgs_ args;
+  args.sweeper         = sweeper;
+  args.vi              = Pointer_h( vi );
+  args.vo              = Pointer_h( vo );
+  args.normsq_part     = (double*)malloc( npart * sizeof(double) );
+  args.normsqdiff_part = (double*)malloc( npart * sizeof(double) );
+  Insist( args.normsq_part && args.normsqdiff_part );
+
+  ThreadTeam_run( &( sweeper->threadteam ), Sweeper_get_state_norms_thread_,
+                  &args );
+
+  get_state_norms_combine( args.normsq_part, args.normsqdiff_part,
+                           sweeper->dims, normsqp, normsqdiffp, env );
+
+  free( (void*)args.normsq_part );
+  free( (void*)args.normsqdiff_part );
 }
 
 /*===========================================================================*/
@@ -338,6 +1267,11 @@ SweeperLite Sweeper_sweeperlite( Sweeper* sweeper )
   sweeperlite.vilocal_host_ = sweeper->vilocal_host_;
   sweeperlite.vslocal_host_ = sweeper->vslocal_host_;
   sweeperlite.volocal_host_ = sweeper->volocal_host_;
+  sweeperlite.vmbatch_host_ = sweeper->vmbatch_host_;
+  sweeperlite.vabatch_host_ = sweeper->vabatch_host_;
+  sweeperlite.velanes_host_ = sweeper->velanes_host_;
+  sweeperlite.vxform_host_  = sweeper->vxform_host_;
+  sweeperlite.vo_private_host_ = sweeper->vo_private_host_;
 
   sweeperlite.dims   = sweeper->dims;
   sweeperlite.dims_b = sweeper->dims_b;
@@ -349,28 +1283,160 @@ SweeperLite Sweeper_sweeperlite( Sweeper* sweeper )
   sweeperlite.nthread_y      = sweeper->nthread_y;
   sweeperlite.nthread_z      = sweeper->nthread_z;
 
-  sweeperlite.nblock_z             = sweeper->nblock_z;
-  sweeperlite.nblock_octant        = sweeper->nblock_octant;
-  sweeperlite.noctant_per_block    = sweeper->noctant_per_block;
-  sweeperlite.nsemiblock           = sweeper->nsemiblock;
-  sweeperlite.ncell_x_per_subblock = sweeper->ncell_x_per_subblock;
-  sweeperlite.ncell_y_per_subblock = sweeper->ncell_y_per_subblock;
-  sweeperlite.ncell_z_per_subblock = sweeper->ncell_z_per_subblock;
+  sweeperlite.nblock_z             = sweeper->nblock_z;
+  sweeperlite.nblock_octant        = sweeper->nblock_octant;
+  sweeperlite.noctant_per_block    = sweeper->noctant_per_block;
+  sweeperlite.nsemiblock           = sweeper->nsemiblock;
+  sweeperlite.ncell_x_per_subblock = sweeper->ncell_x_per_subblock;
+  sweeperlite.ncell_y_per_subblock = sweeper->ncell_y_per_subblock;
+  sweeperlite.ncell_z_per_subblock = sweeper->ncell_z_per_subblock;
+  sweeperlite.ne_per_tile          = sweeper->ne_per_tile;
+  sweeperlite.ne_per_chunk         = sweeper->ne_per_chunk;
+  sweeperlite.ncell_x_per_tile     = sweeper->ncell_x_per_tile;
+  sweeperlite.ncell_y_per_tile     = sweeper->ncell_y_per_tile;
+  sweeperlite.gemm_batch_size      = sweeper->gemm_batch_size;
+  sweeperlite.is_using_energy_lanes = sweeper->is_using_energy_lanes;
+  sweeperlite.xform_variant        = sweeper->xform_variant;
+  /*---Set when a block is launched on the host---*/
+  sweeperlite.env_progress         = NULL;
+
+#ifdef USE_OPENMP_TASKS
+  /*---Mark these as not yet properly initialized---*/
+  sweeperlite.thread_e = -1;
+  sweeperlite.thread_octant = -1;
+  sweeperlite.thread_x = -1;
+  sweeperlite.thread_y = -1;
+  sweeperlite.thread_z = -1;
+  /*---NOTE: will break if sweeperlite is used after sweeper destroyed---*/
+  sweeperlite.taskgraph = &( sweeper->taskgraph );
+#endif
+
+#ifdef USE_OPENMP_THREADS
+  /*---Set per thread when run by the team---*/
+  sweeperlite.thread_in_team = -1;
+  sweeperlite.is_step_pipelined = Bool_false;
+  /*---NOTE: will break if sweeperlite is used after sweeper destroyed---*/
+  sweeperlite.threadteam = &( sweeper->threadteam );
+#endif
+
+  return sweeperlite;
+}
+
+/*===========================================================================*/
+/*---Add the private vo copies of the block step into vo---*/
+
+/*---Each thread takes a fixed range of the elements of a block and adds
+     in the octants in block in order, so the sum does not depend on the
+     number of threads or their timing.  The range is processed SIMD_LEN
+     elements at a time, each element still by a single add---*/
+
+static void Sweeper_reduce_vo_private_( const Sweeper*     sweeper,
+                                        P* __restrict__    vo,
+                                        const StepInfoAll* stepinfoall,
+                                        unsigned long int  do_reduce_init,
+                                        int                thread,
+                                        int                nthread )
+{
+  const size_t n = Dimensions_size_state( sweeper->dims_b,
+                                          sweeper->dims_b.nu );
+  const size_t imin = ( n * ( thread     ) ) / nthread;
+  const size_t imax = ( n * ( thread + 1 ) ) / nthread;
+
+  int octant_in_block = 0;
+
+  for( octant_in_block=0; octant_in_block<sweeper->noctant_per_block;
+                                                            ++octant_in_block )
+  {
+    const StepInfo stepinfo = stepinfoall->stepinfo[octant_in_block];
+
+    if( stepinfo.is_active )
+    {
+      P* __restrict__ vo_block = vo + n * stepinfo.block_z;
+      const P* __restrict__ vo_private = sweeper->vo_private_host_ +
+                                         n * octant_in_block;
+      const Bool_t is_init = ( do_reduce_init &
+                               ( ((unsigned long int)1) << octant_in_block ) )
+                             != 0;
+      size_t i = 0;
+
+      for( i=imin; i<imax; i+=SIMD_LEN )
+      {
+        const int nlane = imax - i < SIMD_LEN ? (int)( imax - i ) : SIMD_LEN;
+        const SimdMask mask = SimdAcc_mask( nlane );
+
+        const SimdAcc v_private = SimdAcc_load_P_mask( vo_private + i, mask );
+
+        SimdAcc_store_P_mask( vo_block + i, is_init ? v_private :
+          SimdAcc_add( SimdAcc_load_P_mask( vo_block + i, mask ), v_private ),
+          mask );
+      }
+    }
+  } /*---octant_in_block---*/
+}
+
+/*===========================================================================*/
+/*---Run the sweep block kernel on one thread of the thread team---*/
+
+#ifdef USE_OPENMP_THREADS
+typedef struct
+{
+  const Sweeper*         sweeper;
+  SweeperLite            sweeperlite;
+        P*               vo;
+  const P*               vi;
+        P*               facexy;
+        P*               facexz;
+        P*               faceyz;
+  const P*               a_from_m;
+  const P*               m_from_a;
+  int                    step;
+  const Quantities*      quan;
+  Bool_t                 proc_x_min;
+  Bool_t                 proc_x_max;
+  Bool_t                 proc_y_min;
+  Bool_t                 proc_y_max;
+  StepInfoAll            stepinfoall;
+  unsigned long int      do_block_init;
+  unsigned long int      do_reduce_init;
+} SweeperBlockArgs_;
 
-#ifdef USE_OPENMP_TASKS
-  /*---Mark these as not yet properly initialized---*/
-  sweeperlite.thread_e = -1;
-  sweeperlite.thread_octant = -1;
-  sweeperlite.thread_x = -1;
-  sweeperlite.thread_y = -1;
-  sweeperlite.thread_z = -1;
-  /*---(Arbitrarily) point to the base of the current sweeper struct---*/
-  /*---NOTE: will break if sweeperlite is used after sweeper destroyed---*/
-  sweeperlite.task_dependency = (char*)sweeper;
-#endif
+/*---------------------------------------------------------------------------*/
 
-  return sweeperlite;
+static void Sweeper_sweep_block_thread_( void* context, int thread )
+{
+  const SweeperBlockArgs_* const args = (const SweeperBlockArgs_*)context;
+
+  SweeperLite sweeperlite = args->sweeperlite;
+  sweeperlite.thread_in_team = thread;
+
+  args->sweeper->kernel->impl( sweeperlite,
+                               args->vo,
+                               args->vi,
+                               args->facexy,
+                               args->facexz,
+                               args->faceyz,
+                               args->a_from_m,
+                               args->m_from_a,
+                               args->step,
+                               *args->quan,
+                               args->proc_x_min,
+                               args->proc_x_max,
+                               args->proc_y_min,
+                               args->proc_y_max,
+                               args->stepinfoall,
+                               args->do_block_init );
+
+  if( args->sweeper->vo_private_host_ )
+  {
+    ThreadTeam_barrier( sweeperlite.threadteam, thread );
+
+    Sweeper_reduce_vo_private_( args->sweeper, args->vo,
+                                &( args->stepinfoall ), args->do_reduce_init,
+                                thread,
+                                ThreadTeam_nthread( sweeperlite.threadteam ) );
+  }
 }
+#endif
 
 /*===========================================================================*/
 /*---Adapter function to launch the sweep block kernel---*/
@@ -392,17 +1458,24 @@ static void Sweeper_sweep_block_adapter(
   Bool_t                 proc_y_max,
   StepInfoAll            stepinfoall,
   unsigned long int      do_block_init,
+  unsigned long int      do_reduce_init,
   Env*                   env )
 {
   /*---Create lightweight version of Sweeper class that uses less GPU mem---*/
 
   SweeperLite sweeperlite = Sweeper_sweeperlite( sweeper );
 
+  if( Env_progress( env ) == ENV_PROGRESS_POLL &&
+      ! Env_cuda_is_using_device( env ) )
+  {
+    sweeperlite.env_progress = env;
+  }
+
   /*---Call sweep block implementation function---*/
 
   if( Env_cuda_is_using_device( env ) )
   {
-    Sweeper_sweep_block_impl_global
+    sweeper->kernel->impl_global
 #ifdef USE_CUDA
                  <<< dim3( Sweeper_nthreadblock( sweeper, 0, env ),
                            Sweeper_nthreadblock( sweeper, 1, env ),
@@ -435,12 +1508,32 @@ static void Sweeper_sweep_block_adapter(
   else
   {
 #ifdef USE_OPENMP_THREADS
-#pragma omp parallel num_threads( sweeper->nthread_e * sweeper->nthread_octant \
-                                * sweeper->nthread_y * sweeper->nthread_z )
-  {
-#endif
-
-    Sweeper_sweep_block_impl( sweeperlite,
+    /*---Run on the persistent thread team---*/
+
+    SweeperBlockArgs_ args;
+    args.sweeper       = sweeper;
+    args.sweeperlite   = sweeperlite;
+    args.vo            = vo;
+    args.vi            = vi;
+    args.facexy        = facexy;
+    args.facexz        = facexz;
+    args.faceyz        = faceyz;
+    args.a_from_m      = a_from_m;
+    args.m_from_a      = m_from_a;
+    args.step          = step;
+    args.quan          = quan;
+    args.proc_x_min    = proc_x_min;
+    args.proc_x_max    = proc_x_max;
+    args.proc_y_min    = proc_y_min;
+    args.proc_y_max    = proc_y_max;
+    args.stepinfoall   = stepinfoall;
+    args.do_block_init = do_block_init;
+    args.do_reduce_init = do_reduce_init;
+
+    ThreadTeam_run( &( sweeper->threadteam ), Sweeper_sweep_block_thread_,
+                    &args );
+#else
+    sweeper->kernel->impl(    sweeperlite,
                               vo,
                               vi,
                               facexy,
@@ -457,53 +1550,46 @@ static void Sweeper_sweep_block_adapter(
                               stepinfoall,
                               do_block_init );
 
-#ifdef USE_OPENMP_THREADS
-  } /*---OPENMP---*/
+    if( sweeper->vo_private_host_ )
+    {
+      Sweeper_reduce_vo_private_( sweeper, vo, &stepinfoall, do_reduce_init,
+                                  0, 1 );
+    }
 #endif
   } /*---if else---*/
 }
 
 /*===========================================================================*/
-/*---Perform a sweep for a block---*/
+/*---Determine the octants and initialization schedule of a block step---*/
 
-void Sweeper_sweep_block(
-  Sweeper*               sweeper,
-  Pointer*               vo,
-  Pointer*               vi,
+static void Sweeper_schedule_block_(
+  const Sweeper*         sweeper,
   int*                   is_block_init,
-  Pointer*               facexy,
-  Pointer*               facexz,
-  Pointer*               faceyz,
-  const Pointer*         a_from_m,
-  const Pointer*         m_from_a,
   int                    step,
-  const Quantities*      quan,
-  Env*                   env )
+  int                    proc_x,
+  int                    proc_y,
+  int                    proc_z,
+  StepInfoAll*           stepinfoall,
+  unsigned long int*     do_block_init,
+  unsigned long int*     do_reduce_init )
 {
-  /*---Declarations---*/
-
-  const int block_init_size = sweeper->nblock_z * sizeof( Bool_t );
-
-  const int proc_x = Env_proc_x_this( env );
-  const int proc_y = Env_proc_y_this( env );
-
   const int noctant_per_block = sweeper->noctant_per_block;
 
-  StepInfoAll stepinfoall;  /*---But only use noctant_per_block values---*/
-
   int octant_in_block = 0;
 
   int semiblock_step = 0;
 
-  unsigned long int do_block_init = 0;
+  *do_block_init = 0;
+  *do_reduce_init = 0;
 
   /*---Precalculate stepinfo for required octants---*/
 
   for( octant_in_block=0; octant_in_block<sweeper->noctant_per_block;
                                                             ++octant_in_block )
   {
-    stepinfoall.stepinfo[octant_in_block] = StepScheduler_stepinfo(
-      &(sweeper->stepscheduler), step, octant_in_block, proc_x, proc_y );
+    stepinfoall->stepinfo[octant_in_block] = StepScheduler_stepinfo(
+      &(sweeper->stepscheduler), step, octant_in_block,
+      proc_x, proc_y, proc_z );
 
   }
 
@@ -511,13 +1597,32 @@ void Sweeper_sweep_block(
   /*---Determine whether this is the first calculation for this sweep step
        and semiblock step - in which case set values rather than add values---*/
 
+  if( sweeper->vo_private_host_ )
+  {
+    /*---Private copies are always set; the first copy added to a block
+         sets it.  The tally below then leaves these unchanged---*/
+
+    *do_block_init = ~ (unsigned long int)0;
+
+    for( octant_in_block=0; octant_in_block<sweeper->noctant_per_block;
+                                                            ++octant_in_block )
+    {
+      const StepInfo stepinfo = stepinfoall->stepinfo[octant_in_block];
+      if( stepinfo.is_active && ! is_block_init[ stepinfo.block_z ] )
+      {
+        *do_reduce_init |= ( ((unsigned long int)1) << octant_in_block );
+        is_block_init[ stepinfo.block_z ] = Bool_true;
+      }
+    }
+  }
+
   for( semiblock_step=0; semiblock_step<sweeper->nsemiblock; ++semiblock_step )
   {
 #pragma novector
     for( octant_in_block=0; octant_in_block<sweeper->noctant_per_block;
                                                             ++octant_in_block )
     {
-      const StepInfo stepinfo = stepinfoall.stepinfo[octant_in_block];
+      const StepInfo stepinfo = stepinfoall->stepinfo[octant_in_block];
       if( stepinfo.is_active )
       {
         const Bool_t is_semiblock_x_lo = is_semiblock_min_when_semiblocked(
@@ -552,7 +1657,7 @@ void Sweeper_sweep_block(
 
         if( ! ( is_block_init[ stepinfo.block_z ] & ( 1 << semiblock_num ) ) )
         {
-          do_block_init |= ( ((unsigned long int)1) <<
+          *do_block_init |= ( ((unsigned long int)1) <<
                              ( octant_in_block + noctant_per_block *
                                semiblock_step ) );
           is_block_init[ stepinfo.block_z ] |= ( 1 << semiblock_num );
@@ -560,6 +1665,40 @@ void Sweeper_sweep_block(
       }
     } /*---octant_in_block---*/
   } /*---semiblock---*/
+}
+
+/*===========================================================================*/
+/*---Perform a sweep for a block---*/
+
+void Sweeper_sweep_block(
+  Sweeper*               sweeper,
+  Pointer*               vo,
+  Pointer*               vi,
+  int*                   is_block_init,
+  Pointer*               facexy,
+  Pointer*               facexz,
+  Pointer*               faceyz,
+  const Pointer*         a_from_m,
+  const Pointer*         m_from_a,
+  int                    step,
+  const Quantities*      quan,
+  Env*                   env )
+{
+  /*---Declarations---*/
+
+  const int proc_x = Env_proc_x_this( env );
+  const int proc_y = Env_proc_y_this( env );
+  const int proc_z = Env_proc_z_this( env );
+
+  StepInfoAll stepinfoall;  /*---But only use noctant_per_block values---*/
+
+  unsigned long int do_block_init = 0;
+
+  unsigned long int do_reduce_init = 0;
+
+  Sweeper_schedule_block_( sweeper, is_block_init, step,
+                           proc_x, proc_y, proc_z,
+                           &stepinfoall, &do_block_init, &do_reduce_init );
 
   /*---Call kernel adapter---*/
 
@@ -579,13 +1718,314 @@ void Sweeper_sweep_block(
                                proc_y==Env_nproc_y( env )-1,
                                stepinfoall,
                                do_block_init,
+                               do_reduce_init,
                                env);
 }
 
 /*===========================================================================*/
-/*---Perform a sweep---*/
+/*---Dataflow execution of the KBA steps on the thread team---*/
 
-void Sweeper_sweep(
+#ifdef USE_OPENMP_THREADS
+typedef struct
+{
+  SweeperBlockArgs_*     block_args;      /*---One per step---*/
+  Bool_t*                is_comm_edge;    /*---One per step, and one more---*/
+  int                    nstep;
+  int                    nface_buffer;
+  Sweeper*               sweeper;
+  Env*                   env;
+} SweeperDataflowArgs_;
+
+/*---------------------------------------------------------------------------*/
+/*---Whether this proc sends or receives any face after a step---*/
+/*---pseudo-private member function---*/
+
+static Bool_t Sweeper_is_step_comm_( Sweeper* sweeper, int step, Env* env )
+{
+  Bool_t result = Bool_false;
+
+  int octant_in_block = 0;
+  int axis = 0;
+  int dir_ind = 0;
+
+  if( step < 0 || step >= StepScheduler_nstep( &(sweeper->stepscheduler) ) )
+  {
+    return Bool_false;
+  }
+
+  for( octant_in_block=0; octant_in_block<sweeper->noctant_per_block;
+                                                            ++octant_in_block )
+  {
+    for( axis=0; axis<NDIM; ++axis )
+    {
+      for( dir_ind=0; dir_ind<2; ++dir_ind )
+      {
+        result = result ||
+          StepScheduler_must_do_send( &(sweeper->stepscheduler), step, axis,
+                                      dir_ind, octant_in_block, env ) ||
+          StepScheduler_must_do_recv( &(sweeper->stepscheduler), step, axis,
+                                      dir_ind, octant_in_block, env );
+      }
+    }
+  }
+
+  return result;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---Face communication between step-1 and step, in the lockstep order---*/
+/*---pseudo-private member function---*/
+
+static void Sweeper_dataflow_comm_( Sweeper* sweeper, int step, Env* env )
+{
+  const int nstep = StepScheduler_nstep( &(sweeper->stepscheduler) );
+
+  Faces* const faces = &(sweeper->faces);
+  StepScheduler* const stepscheduler = &(sweeper->stepscheduler);
+
+  if( step > 0 )
+  {
+    if( Faces_is_face_comm_async( faces ) )
+    {
+      Faces_send_faces_end( faces, stepscheduler, sweeper->dims_b,
+                            step-2, env );
+      Faces_send_faces_start( faces, stepscheduler, sweeper->dims_b,
+                              step-1, env );
+    }
+    else
+    {
+      Faces_communicate_faces( faces, stepscheduler, sweeper->dims_b,
+                               step-1, env );
+    }
+  }
+
+  if( step < nstep && Faces_is_face_comm_async( faces ) )
+  {
+    Faces_recv_faces_end( faces, stepscheduler, sweeper->dims_b,
+                          step-1, env );
+    Faces_recv_faces_start( faces, stepscheduler, sweeper->dims_b,
+                            step, env );
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---Communication as an input edge of a step: faces of the previous step
+     are sent, and those of this step received, by the calling thread
+     once all threads are done with the previous step---*/
+/*---pseudo-private member function---*/
+
+static void Sweeper_dataflow_comm_edge_( const SweeperDataflowArgs_* args,
+                                         int step, int thread )
+{
+  ThreadTeam* const threadteam = args->block_args[0].sweeperlite.threadteam;
+
+  ThreadTeam_barrier( threadteam, thread );
+
+  if( thread == 0 )
+  {
+    Sweeper_dataflow_comm_( args->sweeper, step, args->env );
+  }
+
+  ThreadTeam_barrier( threadteam, thread );
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void Sweeper_sweep_dataflow_thread_( void* context, int thread )
+{
+  const SweeperDataflowArgs_* const args =
+                                      (const SweeperDataflowArgs_*)context;
+
+  ThreadTeam* const threadteam = args->block_args[0].sweeperlite.threadteam;
+
+  const int nthread = ThreadTeam_nthread( threadteam );
+
+  /*---Flag of this thread at the end of each of the last few steps---*/
+
+  int nwave_step_end[NDIM];
+
+  int step = 0;
+
+  for( step=0; step<args->nstep; ++step )
+  {
+    const SweeperBlockArgs_* const block_args = &( args->block_args[step] );
+
+    if( args->is_comm_edge[step] )
+    {
+      /*---Wait for the whole previous step and for the faces it uses---*/
+
+      Sweeper_dataflow_comm_edge_( args, step, thread );
+    }
+    else if( ! block_args->sweeperlite.is_step_pipelined )
+    {
+      /*---Wait for the whole previous step---*/
+
+      if( step > 0 )
+      {
+        ThreadTeam_barrier( threadteam, thread );
+      }
+    }
+    else if( step >= args->nface_buffer )
+    {
+      /*---The x and y faces of this step were last used nface_buffer
+           steps ago; wait until no thread still reads them.  Waits on
+           the previous block itself are made per thread in the kernel---*/
+
+      const int nwave_done = nwave_step_end[ step % args->nface_buffer ];
+      int thread_other = 0;
+
+      for( thread_other=0; thread_other<nthread; ++thread_other )
+      {
+        ThreadTeam_flag_wait( threadteam, thread, thread_other, nwave_done );
+      }
+    }
+
+    Sweeper_sweep_block_thread_( (void*)block_args, thread );
+
+    nwave_step_end[ step % args->nface_buffer ] =
+                                      ThreadTeam_flag( threadteam, thread );
+  }
+
+  if( args->is_comm_edge[args->nstep] )
+  {
+    Sweeper_dataflow_comm_edge_( args, args->nstep, thread );
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void Sweeper_sweep_dataflow_(
+  Sweeper*               sweeper,
+  Pointer*               vo,
+  Pointer*               vi,
+  const Quantities*      quan,
+  Env*                   env )
+{
+  /*=========================================================================
+  =    All steps are run in a single team run.  A step that continues the
+  =    previous step's octant to the next block depends on that step only
+  =    through the xy face, so its threads start as soon as the threads
+  =    of the same y that swept the previous block are done, overlapping
+  =    the wavefront fill of one block with the drain of the previous.
+  =    Other steps, e.g. at a change of octant or when octant threads
+  =    share blocks via semiblocks, wait for the whole previous step.
+  =    With several procs, a step next to one after which this proc sends
+  =    or receives faces, as found from the step schedule, also waits for
+  =    the face communication, made by the calling thread in the same
+  =    order as for the lockstep sweep.
+  =========================================================================*/
+
+  const int nblock_z = sweeper->nblock_z;
+
+  const int nstep = StepScheduler_nstep( &(sweeper->stepscheduler) );
+
+  SweeperBlockArgs_* block_args = (SweeperBlockArgs_*)
+                                  malloc( nstep * sizeof( SweeperBlockArgs_ ) );
+
+  Bool_t* is_block_init = (Bool_t*) malloc( nblock_z * sizeof( Bool_t ) );
+
+  Bool_t* is_comm_edge = (Bool_t*) malloc( (nstep+1) * sizeof( Bool_t ) );
+
+  const int proc_x = Env_proc_x_this( env );
+  const int proc_y = Env_proc_y_this( env );
+  const int proc_z = Env_proc_z_this( env );
+
+  SweeperDataflowArgs_ args;
+
+  int step = 0;
+  int i = 0;
+
+  Insist( block_args && is_block_init && is_comm_edge );
+
+  for( i=0; i<nblock_z; ++i )
+  {
+    is_block_init[i] = 0;
+  }
+
+  /*---Precalculate the arguments of every step, in step order---*/
+
+  for( step=0; step<nstep; ++step )
+  {
+    SweeperBlockArgs_* const a = &( block_args[step] );
+
+    unsigned long int do_block_init = 0;
+
+    unsigned long int do_reduce_init = 0;
+
+    Sweeper_schedule_block_( sweeper, is_block_init, step,
+                             proc_x, proc_y, proc_z,
+                             &( a->stepinfoall ),
+                             &do_block_init, &do_reduce_init );
+
+    a->sweeper       = sweeper;
+    a->sweeperlite   = Sweeper_sweeperlite( sweeper );
+    a->vo            = Pointer_active( vo );
+    a->vi            = Pointer_active( vi );
+    a->facexy        = Pointer_active( Faces_facexy_step( &(sweeper->faces),
+                                                          step ) );
+    a->facexz        = Pointer_active( Faces_facexz_step( &(sweeper->faces),
+                                                          step ) );
+    a->faceyz        = Pointer_active( Faces_faceyz_step( &(sweeper->faces),
+                                                          step ) );
+    a->a_from_m      = Pointer_const_active( & quan->a_from_m );
+    a->m_from_a      = Pointer_const_active( & quan->m_from_a );
+    a->step          = step;
+    a->quan          = quan;
+    a->proc_x_min    = proc_x==0;
+    a->proc_x_max    = proc_x==Env_nproc_x( env )-1;
+    a->proc_y_min    = proc_y==0;
+    a->proc_y_max    = proc_y==Env_nproc_y( env )-1;
+    a->do_block_init = do_block_init;
+    a->do_reduce_init = do_reduce_init;
+
+    /*---Pipeline behind the previous step if it swept the previous block
+         of the same single octant---*/
+
+    a->sweeperlite.is_step_pipelined = step > 0 &&
+      sweeper->noctant_per_block == 1 &&
+      sweeper->nsemiblock == 1 &&
+      ! sweeper->vo_private_host_ &&
+      a->stepinfoall.stepinfo[0].is_active &&
+      block_args[step-1].stepinfoall.stepinfo[0].is_active &&
+      a->stepinfoall.stepinfo[0].octant ==
+                   block_args[step-1].stepinfoall.stepinfo[0].octant;
+  }
+
+  /*---Communication between step-1 and step touches the faces sent
+       after step-2 and step-1 and those received after step-1 and step---*/
+
+  for( step=0; step<=nstep; ++step )
+  {
+    is_comm_edge[step] = Sweeper_is_step_comm_( sweeper, step-2, env ) ||
+                         Sweeper_is_step_comm_( sweeper, step-1, env ) ||
+                         Sweeper_is_step_comm_( sweeper, step,   env );
+  }
+
+  args.block_args   = block_args;
+  args.is_comm_edge = is_comm_edge;
+  args.nstep        = nstep;
+  args.nface_buffer = Faces_is_face_comm_async( &(sweeper->faces) ) ? NDIM
+                                                                    : 1;
+  args.sweeper      = sweeper;
+  args.env          = env;
+
+  ThreadTeam_run( &( sweeper->threadteam ), Sweeper_sweep_dataflow_thread_,
+                  &args );
+
+  /*---Increment message tag, as for the lockstep sweep---*/
+
+  Env_increment_tag( env, sweeper->noctant_per_block );
+
+  free( (void*) is_comm_edge );
+  free( (void*) is_block_init );
+  free( (void*) block_args );
+}
+#endif
+
+/*===========================================================================*/
+/*---Perform a sweep one KBA step at a time---*/
+
+static void Sweeper_sweep_lockstep_(
   Sweeper*               sweeper,
   Pointer*               vo,
   Pointer*               vi,
@@ -603,8 +2043,8 @@ void Sweeper_sweep(
   const int nstep = StepScheduler_nstep( &(sweeper->stepscheduler) );
   int step = -1;
 
-  const size_t size_state_block = Dimensions_size_state( sweeper->dims, NU )
-                                                                   / nblock_z;
+  const size_t size_state_block = Dimensions_size_state( sweeper->dims,
+                                                  sweeper->dims.nu ) / nblock_z;
 
   Bool_t* is_block_init = (Bool_t*) malloc( nblock_z * sizeof( Bool_t ) );
 
@@ -618,7 +2058,7 @@ void Sweeper_sweep(
   /*---Initialize result array to zero if needed---*/
 
 #ifdef USE_OPENMP_VO_ATOMIC
-  initialize_state_zero( Pointer_h( vo ), sweeper->dims, NU );
+  initialize_state_zero( Pointer_h( vo ), sweeper->dims, sweeper->dims.nu );
   Pointer_update_d_stream( vo, Env_cuda_stream_kernel_faces( env ) );
 #endif
 
@@ -681,7 +2121,8 @@ void Sweeper_sweep(
 
     if( is_sweep_step )
     {
-      if( step == 0 )
+      /*---The xy face stays on the device unless it crosses procs---*/
+      if( step == 0 || Env_nproc_z( env ) > 1 )
       {
         Pointer_update_d_stream( facexy, Env_cuda_stream_kernel_faces( env ) );
       }
@@ -735,15 +2176,8 @@ void Sweeper_sweep(
         Pointer_update_d_stream( &vi_b, Env_cuda_stream_send_block( env ) );
         Pointer_destroy(         &vi_b );
 
-        /*---Initialize result array to zero if needed---*/
-        /*---NOTE: this is not performance-optimal---*/
-#ifdef USE_OPENMP_VO_ATOMIC
-        Pointer_create_alias(    &vo_b, vi, size_state_block * block_to_send[i],
-                                          size_state_block );
-        initialize_state_zero( Pointer_h( &vo_b ), sweeper->dims, NU );
-        Pointer_update_d_stream( &vo_b, Env_cuda_stream_send_block( env ) );
-        Pointer_destroy(         &vo_b );
-#endif
+        /*---NOTE: with USE_OPENMP_VO_ATOMIC all of vo was zeroed and
+             sent above, before the first step---*/
       }
     }
 
@@ -803,7 +2237,7 @@ void Sweeper_sweep(
 
     if( is_sweep_step )
     {
-      if( step == nstep-1 )
+      if( step == nstep-1 || Env_nproc_z( env ) > 1 )
       {
         Pointer_update_h_stream( facexy, Env_cuda_stream_kernel_faces( env ) );
       }
@@ -844,6 +2278,32 @@ void Sweeper_sweep(
 
 } /*---sweep---*/
 
+/*===========================================================================*/
+/*---Perform a sweep---*/
+
+void Sweeper_sweep(
+  Sweeper*               sweeper,
+  Pointer*               vo,
+  Pointer*               vi,
+  const Quantities*      quan,
+  Env*                   env )
+{
+  Assert( sweeper );
+  Assert( vi );
+  Assert( vo );
+
+  if( sweeper->is_using_dataflow )
+  {
+#ifdef USE_OPENMP_THREADS
+    Sweeper_sweep_dataflow_( sweeper, vo, vi, quan, env );
+#endif
+  }
+  else
+  {
+    Sweeper_sweep_lockstep_( sweeper, vo, vi, quan, env );
+  }
+}
+
 /*===========================================================================*/
 
 #ifdef __cplusplus
@@ -16,6 +16,7 @@
 #include "definitions_kernels.h"
 #include "quantities_kernels.h"
 #include "array_accessors_kernels.h"
+#include "array_operations_kernels.h"
 #include "stepscheduler_kba_kernels.h"
 #include "sweeper_kba_kernels.h"
 
@@ -31,9 +32,9 @@ TARGET_HD static inline void Sweeper_sweep_cell(
   SweeperLite* __restrict__      sweeper,
   P* const __restrict__          vo_this,
   const P* const __restrict__    vi_this,
-  P* const __restrict__          vilocal,
-  P* const __restrict__          vslocal,
-  P* const __restrict__          volocal,
+  PAccum* const __restrict__     vilocal,
+  PAccum* const __restrict__     vslocal,
+  PAccum* const __restrict__     volocal,
   P* const __restrict__          facexy,
   P* const __restrict__          facexz,
   P* const __restrict__          faceyz,
@@ -182,12 +183,12 @@ TODO: fix vectorization for this loop.
             int im_in_block = 0;
             int iu = 0;
 
-            P v[NU];
+            PAccum v[NU];
 
 #pragma unroll
             for( iu=0; iu<NU; ++iu )
             {
-              v[iu] = ((P)0);
+              v[iu] = PAccum_zero();
             }
 
             /*--------------------*/
@@ -258,12 +259,7 @@ TODO: fix vectorization for this loop.
     __assume_aligned( facexy,  VEC_LEN * sizeof(P) );
     __assume_aligned( facexz,  VEC_LEN * sizeof(P) );
     __assume_aligned( faceyz,  VEC_LEN * sizeof(P) );
-#ifndef __CUDA_ARCH__
-    int sweeper_thread_a = 0;
-#pragma ivdep
-#pragma simd assert, vectorlengthfor( P )
-    for( sweeper_thread_a=0; sweeper_thread_a<NTHREAD_A; ++sweeper_thread_a )
-#endif
+#ifdef __CUDA_ARCH__
     {
       const int ia = ia_base + sweeper_thread_a;
       Quantities_solve( quan, vslocal,
@@ -276,6 +272,20 @@ TODO: fix vectorization for this loop.
                         sweeper->dims_b, sweeper->dims_g,
                         is_elt_active );
     }
+#else
+    /*---Host: one call solves all angles of the block, SIMD across ia---*/
+    Quantities_solve_angles( quan, vslocal,
+                             ia_base,
+                             imin( NTHREAD_A, sweeper->dims_b.na - ia_base ),
+                             NTHREAD_A,
+                             facexy, facexz, faceyz,
+                             ix, iy, iz, ie,
+                             ix+quan->ix_base, iy+quan->iy_base, iz+iz_base,
+                             octant, octant_in_block,
+                             sweeper->noctant_per_block,
+                             sweeper->dims_b, sweeper->dims_g,
+                             is_elt_active );
+#endif
 
     /*====================*/
     /*---Reassign threads from angles to moments---*/
@@ -313,13 +323,13 @@ TODO: fix vectorization for this loop.
         {
           const int im = im_base + sweeper_thread_m;
 
-          P w[NU_PER_THREAD];
+          PAccum w[NU_PER_THREAD];
 
           int iu_per_thread = 0;
 #pragma unroll
           for( iu_per_thread=0; iu_per_thread<NU_PER_THREAD; ++iu_per_thread )
           {
-            w[iu_per_thread] = ((P)0);
+            w[iu_per_thread] = PAccum_zero();
           }
 
           /*====================*/
@@ -416,7 +426,7 @@ TODO: fix vectorization for this loop.
                           ---*/
                         * *const_ref_vslocal( vslocal, sweeper->dims_b, NU,
                                               NTHREAD_A, ia_in_block, iu )
-                        : ((P)0);
+                        : PAccum_zero();
                     }
                   } /*---for iu_per_thread---*/
                 }
@@ -475,7 +485,7 @@ TODO: fix vectorization for this loop.
               int iu_base = 0;
 #ifdef USE_OPENMP_VO_ATOMIC
 #pragma unroll
-              for( iu_base=0; iu_base<NU; iu += NTHREAD_U )
+              for( iu_base=0; iu_base<NU; iu_base += NTHREAD_U )
               {
                 const int iu = iu_base + sweeper_thread_u;
 
@@ -555,15 +565,19 @@ TODO: fix vectorization for this loop.
 }
 
 /*===========================================================================*/
-/*---Perform a sweep for a subblock---*/
+/*---Perform a sweep for a cell, SIMD across energy groups---*/
 
-TARGET_HD static inline void Sweeper_sweep_subblock(
+/*---Alternative to Sweeper_sweep_cell for problems with few angles:
+     groups ie_base .. ie_base+nlane-1 of the cell are done together, one
+     group per SIMD lane, with angles as the outer loop.  velanes holds
+     the moments, lane + SIMD_LEN * ( im + NM * iu ), followed by the
+     angles, lane + SIMD_LEN * ( ia + na * iu )---*/
+
+TARGET_HD static inline void Sweeper_sweep_cell_elanes(
   SweeperLite* __restrict__      sweeper,
   P* const __restrict__          vo_this,
   const P* const __restrict__    vi_this,
-  P* const __restrict__          vilocal,
-  P* const __restrict__          vslocal,
-  P* const __restrict__          volocal,
+  PAccum* const __restrict__     velanes,
   P* const __restrict__          facexy,
   P* const __restrict__          facexz,
   P* const __restrict__          faceyz,
@@ -573,233 +587,1455 @@ TARGET_HD static inline void Sweeper_sweep_subblock(
   const int                      octant,
   const int                      iz_base,
   const int                      octant_in_block,
-  const int                      ixmin_subblock,
-  const int                      ixmax_subblock,
-  const int                      iymin_subblock,
-  const int                      iymax_subblock,
-  const int                      izmin_subblock,
-  const int                      izmax_subblock,
-  const Bool_t                   is_subblock_active,
-  const int                      ixmin_semiblock,
-  const int                      ixmax_semiblock,
-  const int                      iymin_semiblock,
-  const int                      iymax_semiblock,
-  const int                      izmin_semiblock,
-  const int                      izmax_semiblock,
-  const int                      dir_x,
-  const int                      dir_y,
-  const int                      dir_z,
-  const int                      dir_inc_x,
-  const int                      dir_inc_y,
-  const int                      dir_inc_z,
-  const Bool_t                   do_block_init_this,
-  const Bool_t                   is_octant_active )
+  const int                      ie_base,
+  const int                      nlane,
+  const int                      ix,
+  const int                      iy,
+  const int                      iz,
+  const Bool_t                   do_block_init_this )
 {
-  /*---Initializations---*/
+  const int na = sweeper->dims_b.na;
+  const SimdMask mask_all = SimdAcc_mask( SIMD_LEN );
 
-  const int iemin = (   sweeper->dims.ne *
-                      ( Sweeper_thread_e( sweeper )     ) )
-                  /     sweeper->nthread_e;
-  const int iemax = (   sweeper->dims.ne *
-                      ( Sweeper_thread_e( sweeper ) + 1 ) )
-                  /     sweeper->nthread_e;
+  PAccum* const __restrict__ vmlanes = velanes;
+  PAccum* const __restrict__ valanes = velanes + SIMD_LEN * NM * NU;
 
-  int ie = 0;
+  int lane = 0;
+  int im = 0;
+  int ia = 0;
+  int iu = 0;
 
-  const int ixbeg = dir_x==DIR_UP ? ixmin_subblock : ixmax_subblock;
-  const int iybeg = dir_y==DIR_UP ? iymin_subblock : iymax_subblock;
-  const int izbeg = dir_z==DIR_UP ? izmin_subblock : izmax_subblock;
+  /*--------------------*/
+  /*---Gather vi for the groups, moments into lanes---*/
+  /*--------------------*/
 
-  const int ixend = dir_x==DIR_DN ? ixmin_subblock : ixmax_subblock;
-  const int iyend = dir_y==DIR_DN ? iymin_subblock : iymax_subblock;
-  const int izend = dir_z==DIR_DN ? izmin_subblock : izmax_subblock;
+  for( lane=0; lane<SIMD_LEN; ++lane )
+  {
+    const Bool_t is_lane_active = lane < nlane;
+    const P* const __restrict__ vi_cell = const_ref_state_flat( vi_this,
+                      sweeper->dims_b.ncell_x, sweeper->dims_b.ncell_y,
+                      sweeper->dims_b.ncell_z, sweeper->dims_b.ne, NM, NU,
+                      ix, iy, iz, is_lane_active ? ie_base + lane : ie_base,
+                      0, 0 );
+    int imu = 0;
+    for( imu=0; imu<NM*NU; ++imu )
+    {
+      vmlanes[ lane + SIMD_LEN * imu ] = is_lane_active ? vi_cell[imu]
+                                                        : PAccum_zero();
+    }
+  }
 
-  int ix = 0, iy = 0, iz = 0;
+  /*--------------------*/
+  /*---Transform moments to angles---*/
+  /*--------------------*/
+
+  for( ia=0; ia<na; ++ia )
+  {
+#pragma unroll
+    for( iu=0; iu<NU; ++iu )
+    {
+      SimdAcc v = SimdAcc_set1( PAccum_zero() );
+      for( im=0; im<NM; ++im )
+      {
+        v = SimdAcc_add( v, SimdAcc_mul(
+              SimdAcc_set1( *const_ref_a_from_m_flat( a_from_m, NM, na,
+                                                      im, ia, octant ) ),
+              SimdAcc_load_mask( vmlanes + SIMD_LEN * ( im + NM * iu ),
+                                 mask_all ) ) );
+      }
+      SimdAcc_store_mask( valanes + SIMD_LEN * ( ia + na * iu ), v,
+                          mask_all );
+    }
+  }
 
   /*--------------------*/
-  /*---First perform any required boundary initializations---*/
+  /*---Perform solve---*/
   /*--------------------*/
 
+  Quantities_solve_elanes( quan, valanes,
+                           facexy, facexz, faceyz,
+                           ix, iy, iz, ie_base, nlane,
+                           ix+quan->ix_base, iy+quan->iy_base, iz+iz_base,
+                           octant, octant_in_block,
+                           sweeper->noctant_per_block,
+                           sweeper->dims_b, sweeper->dims_g );
+
   /*--------------------*/
-  /*---Loop over energy groups owned by this energy thread---*/
+  /*---Transform angles to moments; vi no longer needed, reuse vmlanes---*/
   /*--------------------*/
 
-  for( ie=iemin; ie<iemax; ++ie )
+  for( im=0; im<NM; ++im )
   {
-    /*--------------------*/
-    /*---Loop over cells in this subblock---*/
-    /*--------------------*/
+#pragma unroll
+    for( iu=0; iu<NU; ++iu )
+    {
+      SimdAcc w = SimdAcc_set1( PAccum_zero() );
+      for( ia=0; ia<na; ++ia )
+      {
+        w = SimdAcc_add( w, SimdAcc_mul(
+              SimdAcc_set1( m_from_a[ ind_m_from_a_flat( NM, na,
+                                                         im, ia, octant ) ] ),
+              SimdAcc_load_mask( valanes + SIMD_LEN * ( ia + na * iu ),
+                                 mask_all ) ) );
+      }
+      SimdAcc_store_mask( vmlanes + SIMD_LEN * ( im + NM * iu ), w,
+                          mask_all );
+    }
+  }
 
-    for( iz=izbeg; iz!=izend+dir_inc_z; iz+=dir_inc_z )
+  /*--------------------*/
+  /*---Scatter result to vo---*/
+  /*--------------------*/
+
+  for( lane=0; lane<nlane; ++lane )
+  {
+    P* const __restrict__ vo_cell = ref_state_flat( vo_this,
+                      sweeper->dims_b.ncell_x, sweeper->dims_b.ncell_y,
+                      sweeper->dims_b.ncell_z, sweeper->dims_b.ne, NM, NU,
+                      ix, iy, iz, ie_base + lane, 0, 0 );
+    int imu = 0;
+#ifdef USE_OPENMP_VO_ATOMIC
+    for( imu=0; imu<NM*NU; ++imu )
     {
-    for( iy=iybeg; iy!=iyend+dir_inc_y; iy+=dir_inc_y )
+#pragma omp atomic update
+      vo_cell[imu] += vmlanes[ lane + SIMD_LEN * imu ];
+    }
+#else
+    if( do_block_init_this )
     {
-    for( ix=ixbeg; ix!=ixend+dir_inc_x; ix+=dir_inc_x )
+      for( imu=0; imu<NM*NU; ++imu )
+      {
+        vo_cell[imu] = vmlanes[ lane + SIMD_LEN * imu ];
+      }
+    }
+    else
     {
-      /*---Truncate loop region to block, semiblock and subblock---*/
-      const Bool_t is_elt_active = ix <  sweeper->dims_b.ncell_x &&
-                                   iy <  sweeper->dims_b.ncell_y &&
-                                   iz <  sweeper->dims_b.ncell_z &&
-                                   ix <= ixmax_semiblock &&
-                                   iy <= iymax_semiblock &&
-                                   iz <= izmax_semiblock &&
-                                   is_subblock_active &&
-                                   is_octant_active;
-                                /* ix >= 0 &&
-                                   iy >= 0 &&
-                                   iz >= 0 &&
-                                   ix >= ixmin_semiblock &&
-                                   iy >= iymin_semiblock &&
-                                   iz >= izmin_semiblock &&
-                                   ix >= ixmin_subblock &&
-                                   iy >= iymin_subblock &&
-                                   iz >= izmin_subblock &&
-                                   ix <= ixmax_subblock &&
-                                   iy <= iymax_subblock &&
-                                   iz <= izmax_subblock && (guaranteed) */
+      for( imu=0; imu<NM*NU; ++imu )
+      {
+        vo_cell[imu] += vmlanes[ lane + SIMD_LEN * imu ];
+      }
+    }
+#endif
+  }
+}
 
-      if( is_elt_active )
+/*===========================================================================*/
+/*---Moment/angle transform variants---*/
+
+/*---Interchangeable versions of the two small matvecs done at each cell,
+     after the sub1 .. sub9 experiments in
+     _matrix_operations_prototype/matrix_kernels.cc.  vm holds the moments,
+     im + NM * iu, and va the angles, ia + na * iu.  Every variant sums
+     over im (resp. ia) in increasing order---*/
+
+/*---DOT (sub1, sub2): one dot product per result entry---*/
+
+TARGET_HD static inline void Sweeper_xform_m_to_a_dot_(
+  const PAccum* const __restrict__ vm,
+  PAccum* const __restrict__       va,
+  const P* const __restrict__      a_from_m,
+  const int                        na,
+  const int                        octant )
+{
+  int ia = 0;
+  int iu = 0;
+  int im = 0;
+
+  for( iu=0; iu<NU; ++iu )
+  {
+    for( ia=0; ia<na; ++ia )
+    {
+      PAccum v = PAccum_zero();
+      for( im=0; im<NM; ++im )
       {
-        /*--------------------*/
-        /*---Set boundary condition if needed: xy---*/
-        /*--------------------*/
+        v += *const_ref_a_from_m_flat( a_from_m, NM, na, im, ia, octant )
+           * vm[ im + NM * iu ];
+      }
+      va[ ia + na * iu ] = v;
+    }
+  }
+}
 
-        const int iz_g = iz + iz_base;
-        if( ( iz_g == 0                         && dir_z == DIR_UP ) ||
-            ( iz_g == sweeper->dims_g.ncell_z-1 && dir_z == DIR_DN ) )
-        {
-          const int ix_g = ix + quan->ix_base;
-          const int iy_g = iy + quan->iy_base;
-          /*---TODO: thread/vectorize in u, a---*/
-          int iu = 0;
-          for( iu=0; iu<NU; ++iu )
-          {
-            int ia = 0;
-          for( ia=0; ia<sweeper->dims_b.na; ++ia )
-          {
-            *ref_facexy( facexy, sweeper->dims_b, NU,  
-                         sweeper->noctant_per_block,
-                         ix, iy, ie, ia, iu, octant_in_block )     
-               = Quantities_init_facexy( quan, ix_g, iy_g, iz_g-dir_inc_z,
-                                         ie, ia, iu, octant, sweeper->dims_g );
-          }
-          }
-        }
+/*---------------------------------------------------------------------------*/
 
-        /*--------------------*/
-        /*---Set boundary condition if needed: xz---*/
-        /*--------------------*/
+TARGET_HD static inline void Sweeper_xform_a_to_m_dot_(
+  const PAccum* const __restrict__ va,
+  PAccum* const __restrict__       vm,
+  const P* const __restrict__      m_from_a,
+  const int                        na,
+  const int                        octant )
+{
+  int ia = 0;
+  int iu = 0;
+  int im = 0;
 
-        const int iy_g = iy + quan->iy_base;
-        if( ( iy_g == 0                         && dir_y == DIR_UP ) ||
-            ( iy_g == sweeper->dims_g.ncell_y-1 && dir_y == DIR_DN ) )
-        {
-          const int ix_g = ix + quan->ix_base;
-          const int iz_g = iz +       iz_base;
-          /*---TODO: thread/vectorize in u, a---*/
-          int iu = 0;
-          for( iu=0; iu<NU; ++iu )
-          {
-            int ia = 0;
-          for( ia=0; ia<sweeper->dims_b.na; ++ia )
-          {
-            *ref_facexz( facexz, sweeper->dims_b, NU,  
-                         sweeper->noctant_per_block,
-                         ix, iz, ie, ia, iu, octant_in_block )     
-               = Quantities_init_facexz( quan, ix_g, iy_g-dir_inc_y, iz_g,
-                                         ie, ia, iu, octant, sweeper->dims_g );
-          }
-          }
-        }
+  for( iu=0; iu<NU; ++iu )
+  {
+    for( im=0; im<NM; ++im )
+    {
+      PAccum w = PAccum_zero();
+      for( ia=0; ia<na; ++ia )
+      {
+        w += m_from_a[ ind_m_from_a_flat( NM, na, im, ia, octant ) ]
+           * va[ ia + na * iu ];
+      }
+      vm[ im + NM * iu ] = w;
+    }
+  }
+}
 
-        /*--------------------*/
-        /*---Set boundary condition if needed: yz---*/
-        /*--------------------*/
+/*---------------------------------------------------------------------------*/
+/*---DOT_UNROLL_U (sub3, sub5): all unknowns at once, in registers---*/
+
+TARGET_HD static inline void Sweeper_xform_m_to_a_dot_unroll_u_(
+  const PAccum* const __restrict__ vm,
+  PAccum* const __restrict__       va,
+  const P* const __restrict__      a_from_m,
+  const int                        na,
+  const int                        octant )
+{
+  int ia = 0;
+  int iu = 0;
+  int im = 0;
 
-        const int ix_g = ix + quan->ix_base;
-        if( ( ix_g == 0                         && dir_x == DIR_UP ) ||
-            ( ix_g == sweeper->dims_g.ncell_x-1 && dir_x == DIR_DN ) )
-        {
-          const int iy_g = iy + quan->iy_base;
-          const int iz_g = iz +       iz_base;
-          /*---TODO: thread/vectorize in u, a---*/
-          int iu = 0;
-          for( iu=0; iu<NU; ++iu )
-          {
-            int ia = 0;
-          for( ia=0; ia<sweeper->dims_b.na; ++ia )
-          {
-            *ref_faceyz( faceyz, sweeper->dims_b, NU,  
-                         sweeper->noctant_per_block,
-                         iy, iz, ie, ia, iu, octant_in_block )     
-               = Quantities_init_faceyz( quan, ix_g-dir_inc_x, iy_g, iz_g,
-                                         ie, ia, iu, octant, sweeper->dims_g );
-          }
-          }
-        }
+  for( ia=0; ia<na; ++ia )
+  {
+    PAccum v[NU];
+#pragma unroll
+    for( iu=0; iu<NU; ++iu )
+    {
+      v[iu] = PAccum_zero();
+    }
+    for( im=0; im<NM; ++im )
+    {
+      const PAccum a_from_m_this = *const_ref_a_from_m_flat( a_from_m,
+                                                  NM, na, im, ia, octant );
+#pragma unroll
+      for( iu=0; iu<NU; ++iu )
+      {
+        v[iu] += a_from_m_this * vm[ im + NM * iu ];
+      }
+    }
+#pragma unroll
+    for( iu=0; iu<NU; ++iu )
+    {
+      va[ ia + na * iu ] = v[iu];
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void Sweeper_xform_a_to_m_dot_unroll_u_(
+  const PAccum* const __restrict__ va,
+  PAccum* const __restrict__       vm,
+  const P* const __restrict__      m_from_a,
+  const int                        na,
+  const int                        octant )
+{
+  int ia = 0;
+  int iu = 0;
+  int im = 0;
+
+  for( im=0; im<NM; ++im )
+  {
+    PAccum w[NU];
+#pragma unroll
+    for( iu=0; iu<NU; ++iu )
+    {
+      w[iu] = PAccum_zero();
+    }
+    for( ia=0; ia<na; ++ia )
+    {
+      const PAccum m_from_a_this = m_from_a[ ind_m_from_a_flat( NM, na,
+                                                        im, ia, octant ) ];
+#pragma unroll
+      for( iu=0; iu<NU; ++iu )
+      {
+        w[iu] += m_from_a_this * va[ ia + na * iu ];
+      }
+    }
+#pragma unroll
+    for( iu=0; iu<NU; ++iu )
+    {
+      vm[ im + NM * iu ] = w[iu];
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---AXPY (sub7, sub8): columns of the matrix, unit stride inner loop---*/
+
+TARGET_HD static inline void Sweeper_xform_m_to_a_axpy_(
+  const PAccum* const __restrict__ vm,
+  PAccum* const __restrict__       va,
+  const P* const __restrict__      a_from_m,
+  const int                        na,
+  const int                        octant )
+{
+  int ia = 0;
+  int iu = 0;
+  int im = 0;
+
+  for( iu=0; iu<NU; ++iu )
+  {
+    PAccum* const __restrict__ va_u = va + na * iu;
+    for( ia=0; ia<na; ++ia )
+    {
+      va_u[ia] = PAccum_zero();
+    }
+    for( im=0; im<NM; ++im )
+    {
+      const P* const __restrict__ a_col = const_ref_a_from_m_flat( a_from_m,
+                                                  NM, na, im, 0, octant );
+      const PAccum vm_this = vm[ im + NM * iu ];
+#pragma ivdep
+#pragma simd
+      for( ia=0; ia<na; ++ia )
+      {
+        va_u[ia] += a_col[ia] * vm_this;
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void Sweeper_xform_a_to_m_axpy_(
+  const PAccum* const __restrict__ va,
+  PAccum* const __restrict__       vm,
+  const P* const __restrict__      m_from_a,
+  const int                        na,
+  const int                        octant )
+{
+  int ia = 0;
+  int iu = 0;
+  int im = 0;
+
+  for( iu=0; iu<NU; ++iu )
+  {
+    PAccum* const __restrict__ vm_u = vm + NM * iu;
+    for( im=0; im<NM; ++im )
+    {
+      vm_u[im] = PAccum_zero();
+    }
+    for( ia=0; ia<na; ++ia )
+    {
+      const P* const __restrict__ m_col = m_from_a + ind_m_from_a_flat( NM,
+                                                      na, 0, ia, octant );
+      const PAccum va_this = va[ ia + na * iu ];
+#pragma ivdep
+#pragma simd
+      for( im=0; im<NM; ++im )
+      {
+        vm_u[im] += m_col[im] * va_this;
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---AXPY_UNROLL4 (sub9): as AXPY, four columns per pass over the result---*/
+
+TARGET_HD static inline void Sweeper_xform_m_to_a_axpy_unroll4_(
+  const PAccum* const __restrict__ vm,
+  PAccum* const __restrict__       va,
+  const P* const __restrict__      a_from_m,
+  const int                        na,
+  const int                        octant )
+{
+  int ia = 0;
+  int iu = 0;
+  int im = 0;
+
+  for( iu=0; iu<NU; ++iu )
+  {
+    PAccum* const __restrict__ va_u = va + na * iu;
+    for( ia=0; ia<na; ++ia )
+    {
+      va_u[ia] = PAccum_zero();
+    }
+    for( im=0; im+4<=NM; im+=4 )
+    {
+      const P* const __restrict__ a_col = const_ref_a_from_m_flat( a_from_m,
+                                                  NM, na, im, 0, octant );
+      const PAccum vm0 = vm[ im + 0 + NM * iu ];
+      const PAccum vm1 = vm[ im + 1 + NM * iu ];
+      const PAccum vm2 = vm[ im + 2 + NM * iu ];
+      const PAccum vm3 = vm[ im + 3 + NM * iu ];
+#pragma ivdep
+#pragma simd
+      for( ia=0; ia<na; ++ia )
+      {
+        va_u[ia] = va_u[ia] + a_col[ ia + 0 * na ] * vm0
+                            + a_col[ ia + 1 * na ] * vm1
+                            + a_col[ ia + 2 * na ] * vm2
+                            + a_col[ ia + 3 * na ] * vm3;
+      }
+    }
+    for( ; im<NM; ++im )
+    {
+      const P* const __restrict__ a_col = const_ref_a_from_m_flat( a_from_m,
+                                                  NM, na, im, 0, octant );
+      const PAccum vm_this = vm[ im + NM * iu ];
+      for( ia=0; ia<na; ++ia )
+      {
+        va_u[ia] += a_col[ia] * vm_this;
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void Sweeper_xform_a_to_m_axpy_unroll4_(
+  const PAccum* const __restrict__ va,
+  PAccum* const __restrict__       vm,
+  const P* const __restrict__      m_from_a,
+  const int                        na,
+  const int                        octant )
+{
+  int ia = 0;
+  int iu = 0;
+  int im = 0;
+
+  for( iu=0; iu<NU; ++iu )
+  {
+    PAccum* const __restrict__ vm_u = vm + NM * iu;
+    for( im=0; im<NM; ++im )
+    {
+      vm_u[im] = PAccum_zero();
+    }
+    for( ia=0; ia+4<=na; ia+=4 )
+    {
+      const P* const __restrict__ m_col = m_from_a + ind_m_from_a_flat( NM,
+                                                      na, 0, ia, octant );
+      const PAccum va0 = va[ ia + 0 + na * iu ];
+      const PAccum va1 = va[ ia + 1 + na * iu ];
+      const PAccum va2 = va[ ia + 2 + na * iu ];
+      const PAccum va3 = va[ ia + 3 + na * iu ];
+#pragma ivdep
+#pragma simd
+      for( im=0; im<NM; ++im )
+      {
+        vm_u[im] = vm_u[im] + m_col[ im + 0 * NM ] * va0
+                            + m_col[ im + 1 * NM ] * va1
+                            + m_col[ im + 2 * NM ] * va2
+                            + m_col[ im + 3 * NM ] * va3;
+      }
+    }
+    for( ; ia<na; ++ia )
+    {
+      const P* const __restrict__ m_col = m_from_a + ind_m_from_a_flat( NM,
+                                                      na, 0, ia, octant );
+      const PAccum va_this = va[ ia + na * iu ];
+      for( im=0; im<NM; ++im )
+      {
+        vm_u[im] += m_col[im] * va_this;
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---CELL: the blocking of Sweeper_sweep_cell on the host, NTHREAD_A
+     angles by NTHREAD_M moments at a time; used only to time that
+     kernel's transforms against the others---*/
+
+TARGET_HD static inline void Sweeper_xform_m_to_a_cell_(
+  const PAccum* const __restrict__ vm,
+  PAccum* const __restrict__       va,
+  const P* const __restrict__      a_from_m,
+  const int                        na,
+  const int                        octant )
+{
+  int ia_base = 0;
+  int im_base = 0;
+  int iu = 0;
+
+  for( ia_base=0; ia_base<na; ia_base+=NTHREAD_A )
+  {
+    for( im_base=0; im_base<NM; im_base+=NTHREAD_M )
+    {
+      int ia_in_block = 0;
+      for( ia_in_block=0; ia_in_block<NTHREAD_A; ++ia_in_block )
+      {
+        const int ia = ia_base + ia_in_block;
+        if( ia < na )
+        {
+          int im_in_block = 0;
+          PAccum v[NU];
+#pragma unroll
+          for( iu=0; iu<NU; ++iu )
+          {
+            v[iu] = PAccum_zero();
+          }
+          for( im_in_block=0; im_in_block<NTHREAD_M; ++im_in_block )
+          {
+            const int im = im_base + im_in_block;
+            if( NM % NTHREAD_M == 0 || im < NM )
+            {
+              const P a_from_m_this = *const_ref_a_from_m_flat( a_from_m,
+                                                  NM, na, im, ia, octant );
+#pragma unroll
+              for( iu=0; iu<NU; ++iu )
+              {
+                v[iu] += a_from_m_this * vm[ im + NM * iu ];
+              }
+            }
+          }
+#pragma unroll
+          for( iu=0; iu<NU; ++iu )
+          {
+            va[ ia + na * iu ] = im_base == 0 ? v[iu]
+                                              : va[ ia + na * iu ] + v[iu];
+          }
+        }
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void Sweeper_xform_a_to_m_cell_(
+  const PAccum* const __restrict__ va,
+  PAccum* const __restrict__       vm,
+  const P* const __restrict__      m_from_a,
+  const int                        na,
+  const int                        octant )
+{
+  int ia_base = 0;
+  int im = 0;
+  int iu = 0;
+
+  for( ia_base=0; ia_base<na; ia_base+=NTHREAD_A )
+  {
+    for( im=0; im<NM; ++im )
+    {
+      int ia_in_block = 0;
+      PAccum w[NU];
+#pragma unroll
+      for( iu=0; iu<NU; ++iu )
+      {
+        w[iu] = PAccum_zero();
+      }
+#pragma unroll 4
+      for( ia_in_block=0; ia_in_block<NTHREAD_A; ++ia_in_block )
+      {
+        const int ia = ia_base + ia_in_block;
+        const Bool_t mask = ia < na;
+        const P m_from_a_this = mask ? m_from_a[ ind_m_from_a_flat( NM, na,
+                                                        im, ia, octant ) ]
+                                     : ((P)0);
+#pragma unroll
+        for( iu=0; iu<NU; ++iu )
+        {
+          w[iu] += m_from_a_this * ( mask ? va[ ia + na * iu ]
+                                          : PAccum_zero() );
+        }
+      }
+#pragma unroll
+      for( iu=0; iu<NU; ++iu )
+      {
+        vm[ im + NM * iu ] = ia_base == 0 ? w[iu]
+                                          : vm[ im + NM * iu ] + w[iu];
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---Dispatch to the selected variant---*/
+
+TARGET_HD static inline void Sweeper_xform_m_to_a(
+  const int                        variant,
+  const PAccum* const __restrict__ vm,
+  PAccum* const __restrict__       va,
+  const P* const __restrict__      a_from_m,
+  const int                        na,
+  const int                        octant )
+{
+  switch( variant )
+  {
+    case XFORM_VARIANT_CELL:
+      Sweeper_xform_m_to_a_cell_( vm, va, a_from_m, na, octant );
+      break;
+    case XFORM_VARIANT_DOT_UNROLL_U:
+      Sweeper_xform_m_to_a_dot_unroll_u_( vm, va, a_from_m, na, octant );
+      break;
+    case XFORM_VARIANT_AXPY:
+      Sweeper_xform_m_to_a_axpy_( vm, va, a_from_m, na, octant );
+      break;
+    case XFORM_VARIANT_AXPY_UNROLL4:
+      Sweeper_xform_m_to_a_axpy_unroll4_( vm, va, a_from_m, na, octant );
+      break;
+    default:
+      Sweeper_xform_m_to_a_dot_( vm, va, a_from_m, na, octant );
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void Sweeper_xform_a_to_m(
+  const int                        variant,
+  const PAccum* const __restrict__ va,
+  PAccum* const __restrict__       vm,
+  const P* const __restrict__      m_from_a,
+  const int                        na,
+  const int                        octant )
+{
+  switch( variant )
+  {
+    case XFORM_VARIANT_CELL:
+      Sweeper_xform_a_to_m_cell_( va, vm, m_from_a, na, octant );
+      break;
+    case XFORM_VARIANT_DOT_UNROLL_U:
+      Sweeper_xform_a_to_m_dot_unroll_u_( va, vm, m_from_a, na, octant );
+      break;
+    case XFORM_VARIANT_AXPY:
+      Sweeper_xform_a_to_m_axpy_( va, vm, m_from_a, na, octant );
+      break;
+    case XFORM_VARIANT_AXPY_UNROLL4:
+      Sweeper_xform_a_to_m_axpy_unroll4_( va, vm, m_from_a, na, octant );
+      break;
+    default:
+      Sweeper_xform_a_to_m_dot_( va, vm, m_from_a, na, octant );
+  }
+}
+
+/*===========================================================================*/
+/*---Perform a sweep for a cell, using a transform variant---*/
+
+/*---Host alternative to Sweeper_sweep_cell: no thread blocking of the
+     angles and moments, the transforms done by sweeper->xform_variant.
+     vxform holds the moments, im + NM * iu, followed by the angles,
+     ia + na * iu---*/
+
+TARGET_HD static inline void Sweeper_sweep_cell_xform(
+  SweeperLite* __restrict__      sweeper,
+  P* const __restrict__          vo_this,
+  const P* const __restrict__    vi_this,
+  PAccum* const __restrict__     vxform,
+  P* const __restrict__          facexy,
+  P* const __restrict__          facexz,
+  P* const __restrict__          faceyz,
+  const P* const __restrict__    a_from_m,
+  const P* const __restrict__    m_from_a,
+  const Quantities* __restrict__ quan,
+  const int                      octant,
+  const int                      iz_base,
+  const int                      octant_in_block,
+  const int                      ie,
+  const int                      ix,
+  const int                      iy,
+  const int                      iz,
+  const Bool_t                   do_block_init_this )
+{
+  const int na = sweeper->dims_b.na;
+
+  PAccum* const __restrict__ vm = vxform;
+  PAccum* const __restrict__ va = vxform + NM * NU;
+
+  const P* const __restrict__ vi_cell = const_ref_state_flat( vi_this,
+                    sweeper->dims_b.ncell_x, sweeper->dims_b.ncell_y,
+                    sweeper->dims_b.ncell_z, sweeper->dims_b.ne, NM, NU,
+                    ix, iy, iz, ie, 0, 0 );
+  P* const __restrict__ vo_cell = ref_state_flat( vo_this,
+                    sweeper->dims_b.ncell_x, sweeper->dims_b.ncell_y,
+                    sweeper->dims_b.ncell_z, sweeper->dims_b.ne, NM, NU,
+                    ix, iy, iz, ie, 0, 0 );
+
+  int imu = 0;
+
+  /*--------------------*/
+  /*---Load vi; moments and unknowns of the cell are contiguous---*/
+  /*--------------------*/
+
+  for( imu=0; imu<NM*NU; ++imu )
+  {
+    vm[imu] = vi_cell[imu];
+  }
+
+  /*--------------------*/
+  /*---Transform moments to angles---*/
+  /*--------------------*/
+
+  Sweeper_xform_m_to_a( sweeper->xform_variant, vm, va, a_from_m,
+                        na, octant );
+
+  /*--------------------*/
+  /*---Perform solve---*/
+  /*--------------------*/
+
+  Quantities_solve_angles( quan, va, 0, na, na,
+                           facexy, facexz, faceyz,
+                           ix, iy, iz, ie,
+                           ix+quan->ix_base, iy+quan->iy_base, iz+iz_base,
+                           octant, octant_in_block,
+                           sweeper->noctant_per_block,
+                           sweeper->dims_b, sweeper->dims_g,
+                           Bool_true );
+
+  /*--------------------*/
+  /*---Transform angles to moments; vi no longer needed, reuse vm---*/
+  /*--------------------*/
+
+  Sweeper_xform_a_to_m( sweeper->xform_variant, va, vm, m_from_a,
+                        na, octant );
+
+  /*--------------------*/
+  /*---Store/update vo---*/
+  /*--------------------*/
+
+#ifdef USE_OPENMP_VO_ATOMIC
+  for( imu=0; imu<NM*NU; ++imu )
+  {
+#pragma omp atomic update
+    vo_cell[imu] += vm[imu];
+  }
+#else
+  if( do_block_init_this )
+  {
+    for( imu=0; imu<NM*NU; ++imu )
+    {
+      vo_cell[imu] = vm[imu];
+    }
+  }
+  else
+  {
+    for( imu=0; imu<NM*NU; ++imu )
+    {
+      vo_cell[imu] += vm[imu];
+    }
+  }
+#endif
+}
+
+/*===========================================================================*/
+/*---Perform a sweep for a batch of mutually independent cells---*/
+
+/*---The cells must all lie on the same wavefront, so that none of them
+     depends on another through the faces.  The moment/angle transforms
+     of the whole batch are then each done as one GEMM---*/
+
+TARGET_HD static inline void Sweeper_sweep_cells_batched(
+  SweeperLite* __restrict__      sweeper,
+  P* const __restrict__          vo_this,
+  const P* const __restrict__    vi_this,
+  PAccum* const __restrict__     vmbatch,
+  PAccum* const __restrict__     vabatch,
+  P* const __restrict__          facexy,
+  P* const __restrict__          facexz,
+  P* const __restrict__          faceyz,
+  const P* const __restrict__    a_from_m,
+  const P* const __restrict__    m_from_a,
+  const Quantities* __restrict__ quan,
+  const int                      octant,
+  const int                      iz_base,
+  const int                      octant_in_block,
+  const int* const __restrict__  ie_batch,
+  const int* const __restrict__  ix_batch,
+  const int* const __restrict__  iy_batch,
+  const int* const __restrict__  iz_batch,
+  const int                      nbatch,
+  const Bool_t                   do_block_init_this )
+{
+  const int na = sweeper->dims_b.na;
+  const int nmu = NM * NU;
+
+  int ibatch = 0;
+
+  /*--------------------*/
+  /*---Gather vi for batch, one NM x NU block per cell---*/
+  /*--------------------*/
+
+  for( ibatch=0; ibatch<nbatch; ++ibatch )
+  {
+    const P* const __restrict__ vi_cell = const_ref_state_flat( vi_this,
+                      sweeper->dims_b.ncell_x, sweeper->dims_b.ncell_y,
+                      sweeper->dims_b.ncell_z, sweeper->dims_b.ne, NM, NU,
+                      ix_batch[ibatch], iy_batch[ibatch], iz_batch[ibatch],
+                      ie_batch[ibatch], 0, 0 );
+    PAccum* const __restrict__ vm_cell = vmbatch + nmu * ibatch;
+    int imu = 0;
+#pragma ivdep
+#pragma simd
+    for( imu=0; imu<nmu; ++imu )
+    {
+      vm_cell[imu] = vi_cell[imu];
+    }
+  }
+
+  /*--------------------*/
+  /*---Transform moments to angles: (na x nm) * (nm x nu*nbatch)---*/
+  /*--------------------*/
+
+  gemm_P( na, NU*nbatch, NM,
+          const_ref_a_from_m_flat( a_from_m, NM, na, 0, 0, octant ), na,
+          vmbatch, NM,
+          vabatch, na );
+
+  /*--------------------*/
+  /*---Perform solve, cell by cell; vabatch has vslocal layout per cell---*/
+  /*--------------------*/
+
+  for( ibatch=0; ibatch<nbatch; ++ibatch )
+  {
+    const int ie = ie_batch[ibatch];
+    const int ix = ix_batch[ibatch];
+    const int iy = iy_batch[ibatch];
+    const int iz = iz_batch[ibatch];
+    PAccum* const __restrict__ vs_cell = vabatch + na * NU * ibatch;
+    Quantities_solve_angles( quan, vs_cell,
+                             0, na, na,
+                             facexy, facexz, faceyz,
+                             ix, iy, iz, ie,
+                             ix+quan->ix_base, iy+quan->iy_base, iz+iz_base,
+                             octant, octant_in_block,
+                             sweeper->noctant_per_block,
+                             sweeper->dims_b, sweeper->dims_g,
+                             Bool_true );
+  }
+
+  /*--------------------*/
+  /*---Transform angles to moments: (nm x na) * (na x nu*nbatch)---*/
+  /*--------------------*/
+
+  /*---NOTE: vi no longer needed, so vmbatch is reused for the result---*/
+
+  gemm_P( NM, NU*nbatch, na,
+          m_from_a + ind_m_from_a_flat( NM, na, 0, 0, octant ), NM,
+          vabatch, na,
+          vmbatch, NM );
+
+  /*--------------------*/
+  /*---Scatter result to vo---*/
+  /*--------------------*/
+
+  for( ibatch=0; ibatch<nbatch; ++ibatch )
+  {
+    P* const __restrict__ vo_cell = ref_state_flat( vo_this,
+                      sweeper->dims_b.ncell_x, sweeper->dims_b.ncell_y,
+                      sweeper->dims_b.ncell_z, sweeper->dims_b.ne, NM, NU,
+                      ix_batch[ibatch], iy_batch[ibatch], iz_batch[ibatch],
+                      ie_batch[ibatch], 0, 0 );
+    const PAccum* const __restrict__ vm_cell = vmbatch + nmu * ibatch;
+    int imu = 0;
+#ifdef USE_OPENMP_VO_ATOMIC
+    for( imu=0; imu<nmu; ++imu )
+    {
+#pragma omp atomic update
+      vo_cell[imu] += vm_cell[imu];
+    }
+#else
+    if( do_block_init_this )
+    {
+#pragma ivdep
+#pragma simd
+      for( imu=0; imu<nmu; ++imu )
+      {
+        vo_cell[imu] = vm_cell[imu];
+      }
+    }
+    else
+    {
+#pragma ivdep
+#pragma simd
+      for( imu=0; imu<nmu; ++imu )
+      {
+        vo_cell[imu] += vm_cell[imu];
+      }
+    }
+#endif
+  }
+}
+
+/*===========================================================================*/
+/*---Perform a sweep for a subblock, transforms batched by wavefront---*/
+
+TARGET_HD static inline void Sweeper_sweep_subblock_batched(
+  SweeperLite* __restrict__      sweeper,
+  P* const __restrict__          vo_this,
+  const P* const __restrict__    vi_this,
+  P* const __restrict__          facexy,
+  P* const __restrict__          facexz,
+  P* const __restrict__          faceyz,
+  const P* const __restrict__    a_from_m,
+  const P* const __restrict__    m_from_a,
+  const Quantities* __restrict__ quan,
+  const int                      octant,
+  const int                      iz_base,
+  const int                      octant_in_block,
+  const int                      iemin,
+  const int                      iemax,
+  const int                      ixbeg,
+  const int                      iybeg,
+  const int                      izbeg,
+  const int                      ncell_x_subblock,
+  const int                      ncell_y_subblock,
+  const int                      ncell_z_subblock,
+  const int                      ixmax_semiblock,
+  const int                      iymax_semiblock,
+  const int                      izmax_semiblock,
+  const int                      dir_inc_x,
+  const int                      dir_inc_y,
+  const int                      dir_inc_z,
+  const Bool_t                   do_block_init_this )
+{
+  PAccum* const __restrict__ vmbatch = Sweeper_vmbatch_this_( sweeper );
+  PAccum* const __restrict__ vabatch = Sweeper_vabatch_this_( sweeper );
+
+  int ie_batch[GEMM_BATCH_SIZE_MAX];
+  int ix_batch[GEMM_BATCH_SIZE_MAX];
+  int iy_batch[GEMM_BATCH_SIZE_MAX];
+  int iz_batch[GEMM_BATCH_SIZE_MAX];
+  int nbatch = 0;
+
+  const int nwave = ncell_x_subblock + ncell_y_subblock + ncell_z_subblock - 2;
+  int wave = 0;
+
+  /*--------------------*/
+  /*---Loop over cell wavefronts of subblock, in sweep order---*/
+  /*--------------------*/
+
+  for( wave=0; wave<nwave; ++wave )
+  {
+    int ie = 0;
+
+    /*---All energy groups of all cells on the wavefront are independent---*/
+
+    for( ie=iemin; ie<iemax; ++ie )
+    {
+      int iz_sub = 0;
+      for( iz_sub=0; iz_sub<ncell_z_subblock; ++iz_sub )
+      {
+      int iy_sub = 0;
+      for( iy_sub=0; iy_sub<ncell_y_subblock; ++iy_sub )
+      {
+        const int ix_sub = wave - iy_sub - iz_sub;
+
+        const int ix = ixbeg + dir_inc_x * ix_sub;
+        const int iy = iybeg + dir_inc_y * iy_sub;
+        const int iz = izbeg + dir_inc_z * iz_sub;
+
+        /*---Truncate to wavefront, block and semiblock---*/
+        const Bool_t is_elt_active = ix_sub >= 0 &&
+                                     ix_sub <  ncell_x_subblock &&
+                                     ix <  sweeper->dims_b.ncell_x &&
+                                     iy <  sweeper->dims_b.ncell_y &&
+                                     iz <  sweeper->dims_b.ncell_z &&
+                                     ix <= ixmax_semiblock &&
+                                     iy <= iymax_semiblock &&
+                                     iz <= izmax_semiblock;
+        if( is_elt_active )
+        {
+          ie_batch[nbatch] = ie;
+          ix_batch[nbatch] = ix;
+          iy_batch[nbatch] = iy;
+          iz_batch[nbatch] = iz;
+          ++nbatch;
+        }
+
+        /*---Flush when full, and always before moving to next wavefront---*/
+
+        if( nbatch == sweeper->gemm_batch_size ||
+            ( nbatch > 0 && ie == iemax-1 && iz_sub == ncell_z_subblock-1
+                                          && iy_sub == ncell_y_subblock-1 ) )
+        {
+          Sweeper_sweep_cells_batched( sweeper, vo_this, vi_this,
+                                       vmbatch, vabatch,
+                                       facexy, facexz, faceyz,
+                                       a_from_m, m_from_a, quan,
+                                       octant, iz_base, octant_in_block,
+                                       ie_batch, ix_batch, iy_batch, iz_batch,
+                                       nbatch, do_block_init_this );
+          nbatch = 0;
+        }
+      }
+      }
+    } /*---ie---*/
+  } /*---wave---*/
+}
+
+/*===========================================================================*/
+/*---Perform a sweep for a subblock, for a range of energy groups---*/
+
+TARGET_HD static inline void Sweeper_sweep_subblock_groups(
+  SweeperLite* __restrict__      sweeper,
+  P* const __restrict__          vo_this,
+  const P* const __restrict__    vi_this,
+  PAccum* const __restrict__     vilocal,
+  PAccum* const __restrict__     vslocal,
+  PAccum* const __restrict__     volocal,
+  P* const __restrict__          facexy,
+  P* const __restrict__          facexz,
+  P* const __restrict__          faceyz,
+  const P* const __restrict__    a_from_m,
+  const P* const __restrict__    m_from_a,
+  const Quantities* __restrict__ quan,
+  const int                      octant,
+  const int                      iz_base,
+  const int                      octant_in_block,
+  const int                      ixmin_subblock,
+  const int                      ixmax_subblock,
+  const int                      iymin_subblock,
+  const int                      iymax_subblock,
+  const int                      izmin_subblock,
+  const int                      izmax_subblock,
+  const Bool_t                   is_subblock_active,
+  const int                      ixmin_semiblock,
+  const int                      ixmax_semiblock,
+  const int                      iymin_semiblock,
+  const int                      iymax_semiblock,
+  const int                      izmin_semiblock,
+  const int                      izmax_semiblock,
+  const int                      dir_x,
+  const int                      dir_y,
+  const int                      dir_z,
+  const int                      dir_inc_x,
+  const int                      dir_inc_y,
+  const int                      dir_inc_z,
+  const Bool_t                   do_block_init_this,
+  const Bool_t                   is_octant_active,
+  const int                      iemin,
+  const int                      iemax )
+{
+  /*---Initializations---*/
+
+  int ie = 0;
+
+  const int ixbeg = dir_x==DIR_UP ? ixmin_subblock : ixmax_subblock;
+  const int iybeg = dir_y==DIR_UP ? iymin_subblock : iymax_subblock;
+  const int izbeg = dir_z==DIR_UP ? izmin_subblock : izmax_subblock;
+
+  const int ixend = dir_x==DIR_DN ? ixmin_subblock : ixmax_subblock;
+  const int iyend = dir_y==DIR_DN ? iymin_subblock : iymax_subblock;
+  const int izend = dir_z==DIR_DN ? izmin_subblock : izmax_subblock;
+
+  int ix = 0, iy = 0, iz = 0;
+
+  /*--------------------*/
+  /*---First perform any required boundary initializations---*/
+  /*--------------------*/
+
+  /*--------------------*/
+  /*---Loop over energy groups owned by this energy thread---*/
+  /*--------------------*/
+
+  for( ie=iemin; ie<iemax; ++ie )
+  {
+    /*--------------------*/
+    /*---Loop over cells in this subblock---*/
+    /*--------------------*/
+
+    for( iz=izbeg; iz!=izend+dir_inc_z; iz+=dir_inc_z )
+    {
+    for( iy=iybeg; iy!=iyend+dir_inc_y; iy+=dir_inc_y )
+    {
+    for( ix=ixbeg; ix!=ixend+dir_inc_x; ix+=dir_inc_x )
+    {
+      /*---Truncate loop region to block, semiblock and subblock---*/
+      const Bool_t is_elt_active = ix <  sweeper->dims_b.ncell_x &&
+                                   iy <  sweeper->dims_b.ncell_y &&
+                                   iz <  sweeper->dims_b.ncell_z &&
+                                   ix <= ixmax_semiblock &&
+                                   iy <= iymax_semiblock &&
+                                   iz <= izmax_semiblock &&
+                                   is_subblock_active &&
+                                   is_octant_active;
+                                /* ix >= 0 &&
+                                   iy >= 0 &&
+                                   iz >= 0 &&
+                                   ix >= ixmin_semiblock &&
+                                   iy >= iymin_semiblock &&
+                                   iz >= izmin_semiblock &&
+                                   ix >= ixmin_subblock &&
+                                   iy >= iymin_subblock &&
+                                   iz >= izmin_subblock &&
+                                   ix <= ixmax_subblock &&
+                                   iy <= iymax_subblock &&
+                                   iz <= izmax_subblock && (guaranteed) */
+
+      if( is_elt_active )
+      {
+        /*--------------------*/
+        /*---Set boundary condition if needed: xy---*/
+        /*--------------------*/
+
+        const int iz_g = iz + iz_base;
+        if( ( iz_g == 0                         && dir_z == DIR_UP ) ||
+            ( iz_g == sweeper->dims_g.ncell_z-1 && dir_z == DIR_DN ) )
+        {
+          const int ix_g = ix + quan->ix_base;
+          const int iy_g = iy + quan->iy_base;
+          /*---TODO: thread/vectorize in u, a---*/
+          int iu = 0;
+          for( iu=0; iu<NU; ++iu )
+          {
+            int ia = 0;
+          for( ia=0; ia<sweeper->dims_b.na; ++ia )
+          {
+            *ref_facexy( facexy, sweeper->dims_b, NU,  
+                         sweeper->noctant_per_block,
+                         ix, iy, ie, ia, iu, octant_in_block )     
+               = Quantities_init_facexy( quan, ix_g, iy_g, iz_g-dir_inc_z,
+                                         ie, ia, iu, octant, sweeper->dims_g );
+          }
+          }
+        }
+
+        /*--------------------*/
+        /*---Set boundary condition if needed: xz---*/
+        /*--------------------*/
+
+        const int iy_g = iy + quan->iy_base;
+        if( ( iy_g == 0                         && dir_y == DIR_UP ) ||
+            ( iy_g == sweeper->dims_g.ncell_y-1 && dir_y == DIR_DN ) )
+        {
+          const int ix_g = ix + quan->ix_base;
+          const int iz_g = iz +       iz_base;
+          /*---TODO: thread/vectorize in u, a---*/
+          int iu = 0;
+          for( iu=0; iu<NU; ++iu )
+          {
+            int ia = 0;
+          for( ia=0; ia<sweeper->dims_b.na; ++ia )
+          {
+            *ref_facexz( facexz, sweeper->dims_b, NU,  
+                         sweeper->noctant_per_block,
+                         ix, iz, ie, ia, iu, octant_in_block )     
+               = Quantities_init_facexz( quan, ix_g, iy_g-dir_inc_y, iz_g,
+                                         ie, ia, iu, octant, sweeper->dims_g );
+          }
+          }
+        }
+
+        /*--------------------*/
+        /*---Set boundary condition if needed: yz---*/
+        /*--------------------*/
+
+        const int ix_g = ix + quan->ix_base;
+        if( ( ix_g == 0                         && dir_x == DIR_UP ) ||
+            ( ix_g == sweeper->dims_g.ncell_x-1 && dir_x == DIR_DN ) )
+        {
+          const int iy_g = iy + quan->iy_base;
+          const int iz_g = iz +       iz_base;
+          /*---TODO: thread/vectorize in u, a---*/
+          int iu = 0;
+          for( iu=0; iu<NU; ++iu )
+          {
+            int ia = 0;
+          for( ia=0; ia<sweeper->dims_b.na; ++ia )
+          {
+            *ref_faceyz( faceyz, sweeper->dims_b, NU,  
+                         sweeper->noctant_per_block,
+                         iy, iz, ie, ia, iu, octant_in_block )     
+               = Quantities_init_faceyz( quan, ix_g-dir_inc_x, iy_g, iz_g,
+                                         ie, ia, iu, octant, sweeper->dims_g );
+          }
+          }
+        }
+
+      } /*---is_elt_active---*/
+
+    }
+    }
+    } /*---ix/iy/iz---*/
+
+  } /*---ie---*/
+
+  /*--------------------*/
+  /*---Now perform actual sweep--*/
+  /*--------------------*/
+
+  if( sweeper->gemm_batch_size > 0 )
+  {
+    /*--------------------*/
+    /*---Transforms batched over cell wavefronts and energy groups---*/
+    /*--------------------*/
+
+    /*---NOTE: host only, so no thread syncs needed for inactive case---*/
+
+    if( is_subblock_active && is_octant_active )
+    {
+      Sweeper_sweep_subblock_batched( sweeper, vo_this, vi_this,
+                                      facexy, facexz, faceyz,
+                                      a_from_m, m_from_a, quan,
+                                      octant, iz_base, octant_in_block,
+                                      iemin, iemax, ixbeg, iybeg, izbeg,
+                                      ixmax_subblock - ixmin_subblock + 1,
+                                      iymax_subblock - iymin_subblock + 1,
+                                      izmax_subblock - izmin_subblock + 1,
+                                      ixmax_semiblock, iymax_semiblock,
+                                      izmax_semiblock,
+                                      dir_inc_x, dir_inc_y, dir_inc_z,
+                                      do_block_init_this );
+    }
+  }
+  else
+  {
+    /*--------------------*/
+    /*---Sweep subblock by tiles of energy groups and of cells---*/
+    /*--------------------*/
+
+    /*---Within a tile, each cell is swept for all the tile's groups before
+         moving on, so the octant's a_from_m/m_from_a slice is reused from
+         cache across the groups.  The tiles of cells are visited in sweep
+         order and cover all of z, which keeps the upwind dependencies;
+         groups are independent of each other---*/
+
+    PAccum* const __restrict__ velanes = sweeper->is_using_energy_lanes ?
+                                         Sweeper_velanes_this_( sweeper ) :
+                                         (PAccum*)NULL;
+    PAccum* const __restrict__ vxform  =
+                            sweeper->xform_variant != XFORM_VARIANT_CELL ?
+                                         Sweeper_vxform_this_( sweeper ) :
+                                         (PAccum*)NULL;
+
+    const int ncell_x_subblock = ixmax_subblock - ixmin_subblock + 1;
+    const int ncell_y_subblock = iymax_subblock - iymin_subblock + 1;
+    const int ncell_z_subblock = izmax_subblock - izmin_subblock + 1;
+
+    int ie_tile = 0;
+    int ix_tile = 0, iy_tile = 0;
+    int ix_off = 0, iy_off = 0, iz_off = 0;
+
+    for( ie_tile=iemin; ie_tile<iemax; ie_tile+=sweeper->ne_per_tile )
+    {
+      const int ie_tile_end = imin( ie_tile + sweeper->ne_per_tile, iemax );
+
+      for( iy_tile=0; iy_tile<ncell_y_subblock;
+                      iy_tile+=sweeper->ncell_y_per_tile )
+      {
+      for( ix_tile=0; ix_tile<ncell_x_subblock;
+                      ix_tile+=sweeper->ncell_x_per_tile )
+      {
+        const int iy_tile_end = imin( iy_tile + sweeper->ncell_y_per_tile,
+                                      ncell_y_subblock );
+        const int ix_tile_end = imin( ix_tile + sweeper->ncell_x_per_tile,
+                                      ncell_x_subblock );
+
+        /*--------------------*/
+        /*---Loop over cells in this tile, in proper direction---*/
+        /*--------------------*/
+
+        for( iz_off=0; iz_off<ncell_z_subblock; ++iz_off )
+        {
+        for( iy_off=iy_tile; iy_off<iy_tile_end; ++iy_off )
+        {
+        for( ix_off=ix_tile; ix_off<ix_tile_end; ++ix_off )
+        {
+          iz = izbeg + dir_inc_z * iz_off;
+          iy = iybeg + dir_inc_y * iy_off;
+          ix = ixbeg + dir_inc_x * ix_off;
+
+          /*---Truncate loop region to block, semiblock and subblock---*/
+          const Bool_t is_elt_active = ix <  sweeper->dims_b.ncell_x &&
+                                       iy <  sweeper->dims_b.ncell_y &&
+                                       iz <  sweeper->dims_b.ncell_z &&
+                                       ix <= ixmax_semiblock &&
+                                       iy <= iymax_semiblock &&
+                                       iz <= izmax_semiblock &&
+                                       is_subblock_active &&
+                                       is_octant_active;
+                                    /* ix >= 0 &&
+                                       iy >= 0 &&
+                                       iz >= 0 &&
+                                       ix >= ixmin_semiblock &&
+                                       iy >= iymin_semiblock &&
+                                       iz >= izmin_semiblock &&
+                                       ix >= ixmin_subblock &&
+                                       iy >= iymin_subblock &&
+                                       iz >= izmin_subblock &&
+                                       ix <= ixmax_subblock &&
+                                       iy <= iymax_subblock &&
+                                       iz <= izmax_subblock && (guaranteed) */
+
+          if( sweeper->is_using_energy_lanes )
+          {
+            /*---Energy groups in SIMD lanes: loop over chunks of groups---*/
+
+            /*---NOTE: host only, so no thread syncs for inactive case---*/
+
+            int ie_base = 0;
+            for( ie_base=ie_tile; ie_base<ie_tile_end; ie_base+=SIMD_LEN )
+            {
+              const int nlane = imin( SIMD_LEN, ie_tile_end - ie_base );
+              if( is_elt_active )
+              {
+                Sweeper_sweep_cell_elanes( sweeper, vo_this, vi_this,
+                                           velanes,
+                                           facexy, facexz, faceyz,
+                                           a_from_m, m_from_a, quan,
+                                           octant, iz_base, octant_in_block,
+                                           ie_base, nlane, ix, iy, iz,
+                                           do_block_init_this );
+              }
+            }
+          }
+          else if( sweeper->xform_variant != XFORM_VARIANT_CELL )
+          {
+            /*---Cells with the selected transform variant---*/
+
+            /*---NOTE: host only, so no thread syncs for inactive case---*/
+
+            for( ie=ie_tile; ie<ie_tile_end; ++ie )
+            {
+              if( is_elt_active )
+              {
+                Sweeper_sweep_cell_xform( sweeper, vo_this, vi_this, vxform,
+                                          facexy, facexz, faceyz,
+                                          a_from_m, m_from_a, quan,
+                                          octant, iz_base, octant_in_block,
+                                          ie, ix, iy, iz, do_block_init_this );
+              }
+            }
+          }
+          else
+          {
+            for( ie=ie_tile; ie<ie_tile_end; ++ie )
+            {
+              /*--------------------*/
+              /*---Perform sweep on cell---*/
+              /*--------------------*/
+              Sweeper_sweep_cell( sweeper, vo_this, vi_this,
+                                  vilocal, vslocal, volocal,
+                                  facexy, facexz, faceyz,
+                                  a_from_m, m_from_a, quan,
+                                  octant, iz_base, octant_in_block,
+                                  ie, ix, iy, iz,
+                                  do_block_init_this,
+                                  is_elt_active );
+            }
+          }
+        }
+        }
+        } /*---ix/iy/iz---*/
+      }
+      } /*---ix_tile/iy_tile---*/
+    } /*---ie_tile---*/
+  }
+}
+
+/*===========================================================================*/
+/*---Perform a sweep for a subblock---*/
+
+TARGET_HD static inline void Sweeper_sweep_subblock(
+  SweeperLite* __restrict__      sweeper,
+  P* const __restrict__          vo_this,
+  const P* const __restrict__    vi_this,
+  PAccum* const __restrict__     vilocal,
+  PAccum* const __restrict__     vslocal,
+  PAccum* const __restrict__     volocal,
+  P* const __restrict__          facexy,
+  P* const __restrict__          facexz,
+  P* const __restrict__          faceyz,
+  const P* const __restrict__    a_from_m,
+  const P* const __restrict__    m_from_a,
+  const Quantities* __restrict__ quan,
+  const int                      octant,
+  const int                      iz_base,
+  const int                      octant_in_block,
+  const int                      ixmin_subblock,
+  const int                      ixmax_subblock,
+  const int                      iymin_subblock,
+  const int                      iymax_subblock,
+  const int                      izmin_subblock,
+  const int                      izmax_subblock,
+  const Bool_t                   is_subblock_active,
+  const int                      ixmin_semiblock,
+  const int                      ixmax_semiblock,
+  const int                      iymin_semiblock,
+  const int                      iymax_semiblock,
+  const int                      izmin_semiblock,
+  const int                      izmax_semiblock,
+  const int                      dir_x,
+  const int                      dir_y,
+  const int                      dir_z,
+  const int                      dir_inc_x,
+  const int                      dir_inc_y,
+  const int                      dir_inc_z,
+  const Bool_t                   do_block_init_this,
+  const Bool_t                   is_octant_active )
+{
+#if defined( USE_OPENMP_THREADS ) && ! defined( __CUDA_ARCH__ )
+  if( sweeper->ne_per_chunk > 0 )
+  {
+    /*---Dynamic scheduling: the energy threads of this octant, yz thread
+         take chunks of groups in turn from a shared counter, whose values
+         for this subblockwave follow those of the previous one---*/
 
-      } /*---is_elt_active---*/
+    const int ne = sweeper->dims.ne;
+    const int nchunk = iceil( ne, sweeper->ne_per_chunk );
+    const int nwave_done = ThreadTeam_flag( sweeper->threadteam,
+                                            sweeper->thread_in_team );
+    const int counter = sweeper->thread_in_team / sweeper->nthread_e;
 
-    }
-    }
-    } /*---ix/iy/iz---*/
+    int chunk = 0;
 
-  } /*---ie---*/
+    /*---NOTE: host only, so no thread syncs needed for inactive case---*/
 
-  /*--------------------*/
-  /*---Now perform actual sweep--*/
-  /*--------------------*/
+    while( is_subblock_active && is_octant_active &&
+           ( chunk = ThreadTeam_counter_take( sweeper->threadteam, counter,
+                                              nchunk * ( nwave_done     ),
+                                              nchunk * ( nwave_done + 1 ) )
+           ) >= 0 )
+    {
+      const int iemin = sweeper->ne_per_chunk * ( chunk - nchunk *
+                                                          nwave_done );
+      const int iemax = imin( iemin + sweeper->ne_per_chunk, ne );
+
+      Sweeper_sweep_subblock_groups( sweeper, vo_this, vi_this,
+                                     vilocal, vslocal, volocal,
+                                     facexy, facexz, faceyz,
+                                     a_from_m, m_from_a, quan,
+                                     octant, iz_base, octant_in_block,
+                                     ixmin_subblock, ixmax_subblock,
+                                     iymin_subblock, iymax_subblock,
+                                     izmin_subblock, izmax_subblock,
+                                     is_subblock_active,
+                                     ixmin_semiblock, ixmax_semiblock,
+                                     iymin_semiblock, iymax_semiblock,
+                                     izmin_semiblock, izmax_semiblock,
+                                     dir_x, dir_y, dir_z,
+                                     dir_inc_x, dir_inc_y, dir_inc_z,
+                                     do_block_init_this,
+                                     is_octant_active,
+                                     iemin, iemax );
+    }
+    return;
+  }
+#endif
 
-  /*--------------------*/
-  /*---Loop over energy groups owned by this energy thread---*/
-  /*--------------------*/
+  /*---Static scheduling: a fixed share of the groups per energy thread---*/
 
-  for( ie=iemin; ie<iemax; ++ie )
   {
-    /*--------------------*/
-    /*---Sweep subblock: loop over cells, in proper direction---*/
-    /*--------------------*/
-
-    for( iz=izbeg; iz!=izend+dir_inc_z; iz+=dir_inc_z )
-    {
-    for( iy=iybeg; iy!=iyend+dir_inc_y; iy+=dir_inc_y )
-    {
-    for( ix=ixbeg; ix!=ixend+dir_inc_x; ix+=dir_inc_x )
-    {
-      /*---Truncate loop region to block, semiblock and subblock---*/
-      const Bool_t is_elt_active = ix <  sweeper->dims_b.ncell_x &&
-                                   iy <  sweeper->dims_b.ncell_y &&
-                                   iz <  sweeper->dims_b.ncell_z &&
-                                   ix <= ixmax_semiblock &&
-                                   iy <= iymax_semiblock &&
-                                   iz <= izmax_semiblock &&
-                                   is_subblock_active &&
-                                   is_octant_active;
-                                /* ix >= 0 &&
-                                   iy >= 0 &&
-                                   iz >= 0 &&
-                                   ix >= ixmin_semiblock &&
-                                   iy >= iymin_semiblock &&
-                                   iz >= izmin_semiblock &&
-                                   ix >= ixmin_subblock &&
-                                   iy >= iymin_subblock &&
-                                   iz >= izmin_subblock &&
-                                   ix <= ixmax_subblock &&
-                                   iy <= iymax_subblock &&
-                                   iz <= izmax_subblock && (guaranteed) */
-
-      /*--------------------*/
-      /*---Perform sweep on cell---*/
-      /*--------------------*/
-      Sweeper_sweep_cell( sweeper, vo_this, vi_this, vilocal, vslocal, volocal,
-                          facexy, facexz, faceyz, a_from_m, m_from_a, quan,
-                          octant, iz_base, octant_in_block, ie, ix, iy, iz,
-                          do_block_init_this,
-                          is_elt_active );
-    }
-    }
-    } /*---ix/iy/iz---*/
-  } /*---ie---*/
+    const int iemin = (   sweeper->dims.ne *
+                        ( Sweeper_thread_e( sweeper )     ) )
+                    /     sweeper->nthread_e;
+    const int iemax = (   sweeper->dims.ne *
+                        ( Sweeper_thread_e( sweeper ) + 1 ) )
+                    /     sweeper->nthread_e;
+
+    Sweeper_sweep_subblock_groups( sweeper, vo_this, vi_this,
+                                   vilocal, vslocal, volocal,
+                                   facexy, facexz, faceyz,
+                                   a_from_m, m_from_a, quan,
+                                   octant, iz_base, octant_in_block,
+                                   ixmin_subblock, ixmax_subblock,
+                                   iymin_subblock, iymax_subblock,
+                                   izmin_subblock, izmax_subblock,
+                                   is_subblock_active,
+                                   ixmin_semiblock, ixmax_semiblock,
+                                   iymin_semiblock, iymax_semiblock,
+                                   izmin_semiblock, izmax_semiblock,
+                                   dir_x, dir_y, dir_z,
+                                   dir_inc_x, dir_inc_y, dir_inc_z,
+                                   do_block_init_this,
+                                   is_octant_active,
+                                   iemin, iemax );
+  }
 }
 
 /*===========================================================================*/
@@ -829,11 +2065,13 @@ TARGET_HD static inline void Sweeper_sweep_semiblock(
   /*---Calculate needed quantities---*/
 
   const int octant  = stepinfo.octant;
-  const int iz_base = stepinfo.block_z * sweeper->dims_b.ncell_z;
+  /*---Global z index of the first cell of the block---*/
+  const int iz_base = quan->iz_base +
+                      stepinfo.block_z * sweeper->dims_b.ncell_z;
 
-  P* __restrict__ vilocal = Sweeper_vilocal_this_( sweeper );
-  P* __restrict__ vslocal = Sweeper_vslocal_this_( sweeper );
-  P* __restrict__ volocal = Sweeper_volocal_this_( sweeper );
+  PAccum* __restrict__ vilocal = Sweeper_vilocal_this_( sweeper );
+  PAccum* __restrict__ vslocal = Sweeper_vslocal_this_( sweeper );
+  PAccum* __restrict__ volocal = Sweeper_volocal_this_( sweeper );
 
   const int dir_x = Dir_x( octant );
   const int dir_y = Dir_y( octant );
@@ -908,6 +2146,8 @@ TARGET_HD static inline void Sweeper_sweep_semiblock(
                             dir_inc_x, dir_inc_y, dir_inc_z,
                             do_block_init_this,
                             is_octant_active );
+
+    Sweeper_progress_poll( sweeper );
   }
   else /*---if tasking---*/
   {
@@ -946,6 +2186,8 @@ TARGET_HD static inline void Sweeper_sweep_semiblock(
 
     int subblockwave = 0;
 
+    Sweeper_wait_yz_threads_semiblock( sweeper );
+
     /*--------------------*/
     /*---Loop over subblock wavefronts---*/
     /*--------------------*/
@@ -993,6 +2235,21 @@ TARGET_HD static inline void Sweeper_sweep_semiblock(
           subblock_y         >= 0 && subblock_y         < nsubblock_y &&
           subblock_x         >= 0 && subblock_x         < nsubblock_x;
 
+      /*---Threads that sweep the upstream subblocks in y and z, if any---*/
+
+      const int subblock_y_up = subblock_y - dir_inc_y;
+      const int subblock_z_up = subblock_z - dir_inc_z;
+
+      const int thread_y_up =
+          subblock_y_up < 0 || subblock_y_up >= nsubblock_y ? -1 :
+          dir_y==DIR_UP ? subblock_y_up % nsubblock_y_per_chunk :
+          nsubblock_y_per_chunk - 1 - subblock_y_up % nsubblock_y_per_chunk;
+
+      const int thread_z_up =
+          subblock_z_up < 0 || subblock_z_up >= nsubblock_z ? -1 :
+          dir_z==DIR_UP ? subblock_z_up % nsubblock_z_per_chunk :
+          nsubblock_z_per_chunk - 1 - subblock_z_up % nsubblock_z_per_chunk;
+
       /*---Compute subblock bounds, inclusive of endpoints---*/
 
       const int ixmin_subblock = ixmin_semiblock +
@@ -1011,6 +2268,13 @@ TARGET_HD static inline void Sweeper_sweep_semiblock(
       /*--------------------*/
       /*---Perform sweep on subblock---*/
       /*--------------------*/
+
+      if( is_subblock_active )
+      {
+        Sweeper_wait_yz_threads_subblock( sweeper, thread_y_up,
+                                                   thread_z_up );
+      }
+
       Sweeper_sweep_subblock( sweeper, vo_this, vi_this,
                               vilocal, vslocal, volocal,
                               facexy, facexz, faceyz, a_from_m, m_from_a, quan,
@@ -1027,6 +2291,10 @@ TARGET_HD static inline void Sweeper_sweep_semiblock(
                               do_block_init_this,
                               is_octant_active );
 
+      Sweeper_signal_yz_threads_subblock( sweeper );
+
+      Sweeper_progress_poll( sweeper );
+
       if( subblockwave != nsubblockwave-1 )
       {
         Sweeper_sync_yz_threads( sweeper );
@@ -1087,6 +2355,346 @@ TARGET_HD static inline void Sweeper_get_semiblock_bounds(
               ?  ( *imax + 1 ) : *imax;
 }                  
 
+/*===========================================================================*/
+/*---Sweep the octants of this octant thread for a semiblock step---*/
+
+TARGET_HD static inline void Sweeper_sweep_semiblock_step(
+  SweeperLite* __restrict__       sweeper,
+        P* __restrict__           vo,
+  const P* __restrict__           vi,
+        P* __restrict__           facexy,
+        P* __restrict__           facexz,
+        P* __restrict__           faceyz,
+  const P* __restrict__           a_from_m,
+  const P* __restrict__           m_from_a,
+  const Quantities* __restrict__  quan,
+  const StepInfoAll* __restrict__ stepinfoall,
+  int                             semiblock_step,
+  unsigned long int               do_block_init )
+{
+  const int noctant_per_block = sweeper->noctant_per_block;
+
+  const int nsemiblock = sweeper->nsemiblock;
+
+  /*--------------------*/
+  /*---Loop over octants in octant block---*/
+  /*---That is, octants that are computed for this semiblock step---*/
+  /*--------------------*/
+
+  const int octant_in_block_min =
+                       (   sweeper->noctant_per_block *
+                         ( Sweeper_thread_octant( sweeper )     ) )
+                     /     sweeper->nthread_octant;
+  const int octant_in_block_max =
+                       (   sweeper->noctant_per_block *
+                         ( Sweeper_thread_octant( sweeper ) + 1 ) )
+                     /     sweeper->nthread_octant;
+
+  int octant_in_block = 0;
+
+  for( octant_in_block=octant_in_block_min;
+       octant_in_block<octant_in_block_max; ++octant_in_block )
+  {
+    /*---Get step info---*/
+
+    const StepInfo stepinfo = stepinfoall->stepinfo[octant_in_block];
+
+    const Bool_t is_octant_active = stepinfo.is_active;
+
+    const int dir_x = Dir_x( stepinfo.octant );
+    const int dir_y = Dir_y( stepinfo.octant );
+    const int dir_z = Dir_z( stepinfo.octant );
+
+    /*--------------------*/
+    /*---Compute semiblock bounds---*/
+    /*--------------------*/
+
+    Bool_t is_semiblock_min_x = 0, is_semiblock_max_x = 0;
+    int ixmin_semiblock = 0, ixmax_semiblock = 0, ixmax_semiblock_up2 = 0;
+
+    Sweeper_get_semiblock_bounds(&is_semiblock_min_x, &is_semiblock_max_x,
+      &ixmin_semiblock, &ixmax_semiblock, &ixmax_semiblock_up2,
+      sweeper->dims_b.ncell_x, DIM_X, dir_x, semiblock_step, nsemiblock);
+
+    /*--------------------*/
+
+    Bool_t is_semiblock_min_y = 0, is_semiblock_max_y = 0;
+    int iymin_semiblock = 0, iymax_semiblock = 0, iymax_semiblock_up2 = 0;
+
+    Sweeper_get_semiblock_bounds(&is_semiblock_min_y, &is_semiblock_max_y,
+      &iymin_semiblock, &iymax_semiblock, &iymax_semiblock_up2,
+      sweeper->dims_b.ncell_y, DIM_Y, dir_y, semiblock_step, nsemiblock);
+
+    /*--------------------*/
+
+    Bool_t is_semiblock_min_z = 0, is_semiblock_max_z = 0;
+    int izmin_semiblock = 0, izmax_semiblock = 0, izmax_semiblock_up2 = 0;
+
+    Sweeper_get_semiblock_bounds(&is_semiblock_min_z, &is_semiblock_max_z,
+      &izmin_semiblock, &izmax_semiblock, &izmax_semiblock_up2,
+      sweeper->dims_b.ncell_z, DIM_Z, dir_z, semiblock_step, nsemiblock);
+
+    /*--------------------*/
+    /*---Perform sweep over subblocks in semiblock---*/
+    /*---(for tasking case, this task sweeps one subblock in semiblock---*/
+    /*--------------------*/
+
+    const int iz_base = stepinfo.block_z * sweeper->dims_b.ncell_z;
+
+    const P* vi_this = const_ref_state( vi, sweeper->dims, NU, 0, 0,
+                                                        iz_base, 0, 0, 0 );
+    /*---With private vo, sweep into this octant in block's copy---*/
+
+    const size_t size_state_b = ( (size_t) sweeper->dims_b.ncell_x ) *
+                                sweeper->dims_b.ncell_y *
+                                sweeper->dims_b.ncell_z *
+                                sweeper->dims_b.ne * NM * NU;
+
+    P* vo_this = sweeper->vo_private_host_ ?
+                 sweeper->vo_private_host_ + size_state_b * octant_in_block :
+                             ref_state( vo, sweeper->dims, NU, 0, 0,
+                                                        iz_base, 0, 0, 0 );
+
+    const int do_block_init_this = !! ( do_block_init &
+                     ( ((unsigned long int)1) <<
+                       ( octant_in_block + noctant_per_block *
+                         semiblock_step ) ) );
+
+    Sweeper_sweep_semiblock( sweeper, vo_this, vi_this,
+                             facexy, facexz, faceyz,
+                             a_from_m, m_from_a,
+                             quan, stepinfo, octant_in_block,
+                             ixmin_semiblock, ixmax_semiblock_up2,
+                             iymin_semiblock, iymax_semiblock_up2,
+                             izmin_semiblock, izmax_semiblock_up2,
+                             do_block_init_this,
+                             is_octant_active );
+
+  } /*---octant_in_block---*/
+}
+
+/*===========================================================================*/
+
+#ifdef USE_OPENMP_TASKS
+
+/*===========================================================================*/
+/*---Subblock tasks: arguments common to the tasks of a block step---*/
+
+typedef struct
+{
+  SweeperLite            sweeper;
+        P*               vo;
+  const P*               vi;
+        P*               facexy;
+        P*               facexz;
+        P*               faceyz;
+  const P*               a_from_m;
+  const P*               m_from_a;
+  const Quantities*      quan;
+  const StepInfoAll*     stepinfoall;
+  unsigned long int      do_block_init;
+} SweeperTaskArgs;
+
+/*---------------------------------------------------------------------------*/
+/*---Decompose a task number.  Tasks are numbered in program order:
+     thread_x fastest, then thread_y, thread_z, thread_e, thread_octant,
+     and the semiblock step slowest---*/
+
+static int Sweeper_task_decompose_( SweeperLite* sweeper, int task )
+{
+  int rest = task;
+
+  sweeper->thread_x      = rest % sweeper->nthread_x;
+  rest                   = rest / sweeper->nthread_x;
+  sweeper->thread_y      = rest % sweeper->nthread_y;
+  rest                   = rest / sweeper->nthread_y;
+  sweeper->thread_z      = rest % sweeper->nthread_z;
+  rest                   = rest / sweeper->nthread_z;
+  sweeper->thread_e      = rest % sweeper->nthread_e;
+  rest                   = rest / sweeper->nthread_e;
+  sweeper->thread_octant = rest % sweeper->nthread_octant;
+  rest                   = rest / sweeper->nthread_octant;
+
+  /*---Semiblock step---*/
+  return rest;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---Task body: sweep one subblock for one semiblock step---*/
+
+static void Sweeper_sweep_task_( void* context, int task )
+{
+  const SweeperTaskArgs* const args = (const SweeperTaskArgs*)context;
+
+  SweeperLite sweeper = args->sweeper;
+
+  const int semiblock_step = Sweeper_task_decompose_( &sweeper, task );
+
+  Sweeper_sweep_semiblock_step( &sweeper, args->vo, args->vi,
+                                args->facexy, args->facexz, args->faceyz,
+                                args->a_from_m, args->m_from_a,
+                                args->quan, args->stepinfoall,
+                                semiblock_step, args->do_block_init );
+}
+
+/*---------------------------------------------------------------------------*/
+/*---Granule holding a cell along an axis.  The granules are the subblocks
+     of the lower and the upper semiblock, so that every subblock of every
+     octant and semiblock step is exactly one granule---*/
+
+static int Sweeper_granule_( int i, int ncell, int ncell_per_subblock,
+                             Bool_t is_semiblocked )
+{
+  const int ncell_lo = is_semiblocked ? ( ncell + 1 ) / 2 : ncell;
+
+  return i < ncell_lo ? i / ncell_per_subblock :
+         iceil( ncell_lo, ncell_per_subblock ) +
+         ( i - ncell_lo ) / ncell_per_subblock;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---Build the graph of subblock tasks for a block step.  Each task
+     declares the granule of state it updates, the granules of face
+     values of each of its octants, and its scratch storage, so a task
+     waits only on the earlier tasks it actually shares data with---*/
+
+static void Sweeper_build_taskgraph_( SweeperLite*       sweeper,
+                                      const StepInfoAll* stepinfoall )
+{
+  TaskGraph* const taskgraph = sweeper->taskgraph;
+
+  const int nsemiblock = sweeper->nsemiblock;
+  const int noctant_per_block = sweeper->noctant_per_block;
+
+  const Bool_t is_semiblocked_x = is_axis_semiblocked( nsemiblock, DIM_X );
+  const Bool_t is_semiblocked_y = is_axis_semiblocked( nsemiblock, DIM_Y );
+  const Bool_t is_semiblocked_z = is_axis_semiblocked( nsemiblock, DIM_Z );
+
+  const int ngranule_x = 1 + Sweeper_granule_( sweeper->dims_b.ncell_x - 1,
+    sweeper->dims_b.ncell_x, sweeper->ncell_x_per_subblock, is_semiblocked_x );
+  const int ngranule_y = 1 + Sweeper_granule_( sweeper->dims_b.ncell_y - 1,
+    sweeper->dims_b.ncell_y, sweeper->ncell_y_per_subblock, is_semiblocked_y );
+  const int ngranule_z = 1 + Sweeper_granule_( sweeper->dims_b.ncell_z - 1,
+    sweeper->dims_b.ncell_z, sweeper->ncell_z_per_subblock, is_semiblocked_z );
+
+  const int ntask_per_step = sweeper->nthread_x * sweeper->nthread_y *
+                             sweeper->nthread_z * sweeper->nthread_e *
+                             sweeper->nthread_octant;
+  const int ntask = nsemiblock * ntask_per_step;
+
+  /*---Keys: state granules, per energy thread; face granules, per energy
+       thread and octant; then scratch storage, per task of a step---*/
+
+  const int nface = sweeper->nthread_e * noctant_per_block;
+
+  const int key_base_xy = sweeper->nthread_e * ngranule_x * ngranule_y *
+                                               ngranule_z;
+  const int key_base_xz = key_base_xy + nface * ngranule_x * ngranule_y;
+  const int key_base_yz = key_base_xz + nface * ngranule_x * ngranule_z;
+  const int key_base_scratch = key_base_yz + nface * ngranule_y * ngranule_z;
+  const int nkey = key_base_scratch + ntask_per_step;
+
+  int task = 0;
+
+  TaskGraph_begin( taskgraph, ntask, nkey );
+
+  for( task=0; task<ntask; ++task )
+  {
+    SweeperLite sweeper_task = *sweeper;
+
+    const int semiblock_step = Sweeper_task_decompose_( &sweeper_task, task );
+
+    const int octant_in_block_min =
+                         (   noctant_per_block *
+                           ( sweeper_task.thread_octant     ) )
+                       /     sweeper_task.nthread_octant;
+    const int octant_in_block_max =
+                         (   noctant_per_block *
+                           ( sweeper_task.thread_octant + 1 ) )
+                       /     sweeper_task.nthread_octant;
+
+    int octant_in_block = 0;
+
+    /*---Scratch storage is indexed by thread_x etc., so shared with the
+         corresponding tasks of other semiblock steps---*/
+
+    TaskGraph_touch( taskgraph, task,
+                     key_base_scratch + task % ntask_per_step );
+
+    for( octant_in_block=octant_in_block_min;
+         octant_in_block<octant_in_block_max; ++octant_in_block )
+    {
+      const StepInfo stepinfo = stepinfoall->stepinfo[octant_in_block];
+
+      const int dir_x = Dir_x( stepinfo.octant );
+      const int dir_y = Dir_y( stepinfo.octant );
+      const int dir_z = Dir_z( stepinfo.octant );
+
+      Bool_t has_lo = 0, has_hi = 0;
+      int ixmin = 0, ixmax = 0, ixmax_up2 = 0;
+      int iymin = 0, iymax = 0, iymax_up2 = 0;
+      int izmin = 0, izmax = 0, izmax_up2 = 0;
+
+      Sweeper_get_semiblock_bounds( &has_lo, &has_hi,
+        &ixmin, &ixmax, &ixmax_up2,
+        sweeper->dims_b.ncell_x, DIM_X, dir_x, semiblock_step, nsemiblock );
+      Sweeper_get_semiblock_bounds( &has_lo, &has_hi,
+        &iymin, &iymax, &iymax_up2,
+        sweeper->dims_b.ncell_y, DIM_Y, dir_y, semiblock_step, nsemiblock );
+      Sweeper_get_semiblock_bounds( &has_lo, &has_hi,
+        &izmin, &izmax, &izmax_up2,
+        sweeper->dims_b.ncell_z, DIM_Z, dir_z, semiblock_step, nsemiblock );
+
+      /*---Subblock swept by this task, as in Sweeper_sweep_semiblock---*/
+
+      const int nsubblock_x = iceil( ixmax_up2 - ixmin + 1,
+                                     sweeper->ncell_x_per_subblock );
+      const int nsubblock_y = iceil( iymax_up2 - iymin + 1,
+                                     sweeper->ncell_y_per_subblock );
+      const int nsubblock_z = iceil( izmax_up2 - izmin + 1,
+                                     sweeper->ncell_z_per_subblock );
+
+      const int subblock_x = dir_x == DIR_UP ? sweeper_task.thread_x :
+                             nsubblock_x - 1 - sweeper_task.thread_x;
+      const int subblock_y = dir_y == DIR_UP ? sweeper_task.thread_y :
+                             nsubblock_y - 1 - sweeper_task.thread_y;
+      const int subblock_z = dir_z == DIR_UP ? sweeper_task.thread_z :
+                             nsubblock_z - 1 - sweeper_task.thread_z;
+
+      const int ix = ixmin + sweeper->ncell_x_per_subblock * subblock_x;
+      const int iy = iymin + sweeper->ncell_y_per_subblock * subblock_y;
+      const int iz = izmin + sweeper->ncell_z_per_subblock * subblock_z;
+
+      /*---Inactive octants and empty subblocks touch nothing---*/
+
+      if( stepinfo.is_active && ix <= ixmax && iy <= iymax && iz <= izmax )
+      {
+        const int gx = Sweeper_granule_( ix, sweeper->dims_b.ncell_x,
+                           sweeper->ncell_x_per_subblock, is_semiblocked_x );
+        const int gy = Sweeper_granule_( iy, sweeper->dims_b.ncell_y,
+                           sweeper->ncell_y_per_subblock, is_semiblocked_y );
+        const int gz = Sweeper_granule_( iz, sweeper->dims_b.ncell_z,
+                           sweeper->ncell_z_per_subblock, is_semiblocked_z );
+
+        const int face = octant_in_block + noctant_per_block *
+                                           sweeper_task.thread_e;
+
+        TaskGraph_touch( taskgraph, task,
+          gx + ngranule_x * ( gy + ngranule_y * ( gz + ngranule_z *
+                                                  sweeper_task.thread_e ) ) );
+        TaskGraph_touch( taskgraph, task, key_base_xy +
+          gx + ngranule_x * ( gy + ngranule_y * face ) );
+        TaskGraph_touch( taskgraph, task, key_base_xz +
+          gx + ngranule_x * ( gz + ngranule_z * face ) );
+        TaskGraph_touch( taskgraph, task, key_base_yz +
+          gy + ngranule_y * ( gz + ngranule_z * face ) );
+      }
+    } /*---octant_in_block---*/
+  } /*---task---*/
+}
+
+#endif /*---USE_OPENMP_TASKS---*/
+
 /*===========================================================================*/
 /*---Perform a sweep for a block, implementation---*/
 
@@ -1108,13 +2716,6 @@ TARGET_HD void Sweeper_sweep_block_impl(
   StepInfoAll            stepinfoall,
   unsigned long int      do_block_init )
 {
-  /*---Declarations---*/
-    const int noctant_per_block = sweeper.noctant_per_block;
-
-    const int nsemiblock = sweeper.nsemiblock;
-
-    int semiblock_step = 0;
-
     /*=========================================================================
     =    OpenMP-parallelizing octants leads to the problem that for the same
     =    step, two octants may be updating the same location in a state vector.
@@ -1158,201 +2759,83 @@ TARGET_HD void Sweeper_sweep_block_impl(
     =      wavefront latency.
     =========================================================================*/
 
+#ifdef USE_OPENMP_TASKS
     /*--------------------*/
-    /*---Loop over semiblock steps---*/
+    /*---Run all semiblock steps as one graph of subblock tasks---*/
     /*--------------------*/
 
-    for( semiblock_step=0; semiblock_step<nsemiblock; ++semiblock_step )
-    {
-#ifdef USE_OPENMP_TASKS
-      /*--------------------*/
-      /*---Enter parallel region where tasks will be launched---*/
-      /*--------------------*/
-
-      int thread_octant = 0;
-      int thread_e = 0;
-
-#pragma omp parallel for firstprivate(sweeper) collapse(2)
-      for( thread_octant=0; thread_octant<sweeper.nthread_octant;
-                                                             ++thread_octant)
-      {
-      for( thread_e=0; thread_e<sweeper.nthread_e; ++thread_e)
-      {
-        sweeper.thread_octant = thread_octant;
-        sweeper.thread_e = thread_e;
-
-      /*--------------------*/
-      /*---Loop over the space of all tasks to be launched---*/
-      /*--------------------*/
-
-      /*---Here we assign one thread/task per subblock---*/
-
-      int thread_z = 0;
-      for( thread_z=0; thread_z<sweeper.nthread_z; ++thread_z)
-      {
-        sweeper.thread_z = thread_z;
-
-      int thread_y = 0;
-      for( thread_y=0; thread_y<sweeper.nthread_y; ++thread_y)
-      {
-        sweeper.thread_y = thread_y;
+    /*---Tasks of different semiblock steps, octant threads and energy
+         threads overlap where they share no data; idle threads steal
+         ready tasks rather than wait at a barrier per semiblock step---*/
 
-      int thread_x = 0;
-      for( thread_x=0; thread_x<sweeper.nthread_x; ++thread_x)
-      {
-        sweeper.thread_x = thread_x;
+    SweeperTaskArgs args;
 
-      /*--------------------*/
-      /*---Determine dependencies---*/
-      /*--------------------*/
+    args.sweeper       = sweeper;
+    args.vo            = vo;
+    args.vi            = vi;
+    args.facexy        = facexy;
+    args.facexz        = facexz;
+    args.faceyz        = faceyz;
+    args.a_from_m      = a_from_m;
+    args.m_from_a      = m_from_a;
+    args.quan          = &quan;
+    args.stepinfoall   = &stepinfoall;
+    args.do_block_init = do_block_init;
 
-      const char* __restrict__ dep_in_x = Sweeper_task_dependency( &sweeper,
-                thread_x-1, thread_y,   thread_z,   thread_e, thread_octant );
+    Sweeper_build_taskgraph_( &sweeper, &stepinfoall );
 
-      const char* __restrict__ dep_in_y = Sweeper_task_dependency( &sweeper,
-                thread_x,   thread_y-1, thread_z,   thread_e, thread_octant );
+    TaskGraph_run( sweeper.taskgraph, Sweeper_sweep_task_, &args );
+#else
+    const int nsemiblock = sweeper.nsemiblock;
 
-      const char* __restrict__ dep_in_z = Sweeper_task_dependency( &sweeper,
-                thread_x,   thread_y,   thread_z-1, thread_e, thread_octant );
+    int semiblock_step = 0;
 
-      const char* __restrict__ dep_out = Sweeper_task_dependency( &sweeper,
-                thread_x,   thread_y,   thread_z,   thread_e, thread_octant );
+    /*--------------------*/
+    /*---Loop over semiblock steps---*/
+    /*--------------------*/
 
-      /*
-        printf("%i %i "
-               "Submitting task %i %i %i %i %i  thread %i numthreads %i\n",
-               step, semiblock_step,
-               thread_x, thread_y, thread_z, thread_e, thread_octant,
-               omp_get_thread_num(), omp_get_num_threads());
-      */
+    for( semiblock_step=0; semiblock_step<nsemiblock; ++semiblock_step )
+    {
+      Sweeper_sweep_semiblock_step( &sweeper, vo, vi,
+                                    facexy, facexz, faceyz,
+                                    a_from_m, m_from_a,
+                                    &quan, &stepinfoall,
+                                    semiblock_step, do_block_init );
 
-      /*--------------------*/
-      /*---Launch this task---*/
-      /*--------------------*/
+      /*---Sync between semiblock steps---*/
+      Sweeper_sync_octant_threads( &sweeper );
 
-#pragma omp task \
-      depend(in:  dep_in_x[0]) \
-      depend(in:  dep_in_y[0]) \
-      depend(in:  dep_in_z[0]) \
-      depend(out: dep_out[0])
-      {
-      /*
-        printf("%i %i                   "
-               "Commencing task %i %i %i %i %i  thread %i\n",
-               step, semiblock_step,
-               thread_x, thread_y, thread_z, thread_e, thread_octant,
-               omp_get_thread_num());
-      */
+    } /*---semiblock---*/
 #endif
+}
 
-      /*--------------------*/
-      /*---Loop over octants in octant block---*/
-      /*---That is, octants that are computed for this semiblock step---*/
-      /*--------------------*/
-
-        const int octant_in_block_min =
-                             (   sweeper.noctant_per_block *
-                               ( Sweeper_thread_octant( &sweeper )     ) )
-                           /     sweeper.nthread_octant;
-        const int octant_in_block_max =
-                             (   sweeper.noctant_per_block *
-                               ( Sweeper_thread_octant( &sweeper ) + 1 ) )
-                           /     sweeper.nthread_octant;
-
-        int octant_in_block = 0;
-
-      for( octant_in_block=octant_in_block_min;
-           octant_in_block<octant_in_block_max; ++octant_in_block )
-      {
-        /*---Get step info---*/
-
-        const StepInfo stepinfo = stepinfoall.stepinfo[octant_in_block];
-
-        const Bool_t is_octant_active = stepinfo.is_active;
-
-        const int dir_x = Dir_x( stepinfo.octant );
-        const int dir_y = Dir_y( stepinfo.octant );
-        const int dir_z = Dir_z( stepinfo.octant );
-
-        /*--------------------*/
-        /*---Compute semiblock bounds---*/
-        /*--------------------*/
-
-        Bool_t is_semiblock_min_x = 0, is_semiblock_max_x = 0;
-        int ixmin_semiblock = 0, ixmax_semiblock = 0, ixmax_semiblock_up2 = 0;
-
-        Sweeper_get_semiblock_bounds(&is_semiblock_min_x, &is_semiblock_max_x,
-          &ixmin_semiblock, &ixmax_semiblock, &ixmax_semiblock_up2,
-          sweeper.dims_b.ncell_x, DIM_X, dir_x, semiblock_step, nsemiblock);
-
-        /*--------------------*/
-
-        Bool_t is_semiblock_min_y = 0, is_semiblock_max_y = 0;
-        int iymin_semiblock = 0, iymax_semiblock = 0, iymax_semiblock_up2 = 0;
-
-        Sweeper_get_semiblock_bounds(&is_semiblock_min_y, &is_semiblock_max_y,
-          &iymin_semiblock, &iymax_semiblock, &iymax_semiblock_up2,
-          sweeper.dims_b.ncell_y, DIM_Y, dir_y, semiblock_step, nsemiblock);
-
-        /*--------------------*/
-
-        Bool_t is_semiblock_min_z = 0, is_semiblock_max_z = 0;
-        int izmin_semiblock = 0, izmax_semiblock = 0, izmax_semiblock_up2 = 0;
-
-        Sweeper_get_semiblock_bounds(&is_semiblock_min_z, &is_semiblock_max_z,
-          &izmin_semiblock, &izmax_semiblock, &izmax_semiblock_up2,
-          sweeper.dims_b.ncell_z, DIM_Z, dir_z, semiblock_step, nsemiblock);
-
-        /*--------------------*/
-        /*---Perform sweep over subblocks in semiblock---*/
-        /*---(for tasking case, this task sweeps one subblock in semiblock---*/
-        /*--------------------*/
-
-        const int iz_base = stepinfo.block_z * sweeper.dims_b.ncell_z;
-
-        const P* vi_this = const_ref_state( vi, sweeper.dims, NU, 0, 0,
-                                                            iz_base, 0, 0, 0 );
-        P* vo_this =             ref_state( vo, sweeper.dims, NU, 0, 0,
-                                                            iz_base, 0, 0, 0 );
-
-        const int do_block_init_this = !! ( do_block_init &
-                         ( ((unsigned long int)1) <<
-                           ( octant_in_block + noctant_per_block *
-                             semiblock_step ) ) );
-
-        Sweeper_sweep_semiblock( &sweeper, vo_this, vi_this,
-                                 facexy, facexz, faceyz,
-                                 a_from_m, m_from_a,
-                                 &quan, stepinfo, octant_in_block,
-                                 ixmin_semiblock, ixmax_semiblock_up2,
-                                 iymin_semiblock, iymax_semiblock_up2,
-                                 izmin_semiblock, izmax_semiblock_up2,
-                                 do_block_init_this,
-                                 is_octant_active );
-
-      } /*---octant_in_block---*/
+/*===========================================================================*/
+/*---Apply a moment/angle transform variant nrep times, for calibration---*/
+
+/*---vxform holds input moments, NM x NU, then angles, na x NU, then
+     output moments, NM x NU.  The octant cycles so that successive
+     repetitions are not identical---*/
+
+void Sweeper_xform_bench_impl(
+  int                     variant,
+  int                     na,
+  const P* __restrict__   a_from_m,
+  const P* __restrict__   m_from_a,
+  PAccum* __restrict__    vxform,
+  int                     nrep )
+{
+  PAccum* const __restrict__ vm_in  = vxform;
+  PAccum* const __restrict__ va     = vxform + NM * NU;
+  PAccum* const __restrict__ vm_out = vxform + NM * NU + na * NU;
 
-#ifdef USE_OPENMP_TASKS
-      /*
-        printf("%i %i                                                 "
-               "Completing task %i %i %i %i %i  thread %i\n",
-               step, semiblock_step,
-               thread_x, thread_y, thread_z, thread_e, thread_octant,
-               omp_get_thread_num());
-      */
-
-      } /*---omp task---*/
-      }
-      }
-      }
-      }
-      } /*---omp parallel for---*/ /*---NOTE: implicit sync here---*/
-#else
-      /*---Sync between semiblock steps---*/
-      Sweeper_sync_octant_threads( &sweeper );
-#endif
+  int rep = 0;
 
-    } /*---semiblock---*/
+  for( rep=0; rep<nrep; ++rep )
+  {
+    Sweeper_xform_m_to_a( variant, vm_in, va, a_from_m, na, rep % NOCTANT );
+    Sweeper_xform_a_to_m( variant, va, vm_out, m_from_a, na,
+                          rep % NOCTANT );
+  }
 }
 
 /*===========================================================================*/
@@ -0,0 +1,59 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   sweeper_kba_kernel_instance_c.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  sweeper_kba, instantiate comp. kernel for one (NM, NU) pair.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+/*---NOTE: to be included once, first thing, by a translation unit that
+     defines SWEEPER_KBA_KERNEL_NM and SWEEPER_KBA_KERNEL_NU---*/
+
+#ifndef _sweeper_kba_kernel_instance_c_h_
+#define _sweeper_kba_kernel_instance_c_h_
+
+#include "sweeper_kba_kernel_instances.h"
+
+/*---Override the build default sizes for this translation unit---*/
+
+#undef  NM_VALUE
+#define NM_VALUE SWEEPER_KBA_KERNEL_NM
+#undef  NU_VALUE
+#define NU_VALUE SWEEPER_KBA_KERNEL_NU
+
+/*---Give the kernel entry points names unique to this instance---*/
+
+#define Sweeper_sweep_block_impl \
+  SWEEPER_KBA_KERNEL_NAME( Sweeper_sweep_block_impl, \
+                           SWEEPER_KBA_KERNEL_NM, SWEEPER_KBA_KERNEL_NU )
+#define Sweeper_sweep_block_impl_global \
+  SWEEPER_KBA_KERNEL_NAME( Sweeper_sweep_block_impl_global, \
+                           SWEEPER_KBA_KERNEL_NM, SWEEPER_KBA_KERNEL_NU )
+#define Sweeper_xform_bench_impl \
+  SWEEPER_KBA_KERNEL_NAME( Sweeper_xform_bench_impl, \
+                           SWEEPER_KBA_KERNEL_NM, SWEEPER_KBA_KERNEL_NU )
+
+#include "sweeper.h"
+
+#ifdef SWEEPER_KBA
+#include "sweeper_kba_c_kernels.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+SWEEPER_KBA_KERNEL_DEFINE( SWEEPER_KBA_KERNEL_NAME( Sweeper_kernel,
+                           SWEEPER_KBA_KERNEL_NM, SWEEPER_KBA_KERNEL_NU ) )
+
+#ifdef __cplusplus
+} /*---extern "C"---*/
+#endif
+
+#endif /*---SWEEPER_KBA---*/
+
+#endif /*---_sweeper_kba_kernel_instance_c_h_---*/
+
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,65 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   sweeper_kba_kernel_instances.h
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  sweeper_kba, list of kernels specialized for (NM, NU) values.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#ifndef _sweeper_kba_kernel_instances_h_
+#define _sweeper_kba_kernel_instances_h_
+
+/*=============================================================================
+
+The sweep kernel relies on NM and NU being compile-time constants so that
+the moment/unknown loops are fully unrolled and the v*local scratch arrays
+are fixed size.  To allow nm, nu to be chosen at run time without giving
+this up, the kernel is compiled several times over, once for each (NM, NU)
+pair listed below, in addition to the build default NM_VALUE, NU_VALUE.
+Sweeper_create picks the matching instance from the requested dims.
+
+To add an instance: add an entry to the list and add a matching translation
+unit sweeper_kernels_nm<NM>_nu<NU>.c (plus .cu link) to the build.
+
+=============================================================================*/
+
+#define SWEEPER_KBA_KERNEL_INSTANCES( X ) \
+  X(  1, 4 ) \
+  X(  4, 4 ) \
+  X(  9, 4 ) \
+  X( 16, 4 ) \
+  X( 25, 4 ) \
+  X( 36, 4 ) \
+  X(  4, 1 ) \
+  X( 16, 1 )
+
+/*===========================================================================*/
+/*---Name of an object specialized for (nm, nu)---*/
+
+#define SWEEPER_KBA_KERNEL_NAME_( name, nm, nu ) name##_nm##nm##_nu##nu
+#define SWEEPER_KBA_KERNEL_NAME( name, nm, nu ) \
+  SWEEPER_KBA_KERNEL_NAME_( name, nm, nu )
+
+/*===========================================================================*/
+/*---Define kernel descriptor; use in translation unit defining the kernel---*/
+
+#define SWEEPER_KBA_KERNEL_DEFINE( name ) \
+  const SweeperKernel name = { \
+    NM, \
+    NU, \
+    NTHREAD_A, \
+    NTHREAD_M, \
+    NTHREAD_U, \
+    NTHREAD_DEVICE_A, \
+    NTHREAD_DEVICE_M, \
+    NTHREAD_DEVICE_U, \
+    Sweeper_sweep_block_impl, \
+    Sweeper_sweep_block_impl_global, \
+    Sweeper_xform_bench_impl \
+  };
+
+#endif /*---_sweeper_kba_kernel_instances_h_---*/
+
+/*---------------------------------------------------------------------------*/
@@ -17,6 +17,15 @@
 #include "dimensions_kernels.h"
 #include "pointer_kernels.h"
 #include "quantities_kernels.h"
+#include "simd_kernels.h"
+
+#ifdef USE_OPENMP_TASKS
+#include "taskgraph.h"
+#endif
+
+#ifdef USE_OPENMP_THREADS
+#include "threadteam.h"
+#endif
 
 #ifdef __cplusplus
 extern "C"
@@ -69,14 +78,33 @@ enum{ NTHREAD_DEVICE_A = NTHREAD_DEVICE_U * NTHREAD_DEVICE_M };
 #endif
 #endif
 
+/*---Upper limit on number of (cell, energy group) pairs per GEMM batch---*/
+
+enum{ GEMM_BATCH_SIZE_MAX = 256 };
+
+/*---Moment/angle transform variants, see Sweeper_xform_m_to_a.  CELL is
+     the threaded transform code built into Sweeper_sweep_cell---*/
+
+enum{ XFORM_VARIANT_CELL         = 0,
+      XFORM_VARIANT_DOT          = 1,
+      XFORM_VARIANT_DOT_UNROLL_U = 2,
+      XFORM_VARIANT_AXPY         = 3,
+      XFORM_VARIANT_AXPY_UNROLL4 = 4,
+      NXFORM_VARIANT             = 5 };
+
 /*===========================================================================*/
 /*---Lightweight version of Sweeper class for sending to device---*/
 
 typedef struct
 {
-  P* __restrict__  vilocal_host_;
-  P* __restrict__  vslocal_host_;
-  P* __restrict__  volocal_host_;
+  PAccum* __restrict__  vilocal_host_;
+  PAccum* __restrict__  vslocal_host_;
+  PAccum* __restrict__  volocal_host_;
+  PAccum* __restrict__  vmbatch_host_;
+  PAccum* __restrict__  vabatch_host_;
+  PAccum* __restrict__  velanes_host_;
+  PAccum* __restrict__  vxform_host_;
+  P* __restrict__       vo_private_host_;
 
   Dimensions       dims;
   Dimensions       dims_b;
@@ -95,19 +123,52 @@ typedef struct
   int              ncell_x_per_subblock;
   int              ncell_y_per_subblock;
   int              ncell_z_per_subblock;
+  int              ne_per_tile;
+  int              ne_per_chunk;
+  int              ncell_x_per_tile;
+  int              ncell_y_per_tile;
+  int              gemm_batch_size;
+  Bool_t           is_using_energy_lanes;
+  int              xform_variant;
+  /*---Env whose outstanding face messages the host kernel polls, or NULL---*/
+  Env*             env_progress;
 #ifdef USE_OPENMP_TASKS
   int              thread_e;
   int              thread_octant;
   int              thread_x;
   int              thread_y;
   int              thread_z;
-  char*            task_dependency;
+  TaskGraph*       taskgraph;
+#endif
+#ifdef USE_OPENMP_THREADS
+  ThreadTeam*      threadteam;
+  int              thread_in_team;
+  Bool_t           is_step_pipelined;
 #endif
 } SweeperLite;
 
 /*===========================================================================*/
 /*---Thread indexers---*/
 
+#if ! defined( __CUDA_ARCH__ ) && ! defined( USE_OPENMP_TASKS )
+/*---Thread number on the host, within the team sweeping the block---*/
+static inline int Sweeper_thread_host_( const SweeperLite* sweeper )
+{
+#ifdef USE_OPENMP_THREADS
+  Assert( sweeper->thread_in_team >= 0 );
+  return sweeper->thread_in_team;
+#else
+  Assert( sweeper->nthread_e *
+          sweeper->nthread_octant *
+          sweeper->nthread_y *
+          sweeper->nthread_z == 1 || Env_omp_in_parallel() );
+  return Env_omp_thread();
+#endif
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 TARGET_HD static inline int Sweeper_thread_e( const SweeperLite* sweeper )
 {
 #ifdef USE_OPENMP_TASKS
@@ -117,11 +178,7 @@ TARGET_HD static inline int Sweeper_thread_e( const SweeperLite* sweeper )
 #ifdef __CUDA_ARCH__
   return Env_cuda_threadblock( 0 );
 #else
-  Assert( sweeper->nthread_e *
-          sweeper->nthread_octant *
-          sweeper->nthread_y *
-          sweeper->nthread_z == 1 || Env_omp_in_parallel() );
-  return Env_omp_thread() % sweeper->nthread_e;
+  return Sweeper_thread_host_( sweeper ) % sweeper->nthread_e;
 #endif
 #endif
 }
@@ -137,12 +194,8 @@ TARGET_HD static inline int Sweeper_thread_octant( const SweeperLite* sweeper )
 #ifdef __CUDA_ARCH__
   return Env_cuda_thread_in_threadblock( 1 );
 #else
-  Assert( sweeper->nthread_e *
-          sweeper->nthread_octant *
-          sweeper->nthread_y *
-          sweeper->nthread_z == 1 || Env_omp_in_parallel() );
-  return ( Env_omp_thread() / sweeper->nthread_e )
-                            % sweeper->nthread_octant;
+  return ( Sweeper_thread_host_( sweeper ) / sweeper->nthread_e )
+                                          % sweeper->nthread_octant;
 #endif
 #endif
 }
@@ -170,13 +223,9 @@ TARGET_HD static inline int Sweeper_thread_y( const SweeperLite* sweeper )
 #ifdef __CUDA_ARCH__
   return Env_cuda_thread_in_threadblock( 2 ) % sweeper->nthread_y ;
 #else
-  Assert( sweeper->nthread_e *
-          sweeper->nthread_octant *
-          sweeper->nthread_y *
-          sweeper->nthread_z == 1 || Env_omp_in_parallel() );
-  return ( Env_omp_thread() / ( sweeper->nthread_e *
-                                sweeper->nthread_octant )
-                            %   sweeper->nthread_y );
+  return ( Sweeper_thread_host_( sweeper ) / ( sweeper->nthread_e *
+                                              sweeper->nthread_octant )
+                                          %   sweeper->nthread_y );
 #endif
 #endif
 }
@@ -192,14 +241,10 @@ TARGET_HD static inline int Sweeper_thread_z( const SweeperLite* sweeper )
 #ifdef __CUDA_ARCH__
   return Env_cuda_thread_in_threadblock( 2 ) / sweeper->nthread_y;
 #else
-  Assert( sweeper->nthread_e *
-          sweeper->nthread_octant *
-          sweeper->nthread_y *
-          sweeper->nthread_z == 1 || Env_omp_in_parallel() );
-  return ( Env_omp_thread() / ( sweeper->nthread_e *
-                                sweeper->nthread_octant *
-                                sweeper->nthread_y )
-                            %   sweeper->nthread_z );
+  return ( Sweeper_thread_host_( sweeper ) / ( sweeper->nthread_e *
+                                              sweeper->nthread_octant *
+                                              sweeper->nthread_y )
+                                          %   sweeper->nthread_z );
 #endif
 #endif
 }
@@ -237,6 +282,26 @@ TARGET_HD static inline int Sweeper_thread_u( const SweeperLite* sweeper )
 #endif
 }
 
+/*===========================================================================*/
+/*---Let outstanding face messages progress, if polling---*/
+
+/*---Called between subblocks; with a thread team only the calling
+     thread of the team polls---*/
+
+TARGET_HD static inline void Sweeper_progress_poll( SweeperLite* sweeper )
+{
+#ifndef __CUDA_ARCH__
+  Bool_t is_polling = sweeper->env_progress != NULL;
+#ifdef USE_OPENMP_THREADS
+  is_polling = is_polling && sweeper->thread_in_team == 0;
+#endif
+  if( is_polling )
+  {
+    Env_progress_poll( sweeper->env_progress );
+  }
+#endif
+}
+
 /*===========================================================================*/
 /*---Thread synchronization---*/
 
@@ -247,10 +312,10 @@ TARGET_HD static inline void Sweeper_sync_octant_threads( SweeperLite* sweeper )
   Env_cuda_sync_threadblock();
 #else
 #ifdef USE_OPENMP_THREADS
-if( sweeper->nthread_octant != 1 )
-{
-#pragma omp barrier
-}
+  if( sweeper->nthread_octant != 1 )
+  {
+    ThreadTeam_barrier( sweeper->threadteam, sweeper->thread_in_team );
+  }
 #endif
 #endif
 }
@@ -264,11 +329,128 @@ TARGET_HD static inline void Sweeper_sync_yz_threads( SweeperLite* sweeper )
   Env_cuda_sync_threadblock();
 #else
 #ifdef USE_OPENMP_THREADS
-if( sweeper->nthread_y != 1 || sweeper->nthread_z != 1 )
+  /*---Host threads sync point to point, see below---*/
+#endif
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/*---Point-to-point sync of yz threads on the host.  The team flag of a
+     thread counts the subblockwaves it has completed in this team run.
+     A thread waits only on the threads that swept its upstream
+     subblocks, rather than on all yz threads at every subblockwave.
+     With dynamic energy scheduling, any energy thread may have swept a
+     given group, so all energy threads of those yz threads are waited on,
+     including those of this thread's own yz thread---*/
+
+#if defined( USE_OPENMP_THREADS ) && ! defined( __CUDA_ARCH__ )
+static inline int Sweeper_thread_in_team_( const SweeperLite* sweeper,
+                                           int                thread_e,
+                                           int                thread_y,
+                                           int                thread_z )
+{
+  /*---Team thread number of a thread of this octant thread---*/
+
+  return thread_e + sweeper->nthread_e * (
+         Sweeper_thread_octant( sweeper ) + sweeper->nthread_octant * (
+         thread_y + sweeper->nthread_y * thread_z ) );
+}
+
+/*---------------------------------------------------------------------------*/
+
+static inline void Sweeper_wait_e_threads_( SweeperLite* sweeper,
+                                            int          thread_y,
+                                            int          thread_z,
+                                            int          nwave_done )
 {
-#pragma omp barrier
+  /*---Wait for the energy threads of a yz thread that may have swept
+       groups of this thread---*/
+
+  const Bool_t is_e_dynamic = sweeper->ne_per_chunk > 0;
+  const int thread_e_min = is_e_dynamic ? 0 : Sweeper_thread_e( sweeper );
+  const int thread_e_max = is_e_dynamic ? sweeper->nthread_e
+                                        : thread_e_min + 1;
+  int thread_e = 0;
+
+  for( thread_e=thread_e_min; thread_e<thread_e_max; ++thread_e )
+  {
+    ThreadTeam_flag_wait( sweeper->threadteam, sweeper->thread_in_team,
+      Sweeper_thread_in_team_( sweeper, thread_e, thread_y, thread_z ),
+      nwave_done );
+  }
 }
 #endif
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void Sweeper_wait_yz_threads_semiblock(
+                                                      SweeperLite* sweeper )
+{
+#if defined( USE_OPENMP_THREADS ) && ! defined( __CUDA_ARCH__ )
+  /*---Wait for all yz threads to finish the previous semiblock, whose
+       cells and faces may be reused by this one.  A step pipelined behind
+       the previous block of the same octant shares only the xy face with
+       it, so then only the yz threads of the same y are waited for---*/
+
+  const int nwave_done = ThreadTeam_flag( sweeper->threadteam,
+                                          sweeper->thread_in_team );
+  int thread_y = 0;
+  int thread_z = 0;
+
+  for( thread_z=0; thread_z<sweeper->nthread_z; ++thread_z )
+  {
+    for( thread_y=0; thread_y<sweeper->nthread_y; ++thread_y )
+    {
+      if( ! sweeper->is_step_pipelined ||
+          thread_y == Sweeper_thread_y( sweeper ) )
+      {
+        Sweeper_wait_e_threads_( sweeper, thread_y, thread_z, nwave_done );
+      }
+    }
+  }
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void Sweeper_wait_yz_threads_subblock(
+                                                      SweeperLite* sweeper,
+                                                      int thread_y_up,
+                                                      int thread_z_up )
+{
+#if defined( USE_OPENMP_THREADS ) && ! defined( __CUDA_ARCH__ )
+  /*---Wait for the threads, if any, that swept the upstream subblocks
+       in y and z, and in x, to reach the previous subblockwave---*/
+
+  const int nwave_done = ThreadTeam_flag( sweeper->threadteam,
+                                          sweeper->thread_in_team );
+
+  if( thread_y_up >= 0 )
+  {
+    Sweeper_wait_e_threads_( sweeper, thread_y_up,
+                             Sweeper_thread_z( sweeper ), nwave_done );
+  }
+  if( thread_z_up >= 0 )
+  {
+    Sweeper_wait_e_threads_( sweeper, Sweeper_thread_y( sweeper ),
+                             thread_z_up, nwave_done );
+  }
+  Sweeper_wait_e_threads_( sweeper, Sweeper_thread_y( sweeper ),
+                           Sweeper_thread_z( sweeper ), nwave_done );
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline void Sweeper_signal_yz_threads_subblock(
+                                                      SweeperLite* sweeper )
+{
+#if defined( USE_OPENMP_THREADS ) && ! defined( __CUDA_ARCH__ )
+  /*---Mark this thread's subblockwave complete---*/
+
+  ThreadTeam_flag_post( sweeper->threadteam, sweeper->thread_in_team,
+                        ThreadTeam_flag( sweeper->threadteam,
+                                         sweeper->thread_in_team ) + 1 );
 #endif
 }
 
@@ -289,11 +471,11 @@ TARGET_HD static inline void Sweeper_sync_amu_threads( SweeperLite* sweeper )
 /*===========================================================================*/
 /*---Select which part of v*local to use for current thread/block---*/
 
-TARGET_HD static inline P* __restrict__ Sweeper_vilocal_this_(
+TARGET_HD static inline PAccum* __restrict__ Sweeper_vilocal_this_(
                                                          SweeperLite* sweeper )
 {
 #ifdef __CUDA_ARCH__
-  return ( (P*) Env_cuda_shared_memory() )
+  return ( (PAccum*) Env_cuda_shared_memory() )
     + ( NTHREAD_M *
         NU *
         sweeper->nthread_octant *
@@ -324,11 +506,11 @@ TARGET_HD static inline P* __restrict__ Sweeper_vilocal_this_(
 
 /*---------------------------------------------------------------------------*/
 
-TARGET_HD static inline P* __restrict__ Sweeper_vslocal_this_(
+TARGET_HD static inline PAccum* __restrict__ Sweeper_vslocal_this_(
                                                          SweeperLite* sweeper )
 {
 #ifdef __CUDA_ARCH__
-  return ( (P*) Env_cuda_shared_memory() )
+  return ( (PAccum*) Env_cuda_shared_memory() )
     + ( NTHREAD_M *
         NU *
         sweeper->nthread_octant *
@@ -359,11 +541,11 @@ TARGET_HD static inline P* __restrict__ Sweeper_vslocal_this_(
 
 /*---------------------------------------------------------------------------*/
 
-TARGET_HD static inline P* __restrict__ Sweeper_volocal_this_(
+TARGET_HD static inline PAccum* __restrict__ Sweeper_volocal_this_(
                                                          SweeperLite* sweeper )
 {
 #ifdef __CUDA_ARCH__
-  return ( (P*) Env_cuda_shared_memory() )
+  return ( (PAccum*) Env_cuda_shared_memory() )
     + ( NTHREAD_M *
         NU *
         sweeper->nthread_octant *
@@ -392,6 +574,81 @@ TARGET_HD static inline P* __restrict__ Sweeper_volocal_this_(
 #endif
 }
 
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline PAccum* __restrict__ Sweeper_vmbatch_this_(
+                                                         SweeperLite* sweeper )
+{
+  /*---Host only: batched transforms are not used on the device---*/
+  return sweeper->vmbatch_host_
+    + sweeper->dims.nm *
+      sweeper->dims.nu *
+      sweeper->gemm_batch_size *
+      ( Sweeper_thread_octant( sweeper ) + sweeper->nthread_octant * (
+        Sweeper_thread_x(      sweeper ) + sweeper->nthread_x      * (
+        Sweeper_thread_y(      sweeper ) + sweeper->nthread_y      * (
+        Sweeper_thread_z(      sweeper ) + sweeper->nthread_z      * (
+        Sweeper_thread_e(      sweeper ) + sweeper->nthread_e      * (
+        0 ) ) ) ) ) )
+  ;
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline PAccum* __restrict__ Sweeper_vabatch_this_(
+                                                         SweeperLite* sweeper )
+{
+  /*---Host only: batched transforms are not used on the device---*/
+  return sweeper->vabatch_host_
+    + sweeper->dims.na *
+      sweeper->dims.nu *
+      sweeper->gemm_batch_size *
+      ( Sweeper_thread_octant( sweeper ) + sweeper->nthread_octant * (
+        Sweeper_thread_x(      sweeper ) + sweeper->nthread_x      * (
+        Sweeper_thread_y(      sweeper ) + sweeper->nthread_y      * (
+        Sweeper_thread_z(      sweeper ) + sweeper->nthread_z      * (
+        Sweeper_thread_e(      sweeper ) + sweeper->nthread_e      * (
+        0 ) ) ) ) ) )
+  ;
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline PAccum* __restrict__ Sweeper_velanes_this_(
+                                                         SweeperLite* sweeper )
+{
+  /*---Host only: energy lane kernels are not used on the device---*/
+  return sweeper->velanes_host_
+    + ( sweeper->dims.nm + sweeper->dims.na ) *
+      sweeper->dims.nu *
+      SIMD_LEN *
+      ( Sweeper_thread_octant( sweeper ) + sweeper->nthread_octant * (
+        Sweeper_thread_x(      sweeper ) + sweeper->nthread_x      * (
+        Sweeper_thread_y(      sweeper ) + sweeper->nthread_y      * (
+        Sweeper_thread_z(      sweeper ) + sweeper->nthread_z      * (
+        Sweeper_thread_e(      sweeper ) + sweeper->nthread_e      * (
+        0 ) ) ) ) ) )
+  ;
+}
+
+/*---------------------------------------------------------------------------*/
+
+TARGET_HD static inline PAccum* __restrict__ Sweeper_vxform_this_(
+                                                         SweeperLite* sweeper )
+{
+  /*---Host only: transform variants are not used on the device---*/
+  return sweeper->vxform_host_
+    + ( sweeper->dims.nm + sweeper->dims.na ) *
+      sweeper->dims.nu *
+      ( Sweeper_thread_octant( sweeper ) + sweeper->nthread_octant * (
+        Sweeper_thread_x(      sweeper ) + sweeper->nthread_x      * (
+        Sweeper_thread_y(      sweeper ) + sweeper->nthread_y      * (
+        Sweeper_thread_z(      sweeper ) + sweeper->nthread_z      * (
+        Sweeper_thread_e(      sweeper ) + sweeper->nthread_e      * (
+        0 ) ) ) ) ) )
+  ;
+}
+
 /*===========================================================================*/
 /*---Helper functions---*/
 
@@ -422,21 +679,6 @@ TARGET_HD static inline Bool_t is_semiblock_min_when_semiblocked(
   return ( ( semiblock_step & (1<<dim) ) == 0 )  ==  ( dir == DIR_UP );
 }
 
-/*---------------------------------------------------------------------------*/
-
-#ifdef USE_OPENMP_TASKS
-static inline char* Sweeper_task_dependency( SweeperLite* sweeperlite,
-  int thread_x, int thread_y, int thread_z, int thread_e, int thread_octant )
-{
-  return &( sweeperlite->task_dependency[
-    1 + thread_x      + (1+sweeperlite->nthread_x)      * (
-    1 + thread_y      + (1+sweeperlite->nthread_y)      * (
-    1 + thread_z      + (1+sweeperlite->nthread_z)      * (
-    1 + thread_e      + (1+sweeperlite->nthread_e)      * (
-    1 + thread_octant + (1+sweeperlite->nthread_octant) * ( 0 ))))) ] );
-}
-#endif
-
 /*===========================================================================*/
 /*---Perform a sweep for a block, implementation---*/
 
@@ -458,6 +700,17 @@ TARGET_HD void Sweeper_sweep_block_impl(
   StepInfoAll            stepinfoall,
   unsigned long int      do_block_init );
 
+/*===========================================================================*/
+/*---Apply a moment/angle transform variant nrep times, for calibration---*/
+
+void Sweeper_xform_bench_impl(
+  int                     variant,
+  int                     na,
+  const P* __restrict__   a_from_m,
+  const P* __restrict__   m_from_a,
+  PAccum* __restrict__    vxform,
+  int                     nrep );
+
 /*===========================================================================*/
 /*---Perform a sweep for a block, implementation, global---*/
 
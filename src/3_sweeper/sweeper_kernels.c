@@ -16,8 +16,16 @@
 #ifdef SWEEPER_TILEOCTANTS
 #endif
 
+#ifdef SWEEPER_HYPERPLANE
+#endif
+
 #ifdef SWEEPER_KBA
 #include "sweeper_kba_c_kernels.h"
+#include "sweeper_kba_kernel_instances.h"
+
+/*---Kernel for the build default NM, NU---*/
+
+SWEEPER_KBA_KERNEL_DEFINE( Sweeper_kernel_default )
 #endif
 
 /*---------------------------------------------------------------------------*/
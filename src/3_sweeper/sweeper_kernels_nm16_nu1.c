@@ -0,0 +1,16 @@
+/*---------------------------------------------------------------------------*/
+/*!
+ * \file   sweeper_kernels_nm16_nu1.c
+ * \author Wayne Joubert
+ * \date   Thu Oct 15 09:12:44 EDT 2026
+ * \brief  Sweep comp. kernel instantiated for NM=16, NU=1.
+ * \note   Copyright (C) 2026 Oak Ridge National Laboratory, UT-Battelle, LLC.
+ */
+/*---------------------------------------------------------------------------*/
+
+#define SWEEPER_KBA_KERNEL_NM 16
+#define SWEEPER_KBA_KERNEL_NU 1
+
+#include "sweeper_kba_kernel_instance_c.h"
+
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1 @@
+./sweeper_kernels_nm16_nu1.c
\ No newline at end of file
@@ -45,6 +45,12 @@ void Sweeper_create( Sweeper*          sweeper,
   /* Insist( Env_nproc( env ) == 1 &&  */
   /*                            "This sweeper version runs only with one proc." ); */
 
+  Insist( dims.nm == NM && dims.nu == NU ?
+          "This sweeper version supports only the compile-time NM, NU." : 0 );
+
+  Insist( STATE_LAYOUT == STATE_LAYOUT_CELL_INNER ?
+          "This sweeper version supports only the default state layout." : 0 );
+
   /*---Allocate arrays---*/
 
   sweeper->vslocal = malloc_host_P( dims.na * NU * dims.ne * NOCTANT * dims.ncell_x * dims.ncell_y );
@@ -88,6 +94,10 @@ void Sweeper_destroy( Sweeper* sweeper,
 #endif
 P Quantities_init_face(int ia, int ie, int iu, int scalefactor_space, int octant)
 {
+#ifdef USE_QUANTITIES_DD
+  /*--- Quantities_init_facexy inline, vacuum ---*/
+  return (P) 0;
+#else
   /*--- Quantities_init_facexy inline ---*/
 
   /*--- Quantities_affinefunction_ inline ---*/
@@ -107,6 +117,7 @@ P Quantities_init_face(int ia, int ie, int iu, int scalefactor_space, int octant
 
     /*--- Quantities_scalefactor_octant_ ---*/
     * ( (P) 1 + octant);
+#endif
 
 }
 #ifdef USE_OPENMP4
@@ -153,6 +164,65 @@ void Quantities_solve_inline(P* vs_local, Dimensions dims, P* facexy, P* facexz,
 			     int ix, int iy, int iz, int ie, int ia,
 			     int octant, int octant_in_block, int noctant_per_block)
 {
+#ifdef USE_QUANTITIES_DD
+  /*--- Quantities_solve inline, diamond difference ---*/
+
+  const PAccum sigma_t = Quantities_sigma_t_(
+    Quantities_material_( ix, iy, iz, dims.ncell_z ), ie, dims );
+  const PAccum cx = Quantities_dircoef_( dims, ia, 0 );
+  const PAccum cy = Quantities_dircoef_( dims, ia, 1 );
+  const PAccum cz = Quantities_dircoef_( dims, ia, 2 );
+
+  const PAccum denom_r = ((PAccum)1) / ( ( ( sigma_t + cx ) + cy ) + cz );
+
+  int iu = 0;
+
+  for( iu=0; iu<NU; ++iu )
+    {
+      const int vs_local_index = ia + dims.na * (
+			   iu + NU  * (
+			   ie + dims.ne * (
+			   ix + dims.ncell_x * (
+			   iy + dims.ncell_y * (
+   			   octant + NOCTANT * (
+						0))))));
+      const int facexy_index = ia + dims.na      * (
+			iu + NU           * (
+                        ie + dims.ne      * (
+                        ix + dims.ncell_x * (
+                        iy + dims.ncell_y * (
+			octant + NOCTANT * (
+					     0 ))))));
+      const int facexz_index = ia + dims.na      * (
+			iu + NU           * (
+                        ie + dims.ne      * (
+                        ix + dims.ncell_x * (
+                        iz + dims.ncell_z * (
+			octant + NOCTANT * (
+					     0 ))))));
+      const int faceyz_index = ia + dims.na      * (
+			iu + NU           * (
+                        ie + dims.ne      * (
+                        iy + dims.ncell_y * (
+                        iz + dims.ncell_z * (
+			octant + NOCTANT * (
+					     0 ))))));
+
+      const PAccum face_xy = facexy[facexy_index];
+      const PAccum face_xz = facexz[facexz_index];
+      const PAccum face_yz = faceyz[faceyz_index];
+
+      const PAccum psi = ( ( ( vs_local[vs_local_index] + cx * face_yz )
+                                                        + cy * face_xz )
+                                                        + cz * face_xy )
+                         * denom_r;
+
+      vs_local[vs_local_index] = psi;
+      facexy[facexy_index] = (P)( psi + psi - face_xy );
+      facexz[facexz_index] = (P)( psi + psi - face_xz );
+      faceyz[faceyz_index] = (P)( psi + psi - face_yz );
+    }
+#else
   const int dir_x = Dir_x( octant );
   const int dir_y = Dir_y( octant );
   const int dir_z = Dir_z( octant );
@@ -291,6 +361,7 @@ void Quantities_solve_inline(P* vs_local, Dimensions dims, P* facexy, P* facexz,
 
     } /*---for---*/
 
+#endif
 }
 #ifdef USE_OPENMP4
 #pragma omp end declare target
@@ -27,12 +27,12 @@ extern "C"
 
 typedef struct
 {
-  P* __restrict__  facexy;
-  P* __restrict__  facexz;
-  P* __restrict__  faceyz;
-  P* __restrict__  vslocal;
+  P* __restrict__       facexy;
+  P* __restrict__       facexz;
+  P* __restrict__       faceyz;
+  PAccum* __restrict__  vslocal;
 
-  Dimensions       dims;
+  Dimensions            dims;
 } Sweeper;
 
 /*===========================================================================*/
@@ -45,9 +45,12 @@ void Sweeper_create( Sweeper*          sweeper,
   Insist( Env_nproc( env ) == 1 &&
                              "This sweeper version runs only with one proc." );
 
+  Insist( dims.nm == NM && dims.nu == NU ?
+          "This sweeper version supports only the compile-time NM, NU." : 0 );
+
   /*---Allocate arrays---*/
 
-  sweeper->vslocal = malloc_host_P( dims.na * NU );
+  sweeper->vslocal = malloc_host_PAccum( dims.na * NU );
   sweeper->facexy  = malloc_host_P( dims.ncell_x * dims.ncell_y * dims.ne *
                          dims.na * NU * Sweeper_noctant_per_block( sweeper ) );
   sweeper->facexz  = malloc_host_P( dims.ncell_x * dims.ncell_z * dims.ne *
@@ -66,7 +69,7 @@ void Sweeper_destroy( Sweeper* sweeper,
 {
   /*---Deallocate arrays---*/
 
-  free_host_P( sweeper->vslocal );
+  free_host_PAccum( sweeper->vslocal );
   free_host_P( sweeper->facexy );
   free_host_P( sweeper->facexz );
   free_host_P( sweeper->faceyz );
@@ -295,7 +298,7 @@ void Sweeper_sweep(
       for( iu=0; iu<NU; ++iu )
       for( ia=0; ia<dims.na; ++ia )
       {
-        P result = P_zero();
+        PAccum result = PAccum_zero();
         for( im=0; im<dims.nm; ++im )
         {
           result += *const_ref_a_from_m( Pointer_const_h( & quan->a_from_m ),
@@ -330,7 +333,7 @@ void Sweeper_sweep(
       for( iu=0; iu<NU; ++iu )
       for( im=0; im<dims.nm; ++im )
       {
-        P result = P_zero();
+        PAccum result = PAccum_zero();
         for( ia=0; ia<dims.na; ++ia )
         {
           result += *const_ref_m_from_a( Pointer_const_h( & quan->m_from_a ),
@@ -25,11 +25,25 @@ extern "C"
 
 typedef struct
 {
-  P      normsq;
-  P      normsqdiff;
+  double normsq;
+  double normsqdiff;
   double flops;
   double floprate;
   Timer  time;
+  /*---State vector pages resident per NUMA node, if requested---*/
+  double npage;
+  double npage_node[ENV_NNODE_MAX];
+  /*---Time each sweeper thread spent waiting on others, if requested---*/
+  int    nthread_idle;
+  Timer* idle;
+  /*---Cpu each sweeper thread is pinned to, if an affinity plan is set---*/
+  int    nthread_cpu;
+  int*   cpu;
+  /*---Face bytes before and after compression, summed over procs, and
+       codec time, mean over procs, if the faces are compressed---*/
+  double face_nbyte_raw;
+  double face_nbyte_coded;
+  Timer  face_time_codec;
 } Runner;
 
 /*===========================================================================*/
@@ -52,10 +66,26 @@ void Runner_destroy( Runner* runner );
 
 void Runner_run_case( Runner* runner, Arguments* args, Env* env );
 
+/*===========================================================================*/
+/*---Tolerance on squared norms, relative to normsq---*/
+
+double Runner_tol_normsq(void);
+
+/*===========================================================================*/
+/*---Check run result against expected answer---*/
+
+Bool_t Runner_is_pass( const Runner* runner );
+
 /*===========================================================================*/
 /*---Utility function: perform two runs, compare results---*/
 
-Bool_t compare_runs( const char* argstring1, const char* argstring2, Env* env );
+Bool_t compare_runs( const char* argstring1, const char* argstring2,
+                     Env* env );
+
+/*===========================================================================*/
+/*---Utility function: perform a run, return squared norm of result---*/
+
+double run_normsq( const char* argstring, Env* env );
 
 /*===========================================================================*/
 
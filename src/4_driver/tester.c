@@ -9,6 +9,9 @@
 /*---------------------------------------------------------------------------*/
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 #include "arguments.h"
 #include "env.h"
@@ -16,8 +19,10 @@
 #include "dimensions.h"
 #include "pointer.h"
 #include "quantities.h"
+#include "array_accessors.h"
 #include "array_operations.h"
 #include "sweeper.h"
+#include "facecodec.h"
 
 #include "runner.h"
 
@@ -95,6 +100,130 @@ static void test_serial( Env* env, int* ntest, int* ntest_passed )
       }
       }
     }
+
+    /*-----*/
+
+    char string_common_gemm[] = "--ncell_x 4 --ncell_y 5 --ncell_z 3 "
+                                "--ne 3 --na 9";
+    int gemm_batch_size = 0;
+    for( gemm_batch_size=1; gemm_batch_size<=64; gemm_batch_size*=4 )
+    {
+      char string1[] = "";
+      char string2[MAX_LINE_LEN];
+      sprintf( string2, "--gemm_batch_size %i --ncell_x_per_subblock 3 "
+        "--ncell_y_per_subblock 2 --ncell_z_per_subblock 2",
+        gemm_batch_size );
+      compare_runs_helper( env, ntest, ntest_passed, string_common_gemm,
+        string1, string2 );
+    }
+
+    /*-----*/
+
+    int na = 0;
+    for( na=1; na<=9; na+=2 )
+    {
+      char string_common_elanes[MAX_LINE_LEN];
+      sprintf( string_common_elanes, "--ncell_x 3 --ncell_y 4 --ncell_z 2 "
+        "--ne 11 --na %i", na );
+      char string1[] = "--is_using_energy_lanes 0";
+      char string2[] = "--is_using_energy_lanes 1";
+      compare_runs_helper( env, ntest, ntest_passed, string_common_elanes,
+        string1, string2 );
+    }
+
+    /*-----*/
+
+    char string_common_tile[] = "--ncell_x 5 --ncell_y 4 --ncell_z 3 "
+                                "--ne 7 --na 5 --ncell_x_per_subblock 3 "
+                                "--ncell_y_per_subblock 3";
+    int ne_per_tile = 0;
+    for( ne_per_tile=1; ne_per_tile<=8; ne_per_tile*=2 )
+    {
+      char string1[] = "--ne_per_tile 1 --ncell_x_per_tile 3 "
+                       "--ncell_y_per_tile 3";
+      char string2[MAX_LINE_LEN];
+      sprintf( string2, "--ne_per_tile %i --ncell_x_per_tile %i "
+        "--ncell_y_per_tile %i", ne_per_tile, 1+ne_per_tile%3, 2 );
+      compare_runs_helper( env, ntest, ntest_passed, string_common_tile,
+        string1, string2 );
+    }
+
+    /*-----*/
+
+    int nblock_z = 0;
+    for( nblock_z=1; nblock_z<=3; nblock_z+=2 )
+    {
+      char string_common_private[MAX_LINE_LEN];
+      sprintf( string_common_private, "--ncell_x 4 --ncell_y 3 --ncell_z 6 "
+        "--ne 3 --na 5 --nblock_z %i", nblock_z );
+      char string1[] = "--is_using_vo_private 0";
+      char string2[] = "--is_using_vo_private 1";
+      compare_runs_helper( env, ntest, ntest_passed, string_common_private,
+        string1, string2 );
+    }
+  }
+}
+
+/*===========================================================================*/
+/*---Tester: Serial, run-time nm and nu---*/
+
+static void test_serial_nm_nu( Env* env, int* ntest, int* ntest_passed )
+{
+#ifdef SWEEPER_KBA
+#ifndef USE_MPI
+#ifndef USE_OPENMP
+#ifndef USE_CUDA
+  const Bool_t do_tests = Bool_true;
+#else
+  const Bool_t do_tests = Bool_false;
+#endif
+#else
+  const Bool_t do_tests = Bool_false;
+#endif
+#else
+  const Bool_t do_tests = Bool_false;
+#endif
+#else
+  const Bool_t do_tests = Bool_false;
+#endif
+
+  if( do_tests )
+  {
+    const int nm_values[] = { 1, 9, 16, 4,  16 };
+    const int nu_values[] = { 4, 4,  4, 1,   1 };
+    const int nvalues = sizeof( nm_values ) / sizeof( nm_values[0] );
+
+    int i = 0;
+    for( i=0; i<nvalues; ++i )
+    {
+      char string_common[MAX_LINE_LEN];
+      sprintf( string_common,
+               "--ncell_x 4 --ncell_y 3 --ncell_z 5 --ne 3 --na 7"
+               " --nm %i --nu %i", nm_values[i], nu_values[i] );
+      char string1[] = "";
+      char string2[] = "--ncell_x_per_subblock 2 --ncell_y_per_subblock 2 "
+                       "--ncell_z_per_subblock 3 --nblock_z 5";
+      compare_runs_helper( env, ntest, ntest_passed, string_common,
+        string1, string2 );
+
+      /*---Each moment/angle transform variant against the built-in one---*/
+      int xform_variant = 0;
+      for( xform_variant=1; xform_variant<=4; ++xform_variant )
+      {
+        char string1_xform[] = "--xform_variant 0";
+        char string2_xform[MAX_LINE_LEN];
+        sprintf( string2_xform, "--xform_variant %i", xform_variant );
+        compare_runs_helper( env, ntest, ntest_passed, string_common,
+          string1_xform, string2_xform );
+      }
+
+      /*---The variant chosen by timing, fresh and through the disk
+           cache, against the built-in one---*/
+      compare_runs_helper( env, ntest, ntest_passed, string_common,
+        "--xform_variant 0", "--xform_variant -1 --is_using_xform_cache 0" );
+      compare_runs_helper( env, ntest, ntest_passed, string_common,
+        "--xform_variant 0", "--xform_variant -1 --is_using_xform_cache 1" );
+    }
   }
 }
 
@@ -135,6 +264,50 @@ static void test_openmp( Env* env, int* ntest, int* ntest_passed )
 
     compare_runs_helper( env, ntest, ntest_passed, "", string1_1, string2_1 );
 
+    char string_common_3[] = "--ncell_x 3 --ncell_y 4 --ncell_z 4 --ne 7 "
+      "--na 3 --ncell_y_per_subblock 2 --ncell_z_per_subblock 2";
+    char string2_3[] = "--nthread_y 2 --nthread_z 2 --nthread_e 3 "
+      "--nthread_octant 2 --ne_per_chunk 2";
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_3, "",
+                         string2_3 );
+
+    char string_common_4[] = "--ncell_x 3 --ncell_y 4 --ncell_z 6 --ne 7 "
+      "--na 3 --nblock_z 3 --ncell_y_per_subblock 2 --ncell_z_per_subblock 1";
+    char string2_4[] = "--nthread_y 2 --nthread_z 2 --nthread_e 2 "
+      "--is_using_dataflow 1";
+    char string3_4[] = "--nthread_y 2 --nthread_e 3 --ne_per_chunk 2 "
+      "--is_using_dataflow 1 --is_face_comm_async 0";
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_4, "",
+                         string2_4 );
+    compare_runs_helper( env, ntest, ntest_passed, string_common_4, "",
+                         string3_4 );
+
+    char string1_5[] = "--nthread_e 2 --nthread_y 2 --affinity 1";
+    char string2_5[] = "--nthread_e 2 --nthread_y 2 --affinity 2";
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_4,
+                         string1_5, string2_5 );
+
+    /*---Private vo copies are added in octant order, so two runs of the
+         same case, differing only in thread timing, agree bitwise---*/
+
+    char string_private[] = "--ncell_x 4 --ncell_y 3 --ncell_z 6 --ne 5 "
+      "--na 5 --nblock_z 3 --nthread_octant 4 --nsemiblock 2 --nthread_e 2 "
+      "--is_using_vo_private 1";
+
+    const double normsq_private_1 = run_normsq( string_private, env );
+    const double normsq_private_2 = run_normsq( string_private, env );
+
+    const Bool_t is_private_match = normsq_private_1 == normsq_private_2;
+
+    printf( "%.16e %.16e // %s\n", normsq_private_1, normsq_private_2,
+            is_private_match ? "PASS" : "FAIL" );
+
+    *ntest += 1;
+    *ntest_passed += is_private_match ? 1 : 0;
+
     /*-----*/
 
     char string_pat_2[] = "--ncell_x 5 --ncell_y 4 --ncell_z 5 --ne 17 --na 10 "
@@ -156,6 +329,37 @@ static void test_openmp( Env* env, int* ntest, int* ntest_passed )
       sprintf( string2_2, string_pat_2, nthread_e, nthread_octant );
 
       compare_runs_helper( env, ntest, ntest_passed, "", string1_2, string2_2 );
+
+      char string3_2[MAX_LINE_LEN];
+      sprintf( string3_2, "%s --gemm_batch_size 6", string2_2 );
+
+      compare_runs_helper( env, ntest, ntest_passed, "", string1_2, string3_2 );
+
+      char string4_2[MAX_LINE_LEN];
+      sprintf( string4_2, "%s --is_using_energy_lanes 1", string2_2 );
+
+      compare_runs_helper( env, ntest, ntest_passed, "", string1_2, string4_2 );
+
+      char string5_2[MAX_LINE_LEN];
+      sprintf( string5_2, "%s --is_using_energy_lanes 0 --xform_variant 4",
+               string2_2 );
+
+      compare_runs_helper( env, ntest, ntest_passed, "", string1_2, string5_2 );
+
+      char string6_2[MAX_LINE_LEN];
+      sprintf( string6_2, "%s --nsemiblock 1", string2_2 );
+
+      compare_runs_helper( env, ntest, ntest_passed, "", string1_2, string6_2 );
+
+      char string7_2[MAX_LINE_LEN];
+      sprintf( string7_2, "%s --ne_per_chunk %i", string2_2, 1+nthread_e%3 );
+
+      compare_runs_helper( env, ntest, ntest_passed, "", string1_2, string7_2 );
+
+      char string8_2[MAX_LINE_LEN];
+      sprintf( string8_2, "%s --is_using_dataflow 1", string2_2 );
+
+      compare_runs_helper( env, ntest, ntest_passed, "", string1_2, string8_2 );
     }
     }
 
@@ -281,6 +485,24 @@ static void test_openmp_tasks( Env* env, int* ntest, int* ntest_passed )
     }
     }
     }
+
+    /*---Several z blocks, all octants threaded, with and without
+         semiblocking in z---*/
+
+    int nsemiblock = 0;
+    for( nsemiblock=4; nsemiblock<=8; nsemiblock*=2 )
+    {
+      char string1_z[] = "--ncell_x 6 --ncell_y 5 --ncell_z 8 "
+                         "--ne 3 --na 4 --nblock_z 2";
+      char string2_z[MAX_LINE_LEN];
+      sprintf( string2_z, "%s --nthread_octant 8 --nsemiblock %i "
+                             "--ncell_x_per_subblock 2 "
+                             "--ncell_y_per_subblock 2 "
+                             "--ncell_z_per_subblock 1 ",
+               string1_z, nsemiblock );
+      compare_runs_helper( env, ntest, ntest_passed, "", string1_z,
+                           string2_z );
+    }
   }
 }
 
@@ -449,6 +671,73 @@ static void test_mpi( Env* env, int* ntest, int* ntest_passed )
     compare_runs_helper( env, ntest, ntest_passed, string_common_4,
         "--nproc_x 4 --nproc_y 4 --nblock_z 2",
         "--nproc_x 4 --nproc_y 4 --nblock_z 4" );
+
+    /*---Persistent face requests reused across sweeps; the synchronous
+         run does the same number of sweeps, since with diamond difference
+         the result depends on it---*/
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_4,
+        "--nproc_x 4 --nproc_y 4 --nblock_z 2 --niterations 3"
+        " --is_face_comm_async 0",
+        "--nproc_x 4 --nproc_y 4 --nblock_z 2 --niterations 3" );
+
+    /*---Decomposition along z---*/
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_4,
+        "--nproc_x 1 --nproc_y 1 --nproc_z 1 --nblock_z 2",
+        "--nproc_x 1 --nproc_y 1 --nproc_z 4 --nblock_z 2" );
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_4,
+        "--nproc_x 1 --nproc_y 1 --nproc_z 1 --nblock_z 2",
+        "--nproc_x 2 --nproc_y 2 --nproc_z 4 --nblock_z 2" );
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_3,
+        "--nproc_x 1 --nproc_y 1 --nproc_z 1 --nblock_z 1",
+        "--nproc_x 2 --nproc_y 2 --nproc_z 3 --nblock_z 2" );
+
+    /*---One-sided face delivery---*/
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_4,
+        "--nproc_x 4 --nproc_y 4 --nblock_z 2",
+        "--nproc_x 4 --nproc_y 4 --nblock_z 2 --is_face_comm_rma 1"
+        " --niterations 2" );
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_4,
+        "--nproc_x 1 --nproc_y 1 --nproc_z 1 --nblock_z 2",
+        "--nproc_x 2 --nproc_y 2 --nproc_z 4 --nblock_z 2"
+        " --is_face_comm_rma 1" );
+
+    /*---Compressed faces---*/
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_4,
+        "--nproc_x 4 --nproc_y 4 --nblock_z 2",
+        "--nproc_x 4 --nproc_y 4 --nblock_z 2 --face_compression 1"
+        " --niterations 2" );
+
+    compare_runs_helper( env, ntest, ntest_passed, string_common_4,
+        "--nproc_x 1 --nproc_y 1 --nproc_z 1 --nblock_z 2",
+        "--nproc_x 2 --nproc_y 2 --nproc_z 4 --nblock_z 2"
+        " --face_compression 2 --face_compression_nbit 60" );
+
+    /*---Progress engine for face messages; MPI is asked for the thread
+         support these need only if the tester is run with e.g.
+         --comm_progress 2, so without it they may be skipped---*/
+
+    if( Env_is_progress_supported( env, ENV_PROGRESS_POLL ) )
+    {
+      compare_runs_helper( env, ntest, ntest_passed, string_common_4,
+          "--nproc_x 4 --nproc_y 4 --nblock_z 2",
+          "--nproc_x 4 --nproc_y 4 --nblock_z 2 --comm_progress 1"
+          " --face_compression 1" );
+    }
+
+    if( Env_is_progress_supported( env, ENV_PROGRESS_THREAD ) )
+    {
+      compare_runs_helper( env, ntest, ntest_passed, string_common_4,
+          "--nproc_x 1 --nproc_y 1 --nproc_z 1 --nblock_z 2",
+          "--nproc_x 2 --nproc_y 2 --nproc_z 4 --nblock_z 2"
+          " --comm_progress 2" );
+    }
   }
 }
 
@@ -542,9 +831,585 @@ static void test_variants( Env* env, int* ntest, int* ntest_passed )
       compare_runs_helper( env, ntest, ntest_passed, string_common,
         string1, string2 );
     }
+
+#ifdef SWEEPER_HYPERPLANE
+    /*---Grid shapes giving hyperplane runs of many lengths---*/
+
+    int key = 0;
+
+    for( key=0; key<4; ++key )
+    {
+      char string_common_shape[MAX_LINE_LEN];
+      sprintf( string_common_shape,
+               "--ncell_x %i --ncell_y %i --ncell_z %i --ne 2 --na 5",
+               1+6*(key%2), 9-4*(key/2), 1+3*key );
+      char string1[] = "";
+      char string2[] = "--niterations 2";
+      compare_runs_helper( env, ntest, ntest_passed, string_common_shape,
+        string1, string2 );
+    }
+#endif
   }
 }
 
+/*===========================================================================*/
+/*---Tester: State layout---*/
+
+/*---Check that the build's state layout is one-to-one, keeps each cell's
+     NM x NU values contiguous, and keeps iz slowest-varying---*/
+
+static void test_state_layout( Env* env, int* ntest, int* ntest_passed )
+{
+  if( Env_is_proc_master( env ) )
+  {
+    Dimensions dims;
+    dims.ncell_x = 5;
+    dims.ncell_y = 7;
+    dims.ncell_z = 3;
+    dims.ne      = 3;
+    dims.nm      = 4;
+    dims.na      = 1;
+    dims.nu      = 2;
+
+    const size_t n = Dimensions_size_state( dims, dims.nu );
+    const size_t nplane = n / dims.ncell_z;
+    int* const count = (int*)calloc( n, sizeof(int) );
+    Bool_t pass = Bool_true;
+
+    int ix = 0;
+    int iy = 0;
+    int iz = 0;
+    int ie = 0;
+    int im = 0;
+    int iu = 0;
+
+    for( iz=0; iz<dims.ncell_z; ++iz )
+    for( ie=0; ie<dims.ne; ++ie )
+    for( iy=0; iy<dims.ncell_y; ++iy )
+    for( ix=0; ix<dims.ncell_x; ++ix )
+    {
+      const size_t ind_base = ind_state( dims, dims.nu, ix, iy, iz, ie, 0, 0 );
+      for( iu=0; iu<dims.nu; ++iu )
+      for( im=0; im<dims.nm; ++im )
+      {
+        const size_t ind = ind_state( dims, dims.nu, ix, iy, iz, ie, im, iu );
+        pass = pass && ind < n
+                    && ind == ind_base + im + dims.nm * iu
+                    && ind / nplane == (size_t)iz;
+        if( ind < n )
+        {
+          count[ind] += 1;
+        }
+      }
+    }
+
+    size_t i = 0;
+    for( i=0; i<n; ++i )
+    {
+      pass = pass && count[i] == 1;
+    }
+    free( count );
+
+    printf( "State layout %i // %s\n", (int)STATE_LAYOUT,
+            pass ? "PASS" : "FAIL" );
+
+    *ntest += 1;
+    *ntest_passed += pass ? 1 : 0;
+  }
+}
+
+/*===========================================================================*/
+/*---Tester: Face codec round trip---*/
+
+/*---Encode and decode faces directly: smooth faces, lossless, must come
+     back bitwise; lossy, each value must be within a relative 2^-nbit and
+     the face must shrink.  A face of random bytes cannot be run coded, so
+     it must take the uncoded path, at the largest coded size---*/
+
+static void test_face_codec( Env* env, int* ntest, int* ntest_passed )
+{
+  if( Env_is_proc_master( env ) )
+  {
+    enum{ NA = 8 };
+    enum{ N = NA * 40 };
+
+    P in[N];
+    P out[N];
+    P coded[N + 8];
+
+    unsigned int seed = 1;
+    size_t k = 0;
+    int key = 0;
+
+    for( key=0; key<4; ++key )
+    {
+      /*---key 0: lossless, 1, 2: lossy, 3: random bytes, lossless---*/
+      const int nbit = key == 1 ? 8 : 12;
+      const Bool_t is_random = key == 3;
+      const int mode = key == 1 || key == 2 ? FACECODEC_LOSSY
+                                            : FACECODEC_LOSSLESS;
+
+      FaceCodec codec;
+      FaceCodec_create( &codec, mode, nbit, NA, N );
+      Assert( FaceCodec_size_coded_max( &codec, N ) <= N + 8 );
+
+      for( k=0; k<N; ++k )
+      {
+        in[k] = (P)( 1 + .1 * sin( .37 * k ) + .01 * ( k / NA ) );
+      }
+      if( is_random )
+      {
+        unsigned char* const bytes = (unsigned char*)in;
+        for( k=0; k<N*sizeof(P); ++k )
+        {
+          seed = seed * 1103515245u + 12345u;
+          bytes[k] = (unsigned char)( seed >> 16 );
+        }
+      }
+
+      const size_t ncoded = FaceCodec_encode( &codec, coded, in, N, env );
+      FaceCodec_decode( &codec, out, coded, N, env );
+
+      Bool_t pass = Bool_true;
+
+      if( mode == FACECODEC_LOSSLESS )
+      {
+        pass = pass && memcmp( in, out, sizeof(in) ) == 0;
+      }
+      else
+      {
+        const double tol = ldexp( 1., -nbit );
+        for( k=0; k<N; ++k )
+        {
+          pass = pass && fabs( (double)out[k] - (double)in[k] ) <=
+                         tol * fabs( (double)in[k] );
+        }
+        pass = pass && ncoded < N;
+      }
+      if( is_random )
+      {
+        pass = pass && ncoded == FaceCodec_size_coded_max( &codec, N );
+      }
+
+      FaceCodec_destroy( &codec );
+
+      printf( "Face codec mode %i nbit %i%s // %i %i // %s\n", mode, nbit,
+              is_random ? " random" : "", (int)ncoded, (int)N,
+              pass ? "PASS" : "FAIL" );
+
+      *ntest += 1;
+      *ntest_passed += pass ? 1 : 0;
+    }
+  }
+}
+
+/*===========================================================================*/
+/*---Tester: Quantities coefficient tables match the direct formulas---*/
+
+#ifndef USE_QUANTITIES_DD
+
+static void test_quantities_coefs( Env* env, int* ntest, int* ntest_passed )
+{
+#ifndef USE_MPI
+  const Bool_t do_tests = Bool_true;
+#else
+  const Bool_t do_tests = Bool_false;
+#endif
+
+  if( do_tests )
+  {
+    Dimensions dims;
+    dims.ncell_x = 5;
+    dims.ncell_y = 4;
+    dims.ncell_z = 3;
+    dims.ne      = 1;
+    dims.nm      = NM;
+    dims.na      = 11;
+    dims.nu      = NU;
+
+    Quantities quan;
+    Bool_t pass = Bool_true;
+
+    int octant = 0;
+    int ix = 0;
+    int iy = 0;
+    int iz = 0;
+    int ia = 0;
+
+    Quantities_create( &quan, dims, env );
+
+    for( octant=0; octant<NOCTANT; ++octant )
+    for( iz=0; iz<dims.ncell_z; ++iz )
+    for( iy=0; iy<dims.ncell_y; ++iy )
+    for( ix=0; ix<dims.ncell_x; ++ix )
+    {
+      const QuantitiesCoefs coefs = Quantities_coefs_( &quan, ix, iy, iz,
+                                                       octant );
+      const int ix_up = ix - Dir_inc( Dir_x( octant ) );
+      const int iy_up = iy - Dir_inc( Dir_y( octant ) );
+      const int iz_up = iz - Dir_inc( Dir_z( octant ) );
+      const PAccum space = Quantities_scalefactor_space_( &quan, ix, iy, iz );
+
+      pass = pass
+        && coefs.octant   == Quantities_scalefactor_octant_( octant )
+        && coefs.octant_r == 1 / (PAccum)Quantities_scalefactor_octant_(
+                                                                   octant )
+        && coefs.space    == space
+        && coefs.space_r  == 1 / space
+        && coefs.space_x_r == 1 / (PAccum)Quantities_scalefactor_space_(
+                                                &quan, ix_up, iy, iz )
+        && coefs.space_y_r == 1 / (PAccum)Quantities_scalefactor_space_(
+                                                &quan, ix, iy_up, iz )
+        && coefs.space_z_r == 1 / (PAccum)Quantities_scalefactor_space_(
+                                                &quan, ix, iy, iz_up );
+    }
+
+    for( ia=0; ia<dims.na; ++ia )
+    {
+      pass = pass
+        && quan.fluxweight_vals[ ia + 0 * dims.na ] ==
+                                        Quantities_xfluxweight_( dims, ia )
+        && quan.fluxweight_vals[ ia + 1 * dims.na ] ==
+                                        Quantities_yfluxweight_( dims, ia )
+        && quan.fluxweight_vals[ ia + 2 * dims.na ] ==
+                                        Quantities_zfluxweight_( dims, ia );
+    }
+
+    Quantities_destroy( &quan );
+
+    printf( "Quantities coefficient tables // %s\n", pass ? "PASS" : "FAIL" );
+
+    *ntest += 1;
+    *ntest_passed += pass ? 1 : 0;
+  }
+}
+
+#else /*---USE_QUANTITIES_DD---*/
+
+/*---Also check the quadrature: unit directions, weights summing to one,
+     and first moments vanishing by symmetry---*/
+
+static void test_quantities_coefs( Env* env, int* ntest, int* ntest_passed )
+{
+#ifndef USE_MPI
+  const Bool_t do_tests = Bool_true;
+#else
+  const Bool_t do_tests = Bool_false;
+#endif
+
+  if( do_tests )
+  {
+    Dimensions dims;
+    dims.ncell_x = 5;
+    dims.ncell_y = 4;
+    dims.ncell_z = 3;
+    dims.ne      = 3;
+    dims.nm      = NM;
+    dims.na      = 11;
+    dims.nu      = NU;
+
+    const double tol = IS_USING_MIXED_PRECISION ? 1.e-6 : 1.e-13;
+
+    Quantities quan;
+    Bool_t pass = Bool_true;
+
+    int octant = 0;
+    int ix = 0;
+    int iy = 0;
+    int iz = 0;
+    int ie = 0;
+    int ia = 0;
+    int im = 0;
+
+    Quantities_create( &quan, dims, env );
+
+    for( iz=0; iz<dims.ncell_z; ++iz )
+    for( iy=0; iy<dims.ncell_y; ++iy )
+    for( ix=0; ix<dims.ncell_x; ++ix )
+    for( ie=0; ie<dims.ne; ++ie )
+    {
+      pass = pass && Quantities_sigma_t_cell_( &quan, ix, iy, iz, ie, dims )
+          == Quantities_sigma_t_( Quantities_material_( ix, iy, iz,
+                                                        dims.ncell_z ),
+                                  ie, dims );
+    }
+
+    for( ia=0; ia<dims.na; ++ia )
+    {
+      const double mu  = Quantities_direction_( dims, ia, 0 );
+      const double eta = Quantities_direction_( dims, ia, 1 );
+      const double xi  = Quantities_direction_( dims, ia, 2 );
+
+      pass = pass && fabs( mu * mu + eta * eta + xi * xi - 1 ) < tol
+        && Quantities_dircoef_angle_( &quan, ia, 0, dims ) == 2 * mu
+        && Quantities_dircoef_angle_( &quan, ia, 1, dims ) == 2 * eta
+        && Quantities_dircoef_angle_( &quan, ia, 2, dims ) == 2 * xi;
+    }
+
+    for( im=0; im<dims.nm && im<1+NDIM; ++im )
+    {
+      double sum = 0;
+      for( octant=0; octant<NOCTANT; ++octant )
+      for( ia=0; ia<dims.na; ++ia )
+      {
+        sum += *const_ref_m_from_a( Pointer_const_h( &quan.m_from_a ), dims,
+                                    im, ia, octant );
+      }
+      pass = pass && fabs( sum - ( im == 0 ? 1 : 0 ) ) < tol;
+    }
+
+    Quantities_destroy( &quan );
+
+    printf( "Quantities coefficient tables // %s\n", pass ? "PASS" : "FAIL" );
+
+    *ntest += 1;
+    *ntest_passed += pass ? 1 : 0;
+  }
+}
+
+#endif /*---USE_QUANTITIES_DD---*/
+
+/*===========================================================================*/
+/*---Diamond-difference reference sweep, in double---*/
+
+#ifdef USE_QUANTITIES_DD
+
+/*---A plain sweep of the whole grid, one octant and cell at a time, with
+     the result, faces and angular fluxes held in double and the solve
+     written out from the formula in quantities_dd_kernels.h.  The input
+     state and transform matrices are those of the build.  Returns the
+     squared norm of the result---*/
+
+static double normsq_dd_ref( Dimensions dims, Env* env )
+{
+  const size_t size_state = Dimensions_size_state( dims, NU );
+
+  const size_t nface_xy = ( (size_t)dims.ncell_x ) * dims.ncell_y;
+  const size_t nface_xz = ( (size_t)dims.ncell_x ) * dims.ncell_z;
+  const size_t nface_yz = ( (size_t)dims.ncell_y ) * dims.ncell_z;
+  const size_t nvslocal = ( (size_t)dims.na ) * NU;
+
+  Quantities quan;
+
+  P* const vi = malloc_host_P( size_state );
+  double* const vo = (double*)malloc( size_state * sizeof(double) );
+  double* const facexy = (double*)malloc( nface_xy * nvslocal *
+                                          sizeof(double) );
+  double* const facexz = (double*)malloc( nface_xz * nvslocal *
+                                          sizeof(double) );
+  double* const faceyz = (double*)malloc( nface_yz * nvslocal *
+                                          sizeof(double) );
+  double* const vslocal = (double*)malloc( nvslocal * sizeof(double) );
+
+  double normsq = 0;
+  size_t i = 0;
+  int octant = 0;
+  int ix = 0;
+  int iy = 0;
+  int iz = 0;
+  int ie = 0;
+  int im = 0;
+  int ia = 0;
+  int iu = 0;
+
+  Insist( vo && facexy && facexz && faceyz && vslocal );
+
+  Quantities_create( &quan, dims, env );
+
+  initialize_state( vi, dims, NU, &quan );
+
+  for( i=0; i<size_state; ++i )
+  {
+    vo[i] = 0;
+  }
+
+  for( octant=0; octant<NOCTANT; ++octant )
+  {
+    const int inc_x = Dir_inc( Dir_x( octant ) );
+    const int inc_y = Dir_inc( Dir_y( octant ) );
+    const int inc_z = Dir_inc( Dir_z( octant ) );
+
+    const int ixbeg = inc_x > 0 ? 0 : dims.ncell_x-1;
+    const int iybeg = inc_y > 0 ? 0 : dims.ncell_y-1;
+    const int izbeg = inc_z > 0 ? 0 : dims.ncell_z-1;
+
+    for( ie=0; ie<dims.ne; ++ie )
+    {
+      /*---Incoming boundary values, stored as for the sweepers---*/
+
+      for( iy=0; iy<dims.ncell_y; ++iy )
+      for( ix=0; ix<dims.ncell_x; ++ix )
+      for( ia=0; ia<dims.na; ++ia )
+      for( iu=0; iu<NU; ++iu )
+      {
+        facexy[ iu + NU * ( ia + dims.na * ( ix + dims.ncell_x * iy ) ) ] =
+          Quantities_init_facexy( &quan, ix, iy,
+            inc_z > 0 ? -1 : dims.ncell_z, ie, ia, iu, octant, dims );
+      }
+
+      for( iz=0; iz<dims.ncell_z; ++iz )
+      for( ix=0; ix<dims.ncell_x; ++ix )
+      for( ia=0; ia<dims.na; ++ia )
+      for( iu=0; iu<NU; ++iu )
+      {
+        facexz[ iu + NU * ( ia + dims.na * ( ix + dims.ncell_x * iz ) ) ] =
+          Quantities_init_facexz( &quan, ix,
+            inc_y > 0 ? -1 : dims.ncell_y, iz, ie, ia, iu, octant, dims );
+      }
+
+      for( iz=0; iz<dims.ncell_z; ++iz )
+      for( iy=0; iy<dims.ncell_y; ++iy )
+      for( ia=0; ia<dims.na; ++ia )
+      for( iu=0; iu<NU; ++iu )
+      {
+        faceyz[ iu + NU * ( ia + dims.na * ( iy + dims.ncell_y * iz ) ) ] =
+          Quantities_init_faceyz( &quan,
+            inc_x > 0 ? -1 : dims.ncell_x, iy, iz, ie, ia, iu, octant, dims );
+      }
+
+      for( iz=izbeg; iz>=0 && iz<dims.ncell_z; iz+=inc_z )
+      for( iy=iybeg; iy>=0 && iy<dims.ncell_y; iy+=inc_y )
+      for( ix=ixbeg; ix>=0 && ix<dims.ncell_x; ix+=inc_x )
+      {
+        const double sigma_t = Quantities_sigma_t_cell_( &quan, ix, iy, iz,
+                                                         ie, dims );
+
+        /*---Moments to angles---*/
+
+        for( ia=0; ia<dims.na; ++ia )
+        for( iu=0; iu<NU; ++iu )
+        {
+          double q = 0;
+          for( im=0; im<dims.nm; ++im )
+          {
+            q += (double)*const_ref_a_from_m(
+                           Pointer_const_h( & quan.a_from_m ),
+                           dims, im, ia, octant ) *
+                 (double)*const_ref_state( vi, dims, NU,
+                                           ix, iy, iz, ie, im, iu );
+          }
+          vslocal[ iu + NU * ia ] = q;
+        }
+
+        /*---Solve, with the diamond-difference closure on the faces---*/
+
+        for( ia=0; ia<dims.na; ++ia )
+        {
+          const double cx = Quantities_dircoef_angle_( &quan, ia, 0, dims );
+          const double cy = Quantities_dircoef_angle_( &quan, ia, 1, dims );
+          const double cz = Quantities_dircoef_angle_( &quan, ia, 2, dims );
+
+          for( iu=0; iu<NU; ++iu )
+          {
+            double* const xy = &facexy[ iu + NU * ( ia + dims.na *
+                                        ( ix + dims.ncell_x * iy ) ) ];
+            double* const xz = &facexz[ iu + NU * ( ia + dims.na *
+                                        ( ix + dims.ncell_x * iz ) ) ];
+            double* const yz = &faceyz[ iu + NU * ( ia + dims.na *
+                                        ( iy + dims.ncell_y * iz ) ) ];
+
+            const double psi = ( vslocal[ iu + NU * ia ] + cx * *yz
+                                 + cy * *xz + cz * *xy ) /
+                               ( sigma_t + cx + cy + cz );
+
+            vslocal[ iu + NU * ia ] = psi;
+            *xy = 2 * psi - *xy;
+            *xz = 2 * psi - *xz;
+            *yz = 2 * psi - *yz;
+          }
+        }
+
+        /*---Angles to moments, added into the result, which is indexed
+             as the state vector---*/
+
+        for( im=0; im<dims.nm; ++im )
+        for( iu=0; iu<NU; ++iu )
+        {
+          double v = 0;
+          for( ia=0; ia<dims.na; ++ia )
+          {
+            v += (double)*const_ref_m_from_a(
+                           Pointer_const_h( & quan.m_from_a ),
+                           dims, im, ia, octant ) *
+                 vslocal[ iu + NU * ia ];
+          }
+          vo[ const_ref_state( vi, dims, NU, ix, iy, iz, ie, im, iu ) - vi ]
+                                                                        += v;
+        }
+      } /*---ix/iy/iz---*/
+    } /*---ie---*/
+  } /*---octant---*/
+
+  for( i=0; i<size_state; ++i )
+  {
+    normsq += vo[i] * vo[i];
+  }
+
+  Quantities_destroy( &quan );
+
+  free( (void*)vslocal );
+  free( (void*)faceyz );
+  free( (void*)facexz );
+  free( (void*)facexy );
+  free( (void*)vo );
+  free_host_P( vi );
+
+  return normsq;
+}
+
+#endif /*---USE_QUANTITIES_DD---*/
+
+/*===========================================================================*/
+/*---Tester: diamond-difference result vs. double reference sweep---*/
+
+/*---Diamond difference has no analytic answer, so each sweeper's result
+     is checked against that of the plain sweep above, done in double:
+     this makes the sweepers agree with each other to rounding.
+     Diamond-difference values are not exact in float, so in a mixed
+     precision build, where the reference starts from the same float
+     input state and transforms, this measures the error of float
+     storage of the faces and result.  The testing problem is exact in
+     float and has no error to measure---*/
+
+/*---Relative error seen, negative if not measured---*/
+
+static double relerr_dd = -1;
+
+static void test_quantities_dd_ref( Env* env, int* ntest, int* ntest_passed )
+{
+#ifdef USE_QUANTITIES_DD
+  const char* argstring = "--ncell_x 5 --ncell_y 4 --ncell_z 6 --ne 3 --na 10";
+
+  Dimensions dims;
+  dims.ncell_x = 5;
+  dims.ncell_y = 4;
+  dims.ncell_z = 6;
+  dims.ne      = 3;
+  dims.nm      = NM;
+  dims.na      = 10;
+  dims.nu      = NU;
+
+  const double normsq = run_normsq( argstring, env );
+
+  /*---The run leaves the env set for one proc, the master---*/
+
+  if( Env_is_proc_master( env ) )
+  {
+    const double normsq_ref = normsq_dd_ref( dims, env );
+
+    relerr_dd = fabs( normsq - normsq_ref ) / normsq_ref;
+
+    const Bool_t pass = relerr_dd <= Runner_tol_normsq();
+
+    printf( "%.16e %.16e %e // %s\n", normsq, normsq_ref, relerr_dd,
+            pass ? "PASS" : "FAIL" );
+
+    *ntest += 1;
+    *ntest_passed += pass ? 1 : 0;
+  }
+#endif
+}
+
 /*===========================================================================*/
 /*---Tester---*/
 
@@ -555,6 +1420,8 @@ static void tester( Env* env )
 
   test_serial( env, &ntest, &ntest_passed );
 
+  test_serial_nm_nu( env, &ntest, &ntest_passed );
+
   test_openmp( env, &ntest, &ntest_passed );
 
   test_openmp_tasks( env, &ntest, &ntest_passed );
@@ -567,8 +1434,20 @@ static void tester( Env* env )
 
   test_variants( env, &ntest, &ntest_passed );
 
+  test_state_layout( env, &ntest, &ntest_passed );
+  test_face_codec( env, &ntest, &ntest_passed );
+  test_quantities_coefs( env, &ntest, &ntest_passed );
+
+  test_quantities_dd_ref( env, &ntest, &ntest_passed );
+
   if( Env_is_proc_master( env ) )
   {
+    if( relerr_dd >= 0 )
+    {
+      printf( "%s: relative error vs. double %e\n",
+              IS_USING_MIXED_PRECISION ? "Mixed precision"
+                                       : "Diamond difference", relerr_dd );
+    }
     printf( "TESTS %i    PASSED %i    FAILED %i\n",
             ntest, ntest_passed, ntest-ntest_passed );
   }